@@ -0,0 +1,112 @@
+/*
+ * This copyright notice applies to this file only
+ *
+ * SPDX-FileCopyrightText: Copyright (c) 2025 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+/*
+ * Throughput of the in place chroma layout change done by YuvConverter, with the SSE2/NEON row loops
+ * against the scalar ones (YuvConverter<T, false>), on 4:2:0 frames at 1080p and 2160p.
+ * Built by tests/CMakeLists.txt and run by hand:
+ *     cmake -S tests -B build/tests -DCMAKE_BUILD_TYPE=Release && cmake --build build/tests --target yuv_converter_benchmark
+ *     build/tests/yuv_converter_benchmark [seconds per case]
+ * The rate is the chroma bytes converted per second.
+ */
+
+#include "YuvConverter.h"
+
+#include <chrono>
+#include <stdio.h>
+#include <stdlib.h>
+#include <vector>
+
+namespace
+{
+
+const char* SimdName()
+{
+#if defined(YUV_CONVERTER_SSE2)
+    return "SSE2";
+#elif defined(YUV_CONVERTER_NEON)
+    return "NEON";
+#else
+    return "none";
+#endif
+}
+
+template <typename T, bool bSimd>
+double MeasureGBps(int nWidth, int nHeight, bool bToInterleaved, double dSeconds)
+{
+    std::vector<T> vFrame((size_t)nWidth * nHeight * 3 / 2);
+    for (T& s : vFrame)
+    {
+        s = (T)rand();
+    }
+    YuvConverter<T, bSimd> converter(nWidth, nHeight);
+    size_t nChromaBytes = (size_t)nWidth * nHeight / 2 * sizeof(T);
+    int nRun = 0;
+    auto start = std::chrono::steady_clock::now();
+    double dElapsed = 0;
+    do
+    {
+        if (bToInterleaved)
+        {
+            converter.PlanarToUVInterleaved(vFrame.data());
+        }
+        else
+        {
+            converter.UVInterleavedToPlanar(vFrame.data());
+        }
+        nRun++;
+        dElapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    } while (dElapsed < dSeconds);
+    return nChromaBytes * (double)nRun / dElapsed / 1e9;
+}
+
+template <typename T>
+void RunCase(const char* szFormat, int nWidth, int nHeight, bool bToInterleaved, double dSeconds)
+{
+    double dScalar = MeasureGBps<T, false>(nWidth, nHeight, bToInterleaved, dSeconds);
+    double dSimd = MeasureGBps<T, true>(nWidth, nHeight, bToInterleaved, dSeconds);
+    printf("%-6s %4dx%-4d %-20s %8.2f %8.2f %7.2fx\n", szFormat, nWidth, nHeight,
+        bToInterleaved ? "planar->interleaved" : "interleaved->planar", dScalar, dSimd, dSimd / dScalar);
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    double dSeconds = argc > 1 ? atof(argv[1]) : 0.5;
+    printf("YuvConverter, SIMD row loops: %s\n", SimdName());
+    printf("%-6s %-9s %-20s %8s %8s %8s\n", "format", "size", "direction", "scalar", "simd", "speedup");
+    printf("%-6s %-9s %-20s %8s %8s\n", "", "", "", "GB/s", "GB/s");
+    const int aSize[][2] = { { 1920, 1080 }, { 3840, 2160 } };
+    for (auto& size : aSize)
+    {
+        for (bool bToInterleaved : { true, false })
+        {
+            RunCase<uint8_t>("8 bit", size[0], size[1], bToInterleaved, dSeconds);
+            RunCase<uint16_t>("16 bit", size[0], size[1], bToInterleaved, dSeconds);
+        }
+    }
+    return 0;
+}
@@ -114,6 +114,28 @@ class SimpleDecoder:
         """
         return self.simple_decoder.get_batch_frames(batch_size)
 
+    def get_batch_tensor(self, batch_size):
+        """
+        Returns a batch of frames packed into one contiguous device tensor. Unlike get_batch_frames
+        no per frame objects are created and the result can be consumed through DLPack without stacking.
+        Requires use_device_memory to be 'True'.
+        Args:
+        batch_size(int): Number of frames in the batch
+        Returns:
+        DecodedBatch : Batch tensor of shape N x rows x W (NV12, P016, NV16, P216), N x 3 x H x W (YUV444, RGBP)
+        or N x H x W x 3 (RGB), along with the timestamps of the frames
+        """
+        return self.simple_decoder.get_batch_tensor(batch_size)
+
+    def get_batch_allocation_count(self):
+        """
+        Returns the number of device allocations made for batch tensors so far. Batch tensors are pooled,
+        so the count only grows while batches are held or when the batch size or resolution changes.
+        Returns:
+        int : Number of batch tensor allocations
+        """
+        return self.simple_decoder.get_batch_allocation_count()
+
     def stop(self):
         return self.simple_decoder.stop()
 
@@ -148,6 +170,23 @@ class SimpleDecoder:
         reordered_frames = [mapping[val] for val in validated_indices]
         return reordered_frames
 
+    def get_batch_tensor_by_index(self, indices):
+        """
+        Returns the frames at the given indices packed into one contiguous device tensor.
+        Frames are stored in ascending index order, duplicate and out of range indices are skipped.
+        Args:
+        indices(list): A list containing the frame indices to be retrieved
+        Returns:
+        DecodedBatch : Batch tensor, see get_batch_tensor
+        """
+        total_frames = self.__len__()
+        valid_indices = sorted(set(index for index in indices if 0 <= index < total_frames))
+        if len(valid_indices) < len(indices):
+            warnings.warn(
+                f"Out of range and duplicate indices have been removed. Modified index list: {valid_indices}"
+            )
+        return self.simple_decoder.get_batch_tensor_by_index(valid_indices)
+
 
     def get_stream_metadata(self):
         """
@@ -82,6 +82,32 @@ class ThreadedDecoder():
             Got batch_size = {batch_size} whereas buffer_size = {self.buffer_size}")
         return self.threaded_decoder.get_batch_frames(batch_size)
 
+    def get_batch_tensor(self, batch_size):
+        """
+        Returns a batch of frames packed into one contiguous device tensor. Unlike get_batch_frames
+        no per frame objects are created and the result can be consumed through DLPack without stacking.
+        Requires use_device_memory to be 'True'.
+        Args:
+        batch_size(int): Number of frames in the batch
+        Returns:
+        DecodedBatch : Batch tensor of shape N x rows x W (NV12, P016, NV16, P216), N x 3 x H x W (YUV444, RGBP)
+        or N x H x W x 3 (RGB), along with the timestamps of the frames
+        """
+        if batch_size > self.buffer_size:
+            raise Exception(f"batch_size cannot be greater than buffer_size. \
+            Got batch_size = {batch_size} whereas buffer_size = {self.buffer_size}")
+        return self.threaded_decoder.get_batch_tensor(batch_size)
+
+    def get_batch_copied_frame_count(self):
+        """
+        Returns the number of frames get_batch_tensor copied into a batch tensor so far. Once a batch size is
+        requested the decoder writes the frames it decodes in place, so the count only grows for frames decoded
+        before and for batches not aligned with the frames written in place.
+        Returns:
+        int : Number of copied frames
+        """
+        return self.threaded_decoder.get_batch_copied_frame_count()
+
     def end(self):
         return self.threaded_decoder.end()
 
@@ -0,0 +1,163 @@
+/*
+ * This copyright notice applies to this file only
+ *
+ * SPDX-FileCopyrightText: Copyright (c) 2025 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <cuda.h>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "NvDecoder/NvDecoder.h"
+#include "PyCAIMemoryView.hpp"
+
+/**
+* @brief A batch of decoded frames packed into one contiguous device tensor.
+* Frame i occupies the i-th slot of the tensor, so the batch can be handed to a framework
+* as a single DLPack tensor without stacking. The layout depends on the output format:
+* NV12/P016/NV16/P216 - N x (H + chroma rows) x W, YUV444/RGBP - N x 3 x H x W, RGB - N x H x W x 3.
+* Frames the decoder wrote in place keep its row pitch, so their rows may be padded as described by the strides.
+*/
+struct DecodedBatch
+{
+    std::vector<int64_t> timestamps;
+    Pixel_Format format = Pixel_Format_UNDEFINED;
+    std::shared_ptr<ExternalBuffer> extBuf;
+    size_t decoderStreamEvent = 0;
+    size_t decoderStream = 0;
+    DecodedBatch() {
+        extBuf = std::make_shared<ExternalBuffer>();
+    }
+};
+
+/**
+* @brief Pool of batch tensors. A buffer is returned to the pool once the last DecodedBatch or
+* DLPack tensor referring to it is released, so steady state batching does not allocate.
+*/
+class BatchFramePool
+{
+public:
+    BatchFramePool(CUcontext cuContext, uint32_t deviceId);
+    ~BatchFramePool();
+
+    /**
+    *   @brief  Copies the frames into one pooled batch tensor on the decoder stream and records
+    *   the batch ready event. The source frames are only read on the decoder stream, so they
+    *   may be unlocked as soon as this returns. Frames the decoder wrote in place into one
+    *   decode target (see SetDecodeTarget()) are handed out as a view of it without copying.
+    */
+    DecodedBatch Pack(const NvDecoder* decoder, const std::vector<DecodedFrame>& frames);
+
+    /**
+    *   @brief  Makes the decoder write its output frames, in display order, into pooled tensors of
+    *   nBatchSize frames that start at batch boundaries, so that Pack() does not copy them.
+    *   The frames must be claimed with ClaimDecodeTarget() when fetched from the decoder.
+    *   nBatchSize 0 detaches the decoder and drops the targets of frames never claimed.
+    *   May be called while the decoder thread runs, frames already decoded stay in decoder memory.
+    */
+    void SetDecodeTarget(NvDecoder* decoder, size_t nBatchSize);
+
+    /**
+    *   @brief  Returns the decode target holding the frame at dpFrame, or nullptr if the frame is in
+    *   decoder memory. The caller keeps it alive for as long as the frame is referenced.
+    */
+    std::shared_ptr<void> ClaimDecodeTarget(CUdeviceptr dpFrame);
+
+    /**
+    *   @brief  Returns the number of device allocations made by the pool so far.
+    */
+    uint32_t GetAllocationCount() const { return mState->nAllocations; }
+
+    /**
+    *   @brief  Returns the number of frames Pack() copied so far instead of handing them out in place.
+    */
+    uint32_t GetCopiedFrameCount() const { return mnCopiedFrames; }
+
+private:
+    struct Buffer
+    {
+        CUdeviceptr data = 0;
+        size_t nBytes = 0;
+        CUevent readyEvent = nullptr;
+    };
+
+    // Shared with the outstanding batches, which return their buffer here on release
+    struct State
+    {
+        CUcontext cuContext = nullptr;
+        std::mutex mtx;
+        std::vector<Buffer> vFree;
+        uint32_t nAllocations = 0;
+        ~State();
+    };
+
+    // Tensor the decoder writes frames into, held here while it is written or has frames not claimed yet.
+    // Afterwards the claimed frames and the batches packed from them keep it alive.
+    struct PendingTarget
+    {
+        std::shared_ptr<Buffer> buffer;
+        size_t nFrameBytes = 0;
+        size_t nFrames = 0;
+        size_t nWritten = 0;
+        size_t nClaimed = 0;
+    };
+
+    // Layout of a target handed to the decoder, to locate the frames of a batch in it
+    struct IssuedTarget
+    {
+        std::weak_ptr<Buffer> buffer;
+        size_t nFrameBytes = 0;
+        // display sequence number of the first frame
+        uint64_t nFirstSeq = 0;
+    };
+
+    std::shared_ptr<Buffer> Acquire(size_t nBytes);
+
+    /**
+    *   @brief  Output target callback of the decoder, called by the decode thread.
+    */
+    uint8_t* NextDecodeTarget(size_t nFrameBytes);
+
+    /**
+    *   @brief  Returns the issued target holding the frame at dpFrame and its display sequence number,
+    *   or nullptr if the frame is in decoder memory. Expects mMtxTargets held.
+    */
+    std::shared_ptr<Buffer> FindIssuedTarget(CUdeviceptr dpFrame, size_t nFrameBytes, uint64_t* pnSeq);
+
+    std::shared_ptr<State> mState;
+    uint32_t mDeviceId = 0;
+
+    std::mutex mMtxTargets;
+    NvDecoder* mTargetDecoder = nullptr;
+    size_t mnTargetBatchSize = 0;
+    // the last target is the one being written
+    std::deque<PendingTarget> mvTargets;
+    std::vector<IssuedTarget> mvIssuedTargets;
+    // display sequence number of the next written frame and of the first frame of the next batch
+    uint64_t mnNextSeq = 0;
+    uint64_t mnAlignSeq = 0;
+    uint32_t mnCopiedFrames = 0;
+};
@@ -32,6 +32,7 @@
 #include <string>
 #include <vector>
 
+#include "DecodedBatch.hpp"
 #include "FFmpegDemuxer.h"
 #include "DecoderCache.hpp"
 #include "NvCodecUtils.h"
@@ -60,6 +61,7 @@ private:
     bool mReleasePrimaryContext = false;
     bool mUseDeviceMemory = false;
     std::unique_ptr<SeekUtils> mSeekUtils;
+    std::unique_ptr<BatchFramePool> mBatchFramePool;
 
     using Keys = std::tuple<int, cudaVideoCodec, cudaVideoChromaFormat>;
     DecoderCache<Keys, NvDecoder*> mDecoderCache;
@@ -96,6 +98,7 @@ public:
     void HandleDecoderInstanceRemoval(const std::optional<NvDecoder*>& decoder);
     void ReconfigureDecoder(std::string newSource);
     SeekUtils* GetPtrToSeekUtils();
+    BatchFramePool* GetBatchFramePool();
     void WaitForStreamMetadata();
     CUcontext GetCUContext() { return mCudaContext; }
     CUstream GetCUStream() { return mCudaStream; }
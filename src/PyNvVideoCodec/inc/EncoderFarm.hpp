@@ -0,0 +1,120 @@
+/*
+ * This copyright notice applies to this file only
+ *
+ * SPDX-FileCopyrightText: Copyright (c) 2025 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "PyNvEncoder.hpp"
+
+/**
+* @brief Result of an EncoderFarm job: the packets of the whole sequence in one bitstream, packet i spanning
+* offsets[i] to offsets[i + 1], or the error that stopped the job.
+*/
+struct EncodeJobResult
+{
+    uint64_t jobId = 0;
+    std::shared_ptr<EncodedBitstream> bitstream;
+    std::string error;
+};
+
+/**
+* @brief Encodes independent frame sequences (jobs) in parallel on several NVENC sessions, possibly across GPUs,
+* within one process. Each session is driven by a worker thread with its own job queue. A job is queued on the
+* least loaded session, preferring one already configured like the job, and an idle worker steals the most
+* recently queued job of the busiest session. A session keeps its encoder for consecutive jobs of the same
+* configuration. The sessions of a GPU share its primary context.
+* Workers never touch Python objects: the frames of a job are parsed by Submit() and released by Retrieve().
+*/
+class EncoderFarm
+{
+public:
+    EncoderFarm(const std::vector<int>& vGpuId, int nSessionsPerGpu);
+    ~EncoderFarm();
+
+    /**
+    *  @brief  Queues the encode of a frame sequence and returns the job id. Device frames are read with the
+    *  ordering of the legacy default stream; frames produced on another GPU than the session must be ready.
+    */
+    uint64_t Submit(py::object frames, int width, int height, const std::string& format,
+        const std::map<std::string, std::string>& config, const std::vector<uint8_t>& vPicFlags);
+
+    /**
+    *  @brief  Returns the next completed job, or nullptr if none completes within timeout seconds (negative
+    *  waits indefinitely) or no job is pending.
+    */
+    std::shared_ptr<EncodeJobResult> Retrieve(double timeout);
+
+    size_t GetPendingCount();
+    size_t GetSessionCount() const { return m_vSessions.size(); }
+
+private:
+    struct EncodeJob
+    {
+        uint64_t id = 0;
+        int width = 0;
+        int height = 0;
+        NV_ENC_BUFFER_FORMAT eBufferFormat = NV_ENC_BUFFER_FORMAT_UNDEFINED;
+        // encoder options, including fmt and s
+        std::map<std::string, std::string> config;
+        std::vector<EncoderInput> vInput;
+        std::vector<uint8_t> vPicFlags;
+        EncodeJobResult result;
+    };
+
+    struct Session
+    {
+        CUcontext cuContext = nullptr;
+        CUstream cuStream = nullptr;
+        std::unique_ptr<NvEncoderCuda> encoder;
+        // options of the encoder, guarded by m_mtx
+        std::map<std::string, std::string> config;
+        std::deque<std::unique_ptr<EncodeJob>> qJobs;
+        std::thread thread;
+    };
+
+    void WorkerLoop(Session& session);
+    std::unique_ptr<EncodeJob> PopJob(Session& session);
+    void RunJob(Session& session, EncodeJob& job);
+    void CreateEncoder(Session& session, const EncodeJob& job);
+
+    std::vector<int> m_vGpuId;
+    std::vector<std::unique_ptr<Session>> m_vSessions;
+    std::mutex m_mtx;
+    std::condition_variable m_cvJobs;
+    std::condition_variable m_cvResults;
+    std::deque<std::unique_ptr<EncodeJob>> m_qCompleted;
+    uint64_t m_nNextJobId = 0;
+    // jobs submitted and not retrieved yet
+    size_t m_nPending = 0;
+    bool m_bStop = false;
+};
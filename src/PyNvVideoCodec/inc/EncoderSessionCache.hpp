@@ -0,0 +1,114 @@
+/*
+ * This copyright notice applies to this file only
+ *
+ * SPDX-FileCopyrightText: Copyright (c) 2025 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <tuple>
+
+#include "NvEncoderCuda.h"
+
+/**
+* @brief Counters of EncoderSessionCache. Time saved is estimated as the average time to create a session
+* times the number of sessions reused, minus the time spent resetting the reused sessions.
+*/
+struct EncoderSessionCacheStats
+{
+    uint64_t sessionsCreated = 0;
+    uint64_t sessionsReused = 0;
+    uint64_t sessionsEvicted = 0;
+    double createTimeMs = 0;
+    double reuseTimeMs = 0;
+    double GetSavedTimeMs() const
+    {
+        return sessionsCreated ? sessionsReused * (createTimeMs / sessionsCreated) - reuseTimeMs : 0;
+    }
+};
+
+/**
+* @brief Process wide LRU cache of idle NVENC sessions. PyNvEncoder hands its session to the cache when it is
+* destroyed, and a later PyNvEncoder with the same key resets the session with NvEncoder::Reconfigure() instead
+* of opening a new one, which skips loading the API, opening the session and allocating and registering the
+* input and output buffers. Only sessions on a device primary context are cached; each cached session holds a
+* reference to the context. Idle sessions count against the NVENC session limit of the GPU, so the cache is
+* disabled (capacity 0) unless enabled with SetCapacity().
+*/
+class EncoderSessionCache
+{
+public:
+    // GPU, codec, width, height, buffer format, preset, tuning info
+    typedef std::tuple<int, std::string, uint32_t, uint32_t, NV_ENC_BUFFER_FORMAT, std::string, std::string> Key;
+
+    static EncoderSessionCache& Instance();
+
+    /**
+    *  @brief  Sets the maximum number of idle sessions, destroying the least recently used ones beyond it
+    */
+    void SetCapacity(size_t nCapacity);
+    size_t GetCapacity();
+
+    /**
+    *  @brief  Removes and returns the most recently cached session matching key, or nullptr. The caller owns the
+    *  reference to the primary context of the GPU that was held by the cache.
+    */
+    std::unique_ptr<NvEncoderCuda> Acquire(const Key& key);
+
+    /**
+    *  @brief  Caches a flushed session. Takes over a reference to the primary context of the GPU of key.
+    *  Returns false, leaving encoder untouched, if the cache is disabled.
+    */
+    bool Release(const Key& key, std::unique_ptr<NvEncoderCuda>& encoder);
+
+    /**
+    *  @brief  Destroys all idle sessions
+    */
+    void Clear();
+
+    void RecordCreate(double timeMs);
+    void RecordReuse(double timeMs);
+    EncoderSessionCacheStats GetStats();
+
+private:
+    EncoderSessionCache() = default;
+    struct Entry
+    {
+        Key key;
+        std::unique_ptr<NvEncoderCuda> encoder;
+    };
+    static void Destroy(Entry& entry);
+    // Evicts entries beyond nCapacity into lEvicted, to be destroyed without the lock held
+    void Trim(size_t nCapacity, std::list<Entry>& lEvicted);
+
+    std::mutex m_mtx;
+    // most recently cached first; the cache is small, so lookups scan the list
+    std::list<Entry> m_lEntries;
+    size_t m_nCapacity = 0;
+    EncoderSessionCacheStats m_stats;
+    // IO stream of idle sessions: the stream of their last owner may be destroyed
+    static CUstream s_idleStream;
+};
@@ -0,0 +1,61 @@
+/*
+ * This copyright notice applies to this file only
+ *
+ * SPDX-FileCopyrightText: Copyright (c) 2025 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <map>
+#include <stdint.h>
+#include <vector>
+
+#include "NvEncFrameStats.h"
+
+/**
+* @brief Running aggregates of the NvEncFrameStats of an encoder: frame counts per picture type and histograms of
+* the average QP, the frame size and the latency from submission to bitstream lock. Sizes and latencies are binned
+* by powers of two: bin i counts the values in [2^i, 2^(i+1)), bin 0 also counts 0 and the last bin everything above.
+*/
+struct EncoderStatsHistogram
+{
+    static constexpr size_t NUM_QP_BINS = 256;
+    static constexpr size_t NUM_LOG2_BINS = 32;
+
+    uint64_t numFrames = 0;
+    uint64_t totalBytes = 0;
+    uint64_t totalQP = 0;
+    double totalLatencyMs = 0;
+    double maxLatencyMs = 0;
+    std::map<NV_ENC_PIC_TYPE, uint64_t> framesByType;
+    std::vector<uint64_t> qpHistogram = std::vector<uint64_t>(NUM_QP_BINS);
+    // in bytes
+    std::vector<uint64_t> sizeHistogram = std::vector<uint64_t>(NUM_LOG2_BINS);
+    // in microseconds
+    std::vector<uint64_t> latencyHistogram = std::vector<uint64_t>(NUM_LOG2_BINS);
+
+    void Add(const NvEncFrameStats& stats);
+    void Reset() { *this = EncoderStatsHistogram(); }
+    double GetAverageQP() const { return numFrames ? (double)totalQP / numFrames : 0; }
+    double GetAverageSize() const { return numFrames ? (double)totalBytes / numFrames : 0; }
+    double GetAverageLatencyMs() const { return numFrames ? totalLatencyMs / numFrames : 0; }
+};
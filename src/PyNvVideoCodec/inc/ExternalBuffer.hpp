@@ -27,8 +27,10 @@
 #define EXTERNAL_BUFFER_HPP
 
 #include "DLPackUtils.hpp"
+#include "TensorDims.hpp"
 
 #include <cuda.h>
+#include <memory>
 #include <pybind11/numpy.h>
 #include <pybind11/pybind11.h>
 #include <pybind11/stl.h>
@@ -55,16 +57,51 @@ public:
 
 
     ExternalBuffer() = default;
-    py::capsule dlpack(py::object consumer_stream, CUstream producer_stream, CUevent producer_stream_event) const;
+    /**
+    * @brief Exports the buffer following the DLPack protocol. A DLPack 1.0 versioned capsule is returned when the
+    * consumer passes max_version >= (1, 0), a legacy capsule otherwise. The consumer stream waits on producer_stream_event,
+    * the event recorded after the frame was written, so that no host or device wide synchronization is needed.
+    * @param consumer_stream - None, -1 (no synchronization), 1 (legacy default), 2 (per-thread default) or a CUstream handle
+    * @param max_version - highest (major, minor) DLPack version supported by the consumer, or None
+    * @param dl_device - (device_type, device_id) requested by the consumer, or None. Only the device of the buffer is supported
+    * @param copy - True is not supported since frames are exported without copy
+    */
+    py::capsule dlpack(py::object consumer_stream, CUstream producer_stream, CUevent producer_stream_event,
+                       py::object max_version = py::none(), py::object dl_device = py::none(), py::object copy = py::none()) const;
     py::tuple dlpackDevice() const;
-    int LoadDLPack(std::vector<size_t> _shape, std::vector<size_t> _stride, std::string _typeStr,
+    // Read-only buffers, e.g. mapped decoder surfaces, are flagged as such in versioned capsules
+    void SetReadOnly(bool bReadOnly) { m_bReadOnly = bReadOnly; }
+    bool IsReadOnly() const { return m_bReadOnly; }
+    int LoadDLPack(const TensorDims& _shape, const TensorDims& _stride, ViewDataType _dtype,
                    CUdeviceptr _data, bool useDeviceMemory, uint32_t deviceId, const CUcontext context);
+    // Keeps the owner of the wrapped memory alive for as long as this buffer or an exported capsule refers to it
+    void SetOwner(std::shared_ptr<void> owner) { m_owner = std::move(owner); }
 
 private:
     friend py::detail::type_caster<ExternalBuffer>;
     DLPackTensor                    m_dlTensor;
+    std::shared_ptr<void>           m_owner;
+    bool                            m_bReadOnly = false;
 };
 
 
+/**
+* @brief Recycles ExternalBuffer objects once every DecodedFrame and DLPack capsule referring to them
+* has been released, so that steady state frame handoff does not allocate.
+* Not thread safe, each producer owns its pool.
+*/
+class ExternalBufferPool
+{
+public:
+    static constexpr size_t MAX_POOLED_BUFFERS = 64;
+
+    std::shared_ptr<ExternalBuffer> Acquire();
+    size_t GetAllocationCount() const { return m_nAllocations; }
+
+private:
+    std::vector<std::shared_ptr<ExternalBuffer>> m_vBuffers;
+    size_t m_nNext = 0;
+    size_t m_nAllocations = 0;
+};
 
 #endif // EXTERNAL_BUFFER_HPP
@@ -49,6 +49,7 @@ enum ColorSpace {
     BT_601 = 0,
     BT_709 = 1,
     UNSPEC = 2,
+    BT_2020 = 3,
 };
 
 enum ColorRange {
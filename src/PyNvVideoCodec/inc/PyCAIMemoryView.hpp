@@ -28,13 +28,17 @@
 #include <sstream>
 #include <cuda.h>
 #include <pybind11/pybind11.h>
+#include <array>
+#include <stdexcept>
 #include <string>
 #include <vector>
 #include "nvEncodeAPI_130.h"
 #include "nvEncodeAPI_121.h"
 #include "NvCodecUtils.h"
 #include "ExternalBuffer.hpp"
+#include "TensorDims.hpp"
 #include "ColorSpace.h"
+#include "PostProcess.h"
 #include "NvEncoderClInterface.hpp"
 using namespace std;
 //using namespace chrono;
@@ -121,36 +125,130 @@ enum Pixel_Format {
 
 struct CAIMemoryView
 {
-  std::vector<size_t>  shape;
-  std::vector<size_t>  stride;
-  std::string          typestr;
+  TensorDims           shape;
+  TensorDims           stride;
+  ViewDataType         dtype = ViewDataType::UINT8;
   CUstream             stream = nullptr;
-  CUdeviceptr          data;
-  bool                 readOnly;
+  CUdeviceptr          data = 0;
+  bool                 readOnly = false;
     public:
-  CAIMemoryView(std::vector<size_t> _shape, std::vector<size_t> _stride, std::string _typeStr, size_t _streamid, CUdeviceptr _data,  bool _readOnly)
+  CAIMemoryView() = default;
+  CAIMemoryView(TensorDims _shape, TensorDims _stride, ViewDataType _dtype, size_t _streamid, CUdeviceptr _data, bool _readOnly)
  {
       shape = _shape;
       stride= _stride;
-      typestr = _typeStr;
+      dtype = _dtype;
       data = _data;
       readOnly= _readOnly;
       stream = reinterpret_cast<CUstream>(_streamid);
   }
+  CAIMemoryView(TensorDims _shape, TensorDims _stride, const std::string& _typeStr, size_t _streamid, CUdeviceptr _data, bool _readOnly)
+      : CAIMemoryView(_shape, _stride, ParseTypeStr(_typeStr), _streamid, _data, _readOnly)
+  {
+  }
+  const char* typestr() const { return GetTypeStr(dtype); }
+};
+
+/**
+* @brief Fixed capacity list of the plane views of a decoded frame.
+*/
+class FrameViews
+{
+public:
+    static constexpr size_t MAX_VIEWS = 3;
+
+    void push_back(const CAIMemoryView& view)
+    {
+        if (m_nViews == MAX_VIEWS)
+        {
+            throw std::length_error("A decoded frame has at most 3 views");
+        }
+        m_views[m_nViews++] = view;
+    }
+    void clear() { m_nViews = 0; }
+    size_t size() const { return m_nViews; }
+    bool empty() const { return m_nViews == 0; }
+    CAIMemoryView& operator[](size_t i) { return m_views[i]; }
+    const CAIMemoryView& operator[](size_t i) const { return m_views[i]; }
+    const CAIMemoryView& at(size_t i) const
+    {
+        if (i >= m_nViews)
+        {
+            throw std::out_of_range("View index out of range");
+        }
+        return m_views[i];
+    }
+    const CAIMemoryView* begin() const { return m_views.data(); }
+    const CAIMemoryView* end() const { return m_views.data() + m_nViews; }
+    py::list ToList() const
+    {
+        py::list views;
+        for (const CAIMemoryView& view : *this)
+        {
+            views.append(py::cast(view));
+        }
+        return views;
+    }
+
+private:
+    std::array<CAIMemoryView, MAX_VIEWS> m_views;
+    size_t m_nViews = 0;
 };
 
+/**
+* @brief One output of the decoder output ladder. Timestamp and stream are those of the frame it was generated from.
+*/
+struct LadderFrame
+{
+    Pixel_Format format = Pixel_Format_UNDEFINED;
+    FrameViews views;
+    std::shared_ptr<ExternalBuffer> extBuf;
+};
+
+/**
+* @brief Fixed capacity list of the ladder outputs of a decoded frame.
+*/
+class FrameLadder
+{
+public:
+    static constexpr size_t MAX_OUTPUTS = PostProcessMaxOutputs;
+
+    void push_back(LadderFrame&& output)
+    {
+        if (m_nOutputs == MAX_OUTPUTS)
+        {
+            throw std::length_error("A decoded frame has at most 8 ladder outputs");
+        }
+        m_outputs[m_nOutputs++] = std::move(output);
+    }
+    size_t size() const { return m_nOutputs; }
+    bool empty() const { return m_nOutputs == 0; }
+    const LadderFrame& operator[](size_t i) const { return m_outputs[i]; }
+    const LadderFrame* begin() const { return m_outputs.data(); }
+    const LadderFrame* end() const { return m_outputs.data() + m_nOutputs; }
+
+private:
+    std::array<LadderFrame, MAX_OUTPUTS> m_outputs;
+    size_t m_nOutputs = 0;
+};
+
+/**
+* @brief Decoded frame handed to Python. Views and ladder outputs are stored inline and the ExternalBuffers are
+* recycled from the producer's ExternalBufferPool, so copying a frame does not allocate.
+*/
 struct DecodedFrame
 {
-    int64_t timestamp;
-    std::vector<CAIMemoryView> views;
-    Pixel_Format format;
+    int64_t timestamp = 0;
+    FrameViews views;
+    Pixel_Format format = Pixel_Format_UNDEFINED;
     std::shared_ptr<ExternalBuffer> extBuf;
     SEI_MESSAGE seiMessage;
-    size_t decoderStreamEvent;
-    size_t decoderStream;
-    DecodedFrame(){
-        extBuf = std::make_shared<ExternalBuffer>();
-    }
+    size_t decoderStreamEvent = 0;
+    size_t decoderStream = 0;
+    // outputs of the decoder output ladder generated from the same picture
+    FrameLadder ladder;
+    // content hash written by the decoder stream, readable once decoderStreamEvent completed
+    const uint64_t* pHash = nullptr;
 };
 
 
@@ -47,6 +47,7 @@ private:
 
 protected:
     std::unique_ptr<NvDecoder> decoder;
+    ExternalBufferPool mExtBufPool;
 
 public:
     PyNvDecoder() {}
@@ -62,7 +63,12 @@ public:
         OutputColorType outputColorType = OutputColorType::NATIVE,
         bool _enableSEIMessage = false,
         bool bWaitForSessionWarmUp = false,
-        DisplayDecodeLatency latency = DisplayDecodeLatency::DISPLAYDECODELATENCY_NATIVE
+        DisplayDecodeLatency latency = DisplayDecodeLatency::DISPLAYDECODELATENCY_NATIVE,
+        uint32_t preallocFrames = 0,
+        bool useMemPool = false,
+        bool outputMappedSurface = false,
+        const PostProcessParams& postProcess = PostProcessParams(),
+        const std::vector<PostProcessOutput>& outputLadder = std::vector<PostProcessOutput>()
         );
 
     ~PyNvDecoder();
@@ -128,6 +134,11 @@ public:
     */
     int GetChromaPlaneSize() { return decoder->GetChromaPlaneSize(); }
 
+    /**
+    *  @brief  This function returns the number of ExternalBuffer descriptors allocated for output frames.
+    */
+    size_t GetExternalBufferAllocationCount() const { return mExtBufPool.GetAllocationCount(); }
+
     /**
     *  @brief  This function is used to get the pitch of the device buffer holding the decoded frame.
     */
@@ -155,6 +166,19 @@ public:
     int setReconfigParams(const Dim& mResizeDim) { return decoder->setReconfigParams(mResizeDim); };
 
     void setDecoderSessionID(int sessionID) { decoder->setDecoderSessionID(sessionID); }
+
+    /**
+    *   @brief  This function sets the color description used for RGB/RGBP output.
+    */
+    void SetColorimetry(const PostProcessColorimetry& colorimetry) { decoder->SetColorimetry(colorimetry); }
+
+    /**
+    *   @brief  This function makes native output frames of 10/12 bit streams 8 bit, optionally dithered.
+    */
+    void SetBitDepthConversion(bool bTo8Bit, bool bDither) { decoder->SetBitDepthConversion(bTo8Bit, bDither); }
+    void SetFrameHash(bool bEnable) { decoder->SetFrameHash(bEnable); }
+
+    cudaVideoSurfaceFormat GetNativeOutputFormat() { return decoder->GetNativeOutputFormat(); }
     
     static int64_t getDecoderSessionOverHead(int sessionID) { return NvDecoder::getDecoderSessionOverHead(sessionID); }
 
@@ -163,4 +187,6 @@ public:
     int64_t GetSessionInitTime() { return decoder->GetSessionInitTime(); }
 
     static void SetSessionCount(uint32_t count) { NvDecoder::SetSessionCount(count); }
+
+    FramePoolStats GetFramePoolStats() { return decoder->GetFramePoolStats(); }
 };
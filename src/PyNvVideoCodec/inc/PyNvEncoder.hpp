@@ -24,8 +24,16 @@
  */
 
 #include "NvEncoderCuda.h"
+#include "EncoderSessionCache.hpp"
+#include "EncoderStats.hpp"
 #include "PyCAIMemoryView.hpp"
+#include "HashUtils.hpp"
+#include <deque>
+#include <list>
 #include <map>
+#include <mutex>
+#include <tuple>
+#include <unordered_map>
 
 namespace py = pybind11;
 
@@ -91,6 +99,70 @@ private:
 };
 
 
+/**
+* @brief Encoded bitstream of one Encode call, exposed to Python through the buffer protocol without a copy.
+* Buffers are pooled by PyNvEncoder and reused once Python no longer refers to them.
+*/
+struct EncodedBitstream
+{
+    std::vector<uint8_t> data;
+    int numPackets = 0;
+    // ticket of the frame returned by PyNvEncoder::Submit, for packets retrieved from the pipeline
+    uint64_t timestamp = 0;
+    // for EncodeBatch, packet i spans offsets[i] to offsets[i + 1] of data
+    std::vector<size_t> offsets;
+    // statistics of each packet, if the encoder was created with frame_stats=1
+    std::vector<NvEncFrameStats> stats;
+};
+
+/**
+* @brief Returns a writer appending to bitstream and recording the end of each packet in its offsets table,
+* which must start with 0.
+*/
+inline NvEncBitstreamWriter GetBatchWriter(EncodedBitstream& bitstream)
+{
+    return [&bitstream](const uint8_t* pData, size_t nBytes, bool bEndOfPacket) {
+        bitstream.data.insert(bitstream.data.end(), pData, pData + nBytes);
+        if (bEndOfPacket)
+        {
+            bitstream.offsets.push_back(bitstream.data.size());
+        }
+    };
+}
+
+/**
+* @brief Input frame parsed from a Python object, copied to the encoder without the GIL.
+* keepAlive holds the object owning the frame memory until the copy is issued.
+*/
+struct EncoderInput
+{
+    void* pSrc = nullptr;
+    uint32_t nSrcStride = 0;
+    uint32_t srcChromaOffsets[2] = {};
+    // chroma planes follow the luma rows at the offsets of NvEncoder::GetChromaSubPlaneOffsets()
+    bool bContiguous = true;
+    CUmemorytype memoryType = CU_MEMORYTYPE_DEVICE;
+    // size of a host frame
+    size_t nBytes = 0;
+    py::object keepAlive;
+};
+
+/**
+* @brief Motion vectors of one frame output by a motion estimation only H.264 session, one entry per 16x16 macroblock
+* in raster order. Each macroblock carries up to 4 partition vectors in quarter pel units, relative to the reference frame.
+*/
+struct MotionVectorField
+{
+    uint32_t mbWidth = 0;
+    uint32_t mbHeight = 0;
+    // mbHeight x mbWidth x 4 x (x, y)
+    std::vector<int16_t> mv;
+    std::vector<uint32_t> cost;
+    // macroblock type: 0 (I), 1 (P), 2 (IPCM), 3 (B); partition type: 0 (16x16), 1 (8x8), 2 (16x8), 3 (8x16)
+    std::vector<uint8_t> mbType;
+    std::vector<uint8_t> partitionType;
+};
+
 struct structEncodeReconfigureParams
 {
     NV_ENC_PARAMS_RC_MODE  rateControlMode;
@@ -101,6 +173,19 @@ struct structEncodeReconfigureParams
     uint32_t vbvInitialDelay;
     uint32_t frameRateNum;
     uint32_t frameRateDen;
+    // encode resolution, up to the max_res given at creation; 0 keeps the current one
+    uint32_t encodeWidth = 0;
+    uint32_t encodeHeight = 0;
+    // in frames, 0 keeps the current one
+    uint32_t gopLength = 0;
+    uint32_t idrPeriod = 0;
+    // QPs of CONSTQP rate control
+    uint32_t constQPInterP = 0;
+    uint32_t constQPInterB = 0;
+    uint32_t constQPIntra = 0;
+    // a resolution change always resets the encoder and starts with an IDR frame
+    bool resetEncoder = false;
+    bool forceIDR = false;
 };
 
 class PyNvEncoder {
@@ -108,7 +193,14 @@ private:
     CUcontext m_CUcontext = nullptr;
     CUstream m_CUstream = nullptr;
     bool m_ReleasePrimaryContext = false;
-    std::map<CUdeviceptr, NV_ENC_REGISTERED_PTR> m_mapPtr;
+    // LRU cache of caller frames registered with the encoder, most recently used first. Frames are encoded
+    // in place instead of being copied to the encoder input buffer. A null entry marks a frame that cannot be registered.
+    typedef std::tuple<CUdeviceptr, uint32_t, NV_ENC_BUFFER_FORMAT> RegisteredInputKey;
+    typedef std::list<std::pair<RegisteredInputKey, NV_ENC_REGISTERED_PTR>> RegisteredInputList;
+    RegisteredInputList m_lRegisteredInputs;
+    std::unordered_map<RegisteredInputKey, RegisteredInputList::iterator, TupleHash> m_mapRegisteredInputs;
+    size_t m_nMaxRegisteredInputs = 0;
+    NV_ENC_REGISTERED_PTR GetRegisteredInput(CUdeviceptr dpFrame, uint32_t nPitch);
     size_t m_width;
     size_t m_height;
     uint64_t m_frameNum;
@@ -116,25 +208,95 @@ private:
     bool m_bUseCPUInutBuffer;
     GUID m_encodeGUID;
     int m_gpuId = 0;
+    // key of the session in EncoderSessionCache; sessions used by the pipelined API are not cached
+    EncoderSessionCache::Key m_sessionKey;
+    bool m_bPipelined = false;
+    std::unique_ptr<NvEncoderCuda> AcquireCachedSession(const std::map<std::string, std::string>& options,
+        NvEncoderClInterface& cliInterface, NV_ENC_INITIALIZE_PARAMS& params);
+    bool ReleaseToSessionCache();
+    void ReleaseRegisteredInputs();
+    // Statistics of the encoded frames, enabled by the frame_stats and block_stats options. The encoder reports them
+    // from the thread locking the bitstream; they wait in m_qFrameStats until attached to an EncodedBitstream or
+    // fetched with GetFrameStats().
+    bool m_bFrameStats = false;
+    std::mutex m_mtxFrameStats;
+    static constexpr size_t MAX_QUEUED_FRAME_STATS = 1024;
+    std::deque<NvEncFrameStats> m_qFrameStats;
+    EncoderStatsHistogram m_statsHistogram;
+    void InstallFrameStatsCallback();
+    void TakeFrameStats(EncodedBitstream& bitstream);
 
-    const NvEncInputFrame* GetEncoderInput(py::object _frame);
-    const NvEncInputFrame* GetEncoderInputFromCPUBuffer(py::array_t<uint8_t, py::array::c_style | py::array::forcecast> _frame);
+    static EncoderInput ParseEncoderInput(py::object _frame, NV_ENC_BUFFER_FORMAT eBufferFormat, size_t width, size_t height, CUstream stream);
+    static EncoderInput ParseEncoderInputFromCPUBuffer(py::array_t<uint8_t, py::array::c_style | py::array::forcecast> _frame,
+        NV_ENC_BUFFER_FORMAT eBufferFormat, size_t width, size_t height);
+    EncoderInput ParseFrame(py::object frame);
+    const NvEncInputFrame* WriteEncoderInput(const EncoderInput& input);
+    const NvEncInputFrame* WriteHostEncoderInput(const EncoderInput& input);
+    // Ring of pinned buffers staging host frames for the asynchronous upload on m_CUstream. The event of a
+    // buffer marks the completion of its last upload, uploads from registered host buffers use the events only.
+    struct HostStagingBuffer
+    {
+        void* pHost = nullptr;
+        size_t nBytes = 0;
+        CUevent event = nullptr;
+    };
+    static constexpr size_t NUM_STAGING_BUFFERS = 3;
+    std::vector<HostStagingBuffer> m_vStagingBuffers;
+    size_t m_iStagingBuffer = 0;
+    // host buffers page-locked with RegisterHostBuffer(), by start address
+    std::map<const uint8_t*, size_t> m_mapHostBuffers;
+    bool IsHostBufferRegistered(const void* pData, size_t nBytes) const;
+    void ReleaseHostBuffers();
     std::unique_ptr<NvCUStream> pCUStream;
+    // bitstream of the bytes returning calls, reused across frames
+    std::vector<uint8_t> m_vBitstream;
+    static constexpr size_t MAX_POOLED_BITSTREAMS = 16;
+    std::vector<std::shared_ptr<EncodedBitstream>> m_vBitstreamPool;
+    size_t m_nNextBitstream = 0;
+    std::shared_ptr<EncodedBitstream> AcquireBitstream();
+    int EncodeTo(py::object frame, uint8_t picFlags, const SEI_MESSAGE& sei, const NvEncBitstreamWriter& fnWrite);
+    void SetPicParams(NV_ENC_PIC_PARAMS& picParam, uint8_t picFlags, const SEI_MESSAGE& sei, std::vector<NV_ENC_SEI_PAYLOAD>& vSei);
+    // packet handed out by the pipeline, swapped with the buffer of the returned EncodedBitstream
+    NvEncOutputFrame m_retrievedPacket;
+    int EndEncodeTo(const NvEncBitstreamWriter& fnWrite);
     structEncodeReconfigureParams m_EncReconfigureParams;
 protected:
     std::unique_ptr<NvEncoderCuda> m_encoder;
 
 public:
+    /**
+    *  @brief  Parses a device frame (DLPack, __cuda_array_interface__ or an object with a cuda() method) or a host
+    *  frame (numpy) of the given format and size. DLPack producers are synchronized with stream.
+    */
+    static EncoderInput ParseFrame(py::object frame, NV_ENC_BUFFER_FORMAT eBufferFormat, size_t width, size_t height,
+        CUstream stream, bool bUseCPUInputBuffer);
     explicit PyNvEncoder(int width, int height,  std::string format,
             size_t cudastream, size_t cudacontext, bool bUseCPUInutBuffer,std::map<std::string, std::string> config);
     PyNvEncoder(PyNvEncoder&& pyenvc);
-    PyNvEncoder(PyNvEncoder& pyenvc);
+    // an encoder owns its session, it can only be moved
+    PyNvEncoder(const PyNvEncoder&) = delete;
+    PyNvEncoder& operator=(const PyNvEncoder&) = delete;
     NV_ENC_REGISTERED_PTR RegisterInputFrame(const py::object obj, const CAIMemoryView frame); 
     bool Reconfigure(structEncodeReconfigureParams reconfigureParams);
     py::bytes Encode(py::object frame, uint8_t picFlags, SEI_MESSAGE sei);
     py::bytes Encode(const py::object frame, uint8_t picFlags);
     py::bytes Encode(py::object _frame);
     py::bytes Encode();
+    std::shared_ptr<EncodedBitstream> EncodeToBuffer(py::object frame, uint8_t picFlags, const SEI_MESSAGE& sei);
+    std::shared_ptr<EncodedBitstream> EndEncodeToBuffer();
+    size_t EncodeToFile(py::object frame, int fd, uint8_t picFlags, const SEI_MESSAGE& sei);
+    size_t EndEncodeToFile(int fd);
+    uint64_t Submit(py::object frame, uint8_t picFlags, const SEI_MESSAGE& sei);
+    std::shared_ptr<EncodedBitstream> Retrieve(double timeout);
+    std::vector<std::shared_ptr<EncodedBitstream>> Flush();
+    std::shared_ptr<EncodedBitstream> EncodeBatch(py::object frames, const std::vector<uint8_t>& vPicFlags, bool bFlush);
+    std::shared_ptr<MotionVectorField> RunMotionEstimation(py::object frame, py::object reference);
+    size_t GetPendingCount() { return m_encoder->GetPendingCount(); }
+    std::vector<NvEncFrameStats> GetFrameStats();
+    EncoderStatsHistogram GetStatsHistogram();
+    void ResetStatsHistogram();
+    void RegisterHostBuffer(py::buffer buffer);
+    void UnregisterHostBuffer(py::buffer buffer);
     void UnregisterInputFrame(const CAIMemoryView frame);
     void InitEncodeReconfigureParams(const NV_ENC_INITIALIZE_PARAMS params);
     structEncodeReconfigureParams GetEncodeReconfigureParams();
@@ -56,6 +56,7 @@ class SeekUtils {
     bool mbEOSreached;
     bool bIsSeekDirectionBackwards;
     bool bSeekToIndexSet;
+    ExternalBufferPool mExtBufPool;
 public:
     void setEOS(bool newVal) { mbEOSreached = true; }
     SeekUtils(FFmpegDemuxer* demuxer,NvDecoder* decoder);
@@ -54,6 +54,8 @@ public:
     std::vector<DecodedFrame> GetBatchFrames(size_t batchSize);
     std::variant<DecodedFrame, std::vector<DecodedFrame>> operator[](std::variant<uint32_t, std::vector<uint32_t>> indices);
     std::vector<DecodedFrame> GetBatchFramesByIndex(std::vector<uint32_t> indices);
+    DecodedBatch GetBatchTensor(size_t batchSize);
+    DecodedBatch GetBatchTensorByIndex(std::vector<uint32_t> indices);
     StreamMetadata GetStreamMetadata();
     ScannedStreamMetadata GetScannedStreamMetadata();
     void SeekToIndex(uint32_t index);
@@ -61,6 +63,7 @@ public:
     void ReconfigureDecoder(std::string newSource);
     DecoderCommon* GetDecoderCommonInstance();
     int64_t GetSessionInitTime();
+    uint32_t GetBatchAllocationCount();
     static void SetSessionCount(uint32_t count);
 private:
     void ResetDecoderIfRequired(std::variant<uint32_t, std::vector<uint32_t>> indices);
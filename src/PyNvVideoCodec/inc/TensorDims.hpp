@@ -0,0 +1,147 @@
+/*
+ * This copyright notice applies to this file only
+ *
+ * SPDX-FileCopyrightText: Copyright (c) 2025 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <initializer_list>
+#include <iterator>
+#include <stddef.h>
+#include <stdexcept>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+/**
+* @brief Fixed capacity shape or stride descriptor of a frame view or tensor.
+* Kept inline so that describing a decoded frame does not touch the heap.
+*/
+class TensorDims
+{
+public:
+    static constexpr size_t MAX_DIMS = 4;
+
+    TensorDims() = default;
+    TensorDims(std::initializer_list<size_t> dims) { Assign(dims.begin(), dims.end()); }
+    TensorDims(const std::vector<size_t>& dims) { Assign(dims.begin(), dims.end()); }
+
+    size_t size() const { return m_nDims; }
+    bool empty() const { return m_nDims == 0; }
+    size_t& operator[](size_t i) { return m_dims[i]; }
+    const size_t& operator[](size_t i) const { return m_dims[i]; }
+    size_t at(size_t i) const
+    {
+        if (i >= m_nDims)
+        {
+            throw std::out_of_range("TensorDims index out of range");
+        }
+        return m_dims[i];
+    }
+    const size_t* begin() const { return m_dims.data(); }
+    const size_t* end() const { return m_dims.data() + m_nDims; }
+    std::vector<size_t> ToVector() const { return std::vector<size_t>(begin(), end()); }
+
+    bool operator==(const TensorDims& other) const { return std::equal(begin(), end(), other.begin(), other.end()); }
+    bool operator!=(const TensorDims& other) const { return !(*this == other); }
+
+private:
+    template <typename It>
+    void Assign(It first, It last)
+    {
+        size_t nDims = (size_t)std::distance(first, last);
+        if (nDims > MAX_DIMS)
+        {
+            throw std::invalid_argument("TensorDims supports at most " + std::to_string(MAX_DIMS) + " dimensions");
+        }
+        std::copy(first, last, m_dims.begin());
+        m_nDims = nDims;
+    }
+
+    std::array<size_t, MAX_DIMS> m_dims{};
+    size_t m_nDims = 0;
+};
+
+/**
+* @brief Element type of a frame view.
+*/
+enum class ViewDataType : uint8_t
+{
+    UINT8,
+    UINT16,
+    FLOAT16,
+    FLOAT32,
+};
+
+inline const char* GetTypeStr(ViewDataType dtype)
+{
+    switch (dtype)
+    {
+    case ViewDataType::UINT16: return "<u2";
+    case ViewDataType::FLOAT16: return "<f2";
+    case ViewDataType::FLOAT32: return "<f4";
+    default: return "|u1";
+    }
+}
+
+inline size_t GetElementSize(ViewDataType dtype)
+{
+    switch (dtype)
+    {
+    case ViewDataType::UINT16:
+    case ViewDataType::FLOAT16:
+        return 2;
+    case ViewDataType::FLOAT32:
+        return 4;
+    default:
+        return 1;
+    }
+}
+
+inline bool IsFloatType(ViewDataType dtype)
+{
+    return dtype == ViewDataType::FLOAT16 || dtype == ViewDataType::FLOAT32;
+}
+
+inline ViewDataType ParseTypeStr(const std::string& typestr)
+{
+    if (typestr == "<u2" || typestr == "|u2")
+    {
+        return ViewDataType::UINT16;
+    }
+    if (typestr == "|u1" || typestr == "B")
+    {
+        return ViewDataType::UINT8;
+    }
+    if (typestr == "<f2")
+    {
+        return ViewDataType::FLOAT16;
+    }
+    if (typestr == "<f4")
+    {
+        return ViewDataType::FLOAT32;
+    }
+    throw std::runtime_error("Unsupported typestr: " + typestr);
+}
@@ -38,7 +38,7 @@
 
 template<typename T>
 static void RunDecoder(FFmpegDemuxer* demuxer, NvDecoder* decoder, SPSCBuffer<T>& decodedFrames,
-                        std::atomic<bool>& decodeStopFlag);
+                        std::atomic<bool>& decodeStopFlag, ExternalBufferPool& extBufPool, BatchFramePool* batchFramePool);
 
 
 class ThreadedDecoder {
@@ -47,6 +47,8 @@ private:
     NvThread mDecoderThread;
     SPSCBuffer<DecodedFrame> mDecodedFrames;
     std::atomic<bool> mDecodeStopFlag {false};
+    // Used by the decoder thread only
+    ExternalBufferPool mExtBufPool;
     uint32_t mPrevBatchSize = 0;
     bool endCalled = false;
 public:
@@ -65,6 +67,8 @@ public:
             OutputColorType outputColorType = OutputColorType::NATIVE);
     void Initialize();
     std::vector<DecodedFrame> GetBatchFrames(size_t batchSize);
+    DecodedBatch GetBatchTensor(size_t batchSize);
+    uint32_t GetBatchCopiedFrameCount();
     StreamMetadata GetStreamMetadata();
     ScannedStreamMetadata GetScannedStreamMetadata();
     void ReconfigureDecoder(std::string newSource);
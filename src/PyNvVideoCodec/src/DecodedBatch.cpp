@@ -0,0 +1,347 @@
+/*
+ * This copyright notice applies to this file only
+ *
+ * SPDX-FileCopyrightText: Copyright (c) 2025 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#include "DecodedBatch.hpp"
+
+#include <algorithm>
+#include <iterator>
+
+namespace
+{
+    size_t GetViewRowBytes(const CAIMemoryView& view, size_t elemSize)
+    {
+        size_t rowBytes = elemSize;
+        for (size_t i = 1; i < view.shape.size(); i++)
+        {
+            rowBytes *= view.shape[i];
+        }
+        return rowBytes;
+    }
+}  // namespace
+
+BatchFramePool::State::~State()
+{
+    if (vFree.empty())
+    {
+        return;
+    }
+    cuCtxPushCurrent(cuContext);
+    for (Buffer& buffer : vFree)
+    {
+        cuMemFree(buffer.data);
+        cuEventDestroy(buffer.readyEvent);
+    }
+    cuCtxPopCurrent(NULL);
+}
+
+BatchFramePool::BatchFramePool(CUcontext cuContext, uint32_t deviceId) : mState(std::make_shared<State>()), mDeviceId(deviceId)
+{
+    mState->cuContext = cuContext;
+}
+
+BatchFramePool::~BatchFramePool()
+{
+    SetDecodeTarget(nullptr, 0);
+    // Buffers still referenced by batches or frames keep the shared state alive and are released with the last reference
+}
+
+void BatchFramePool::SetDecodeTarget(NvDecoder* decoder, size_t nBatchSize)
+{
+    if (!decoder || !decoder->IsDeviceFrame())
+    {
+        nBatchSize = 0;
+    }
+    NvDecoder* prevDecoder = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(mMtxTargets);
+        if (decoder == mTargetDecoder && nBatchSize == mnTargetBatchSize)
+        {
+            return;
+        }
+        prevDecoder = mTargetDecoder;
+        mTargetDecoder = nBatchSize ? decoder : nullptr;
+        mnTargetBatchSize = nBatchSize;
+        // Start the next target at a batch boundary
+        mnAlignSeq = mnNextSeq;
+        mvTargets.clear();
+    }
+    // The decoder calls back with its frame pool lock held, which is taken before mMtxTargets
+    if (prevDecoder && prevDecoder != decoder)
+    {
+        prevDecoder->SetOutputTargetCallback(nullptr);
+    }
+    if (nBatchSize)
+    {
+        decoder->SetOutputTargetCallback([this](size_t nFrameBytes, size_t) { return NextDecodeTarget(nFrameBytes); });
+    }
+    else if (decoder)
+    {
+        decoder->SetOutputTargetCallback(nullptr);
+    }
+}
+
+uint8_t* BatchFramePool::NextDecodeTarget(size_t nFrameBytes)
+{
+    std::lock_guard<std::mutex> lock(mMtxTargets);
+    if (!mnTargetBatchSize)
+    {
+        return nullptr;
+    }
+    PendingTarget* pTarget = mvTargets.empty() ? nullptr : &mvTargets.back();
+    if (!pTarget || pTarget->nWritten == pTarget->nFrames || pTarget->nFrameBytes != nFrameBytes
+        || (mnNextSeq - mnAlignSeq) % mnTargetBatchSize == 0)
+    {
+        // Targets that are no longer written are only held for frames not claimed yet
+        mvTargets.erase(std::remove_if(mvTargets.begin(), mvTargets.end(), [](const PendingTarget& t) { return t.nClaimed == t.nWritten; }),
+            mvTargets.end());
+        mvIssuedTargets.erase(std::remove_if(mvIssuedTargets.begin(), mvIssuedTargets.end(), [](const IssuedTarget& t) { return t.buffer.expired(); }),
+            mvIssuedTargets.end());
+
+        PendingTarget target;
+        target.nFrameBytes = nFrameBytes;
+        target.nFrames = mnTargetBatchSize;
+        ck(cuCtxPushCurrent(mState->cuContext));
+        target.buffer = Acquire(target.nFrames * nFrameBytes);
+        ck(cuCtxPopCurrent(NULL));
+        mvTargets.push_back(target);
+        mvIssuedTargets.push_back(IssuedTarget{ target.buffer, nFrameBytes, mnNextSeq });
+        pTarget = &mvTargets.back();
+    }
+    uint8_t* pFrame = reinterpret_cast<uint8_t*>(pTarget->buffer->data + pTarget->nWritten * nFrameBytes);
+    pTarget->nWritten++;
+    mnNextSeq++;
+    return pFrame;
+}
+
+std::shared_ptr<void> BatchFramePool::ClaimDecodeTarget(CUdeviceptr dpFrame)
+{
+    std::lock_guard<std::mutex> lock(mMtxTargets);
+    for (auto it = mvTargets.begin(); it != mvTargets.end(); ++it)
+    {
+        if (dpFrame < it->buffer->data || dpFrame >= it->buffer->data + it->nWritten * it->nFrameBytes)
+        {
+            continue;
+        }
+        std::shared_ptr<Buffer> buffer = it->buffer;
+        it->nClaimed++;
+        if (it->nClaimed == it->nWritten && std::next(it) != mvTargets.end())
+        {
+            mvTargets.erase(it);
+        }
+        return buffer;
+    }
+    return nullptr;
+}
+
+// Expects mMtxTargets held
+std::shared_ptr<BatchFramePool::Buffer> BatchFramePool::FindIssuedTarget(CUdeviceptr dpFrame, size_t nFrameBytes, uint64_t* pnSeq)
+{
+    for (const IssuedTarget& target : mvIssuedTargets)
+    {
+        std::shared_ptr<Buffer> buffer = target.buffer.lock();
+        if (!buffer || target.nFrameBytes != nFrameBytes || dpFrame < buffer->data || dpFrame >= buffer->data + buffer->nBytes
+            || (dpFrame - buffer->data) % nFrameBytes != 0)
+        {
+            continue;
+        }
+        *pnSeq = target.nFirstSeq + (dpFrame - buffer->data) / nFrameBytes;
+        return buffer;
+    }
+    return nullptr;
+}
+
+// Expects the pool context to be current
+std::shared_ptr<BatchFramePool::Buffer> BatchFramePool::Acquire(size_t nBytes)
+{
+    Buffer buffer;
+    std::vector<Buffer> vStale;
+    {
+        std::lock_guard<std::mutex> lock(mState->mtx);
+        auto it = std::find_if(mState->vFree.begin(), mState->vFree.end(), [nBytes](const Buffer& b) { return b.nBytes == nBytes; });
+        if (it != mState->vFree.end())
+        {
+            buffer = *it;
+            mState->vFree.erase(it);
+        }
+        else
+        {
+            // Batch size or resolution changed, buffers of other sizes are unlikely to be used again
+            vStale.swap(mState->vFree);
+            mState->nAllocations++;
+        }
+    }
+    for (Buffer& stale : vStale)
+    {
+        ck(cuMemFree(stale.data));
+        ck(cuEventDestroy(stale.readyEvent));
+    }
+    if (!buffer.data)
+    {
+        ck(cuMemAlloc(&buffer.data, nBytes));
+        ck(cuEventCreate(&buffer.readyEvent, CU_EVENT_DISABLE_TIMING));
+        buffer.nBytes = nBytes;
+    }
+
+    std::shared_ptr<State> state = mState;
+    return std::shared_ptr<Buffer>(new Buffer(buffer), [state](Buffer* pBuffer) {
+        std::lock_guard<std::mutex> lock(state->mtx);
+        state->vFree.push_back(*pBuffer);
+        delete pBuffer;
+    });
+}
+
+DecodedBatch BatchFramePool::Pack(const NvDecoder* decoder, const std::vector<DecodedFrame>& frames)
+{
+    DecodedBatch batch;
+    if (frames.empty())
+    {
+        return batch;
+    }
+    if (!decoder->IsDeviceFrame())
+    {
+        PYNVVC_THROW_ERROR_UNSUPPORTED("Batch tensors require decoder output in device memory", CUDA_ERROR_NOT_SUPPORTED);
+    }
+
+    const DecodedFrame& first = frames[0];
+    ViewDataType dtype = first.views[0].dtype;
+    size_t elemSize = GetElementSize(dtype);
+    // Copied frames are packed at the row size of the first plane, frames written in place keep the decoder pitch
+    size_t dstPitch = GetViewRowBytes(first.views[0], elemSize);
+    size_t srcPitch = first.views[0].stride[0];
+    size_t nRows = 0;
+    for (const CAIMemoryView& view : first.views)
+    {
+        nRows += view.shape[0];
+    }
+    size_t nFrameBytes = nRows * dstPitch;
+    size_t nSrcFrameBytes = nRows * srcPitch;
+    size_t height = first.views[0].shape[0];
+    size_t width = first.views[0].shape[1];
+    size_t nFrames = frames.size();
+
+    for (const DecodedFrame& frame : frames)
+    {
+        if (frame.format != first.format || frame.views.size() != first.views.size() || frame.views[0].shape != first.views[0].shape)
+        {
+            PYNVVC_THROW_ERROR("Frames of a batch must share format and resolution", CUDA_ERROR_INVALID_VALUE);
+        }
+    }
+
+    // Frames written in place by the decoder are already laid out as the batch when they are consecutive in one target
+    bool bDense = true;
+    for (size_t i = 0; i < nFrames && bDense; i++)
+    {
+        CUdeviceptr dpPlane = first.views[0].data + i * nSrcFrameBytes;
+        for (const CAIMemoryView& view : frames[i].views)
+        {
+            bDense = bDense && view.data == dpPlane && view.stride[0] == srcPitch;
+            dpPlane += view.shape[0] * srcPitch;
+        }
+    }
+    std::shared_ptr<Buffer> target;
+    size_t nTargetOffset = 0;
+    {
+        std::lock_guard<std::mutex> lock(mMtxTargets);
+        uint64_t nFirstSeq = 0, nLastSeq = 0;
+        std::shared_ptr<Buffer> firstTarget = FindIssuedTarget(first.views[0].data, nSrcFrameBytes, &nFirstSeq);
+        std::shared_ptr<Buffer> lastTarget = FindIssuedTarget(frames.back().views[0].data, nSrcFrameBytes, &nLastSeq);
+        if (lastTarget)
+        {
+            // The decoder starts the next target with the frame following this batch
+            mnAlignSeq = nLastSeq + 1;
+        }
+        if (bDense && firstTarget && firstTarget == lastTarget)
+        {
+            target = firstTarget;
+            nTargetOffset = first.views[0].data - target->data;
+        }
+    }
+
+    // Row stride of the tensor in elements
+    size_t rowStride = (target ? srcPitch : dstPitch) / elemSize;
+    TensorDims shape;
+    TensorDims stride;
+    switch (first.format)
+    {
+        case Pixel_Format_RGB:
+            shape = { nFrames, height, width, 3 };
+            stride = { height * rowStride, rowStride, 3, 1 };
+            break;
+        case Pixel_Format_RGBP:
+        case Pixel_Format_YUV444:
+        case Pixel_Format_YUV444_16Bit:
+            shape = { nFrames, 3, height, width };
+            stride = { 3 * height * rowStride, height * rowStride, rowStride, 1 };
+            break;
+        default:
+            // semi-planar formats keep the chroma rows below the luma rows, as in the single frame tensor
+            shape = { nFrames, nRows, width };
+            stride = { nRows * rowStride, rowStride, 1 };
+            break;
+    }
+
+    CUcontext cuContext = decoder->GetContext();
+    CUstream stream = decoder->GetStream();
+    ck(cuCtxPushCurrent(cuContext));
+    std::shared_ptr<Buffer> buffer = target ? target : Acquire(nFrames * nFrameBytes);
+    if (!target)
+    {
+        mnCopiedFrames += (uint32_t)nFrames;
+    }
+    CUdeviceptr dst = buffer->data;
+    for (const DecodedFrame& frame : frames)
+    {
+        batch.timestamps.push_back(frame.timestamp);
+        if (target)
+        {
+            continue;
+        }
+        for (const CAIMemoryView& view : frame.views)
+        {
+            CUDA_MEMCPY2D m = { 0 };
+            m.srcMemoryType = CU_MEMORYTYPE_DEVICE;
+            m.srcDevice = view.data;
+            m.srcPitch = view.stride[0];
+            m.dstMemoryType = CU_MEMORYTYPE_DEVICE;
+            m.dstDevice = dst;
+            m.dstPitch = dstPitch;
+            m.WidthInBytes = GetViewRowBytes(view, elemSize);
+            m.Height = view.shape[0];
+            ck(cuMemcpy2DAsync(&m, stream));
+            dst += m.Height * dstPitch;
+        }
+    }
+    // The decoder records the event of each frame on the same stream, so the event covers in place frames as well
+    ck(cuEventRecord(buffer->readyEvent, stream));
+    ck(cuCtxPopCurrent(NULL));
+
+    batch.format = first.format;
+    batch.decoderStream = reinterpret_cast<size_t>(stream);
+    batch.decoderStreamEvent = reinterpret_cast<size_t>(buffer->readyEvent);
+    batch.extBuf->LoadDLPack(shape, stride, dtype, buffer->data + nTargetOffset, true, mDeviceId, cuContext);
+    // The tensor and any DLPack capsule exported from it keep the pooled buffer alive
+    batch.extBuf->SetOwner(buffer);
+    return batch;
+}
@@ -120,7 +120,7 @@ void DecoderCommon::CreateDecoder(cudaVideoCodec codec,
         maxWidth, 
         maxHeight, 
         mOutputColorType,
-        false, // bDeviceFramePitched
+        mUseDeviceMemory, // bDeviceFramePitched, applied to native output only
         false, // extract_user_SEI_Message
         1000U,  // clkRate
         false, // force_zero_latency
@@ -236,7 +236,7 @@ void DecoderCommon::ReconfigureDecoder(std::string encSource)
             auto maxHeight = std::max(height, (*decoder)->GetMaxHeight());
             mDecoder.release();
             mDecoder.reset(new NvDecoder(mGPUId, mCudaStream, mCudaContext, mUseDeviceMemory, FFmpeg2NvCodecId(mDemuxer->GetVideoCodec()),
-                false, false, maxWidth, maxHeight, mOutputColorType));
+                false, false, maxWidth, maxHeight, mOutputColorType, mUseDeviceMemory));
             HandleDecoderInstanceRemoval(mDecoderCache.PushDecoder(key, mDecoder.get()));
         }
         else
@@ -258,7 +258,7 @@ void DecoderCommon::ReconfigureDecoder(std::string encSource)
         LOG(DEBUG) << "Cached decoder instance not found. Creating a new decoder\n";
         mDecoder.release();
         mDecoder.reset(new NvDecoder(mGPUId, mCudaStream, mCudaContext, mUseDeviceMemory, FFmpeg2NvCodecId(mDemuxer->GetVideoCodec()),
-            false, false, width, height, mOutputColorType));
+            false, false, width, height, mOutputColorType, mUseDeviceMemory));
         HandleDecoderInstanceRemoval(mDecoderCache.PushDecoder(key, mDecoder.get()));
     }
     
@@ -269,6 +269,15 @@ SeekUtils* DecoderCommon::GetPtrToSeekUtils()
     return mSeekUtils.get();
 }
 
+BatchFramePool* DecoderCommon::GetBatchFramePool()
+{
+    if (!mBatchFramePool)
+    {
+        mBatchFramePool.reset(new BatchFramePool(mCudaContext, mGPUId));
+    }
+    return mBatchFramePool.get();
+}
+
 void DecoderCommon::WaitForStreamMetadata() {
     if (mNeedScannedStreamMetadata) {
         mStreamMetaThread.join();  // NvThread only has join()
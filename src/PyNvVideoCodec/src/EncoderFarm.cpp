@@ -0,0 +1,360 @@
+/*
+ * This copyright notice applies to this file only
+ *
+ * SPDX-FileCopyrightText: Copyright (c) 2025 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#include "EncoderFarm.hpp"
+#include "NvEncoderClInterface.hpp"
+#include "PyNvVideoCodecUtils.hpp"
+
+#include <algorithm>
+#include <chrono>
+
+static NV_ENC_BUFFER_FORMAT GetEncoderBufferFormat(std::string& format)
+{
+    if (format == "NV12")
+        return NV_ENC_BUFFER_FORMAT_NV12;
+    if (format == "YUV420")
+        return NV_ENC_BUFFER_FORMAT_IYUV;
+    if (format == "ARGB")
+        return NV_ENC_BUFFER_FORMAT_ARGB;
+    if (format == "ABGR")
+        return NV_ENC_BUFFER_FORMAT_ABGR;
+    if (format == "YUV444")
+        return NV_ENC_BUFFER_FORMAT_YUV444;
+    if (format == "YUV444_10BIT" || format == "YUV444_16BIT")
+    {
+        format = "YUV444_10BIT";
+        return NV_ENC_BUFFER_FORMAT_YUV444_10BIT;
+    }
+    if (format == "P010")
+        return NV_ENC_BUFFER_FORMAT_YUV420_10BIT;
+    if (format == "ARGB10")
+        return NV_ENC_BUFFER_FORMAT_ARGB10;
+    if (format == "ABGR10")
+        return NV_ENC_BUFFER_FORMAT_ABGR10;
+#if CHECK_API_VERSION(13,0)
+    if (format == "NV16")
+        return NV_ENC_BUFFER_FORMAT_NV16;
+    if (format == "P210")
+        return NV_ENC_BUFFER_FORMAT_P210;
+#endif
+    PYNVVC_THROW_ERROR_UNSUPPORTED("Unknown format: " + format, NV_ENC_ERR_INVALID_PARAM);
+    return NV_ENC_BUFFER_FORMAT_UNDEFINED;
+}
+
+EncoderFarm::EncoderFarm(const std::vector<int>& vGpuId, int nSessionsPerGpu)
+{
+    if (vGpuId.empty() || nSessionsPerGpu < 1)
+    {
+        PYNVVC_THROW_ERROR("EncoderFarm needs at least one GPU and one session per GPU", NV_ENC_ERR_INVALID_PARAM);
+    }
+    CUDA_DRVAPI_CALL(cuInit(0));
+    for (int gpuId : vGpuId)
+    {
+        ValidateGpuId(gpuId);
+        CUcontext cuContext = nullptr;
+        CUDA_DRVAPI_CALL(cuDevicePrimaryCtxRetain(&cuContext, gpuId));
+        m_vGpuId.push_back(gpuId);
+        for (int i = 0; i < nSessionsPerGpu; i++)
+        {
+            auto session = std::make_unique<Session>();
+            session->cuContext = cuContext;
+            CUDA_DRVAPI_CALL(cuCtxPushCurrent(cuContext));
+            // A blocking stream is ordered after the work of DLPack producers on the legacy default stream
+            CUDA_DRVAPI_CALL(cuStreamCreate(&session->cuStream, CU_STREAM_DEFAULT));
+            CUDA_DRVAPI_CALL(cuCtxPopCurrent(NULL));
+            m_vSessions.push_back(std::move(session));
+        }
+    }
+    for (auto& session : m_vSessions)
+    {
+        Session* pSession = session.get();
+        session->thread = std::thread([this, pSession] { WorkerLoop(*pSession); });
+    }
+}
+
+EncoderFarm::~EncoderFarm()
+{
+    {
+        py::gil_scoped_release release;
+        {
+            std::lock_guard<std::mutex> lock(m_mtx);
+            m_bStop = true;
+        }
+        m_cvJobs.notify_all();
+        for (auto& session : m_vSessions)
+        {
+            if (session->thread.joinable())
+            {
+                session->thread.join();
+            }
+            try
+            {
+                session->encoder.reset();
+            }
+            catch (...)
+            {
+            }
+            cuCtxPushCurrent(session->cuContext);
+            cuStreamDestroy(session->cuStream);
+            cuCtxPopCurrent(NULL);
+        }
+        for (int gpuId : m_vGpuId)
+        {
+            cuDevicePrimaryCtxRelease(gpuId);
+        }
+    }
+    // Jobs still queued hold Python frames, which are released with the GIL held
+    for (auto& session : m_vSessions)
+    {
+        session->qJobs.clear();
+    }
+    m_qCompleted.clear();
+}
+
+uint64_t EncoderFarm::Submit(py::object frames, int width, int height, const std::string& format,
+    const std::map<std::string, std::string>& config, const std::vector<uint8_t>& vPicFlags)
+{
+    auto job = std::make_unique<EncodeJob>();
+    std::string fmt = format;
+    job->eBufferFormat = GetEncoderBufferFormat(fmt);
+    job->width = width;
+    job->height = height;
+    job->config = config;
+    job->config["fmt"] = fmt;
+    job->config["s"] = std::to_string(width) + "x" + std::to_string(height);
+    // the session is chosen by the farm
+    job->config.erase("gpu_id");
+
+    size_t nFrames = py::len(frames);
+    if (!vPicFlags.empty() && vPicFlags.size() != nFrames)
+    {
+        PYNVVC_THROW_ERROR("picflags must hold one entry per frame", NV_ENC_ERR_INVALID_PARAM);
+    }
+    job->vPicFlags = vPicFlags;
+    job->vInput.reserve(nFrames);
+    for (size_t i = 0; i < nFrames; i++)
+    {
+        job->vInput.push_back(PyNvEncoder::ParseFrame(frames.attr("__getitem__")(i), job->eBufferFormat, width, height,
+            CU_STREAM_LEGACY, true));
+    }
+
+    std::lock_guard<std::mutex> lock(m_mtx);
+    job->id = m_nNextJobId++;
+    job->result.jobId = job->id;
+    uint64_t jobId = job->id;
+    // Least loaded session, a session already configured like the job winning ties
+    Session* pTarget = nullptr;
+    size_t nBestCost = SIZE_MAX;
+    for (auto& session : m_vSessions)
+    {
+        size_t nCost = 2 * session->qJobs.size() + (session->config == job->config ? 0 : 1);
+        if (nCost < nBestCost)
+        {
+            nBestCost = nCost;
+            pTarget = session.get();
+        }
+    }
+    pTarget->qJobs.push_back(std::move(job));
+    m_nPending++;
+    m_cvJobs.notify_all();
+    return jobId;
+}
+
+std::shared_ptr<EncodeJobResult> EncoderFarm::Retrieve(double timeout)
+{
+    std::unique_ptr<EncodeJob> job;
+    {
+        py::gil_scoped_release release;
+        std::unique_lock<std::mutex> lock(m_mtx);
+        auto ready = [this] { return !m_qCompleted.empty() || m_nPending == 0; };
+        if (timeout < 0)
+        {
+            m_cvResults.wait(lock, ready);
+        }
+        else
+        {
+            m_cvResults.wait_for(lock, std::chrono::duration<double>(timeout), ready);
+        }
+        if (m_qCompleted.empty())
+        {
+            return nullptr;
+        }
+        job = std::move(m_qCompleted.front());
+        m_qCompleted.pop_front();
+        m_nPending--;
+    }
+    // The frames of the job are released here, with the GIL held
+    return std::make_shared<EncodeJobResult>(std::move(job->result));
+}
+
+size_t EncoderFarm::GetPendingCount()
+{
+    std::lock_guard<std::mutex> lock(m_mtx);
+    return m_nPending;
+}
+
+std::unique_ptr<EncoderFarm::EncodeJob> EncoderFarm::PopJob(Session& session)
+{
+    std::unique_lock<std::mutex> lock(m_mtx);
+    while (!m_bStop)
+    {
+        if (!session.qJobs.empty())
+        {
+            std::unique_ptr<EncodeJob> job = std::move(session.qJobs.front());
+            session.qJobs.pop_front();
+            return job;
+        }
+        // Steal the most recently queued job of the busiest session, which it would run last
+        Session* pVictim = nullptr;
+        for (auto& other : m_vSessions)
+        {
+            if (!other->qJobs.empty() && (!pVictim || other->qJobs.size() > pVictim->qJobs.size()))
+            {
+                pVictim = other.get();
+            }
+        }
+        if (pVictim)
+        {
+            std::unique_ptr<EncodeJob> job = std::move(pVictim->qJobs.back());
+            pVictim->qJobs.pop_back();
+            return job;
+        }
+        m_cvJobs.wait(lock);
+    }
+    return nullptr;
+}
+
+void EncoderFarm::WorkerLoop(Session& session)
+{
+    while (std::unique_ptr<EncodeJob> job = PopJob(session))
+    {
+        try
+        {
+            RunJob(session, *job);
+        }
+        catch (const std::exception& e)
+        {
+            job->result.error = e.what();
+            job->result.bitstream.reset();
+            // The state of the encoder is unknown after a failure
+            try
+            {
+                session.encoder.reset();
+            }
+            catch (...)
+            {
+            }
+            std::lock_guard<std::mutex> lock(m_mtx);
+            session.config.clear();
+        }
+        {
+            std::lock_guard<std::mutex> lock(m_mtx);
+            m_qCompleted.push_back(std::move(job));
+        }
+        m_cvResults.notify_all();
+    }
+}
+
+void EncoderFarm::CreateEncoder(Session& session, const EncodeJob& job)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mtx);
+        session.config.clear();
+    }
+    session.encoder.reset();
+
+    std::map<std::string, std::string> options = job.config;
+    NV_ENC_INITIALIZE_PARAMS params = { NV_ENC_INITIALIZE_PARAMS_VER };
+    NV_ENC_CONFIG encodeConfig = { NV_ENC_CONFIG_VER };
+    params.encodeConfig = &encodeConfig;
+    std::string codec = options.count("codec") ? options["codec"] : "h264";
+    params.encodeGUID = (codec == "hevc") ? NV_ENC_CODEC_HEVC_GUID :
+                        (codec == "av1") ? NV_ENC_CODEC_AV1_GUID :
+                        NV_ENC_CODEC_H264_GUID;
+    params.bufferFormat = job.eBufferFormat;
+
+    session.encoder = std::make_unique<NvEncoderCuda>(session.cuContext, session.cuStream, job.width, job.height, job.eBufferFormat);
+    NvEncoderClInterface cliInterface(options);
+    cliInterface.SetupInitParams(params, false, session.encoder->GetApi(), session.encoder->GetEncoder(), false);
+    session.encoder->CreateDefaultEncoderParams(&params, params.encodeGUID, params.presetGUID, params.tuningInfo);
+    session.encoder->CreateEncoder(&params);
+    session.encoder->SetIOCudaStreams((NV_ENC_CUSTREAM_PTR)&session.cuStream, (NV_ENC_CUSTREAM_PTR)&session.cuStream);
+
+    std::lock_guard<std::mutex> lock(m_mtx);
+    session.config = job.config;
+}
+
+void EncoderFarm::RunJob(Session& session, EncodeJob& job)
+{
+    if (!session.encoder || session.config != job.config)
+    {
+        CreateEncoder(session, job);
+    }
+    else
+    {
+        session.encoder->StartNewSequence();
+    }
+    NvEncoderCuda& encoder = *session.encoder;
+
+    job.result.bitstream = std::make_shared<EncodedBitstream>();
+    EncodedBitstream& bitstream = *job.result.bitstream;
+    bitstream.offsets.push_back(0);
+    NvEncBitstreamWriter fnWrite = GetBatchWriter(bitstream);
+
+    for (size_t i = 0; i < job.vInput.size(); i++)
+    {
+        const EncoderInput& input = job.vInput[i];
+        if (input.memoryType == CU_MEMORYTYPE_HOST && input.nBytes < (size_t)encoder.GetFrameSize())
+        {
+            PYNVVC_THROW_ERROR("CPU input buffer is smaller than the frame", NV_ENC_ERR_INVALID_PARAM);
+        }
+        const NvEncInputFrame* encoderInputFrame = encoder.GetNextInputFrame();
+        NvEncoderCuda::CopyToDeviceFrame(session.cuContext,
+            input.pSrc,
+            input.nSrcStride,
+            (CUdeviceptr)encoderInputFrame->inputPtr,
+            (int)encoderInputFrame->pitch,
+            encoder.GetEncodeWidth(),
+            encoder.GetEncodeHeight(),
+            input.memoryType,
+            encoderInputFrame->bufferFormat,
+            encoderInputFrame->chromaOffsets,
+            encoderInputFrame->numChromaPlanes,
+            false,
+            input.memoryType == CU_MEMORYTYPE_DEVICE ? session.cuStream : nullptr,
+            input.srcChromaOffsets);
+
+        NV_ENC_PIC_PARAMS picParam = { 0 };
+        picParam.inputTimeStamp = i;
+        picParam.encodePicFlags = job.vPicFlags.empty() ? 0 : job.vPicFlags[i];
+        if (i == 0)
+        {
+            // every job is an independent stream, also when the session encoded another one before
+            picParam.encodePicFlags |= NV_ENC_PIC_FLAG_FORCEIDR | NV_ENC_PIC_FLAG_OUTPUT_SPSPPS;
+        }
+        bitstream.numPackets += encoder.EncodeFrame(fnWrite, &picParam);
+    }
+    bitstream.numPackets += encoder.EndEncode(fnWrite);
+}
@@ -0,0 +1,147 @@
+/*
+ * This copyright notice applies to this file only
+ *
+ * SPDX-FileCopyrightText: Copyright (c) 2025 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#include "EncoderSessionCache.hpp"
+
+#include <iterator>
+
+CUstream EncoderSessionCache::s_idleStream = nullptr;
+
+EncoderSessionCache& EncoderSessionCache::Instance()
+{
+    // Never destroyed: NVENC sessions cannot be torn down safely once the driver is unloading at exit.
+    // The Python module clears the cache with atexit instead.
+    static EncoderSessionCache* pCache = new EncoderSessionCache();
+    return *pCache;
+}
+
+void EncoderSessionCache::Destroy(Entry& entry)
+{
+    try
+    {
+        entry.encoder.reset();
+    }
+    catch (...)
+    {
+    }
+    cuDevicePrimaryCtxRelease(std::get<0>(entry.key));
+}
+
+void EncoderSessionCache::Trim(size_t nCapacity, std::list<Entry>& lEvicted)
+{
+    while (m_lEntries.size() > nCapacity)
+    {
+        lEvicted.splice(lEvicted.end(), m_lEntries, std::prev(m_lEntries.end()));
+        m_stats.sessionsEvicted++;
+    }
+}
+
+void EncoderSessionCache::SetCapacity(size_t nCapacity)
+{
+    std::list<Entry> lEvicted;
+    {
+        std::lock_guard<std::mutex> lock(m_mtx);
+        m_nCapacity = nCapacity;
+        Trim(nCapacity, lEvicted);
+    }
+    for (Entry& entry : lEvicted)
+    {
+        Destroy(entry);
+    }
+}
+
+size_t EncoderSessionCache::GetCapacity()
+{
+    std::lock_guard<std::mutex> lock(m_mtx);
+    return m_nCapacity;
+}
+
+std::unique_ptr<NvEncoderCuda> EncoderSessionCache::Acquire(const Key& key)
+{
+    std::lock_guard<std::mutex> lock(m_mtx);
+    for (auto it = m_lEntries.begin(); it != m_lEntries.end(); ++it)
+    {
+        if (it->key == key)
+        {
+            std::unique_ptr<NvEncoderCuda> encoder = std::move(it->encoder);
+            m_lEntries.erase(it);
+            return encoder;
+        }
+    }
+    return nullptr;
+}
+
+bool EncoderSessionCache::Release(const Key& key, std::unique_ptr<NvEncoderCuda>& encoder)
+{
+    std::list<Entry> lEvicted;
+    {
+        std::lock_guard<std::mutex> lock(m_mtx);
+        if (m_nCapacity == 0)
+        {
+            return false;
+        }
+        encoder->SetIOCudaStreams((NV_ENC_CUSTREAM_PTR)&s_idleStream, (NV_ENC_CUSTREAM_PTR)&s_idleStream);
+        m_lEntries.push_front(Entry{ key, std::move(encoder) });
+        Trim(m_nCapacity, lEvicted);
+    }
+    for (Entry& entry : lEvicted)
+    {
+        Destroy(entry);
+    }
+    return true;
+}
+
+void EncoderSessionCache::Clear()
+{
+    std::list<Entry> lEvicted;
+    {
+        std::lock_guard<std::mutex> lock(m_mtx);
+        lEvicted.swap(m_lEntries);
+    }
+    for (Entry& entry : lEvicted)
+    {
+        Destroy(entry);
+    }
+}
+
+void EncoderSessionCache::RecordCreate(double timeMs)
+{
+    std::lock_guard<std::mutex> lock(m_mtx);
+    m_stats.sessionsCreated++;
+    m_stats.createTimeMs += timeMs;
+}
+
+void EncoderSessionCache::RecordReuse(double timeMs)
+{
+    std::lock_guard<std::mutex> lock(m_mtx);
+    m_stats.sessionsReused++;
+    m_stats.reuseTimeMs += timeMs;
+}
+
+EncoderSessionCacheStats EncoderSessionCache::GetStats()
+{
+    std::lock_guard<std::mutex> lock(m_mtx);
+    return m_stats;
+}
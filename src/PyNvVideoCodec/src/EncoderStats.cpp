@@ -0,0 +1,51 @@
+/*
+ * This copyright notice applies to this file only
+ *
+ * SPDX-FileCopyrightText: Copyright (c) 2025 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#include "EncoderStats.hpp"
+
+#include <algorithm>
+
+static size_t GetLog2Bin(uint64_t value)
+{
+    size_t bin = 0;
+    while (value >>= 1)
+    {
+        bin++;
+    }
+    return std::min(bin, EncoderStatsHistogram::NUM_LOG2_BINS - 1);
+}
+
+void EncoderStatsHistogram::Add(const NvEncFrameStats& stats)
+{
+    numFrames++;
+    totalBytes += stats.sizeInBytes;
+    totalQP += stats.frameAvgQP;
+    totalLatencyMs += stats.latencyMs;
+    maxLatencyMs = std::max(maxLatencyMs, stats.latencyMs);
+    framesByType[stats.pictureType]++;
+    qpHistogram[std::min<size_t>(stats.frameAvgQP, NUM_QP_BINS - 1)]++;
+    sizeHistogram[GetLog2Bin(stats.sizeInBytes)]++;
+    latencyHistogram[GetLog2Bin((uint64_t)(stats.latencyMs * 1000))]++;
+}
@@ -30,6 +30,7 @@
 #include <pybind11/stl.h>
 
 #include <string>
+#include <string.h>
 #include <functional> // for std::multiplies
 
 using namespace py::literals;
@@ -74,9 +75,13 @@ py::tuple ExternalBuffer::strides() const
 
 std::string ExternalBuffer::dtype() const
 {
-    return std::string("|u1");
-    //return (m_dlTensor->dtype);
-
+    switch (m_dlTensor->dtype.code)
+    {
+    case kDLFloat:
+        return GetTypeStr(m_dlTensor->dtype.bits == 16 ? ViewDataType::FLOAT16 : ViewDataType::FLOAT32);
+    default:
+        return GetTypeStr(m_dlTensor->dtype.bits == 16 ? ViewDataType::UINT16 : ViewDataType::UINT8);
+    }
 }
 
 void *ExternalBuffer::data() const
@@ -84,26 +89,80 @@ void *ExternalBuffer::data() const
     return m_dlTensor->data;
 }
 
-py::capsule ExternalBuffer::dlpack(py::object consumer_stream, CUstream producer_stream, CUevent producer_stream_event) const
+namespace
+{
+// Owns what an exported DLPack tensor refers to, for legacy and versioned capsules
+template <typename ManagedTensor>
+struct ManagerCtx
+{
+    ManagedTensor tensor;
+    std::shared_ptr<const ExternalBuffer> extBuffer;
+};
+
+template <typename ManagedTensor>
+py::capsule MakeDLPackCapsule(std::unique_ptr<ManagerCtx<ManagedTensor>> ctx, const char* szName)
 {
-    struct ManagerCtx
+    // Set up tensor deleter to delete the ManagerCtx
+    ctx->tensor.manager_ctx = ctx.get();
+    ctx->tensor.deleter = [](ManagedTensor *tensor)
     {
-        DLManagedTensor tensor;
-        std::shared_ptr<const ExternalBuffer> extBuffer;
+        delete static_cast<ManagerCtx<ManagedTensor> *>(tensor->manager_ctx);
     };
 
+    // Creates the python capsule with the managed tensor we're returning. A consumer renames the capsule
+    // to used_<name> once it owns the tensor, in which case the destructor leaves the tensor alone.
+    py::capsule cap(&ctx->tensor, szName, [](PyObject *ptr)
+                    {
+                        const char *szName = PyCapsule_GetName(ptr);
+                        if (szName && PyCapsule_IsValid(ptr, szName) && strncmp(szName, "used_", 5) != 0)
+                        {
+                            if (auto *tensor = static_cast<ManagedTensor *>(PyCapsule_GetPointer(ptr, szName)))
+                            {
+                                if (tensor->deleter != nullptr)
+                                {
+                                    tensor->deleter(tensor);
+                                }
+                            }
+                        }
+                    });
+
+    // Now that the capsule is created and the manager ctx was transfered to it,
+    // we can release the unique_ptr.
+    ctx.release();
+    return cap;
+}
+}
+
+py::capsule ExternalBuffer::dlpack(py::object consumer_stream, CUstream producer_stream, CUevent producer_stream_event,
+                                   py::object max_version, py::object dl_device, py::object copy) const
+{
+    if (!copy.is_none() && copy.cast<bool>())
+    {
+        throw py::buffer_error("Frames are exported without copy, copy=True is not supported");
+    }
+    if (!dl_device.is_none())
+    {
+        auto device = dl_device.cast<std::tuple<int, int>>();
+        if (std::get<0>(device) != static_cast<int>(m_dlTensor->device.device_type) ||
+            std::get<1>(device) != static_cast<int>(m_dlTensor->device.device_id))
+        {
+            throw py::buffer_error("Frames can only be exported to the device they reside on");
+        }
+    }
+
     if (m_dlTensor->device.device_type == kDLCUDA)
     {
-        CUstream consumer_custream = nullptr;
         // Caveat: DLPack semantics use int for stream objects. For CUDA's case it is
         // a int64_t value. Need to check how this impacts.
-        auto consumer_raw_stream = consumer_stream.cast<int64_t>();
+        // None implies legacy default
         // 0 implies throw
         // 1 implies legacy default
         // 2 implies PTDS
         // -1 implies no sync
         // reference for semantics:
         // https://data-apis.org/array-api/2022.12/API_specification/generated/array_api.array.__dlpack__.html
+        auto consumer_raw_stream = consumer_stream.is_none() ? 1 : consumer_stream.cast<int64_t>();
+        CUstream consumer_custream = reinterpret_cast<CUstream>(consumer_raw_stream);
         if (consumer_raw_stream == 0)
         {
             std::string msg = "Invalid value for stream parameter. Passed value of 0 which is not allowed\n";
@@ -117,64 +176,52 @@ py::capsule ExternalBuffer::dlpack(py::object consumer_stream, CUstream producer
         {
             consumer_custream = CU_STREAM_PER_THREAD;
         }
-        
-        if (consumer_raw_stream != -1)
+
+        if (consumer_raw_stream != -1 && producer_stream_event && producer_stream != consumer_custream)
+        {
+            // The producer event is recorded in the decoder once per frame, after the frame has been
+            // written, and travels with the DecodedFrame returned to the user. The consumer stream only
+            // waits for the work that produced this frame.
+            ck(cuStreamWaitEvent(consumer_custream, producer_stream_event, 0));
+        }
+    }
+    else if (m_dlTensor->device.device_type == kDLCPU)
+    {
+        // Host frames are copied from the device asynchronously and are only waited for once they are exported
+        if (producer_stream_event)
         {
-            consumer_custream = reinterpret_cast<CUstream>(consumer_raw_stream);
-            if (producer_stream != consumer_custream)
-            {
-                // Note that producer event is recorded in decoder on a per frame
-                // basis and the event is stored in DecodedFrame structure returned
-                // to user. The caller of this functions fetches stream from 
-                // DecodedFrame and passes to this function.
-                ck(cuStreamWaitEvent(consumer_custream, producer_stream_event, 0));
-            }    
+            py::gil_scoped_release release;
+            ck(cuEventSynchronize(producer_stream_event));
         }
     }
-    else if (m_dlTensor->device.device_type != kDLCPU)
+    else
     {
         LOG(WARNING) << "Unsupported Device Type. Should not reach here\n";
     }
 
-    auto ctx = std::make_unique<ManagerCtx>();
-
-    // Set up tensor deleter to delete the ManagerCtx
-    ctx->tensor.manager_ctx = ctx.get();
-    ctx->tensor.deleter = [](DLManagedTensor *tensor)
+    bool bVersioned = false;
+    if (!max_version.is_none())
     {
-        auto *ctx = static_cast<ManagerCtx *>(tensor->manager_ctx);
-        delete ctx;
-    };
-
-    // Copy tensor data
-    ctx->tensor.dl_tensor = *m_dlTensor;
+        auto version = max_version.cast<std::tuple<int, int>>();
+        bVersioned = std::get<0>(version) >= 1;
+    }
 
     // Manager context holds a reference to this External Buffer so that
     // GC doesn't delete this buffer while the dlpack tensor still refers to it.
+    if (bVersioned)
+    {
+        auto ctx = std::make_unique<ManagerCtx<DLManagedTensorVersioned>>();
+        ctx->tensor.version.major = DLPACK_MAJOR_VERSION;
+        ctx->tensor.version.minor = DLPACK_MINOR_VERSION;
+        ctx->tensor.flags = m_bReadOnly ? DLPACK_FLAG_BITMASK_READ_ONLY : 0;
+        ctx->tensor.dl_tensor = *m_dlTensor;
+        ctx->extBuffer = this->shared_from_this();
+        return MakeDLPackCapsule(std::move(ctx), "dltensor_versioned");
+    }
+    auto ctx = std::make_unique<ManagerCtx<DLManagedTensor>>();
+    ctx->tensor.dl_tensor = *m_dlTensor;
     ctx->extBuffer = this->shared_from_this();
-
-    // Creates the python capsule with the DLManagedTensor instance we're returning.
-    py::capsule cap(&ctx->tensor, "dltensor", [](PyObject *ptr)
-                    {
-                        if(PyCapsule_IsValid(ptr, "dltensor"))
-                        {
-                            // If consumer didn't delete the tensor,
-                            if(auto *dlTensor = static_cast<DLManagedTensor *>(PyCapsule_GetPointer(ptr, "dltensor")))
-                            {
-                                // Delete the tensor.
-                                if(dlTensor->deleter != nullptr)
-                                {
-                                    dlTensor->deleter(dlTensor);
-                                }
-                            }
-                        }
-                    });
-
-    // Now that the capsule is created and the manager ctx was transfered to it,
-    // we can release the unique_ptr.
-    ctx.release();
-
-    return cap;
+    return MakeDLPackCapsule(std::move(ctx), "dltensor");
 }
 
 py::tuple ExternalBuffer::dlpackDevice() const
@@ -188,7 +235,7 @@ const DLTensor &ExternalBuffer::dlTensor() const
     return *m_dlTensor;
 }
 
-int ExternalBuffer::LoadDLPack(std::vector<size_t> _shape, std::vector<size_t> _stride, std::string _typeStr,
+int ExternalBuffer::LoadDLPack(const TensorDims& _shape, const TensorDims& _stride, ViewDataType _dtype,
                                CUdeviceptr _data, bool useDeviceMemory, uint32_t deviceId, const CUcontext context)
 {
     m_dlTensor->byte_offset = 0;
@@ -205,45 +252,54 @@ int ExternalBuffer::LoadDLPack(std::vector<size_t> _shape, std::vector<size_t> _
     m_dlTensor->data = ptr;
 
     // Convert DataType
-    if (_typeStr != "|u1" && _typeStr != "B" && _typeStr != "|u2")
-    {
-        throw std::runtime_error("Could not create DL Pack tensor! Invalid typstr: " + _typeStr);
-        return -1;
-    }
-
-    int itemSizeDT = sizeof(uint8_t);// dt.itemsize() 
-    m_dlTensor->dtype.code = kDLUInt;
-    m_dlTensor->dtype.bits = 8;
+    m_dlTensor->dtype.code = IsFloatType(_dtype) ? kDLFloat : kDLUInt;
+    m_dlTensor->dtype.bits = (uint8_t)(GetElementSize(_dtype) * 8);
     m_dlTensor->dtype.lanes = 1;
 
-    if (_typeStr == "|u2")
+    // Shape and stride arrays are reused when a recycled buffer describes a frame of the same rank
+    if (m_dlTensor->ndim != (int)_shape.size() || !m_dlTensor->shape || !m_dlTensor->strides)
     {
-        itemSizeDT = sizeof(uint16_t);
-        m_dlTensor->dtype.bits = 16;
-    }
+        delete[] m_dlTensor->shape;
+        m_dlTensor->shape = nullptr;
 
-    // Convert ndim
-    m_dlTensor->ndim = _shape.size();
+        delete[] m_dlTensor->strides;
+        m_dlTensor->strides = nullptr;
 
-    delete[] m_dlTensor->shape;
-    m_dlTensor->shape = nullptr;
-
-    delete[] m_dlTensor->strides;
-    m_dlTensor->strides = nullptr;
-
-    // Convert shape
-    m_dlTensor->shape = new int64_t[m_dlTensor->ndim];
-    for (int i = 0; i < m_dlTensor->ndim; ++i)
-    {
-        m_dlTensor->shape[i] = _shape[i];
+        m_dlTensor->ndim = _shape.size();
+        m_dlTensor->shape = new int64_t[m_dlTensor->ndim];
+        m_dlTensor->strides = new int64_t[m_dlTensor->ndim];
     }
 
-    // Convert strides
-    m_dlTensor->strides = new int64_t[m_dlTensor->ndim];
+    // Convert shape and strides
     for (int i = 0; i < m_dlTensor->ndim; ++i)
     {
+        m_dlTensor->shape[i] = _shape[i];
         m_dlTensor->strides[i] = _stride[i];
     }
 
     return 0;
 }
+
+std::shared_ptr<ExternalBuffer> ExternalBufferPool::Acquire()
+{
+    // A pooled buffer that nobody else refers to anymore can be reused. Only the owner of the pool
+    // hands out references, so the use count of an idle buffer cannot grow concurrently.
+    for (size_t i = 0; i < m_vBuffers.size(); i++)
+    {
+        size_t idx = (m_nNext + i) % m_vBuffers.size();
+        if (m_vBuffers[idx].use_count() == 1)
+        {
+            m_nNext = idx + 1;
+            // release the memory the previous frame kept alive
+            m_vBuffers[idx]->SetOwner(nullptr);
+            return m_vBuffers[idx];
+        }
+    }
+    m_nAllocations++;
+    auto extBuf = std::make_shared<ExternalBuffer>();
+    if (m_vBuffers.size() < MAX_POOLED_BUFFERS)
+    {
+        m_vBuffers.push_back(extBuf);
+    }
+    return extBuf;
+}
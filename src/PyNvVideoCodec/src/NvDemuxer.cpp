@@ -114,6 +114,10 @@ ColorSpace NvDemuxer::GetColorSpace() const
     case AVCOL_SPC_SMPTE170M:
         return ColorSpace::BT_601;
         break;
+    case AVCOL_SPC_BT2020_NCL:
+    case AVCOL_SPC_BT2020_CL:
+        return ColorSpace::BT_2020;
+        break;
     default:
         return ColorSpace::UNSPEC;
         break;
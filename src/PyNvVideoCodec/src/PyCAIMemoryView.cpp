@@ -232,10 +232,18 @@ CAIMemoryView  coerceToCudaArrayView(py::object cuda_array, NV_ENC_BUFFER_FORMAT
     ss << py::str(py::cast(expectedShape));
     throw std::runtime_error(ss.str());
   }
+  stride = expectedStrides;
   if (!array_interface["strides"].is_none())
   {
     auto strides = array_interface["strides"].cast<std::vector<size_t>>();
-    if (strides != expectedStrides)
+    // Rows may be padded (e.g. pitched decoder output), so the row stride may exceed the packed one.
+    // Strides of unit dimensions are never used for addressing and are not checked.
+    bool bValid = strides.size() == expectedStrides.size() && strides[0] >= expectedStrides[0];
+    for (size_t i = 1; bValid && i < strides.size(); i++)
+    {
+      bValid = strides[i] == expectedStrides[i] || shape[i] == 1;
+    }
+    if (!bValid)
     {
       std::stringstream ss;
       ss << "Invalid strides: ";
@@ -244,7 +252,7 @@ CAIMemoryView  coerceToCudaArrayView(py::object cuda_array, NV_ENC_BUFFER_FORMAT
       ss << py::str(py::cast(expectedStrides));
       throw std::runtime_error(ss.str());
     }
+    stride = strides;
   }
-  stride = expectedStrides;
   return CAIMemoryView{  shape, stride, typestr,0,data, readyOnly  };
 }
@@ -24,6 +24,7 @@
  */
 
 #include "ExternalBuffer.hpp"
+#include "DecodedBatch.hpp"
 #include "PyNvDecoder.hpp"
 #include "PyNvVideoCodecUtils.hpp"
 
@@ -47,7 +48,12 @@ PyNvDecoder::PyNvDecoder(
     OutputColorType outputColorType,
     bool _enableSEIMessage,
     bool bWaitForSessionWarmUp,
-    DisplayDecodeLatency latency
+    DisplayDecodeLatency latency,
+    uint32_t preallocFrames,
+    bool useMemPool,
+    bool outputMappedSurface,
+    const PostProcessParams& postProcess,
+    const std::vector<PostProcessOutput>& outputLadder
 ) : mReleasePrimaryContext(false),
     mGPUId(_gpuid)
 {
@@ -91,6 +97,13 @@ PyNvDecoder::PyNvDecoder(
     }
     decoder.reset(new NvDecoder(_gpuid, cuStream, cuContext, m_bUseDeviceFrame, _codec, bLowLatency,
         _enableasyncallocations, maxWidth, maxHeight, outputColorType,false, _enableSEIMessage,1000U, bZeroLatency,bWaitForSessionWarmUp));
+    decoder->SetFramePoolPolicy(preallocFrames, useMemPool);
+    if (outputMappedSurface)
+    {
+        decoder->SetMappedSurfaceOutput(true);
+    }
+    decoder->SetPostProcess(postProcess);
+    decoder->SetOutputLadder(outputLadder);
 
 }
 
@@ -134,8 +147,10 @@ std::vector<DecodedFrame> PyNvDecoder::Decode(const PacketData packetData)
     std::vector<DecodedFrame> frames;
     py::gil_scoped_release release;
     auto vecTupFrame = decoder->PyDecode((uint8_t*)packetData.bsl_data, packetData.bsl, packetData.pts, packetData.decode_flag);
-    auto funcCAIDLPack = std::bind(GetCAIMemoryViewAndDLPack, decoder.get(), std::placeholders::_1);
-    std::transform(vecTupFrame.begin(), vecTupFrame.end(), std::back_inserter(frames), funcCAIDLPack);
+    auto funcCAIDLPack = std::bind(GetCAIMemoryViewAndDLPack, decoder.get(), std::placeholders::_1, &mExtBufPool);
+    // the SEI messages are moved into the frames
+    std::transform(std::make_move_iterator(vecTupFrame.begin()), std::make_move_iterator(vecTupFrame.end()),
+                   std::back_inserter(frames), funcCAIDLPack);
     py::gil_scoped_acquire acquire;
     return frames;
 }
@@ -149,7 +164,7 @@ DecodedFrame PyNvDecoder::GetFrame()
     SEI_MESSAGE seimsg;
     CUevent event = nullptr;
     CUdeviceptr  data = (CUdeviceptr)decoder->GetFrame(&timestamp, &seimsg, &event);
-    return GetCAIMemoryViewAndDLPack(decoder.get(), std::make_tuple(data, timestamp, seimsg, event));
+    return GetCAIMemoryViewAndDLPack(decoder.get(), std::make_tuple(data, timestamp, std::move(seimsg), event), &mExtBufPool);
 }
 
 using CAPS = std::unordered_map<std::string, uint32_t>;
@@ -294,10 +309,16 @@ void Init_PyNvDecoder(py::module& m)
             OutputColorType outputColorType,
             bool enableSEIMessage,
             bool bWaitForSessionWarmUp,
-            DisplayDecodeLatency latency
+            DisplayDecodeLatency latency,
+            uint32_t preallocframes,
+            bool usememorypool,
+            bool outputmappedsurface,
+            const PostProcessParams& postprocess,
+            const std::vector<PostProcessOutput>& outputladder
             )
         {
-            return std::make_shared<PyNvDecoder>(gpuid, codec, cudacontext, cudastream, usedevicememory, false, maxwidth, maxheight,outputColorType,enableSEIMessage, bWaitForSessionWarmUp, latency);
+            return std::make_shared<PyNvDecoder>(gpuid, codec, cudacontext, cudastream, usedevicememory, false, maxwidth, maxheight,outputColorType,enableSEIMessage, bWaitForSessionWarmUp, latency,
+                preallocframes, usememorypool, outputmappedsurface, postprocess, outputladder);
         },
 
         py::arg("gpuid") = 0,
@@ -311,6 +332,11 @@ void Init_PyNvDecoder(py::module& m)
             py::arg("enableSEIMessage") = 0,
             py::arg("bWaitForSessionWarmUp") = 0,
             py::arg("latency") = DisplayDecodeLatency::DISPLAYDECODELATENCY_NATIVE,
+            py::arg("preallocframes") = 0,
+            py::arg("usememorypool") = 0,
+            py::arg("outputmappedsurface") = 0,
+            py::arg("postprocess") = PostProcessParams(),
+            py::arg("outputladder") = std::vector<PostProcessOutput>(),
             R"pbdoc(
         Initialize decoder with set of particular
         parameters
@@ -327,6 +353,13 @@ void Init_PyNvDecoder(py::module& m)
         :param latency : "DISPLAYDECODELATENCY_NATIVE - Decoder input and output have a latency of 4 frames, output in display order"
                          "DISPLAYDECODELATENCY_LOW - Decoder input and output have a latency of 0 frames, output in display order"
                          "DISPLAYDECODELATENCY_ZERO - Decoder input and output have a latency of 0 frames, output in decode order"
+        :param preallocframes : number of output frames allocated at maxwidth x maxheight when the session is created and reused across reconfiguration, 0 allocates lazily
+        :param usememorypool : back device output frames with a dedicated CUDA memory pool
+        :param outputmappedsurface : return mapped decoder surfaces (pitched) without copying, native format and device memory only.
+                                     A frame stays valid until it is unlocked or, for frames returned by Decode, until the next Decode call
+        :param postprocess : PostProcessParams fused with the RGB/RGBP conversion (crop, resize, normalization and cast), RGB and RGBP output only
+        :param outputladder : list of up to 8 PostProcessOutput generated from every decoded frame by one kernel, available as DecodedFrame.ladder.
+                              Device memory only, not with outputmappedsurface
     )pbdoc"
             )
         .def(
@@ -342,10 +375,16 @@ void Init_PyNvDecoder(py::module& m)
                 int maxheight,
                 OutputColorType outputColorType,
                 bool enableSEIMessage,
-                DisplayDecodeLatency latency
+                DisplayDecodeLatency latency,
+                uint32_t preallocframes,
+                bool usememorypool,
+                bool outputmappedsurface,
+                const PostProcessParams& postprocess,
+                const std::vector<PostProcessOutput>& outputladder
                 )
             {
-                return std::make_shared<PyNvDecoder>(gpuid, codec, cudacontext, cudastream, true, enableasyncallocations, maxwidth, maxheight, outputColorType ,enableSEIMessage,true, latency);
+                return std::make_shared<PyNvDecoder>(gpuid, codec, cudacontext, cudastream, true, enableasyncallocations, maxwidth, maxheight, outputColorType ,enableSEIMessage,true, latency,
+                    preallocframes, usememorypool, outputmappedsurface, postprocess, outputladder);
             },
 
             py::arg("gpuid") = 0,
@@ -359,6 +398,11 @@ void Init_PyNvDecoder(py::module& m)
                 py::arg("outputColorType") = OutputColorType::NATIVE,
                 py::arg("enableSEIMessage") = 0,
                 py::arg("latency") = DisplayDecodeLatency::DISPLAYDECODELATENCY_NATIVE,
+                py::arg("preallocframes") = 0,
+                py::arg("usememorypool") = 0,
+                py::arg("outputmappedsurface") = 0,
+                py::arg("postprocess") = PostProcessParams(),
+                py::arg("outputladder") = std::vector<PostProcessOutput>(),
                 R"pbdoc(
         Initialize decoder with set of particular
         parameters
@@ -374,6 +418,13 @@ void Init_PyNvDecoder(py::module& m)
         :param latency : "DISPLAYDECODELATENCY_NATIVE - Decoder input and output have a latency of 4 frames, output in display order"
                          "DISPLAYDECODELATENCY_LOW - Decoder input and output have a latency of 0 frames, output in display order"
                          "DISPLAYDECODELATENCY_ZERO - Decoder input and output have a latency of 0 frames, output in decode order"
+        :param preallocframes : number of output frames allocated at maxwidth x maxheight when the session is created and reused across reconfiguration, 0 allocates lazily
+        :param usememorypool : back device output frames with a dedicated CUDA memory pool
+        :param outputmappedsurface : return mapped decoder surfaces (pitched) without copying, native format and device memory only.
+                                     A frame stays valid until it is unlocked or, for frames returned by Decode, until the next Decode call
+        :param postprocess : PostProcessParams fused with the RGB/RGBP conversion (crop, resize, normalization and cast), RGB and RGBP output only
+        :param outputladder : list of up to 8 PostProcessOutput generated from every decoded frame by one kernel, available as DecodedFrame.ladder.
+                              Device memory only, not with outputmappedsurface
     )pbdoc"
     );
 
@@ -402,10 +453,66 @@ void Init_PyNvDecoder(py::module& m)
     )pbdoc"
             );
 
+    m.def(
+        "FrameHash",
+        [](py::buffer buffer)
+        {
+            py::buffer_info info = buffer.request();
+            py::ssize_t nStride = info.itemsize;
+            for (py::ssize_t i = info.ndim - 1; i >= 0; i--)
+            {
+                if (info.shape[i] > 1 && info.strides[i] != nStride)
+                {
+                    throw std::invalid_argument("FrameHash expects a C-contiguous buffer");
+                }
+                nStride *= info.shape[i];
+            }
+            return ComputeFrameHashHost(static_cast<const uint8_t*>(info.ptr), (uint64_t)info.size * info.itemsize);
+        },
+        py::arg("frame"),
+        R"pbdoc(
+        Host implementation of the decoder frame hash, to verify DecodedFrame.hash on a host copy of the frame
+        :param frame: C-contiguous buffer holding the frame, e.g. a numpy array of shape (height * 3 / 2, width) for NV12
+        :return: 64 bit hash of the bytes of the buffer
+    )pbdoc");
+
     py::class_<DecodedFrame, std::shared_ptr<DecodedFrame>>(m, "DecodedFrame")
         .def_readonly("timestamp", &DecodedFrame::timestamp)
         .def_readonly("format", &DecodedFrame::format)
         .def_readonly("decoder_stream_event", &DecodedFrame::decoderStreamEvent)
+        .def_property_readonly("ladder",
+            [](std::shared_ptr<DecodedFrame>& self)
+            {
+                std::vector<std::shared_ptr<DecodedFrame>> ladder;
+                for (const LadderFrame& output : self->ladder)
+                {
+                    auto frame = std::make_shared<DecodedFrame>();
+                    frame->timestamp = self->timestamp;
+                    frame->format = output.format;
+                    frame->views = output.views;
+                    frame->extBuf = output.extBuf;
+                    frame->decoderStreamEvent = self->decoderStreamEvent;
+                    frame->decoderStream = self->decoderStream;
+                    ladder.push_back(frame);
+                }
+                return ladder;
+            }, "outputs of the decoder output ladder generated from the same picture, in the order they were configured")
+        .def_property_readonly("hash",
+            [](std::shared_ptr<DecodedFrame>& self) -> py::object
+            {
+                if (!self->pHash)
+                {
+                    return py::none();
+                }
+                {
+                    py::gil_scoped_release release;
+                    ck(cuEventSynchronize(reinterpret_cast<CUevent>(self->decoderStreamEvent)));
+                }
+                return py::int_(*self->pHash);
+            }, R"pbdoc(
+            64 bit content hash of the frame if frame hashing is enabled on the decoder, None otherwise.
+            Waits for the frame to be decoded. Matches FrameHash() of a contiguous copy of the frame.
+            )pbdoc")
         .def("__repr__",
             [](std::shared_ptr<DecodedFrame>& self)
             {
@@ -413,7 +520,7 @@ void Init_PyNvDecoder(py::module& m)
                 ss << "<DecodedFrame [";
                 ss << "timestamp=" << self->timestamp;
                 ss << ", format=" << py::str(py::cast(self->format));
-                ss << ", " << py::str(py::cast(self->views));
+                ss << ", " << py::str(self->views.ToList());
                 ss << "]>";
                 return ss.str();
             })
@@ -476,7 +583,7 @@ void Init_PyNvDecoder(py::module& m)
             )pbdoc")
         .def("cuda",
             [](std::shared_ptr<DecodedFrame>& self) {
-                return self->views;
+                return self->views.ToList();
             },
             R"pbdoc(
             return underlying views which implement CAI
@@ -500,29 +607,32 @@ void Init_PyNvDecoder(py::module& m)
                      {
                          
                          size_t width = self->views.at(0).shape[1];
-                         size_t height = self->views.at(0).shape[0] * 1.5;
+                         size_t pitch = self->views.at(0).stride[0];
+                         // rows up to the end of the chroma plane, which may not directly follow the luma rows
+                         size_t height = (self->views.at(1).data - self->views.at(0).data) / pitch + self->views.at(1).shape[0];
                          CUdeviceptr data = self->views.at(0).data;
                          CUstream stream = self->views.at(0).stream;
                          self->views.clear();
-                         self->views.push_back(CAIMemoryView{ { height, width, 1}, {width, 2, 1}, "|u1", reinterpret_cast<size_t>(stream),(data), false }); //hack for cvcuda tensor represenation
+                         self->views.push_back(CAIMemoryView{ { height, width, 1}, {pitch, 2, 1}, "|u1", reinterpret_cast<size_t>(stream),(data), false }); //hack for cvcuda tensor represenation
                      }
                      break;
                      case Pixel_Format_YUV444:
                      {
 
                          size_t width = self->views.at(0).shape[1];
-                         size_t height = self->views.at(0).shape[0] * 3;
+                         size_t pitch = self->views.at(0).stride[0];
+                         size_t height = (self->views.at(2).data - self->views.at(0).data) / pitch + self->views.at(2).shape[0];
                          CUdeviceptr data = self->views.at(0).data;
                          CUstream stream = self->views.at(0).stream;
                          self->views.clear();
-                         self->views.push_back(CAIMemoryView{ { height, width, 1}, {width, 3, 1}, "|u1", reinterpret_cast<size_t>(stream),(data), false }); //hack for cvcuda tensor represenation
+                         self->views.push_back(CAIMemoryView{ { height, width, 1}, {pitch, 3, 1}, "|u1", reinterpret_cast<size_t>(stream),(data), false }); //hack for cvcuda tensor represenation
                      }
                 break;
              default:
                 PYNVVC_THROW_ERROR_UNSUPPORTED("only nv12 and yuv444 supported as of now", CUDA_ERROR_NOT_SUPPORTED);
                 break;
                  }
-                 return self->views;
+                 return self->views.ToList();
              },
              R"pbdoc(
             return underlying views which implement CAI
@@ -539,9 +649,19 @@ void Init_PyNvDecoder(py::module& m)
              .def_property_readonly("dtype", [](std::shared_ptr<DecodedFrame>& self) {
                 return self->extBuf->dtype();
                  }, "Get the data type of the buffer")
-             .def("__dlpack__", [](std::shared_ptr<DecodedFrame>& self, py::object stream) {
-                return self->extBuf->dlpack(stream, reinterpret_cast<CUstream>(self->decoderStream), reinterpret_cast<CUevent>(self->decoderStreamEvent));
-                    }, py::arg("stream") = NULL, "Export the buffer as a DLPack tensor")
+             .def("__dlpack__", [](std::shared_ptr<DecodedFrame>& self, py::object stream, py::object max_version, py::object dl_device, py::object copy) {
+                return self->extBuf->dlpack(stream, reinterpret_cast<CUstream>(self->decoderStream), reinterpret_cast<CUevent>(self->decoderStreamEvent),
+                    max_version, dl_device, copy);
+                    }, py::arg("stream") = py::none(), py::arg("max_version") = py::none(), py::arg("dl_device") = py::none(), py::arg("copy") = py::none(),
+                    R"pbdoc(
+            Export the buffer as a DLPack tensor, as a DLPack 1.0 versioned capsule if max_version >= (1, 0).
+            The consumer stream waits on the event recorded after this frame was decoded, without host synchronization.
+            Host frames are copied asynchronously, exporting one waits for its copy to complete.
+            :param stream: consumer stream, None for the legacy default stream, -1 for no synchronization
+            :param max_version: highest DLPack version supported by the consumer
+            :param dl_device: device requested by the consumer, must be the device of the frame
+            :param copy: copies are not supported, must be None or False
+            )pbdoc")
              .def("__dlpack_device__", [](std::shared_ptr<DecodedFrame>& self) {
                 return self->extBuf->dlpackDevice();
                  }, "Get the device associated with the buffer")
@@ -550,22 +670,28 @@ void Init_PyNvDecoder(py::module& m)
             .def("GetPtrToPlane",
 
                 [](std::shared_ptr<DecodedFrame>& self, int planeIdx) {
+                    if (self->extBuf->dlTensor().device.device_type == kDLCPU && self->decoderStreamEvent)
+                    {
+                        // the host frame may still be copied from the device
+                        py::gil_scoped_release release;
+                        ck(cuEventSynchronize(reinterpret_cast<CUevent>(self->decoderStreamEvent)));
+                    }
                     return self->views[planeIdx].data;
                     }, R"pbdoc(
-            return pointer to base address for plane index
+            return pointer to base address for plane index, waits for the copy of a host frame
             :param planeIdx : index to the plane
             )pbdoc");
             py::class_<CAIMemoryView, std::shared_ptr<CAIMemoryView>>(m, "CAIMemoryView")
                 .def(py::init<std::vector<size_t>, std::vector<size_t>, std::string, size_t, CUdeviceptr, bool>())
-                .def_readonly("shape", &CAIMemoryView::shape)
-                .def_readonly("stride", &CAIMemoryView::stride)
+                .def_property_readonly("shape", [](std::shared_ptr<CAIMemoryView>& self) { return self->shape.ToVector(); })
+                .def_property_readonly("stride", [](std::shared_ptr<CAIMemoryView>& self) { return self->stride.ToVector(); })
                 .def_readonly("dataptr", &CAIMemoryView::data)
                 .def("__repr__",
                     [](std::shared_ptr<CAIMemoryView>& self)
                     {
                         std::stringstream ss;
                         ss << "<CAIMemoryView ";
-                        ss << py::str(py::cast(self->shape));
+                        ss << py::str(py::cast(self->shape.ToVector()));
                         ss << ">";
                         return ss.str();
                     })
@@ -575,15 +701,62 @@ void Init_PyNvDecoder(py::module& m)
                             {
                                 py::dict dict;
                                 dict["version"] = 3;
-                                dict["shape"] = self->shape;
-                                dict["strides"] = self->stride;
-                                dict["typestr"] = self->typestr;
+                                dict["shape"] = self->shape.ToVector();
+                                dict["strides"] = self->stride.ToVector();
+                                dict["typestr"] = self->typestr();
                                 dict["stream"] = self->stream == 0 ? int(size_t(self->stream)) : 2;
                                 dict["data"] = std::make_pair(self->data, false);
                                 dict["gpuIdx"] = 0;
                                 return dict;
                             });
 
+                    py::class_<DecodedBatch, std::shared_ptr<DecodedBatch>>(m, "DecodedBatch")
+                        .def_readonly("timestamps", &DecodedBatch::timestamps)
+                        .def_readonly("format", &DecodedBatch::format)
+                        .def_readonly("decoder_stream_event", &DecodedBatch::decoderStreamEvent)
+                        .def("__len__", [](std::shared_ptr<DecodedBatch>& self) {
+                            return self->timestamps.size();
+                            })
+                        .def("__repr__",
+                            [](std::shared_ptr<DecodedBatch>& self)
+                            {
+                                std::stringstream ss;
+                                ss << "<DecodedBatch [";
+                                ss << "frames=" << self->timestamps.size();
+                                ss << ", format=" << py::str(py::cast(self->format));
+                                ss << ", shape=" << py::str(self->extBuf->shape());
+                                ss << "]>";
+                                return ss.str();
+                            })
+                        .def_property_readonly("shape", [](std::shared_ptr<DecodedBatch>& self) {
+                            return self->extBuf->shape();
+                            }, "Get the shape of the batch tensor")
+                        .def_property_readonly("strides", [](std::shared_ptr<DecodedBatch>& self) {
+                            return self->extBuf->strides();
+                            }, "Get the strides of the batch tensor")
+                        .def_property_readonly("dtype", [](std::shared_ptr<DecodedBatch>& self) {
+                            return self->extBuf->dtype();
+                            }, "Get the data type of the batch tensor")
+                        .def("__dlpack__", [](std::shared_ptr<DecodedBatch>& self, py::object stream, py::object max_version, py::object dl_device, py::object copy) {
+                            if (self->timestamps.empty())
+                            {
+                                PYNVVC_THROW_ERROR("Cannot export an empty batch", CUDA_ERROR_INVALID_VALUE);
+                            }
+                            return self->extBuf->dlpack(stream, reinterpret_cast<CUstream>(self->decoderStream), reinterpret_cast<CUevent>(self->decoderStreamEvent),
+                                max_version, dl_device, copy);
+                            }, py::arg("stream") = py::none(), py::arg("max_version") = py::none(), py::arg("dl_device") = py::none(), py::arg("copy") = py::none(),
+                            R"pbdoc(
+            Export the batch as one DLPack tensor, as a DLPack 1.0 versioned capsule if max_version >= (1, 0).
+            The consumer stream waits on the batch ready event.
+            :param stream: consumer stream, None for the legacy default stream, -1 for no synchronization
+            :param max_version: highest DLPack version supported by the consumer
+            :param dl_device: device requested by the consumer, must be the device of the batch
+            :param copy: copies are not supported, must be None or False
+            )pbdoc")
+                        .def("__dlpack_device__", [](std::shared_ptr<DecodedBatch>& self) {
+                            return self->extBuf->dlpackDevice();
+                            }, "Get the device associated with the batch tensor");
+
                     
                     py::class_<PyNvDecoder, shared_ptr<PyNvDecoder>>(m, "PyNvDecoder", py::module_local())
                         .def(py::init<>(),
@@ -615,10 +788,38 @@ void Init_PyNvDecoder(py::module& m)
                                     {
                                        return PyNvDecoder::getDecoderSessionOverHead(sessionID);
                                     })
+                                .def("SetColorimetry",
+                                    [](std::shared_ptr<PyNvDecoder>& dec, const PostProcessColorimetry& colorimetry)
+                                    {
+                                        dec->SetColorimetry(colorimetry);
+                                    }, R"pbdoc(
+            Sets the color matrix, range and transfer used for RGB/RGBP output, e.g. from the container
+            metadata, and optionally enables HDR to SDR tone mapping. Takes effect from the next decoded frame.
+            :param colorimetry: PostProcessColorimetry, fields left at 0/AUTO follow the stream
+    )pbdoc")
+                                .def("SetBitDepthConversion",
+                                    [](std::shared_ptr<PyNvDecoder>& dec, bool to8bit, bool dither)
+                                    {
+                                        dec->SetBitDepthConversion(to8bit, dither);
+                                    }, py::arg("to8bit"), py::arg("dither") = false, R"pbdoc(
+            Makes native output frames of 10/12 bit streams 8 bit: P016 becomes NV12, YUV444_16Bit becomes YUV444
+            and P216 becomes NV16, which halves their size. Must be called before the first Decode call.
+            :param to8bit: convert to 8 bit, rounding to nearest
+            :param dither: use ordered dithering instead of rounding to avoid banding
+    )pbdoc")
+                                .def("SetFrameHash",
+                                    [](std::shared_ptr<PyNvDecoder>& dec, bool enable)
+                                    {
+                                        dec->SetFrameHash(enable);
+                                    }, py::arg("enable"), R"pbdoc(
+            Computes a 64 bit content hash of every decoded frame on the GPU, exposed as DecodedFrame.hash.
+            Use it to detect corrupted decodes or to skip identical frames. Must be called before the first Decode call.
+            :param enable: hash output frames
+    )pbdoc")
                                 .def("GetPixelFormat",
                                     [](std::shared_ptr<PyNvDecoder>& dec)
                                     {
-                                        return GetNativeFormat(dec->GetOutputFormat());
+                                        return GetNativeFormat(dec->GetNativeOutputFormat());
                                     },R"pbdoc(
             Returns Pixel format string representation 
             :param None
@@ -751,6 +952,33 @@ void Init_PyNvDecoder(py::module& m)
                     return dec->GetFrameSize();
                 },R"pbdoc()pbdoc"
                 "Get the size of decoded frame"
+                )
+                .def(
+                "GetFramePoolStats",
+                [](std::shared_ptr<PyNvDecoder>& dec)
+                {
+                    FramePoolStats stats = dec->GetFramePoolStats();
+                    py::dict dict;
+                    dict["preallocated_frames"] = stats.nPreallocatedFrames;
+                    dict["decode_time_allocations"] = stats.nDecodeTimeAllocations;
+                    dict["allocations"] = stats.nAllocations;
+                    dict["frees"] = stats.nFrees;
+                    return dict;
+                },R"pbdoc(
+            Returns output frame allocation counters. decode_time_allocations stays at 0 after warm-up
+            when the decoder is created with preallocframes
+            :param None
+            :return: dict of counters
+    )pbdoc"
+                )
+            .def(
+                "GetExternalBufferAllocationCount",
+                &PyNvDecoder::GetExternalBufferAllocationCount,R"pbdoc(
+            Returns the number of buffer descriptors allocated for the frames handed out by Decode and GetFrame.
+            Descriptors are recycled once the frames are released, so the count stays flat after warm-up
+            :param None
+            :return: number of allocated descriptors
+    )pbdoc"
                 )
  
                                         .def(
@@ -54,6 +54,7 @@ void Init_PyNvDemuxer(py::module& m)
         .value("BT_601", BT_601)
         .value("BT_709", BT_709)
         .value("UNSPEC", UNSPEC)
+        .value("BT_2020", BT_2020)
         .export_values();
 
     py::enum_<ColorRange>(m, "ColorRange", py::module_local())
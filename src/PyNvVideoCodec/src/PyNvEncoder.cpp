@@ -24,6 +24,7 @@
  */
 
 #include "PyNvEncoder.hpp"
+#include "EncoderSessionCache.hpp"
 #include "NvEncoderClInterface.hpp"
 #include "PyCAIMemoryView.hpp"
 #include "PyNvVideoCodecUtils.hpp"
@@ -35,6 +36,18 @@
 #include <pybind11/embed.h>
 #include <pybind11/cast.h>
 #include <unordered_map>
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <iterator>
+#include <mutex>
+#include <utility>
+#if defined(_WIN32)
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
 
 using namespace std;
 using namespace chrono;
@@ -46,18 +59,60 @@ using CAPS = std::unordered_map<std::string, uint32_t>;
 // Forward declaration of PyNvEncoderCaps
 static CAPS PyNvEncoderCaps(int32_t gpuid, std::string codec);
 
-PyNvEncoder::PyNvEncoder( PyNvEncoder&& pyenvc)
-    :m_encoder(std::move(pyenvc.m_encoder)), m_CUcontext(pyenvc.m_CUcontext), m_width(pyenvc.m_width), m_height(pyenvc.m_height), m_eBufferFormat(pyenvc.m_eBufferFormat),
-    pCUStream(std::move(pyenvc.pCUStream)), m_mapPtr(pyenvc.m_mapPtr), m_gpuId(pyenvc.m_gpuId)
+// CreateDefaultEncoderParams() limits the encode size to the initial one; restore the max_res option, which
+// allows Reconfigure() to change the resolution up to it
+static void ApplyMaxResolution(const std::map<std::string, std::string>& options, NV_ENC_INITIALIZE_PARAMS& params)
 {
-    
+    auto it = options.find("max_res");
+    uint32_t maxWidth = 0, maxHeight = 0;
+    if (it != options.end() && sscanf(it->second.c_str(), "%ux%u", &maxWidth, &maxHeight) == 2)
+    {
+        params.maxEncodeWidth = std::max(maxWidth, params.encodeWidth);
+        params.maxEncodeHeight = std::max(maxHeight, params.encodeHeight);
+    }
 }
 
-PyNvEncoder::PyNvEncoder(PyNvEncoder& pyenvc)
-    :m_encoder(std::move(pyenvc.m_encoder)), m_CUcontext(pyenvc.m_CUcontext), m_width(pyenvc.m_width), m_height(pyenvc.m_height), m_eBufferFormat(pyenvc.m_eBufferFormat),
-    pCUStream(std::move(pyenvc.pCUStream)), m_mapPtr(pyenvc.m_mapPtr), m_gpuId(pyenvc.m_gpuId)
+// The block_stats option makes the encoder output the QP and bit count of every block
+static void ApplyOutputStats(const std::map<std::string, std::string>& options, NV_ENC_INITIALIZE_PARAMS& params)
 {
+    auto it = options.find("block_stats");
+    if (it != options.end() && stoi(it->second) != 0)
+    {
+        params.enableOutputStats = 1;
+        params.outputStatsLevel = NV_ENC_OUTPUT_STATS_BLOCK_LEVEL;
+    }
+}
 
+static uint32_t& GetIdrPeriod(NV_ENC_CONFIG& encodeConfig, const GUID& encodeGUID)
+{
+    if (encodeGUID == NV_ENC_CODEC_HEVC_GUID)
+    {
+        return encodeConfig.encodeCodecConfig.hevcConfig.idrPeriod;
+    }
+    if (encodeGUID == NV_ENC_CODEC_AV1_GUID)
+    {
+        return encodeConfig.encodeCodecConfig.av1Config.idrPeriod;
+    }
+    return encodeConfig.encodeCodecConfig.h264Config.idrPeriod;
+}
+
+PyNvEncoder::PyNvEncoder( PyNvEncoder&& pyenvc)
+    :m_CUcontext(pyenvc.m_CUcontext), m_CUstream(pyenvc.m_CUstream), m_ReleasePrimaryContext(std::exchange(pyenvc.m_ReleasePrimaryContext, false)),
+    m_lRegisteredInputs(std::move(pyenvc.m_lRegisteredInputs)), m_mapRegisteredInputs(std::move(pyenvc.m_mapRegisteredInputs)),
+    m_nMaxRegisteredInputs(pyenvc.m_nMaxRegisteredInputs), m_width(pyenvc.m_width), m_height(pyenvc.m_height), m_frameNum(pyenvc.m_frameNum),
+    m_eBufferFormat(pyenvc.m_eBufferFormat), m_bUseCPUInutBuffer(pyenvc.m_bUseCPUInutBuffer), m_encodeGUID(pyenvc.m_encodeGUID),
+    m_gpuId(pyenvc.m_gpuId), m_sessionKey(std::move(pyenvc.m_sessionKey)), m_bPipelined(pyenvc.m_bPipelined),
+    m_vStagingBuffers(std::move(pyenvc.m_vStagingBuffers)), m_iStagingBuffer(pyenvc.m_iStagingBuffer),
+    m_mapHostBuffers(std::move(pyenvc.m_mapHostBuffers)), pCUStream(std::move(pyenvc.pCUStream)),
+    m_EncReconfigureParams(pyenvc.m_EncReconfigureParams), m_encoder(std::move(pyenvc.m_encoder))
+{
+    // the moved from encoder owns neither the session nor the host buffers registered with it
+    pyenvc.m_mapHostBuffers.clear();
+    m_bFrameStats = pyenvc.m_bFrameStats;
+    if (m_encoder)
+    {
+        InstallFrameStatsCallback();
+    }
 }
 
 PyNvEncoder::PyNvEncoder(
@@ -75,6 +130,17 @@ PyNvEncoder::PyNvEncoder(
     {
         m_gpuId = stoi(options["gpu_id"].c_str());
     }
+    if (options.count("registered_inputs") == 1)
+    {
+        m_nMaxRegisteredInputs = stoi(options["registered_inputs"].c_str());
+    }
+    bool bMotionEstimationOnly = false;
+    if (options.count("me_only") == 1)
+    {
+        bMotionEstimationOnly = stoi(options["me_only"].c_str()) != 0;
+    }
+    bool bBlockStats = options.count("block_stats") == 1 && stoi(options["block_stats"].c_str()) != 0;
+    m_bFrameStats = bBlockStats || (options.count("frame_stats") == 1 && stoi(options["frame_stats"].c_str()) != 0);
     NV_ENC_BUFFER_FORMAT eBufferFormat;
     CUcontext cudacontext =(CUcontext) _cudacontext;
     CUstream cudastream = (CUstream)_cudastream;
@@ -91,6 +157,11 @@ PyNvEncoder::PyNvEncoder(
     params.encodeGUID = (codec == "hevc") ? NV_ENC_CODEC_HEVC_GUID : 
                        (codec == "av1") ? NV_ENC_CODEC_AV1_GUID : 
                        NV_ENC_CODEC_H264_GUID;
+    if (bMotionEstimationOnly && codec != "h264")
+    {
+        // the motion vector layout of the other codecs follows their coding tree, which RunMotionEstimation() does not unpack
+        PYNVVC_THROW_ERROR_UNSUPPORTED("Motion estimation only mode is supported for codec h264 only", NV_ENC_ERR_UNSUPPORTED_PARAM);
+    }
 
     // Check encoder capabilities first
     CUDA_DRVAPI_CALL(cuInit(0));
@@ -113,6 +184,16 @@ PyNvEncoder::PyNvEncoder(
     // Get encoder capabilities using the same approach as PyNvEncoderCaps
     CAPS caps = PyNvEncoderCaps(m_gpuId, codec);
     
+    if (bMotionEstimationOnly && !caps["support_meonly_mode"])
+    {
+        PYNVVC_THROW_ERROR_UNSUPPORTED("Motion estimation only mode is not supported by current encoder", NV_ENC_ERR_UNSUPPORTED_PARAM);
+    }
+
+    if (bBlockStats && !caps["output_block_stats"])
+    {
+        PYNVVC_THROW_ERROR_UNSUPPORTED("Output block stats are not supported by current encoder", NV_ENC_ERR_UNSUPPORTED_PARAM);
+    }
+
     bool supports_444 = caps["support_yuv444_encode"];
     bool supports_10bit = caps["support_10bit_encode"];
     bool supports_422 = false;
@@ -225,16 +306,49 @@ PyNvEncoder::PyNvEncoder(
         CUDA_DRVAPI_CALL(cuCtxPopCurrent(NULL));
     }
 
-    // Create the actual encoder with the validated format
-    m_encoder = std::make_unique<NvEncoderCuda>(cudacontext, cudastream, _width, _height, eBufferFormat);
     options.insert({"fmt", _format});
     options.insert({"s", std::to_string(_width) + "x" + std::to_string(_height)});
     NvEncoderClInterface cliInterface(options);
-    cliInterface.SetupInitParams(params, false, m_encoder->GetApi(), m_encoder->GetEncoder(), false);
-    m_encoder->CreateDefaultEncoderParams(&params, params.encodeGUID, params.presetGUID, params.tuningInfo);
-    m_encoder->CreateEncoder(&params);
+    m_sessionKey = EncoderSessionCache::Key(m_gpuId, codec, _width, _height, eBufferFormat,
+        options.count("preset") ? options["preset"] : "", options.count("tuning_info") ? options["tuning_info"] : "");
+
+    // Reuse an idle session with the same key if the session cache is enabled, otherwise create the encoder
+    auto tStart = steady_clock::now();
+    if (m_ReleasePrimaryContext && !bMotionEstimationOnly)
+    {
+        m_encoder = AcquireCachedSession(options, cliInterface, params);
+    }
+    if (m_encoder)
+    {
+        EncoderSessionCache::Instance().RecordReuse(duration<double, std::milli>(steady_clock::now() - tStart).count());
+    }
+    else
+    {
+        if (bMotionEstimationOnly)
+        {
+            // RunMotionEstimation() returns the vectors of each frame right away, which requires a session without output delay
+            m_encoder = std::make_unique<NvEncoderCuda>(cudacontext, cudastream, _width, _height, eBufferFormat, 0, true);
+        }
+        else
+        {
+            m_encoder = std::make_unique<NvEncoderCuda>(cudacontext, cudastream, _width, _height, eBufferFormat);
+        }
+        cliInterface.SetupInitParams(params, false, m_encoder->GetApi(), m_encoder->GetEncoder(), false);
+        m_encoder->CreateDefaultEncoderParams(&params, params.encodeGUID, params.presetGUID, params.tuningInfo);
+        ApplyMaxResolution(options, params);
+        ApplyOutputStats(options, params);
+        if (bMotionEstimationOnly)
+        {
+            params.encodeConfig->frameIntervalP = 1;
+            params.encodeConfig->rcParams.enableLookahead = 0;
+            params.encodeConfig->rcParams.lookaheadDepth = 0;
+        }
+        m_encoder->CreateEncoder(&params);
+        EncoderSessionCache::Instance().RecordCreate(duration<double, std::milli>(steady_clock::now() - tStart).count());
+    }
 
     pCUStream.reset(new NvCUStream(cudacontext, cudastream, m_encoder));
+    InstallFrameStatsCallback();
     InitEncodeReconfigureParams(params);
     m_encodeGUID = params.encodeGUID;
     m_CUcontext = cudacontext;
@@ -243,7 +357,6 @@ PyNvEncoder::PyNvEncoder(
     m_height = _height;
     m_eBufferFormat = eBufferFormat;
     m_bUseCPUInutBuffer = bUseCPUInutBuffer;
-    m_mapPtr.clear();
 }
 
 void PyNvEncoder::InitEncodeReconfigureParams(const NV_ENC_INITIALIZE_PARAMS params)
@@ -258,6 +371,13 @@ void PyNvEncoder::InitEncodeReconfigureParams(const NV_ENC_INITIALIZE_PARAMS par
     m_EncReconfigureParams.vbvInitialDelay = reconfigRCParams.vbvInitialDelay;
     m_EncReconfigureParams.frameRateNum = params.frameRateNum;
     m_EncReconfigureParams.frameRateDen = params.frameRateDen;
+    m_EncReconfigureParams.encodeWidth = params.encodeWidth;
+    m_EncReconfigureParams.encodeHeight = params.encodeHeight;
+    m_EncReconfigureParams.gopLength = params.encodeConfig->gopLength;
+    m_EncReconfigureParams.idrPeriod = GetIdrPeriod(*params.encodeConfig, params.encodeGUID);
+    m_EncReconfigureParams.constQPInterP = reconfigRCParams.constQP.qpInterP;
+    m_EncReconfigureParams.constQPInterB = reconfigRCParams.constQP.qpInterB;
+    m_EncReconfigureParams.constQPIntra = reconfigRCParams.constQP.qpIntra;
 }
 
 structEncodeReconfigureParams PyNvEncoder::GetEncodeReconfigureParams()
@@ -271,95 +391,70 @@ structEncodeReconfigureParams PyNvEncoder::GetEncodeReconfigureParams()
     reconfigureParams.vbvInitialDelay = m_EncReconfigureParams.vbvInitialDelay;
     reconfigureParams.frameRateNum = m_EncReconfigureParams.frameRateNum;
     reconfigureParams.frameRateDen = m_EncReconfigureParams.frameRateDen;
+    reconfigureParams.encodeWidth = m_EncReconfigureParams.encodeWidth;
+    reconfigureParams.encodeHeight = m_EncReconfigureParams.encodeHeight;
+    reconfigureParams.gopLength = m_EncReconfigureParams.gopLength;
+    reconfigureParams.idrPeriod = m_EncReconfigureParams.idrPeriod;
+    reconfigureParams.constQPInterP = m_EncReconfigureParams.constQPInterP;
+    reconfigureParams.constQPInterB = m_EncReconfigureParams.constQPInterB;
+    reconfigureParams.constQPIntra = m_EncReconfigureParams.constQPIntra;
     return reconfigureParams;
 }
 
 
-const NvEncInputFrame* PyNvEncoder::GetEncoderInputFromCPUBuffer(py::array_t<uint8_t, py::array::c_style | py::array::forcecast> framedata)
+EncoderInput PyNvEncoder::ParseEncoderInputFromCPUBuffer(py::array_t<uint8_t, py::array::c_style | py::array::forcecast> framedata,
+    NV_ENC_BUFFER_FORMAT eBufferFormat, size_t width, size_t height)
 {
-    auto encoderInputFrame = m_encoder->GetNextInputFrame();
     void* srcPtr = (void*)framedata.data(0);
     uint32_t srcStride = 0;
-    uint32_t srcChromaOffsets[2];
 
-    switch (m_eBufferFormat)
+    switch (eBufferFormat)
     {
     case NV_ENC_BUFFER_FORMAT_NV12:
-    {   
-        srcChromaOffsets[0] = m_width * m_height;
-        break;
-    }
     case NV_ENC_BUFFER_FORMAT_YUV444:
-    {
-        srcChromaOffsets[0] = (m_width * m_height);
-        srcChromaOffsets[1] = 2 * (m_width * m_height);
-        break;
-    }
     case NV_ENC_BUFFER_FORMAT_YUV444_10BIT:
-    {
-        srcChromaOffsets[0] = 2* (m_width * m_height);
-        srcChromaOffsets[1] = 4 * (m_width * m_height);
-        break;
-    }
     case NV_ENC_BUFFER_FORMAT_YUV420_10BIT:
-    {
-        srcChromaOffsets[0] = m_width * m_height;
-        break;
-    }
     case NV_ENC_BUFFER_FORMAT_YV12:
-    {
-        srcChromaOffsets[0] = (m_width * m_height);
-        break;
-    }
-    case NV_ENC_BUFFER_FORMAT_ARGB10:
-    {
-        PYNVVC_THROW_ERROR_UNSUPPORTED("ARGB10 format not supported in current release. Use YUV444_16BIT or P010", NV_ENC_ERR_INVALID_PARAM);
-        break;
-    }
     case NV_ENC_BUFFER_FORMAT_ABGR:
     case NV_ENC_BUFFER_FORMAT_ARGB:
-    {
-        srcChromaOffsets[0] = 0;
-        break;
-    }
 #if CHECK_API_VERSION(13,0)
     case NV_ENC_BUFFER_FORMAT_NV16:
     case NV_ENC_BUFFER_FORMAT_P210:
+#endif
+        break;
+    case NV_ENC_BUFFER_FORMAT_ARGB10:
     {
-        srcChromaOffsets[0] = m_width * m_height;
+        PYNVVC_THROW_ERROR_UNSUPPORTED("ARGB10 format not supported in current release. Use YUV444_16BIT or P010", NV_ENC_ERR_INVALID_PARAM);
         break;
     }
-#endif
     default:
         PYNVVC_THROW_ERROR_UNSUPPORTED("Format not supported", NV_ENC_ERR_INVALID_PARAM);
     }
 
-    NvEncoderCuda::CopyToDeviceFrame(m_CUcontext,
-        (void*)srcPtr,
-        srcStride,
-        (CUdeviceptr)encoderInputFrame->inputPtr,
-        (int)encoderInputFrame->pitch,
-        m_encoder->GetEncodeWidth(),
-        m_encoder->GetEncodeHeight(),
-        CU_MEMORYTYPE_HOST,
-        encoderInputFrame->bufferFormat,
-        encoderInputFrame->chromaOffsets,
-        encoderInputFrame->numChromaPlanes,
-        false,
-        nullptr,
-        srcChromaOffsets
-    );
-    return encoderInputFrame;
+    // CPU frames are tightly packed, the chroma planes follow the luma rows
+    std::vector<uint32_t> srcChromaOffsets;
+    NvEncoder::GetChromaSubPlaneOffsets(eBufferFormat, NvEncoder::GetWidthInBytes(eBufferFormat, (uint32_t)width), (uint32_t)height, srcChromaOffsets);
+    EncoderInput input;
+    input.pSrc = srcPtr;
+    input.nSrcStride = srcStride;
+    for (size_t i = 0; i < srcChromaOffsets.size() && i < 2; i++)
+    {
+        input.srcChromaOffsets[i] = srcChromaOffsets[i];
+    }
+    input.memoryType = CU_MEMORYTYPE_HOST;
+    input.nBytes = framedata.nbytes();
+    input.keepAlive = framedata;
+    return input;
 }
 
-const NvEncInputFrame* PyNvEncoder::GetEncoderInput(py::object frame)
+EncoderInput PyNvEncoder::ParseEncoderInput(py::object frame, NV_ENC_BUFFER_FORMAT eBufferFormat, size_t width, size_t height, CUstream stream)
 {
-    auto encoderInputFrame = m_encoder->GetNextInputFrame();
     void * srcPtr = nullptr;
     uint32_t srcStride = 0;
-    uint32_t srcChromaOffsets[2];
+    uint32_t srcChromaOffsets[2] = {};
+    uint32_t numSrcChromaOffsets = 0;
 
-    if(m_eBufferFormat == NV_ENC_BUFFER_FORMAT_YUV420_10BIT || m_eBufferFormat == NV_ENC_BUFFER_FORMAT_NV12 || m_eBufferFormat == NV_ENC_BUFFER_FORMAT_IYUV)
+    if(eBufferFormat == NV_ENC_BUFFER_FORMAT_YUV420_10BIT || eBufferFormat == NV_ENC_BUFFER_FORMAT_NV12 || eBufferFormat == NV_ENC_BUFFER_FORMAT_IYUV)
     {
         //YUV420_10BIT is actually P010 format
         if (py::hasattr(frame, "__dlpack__"))
@@ -374,18 +469,18 @@ const NvEncInputFrame* PyNvEncoder::GetEncoderInput(py::object frame)
                 }
             }
             int64_t consumer_stream = 0;
-            if (m_CUstream == CU_STREAM_LEGACY)
+            if (stream == CU_STREAM_LEGACY)
             {
                 consumer_stream = 1;
             }
             // We mostly dont need this. The else part should take care
-            else if (m_CUstream == CU_STREAM_PER_THREAD)
+            else if (stream == CU_STREAM_PER_THREAD)
             {
                 consumer_stream = 2;
             }
             else
             {
-                consumer_stream = reinterpret_cast<int64_t>(m_CUstream);
+                consumer_stream = reinterpret_cast<int64_t>(stream);
             }
             py::capsule cap = frame.attr("__dlpack__")(consumer_stream).cast<py::capsule>();
             if (auto* tensor = static_cast<DLManagedTensor*>(cap.get_pointer()))
@@ -394,25 +489,26 @@ const NvEncInputFrame* PyNvEncoder::GetEncoderInput(py::object frame)
                 py::tuple shape(tensor->dl_tensor.ndim);//assuming its a CHW tensor, so tensor height should be 1.5 times actual height
                 int64_t tensorWidth = tensor->dl_tensor.shape[1];
                 int64_t tensorHeight = tensor->dl_tensor.shape[0];
-                if (tensorHeight != (m_height * 1.5))
+                if (tensorHeight != (height * 1.5))
                 {
                     std::string error = "Tensor height :";
                     error.append(std::to_string(tensorHeight));
                     error.append(" must be 1.5 times the actual height :");
-                    error.append(std::to_string(m_height));
+                    error.append(std::to_string(height));
                     error.append(" passed to encoder.");
                     PYNVVC_THROW_ERROR(error, NV_ENC_ERR_INVALID_PARAM);
                 }
                 srcStride = tensor->dl_tensor.strides[0] * tensor->dl_tensor.dtype.bits / 8;
-                srcChromaOffsets[0] = m_width * m_height * tensor->dl_tensor.dtype.bits / 8;;
+                srcChromaOffsets[0] = srcStride * height;
+                numSrcChromaOffsets = 1;
             }
         }
         else
         {
-            CAIMemoryView yPlane = coerceToCudaArrayView(frame.attr("__getitem__")(0), m_eBufferFormat, m_width, m_height, 0);
-            CAIMemoryView uvPlane = coerceToCudaArrayView(frame.attr("__getitem__")(1), m_eBufferFormat, m_width, m_height, 1);
+            CAIMemoryView yPlane = coerceToCudaArrayView(frame.attr("__getitem__")(0), eBufferFormat, width, height, 0);
+            CAIMemoryView uvPlane = coerceToCudaArrayView(frame.attr("__getitem__")(1), eBufferFormat, width, height, 1);
 
-            if (m_eBufferFormat == NV_ENC_BUFFER_FORMAT_IYUV)
+            if (eBufferFormat == NV_ENC_BUFFER_FORMAT_IYUV)
             {
                 if (yPlane.stride[0] != (uvPlane.stride[0] * 2 ))
                 {
@@ -434,18 +530,19 @@ const NvEncInputFrame* PyNvEncoder::GetEncoderInput(py::object frame)
                 PYNVVC_THROW_ERROR("Unsupported surface allocation. u plane must follow yplane.", NV_ENC_ERR_INVALID_PARAM);
             }
             srcChromaOffsets[0] = static_cast<uint32_t>(uvPlane.data - yPlane.data);
+            numSrcChromaOffsets = 1;
         }
     }
-    else if(m_eBufferFormat == NV_ENC_BUFFER_FORMAT_ARGB || m_eBufferFormat == NV_ENC_BUFFER_FORMAT_ABGR 
-            || m_eBufferFormat == NV_ENC_BUFFER_FORMAT_ARGB10 || m_eBufferFormat == NV_ENC_BUFFER_FORMAT_ABGR10)
+    else if(eBufferFormat == NV_ENC_BUFFER_FORMAT_ARGB || eBufferFormat == NV_ENC_BUFFER_FORMAT_ABGR 
+            || eBufferFormat == NV_ENC_BUFFER_FORMAT_ARGB10 || eBufferFormat == NV_ENC_BUFFER_FORMAT_ABGR10)
     {
-        CAIMemoryView argb = coerceToCudaArrayView(frame, m_eBufferFormat, m_width, m_height);
+        CAIMemoryView argb = coerceToCudaArrayView(frame, eBufferFormat, width, height);
         srcPtr =(void*) argb.data;
         srcStride = argb.stride[0];
         srcChromaOffsets[0] = 0;
     }
-    else if(m_eBufferFormat == NV_ENC_BUFFER_FORMAT_YUV444 || 
-            m_eBufferFormat == NV_ENC_BUFFER_FORMAT_YUV444_10BIT)
+    else if(eBufferFormat == NV_ENC_BUFFER_FORMAT_YUV444 || 
+            eBufferFormat == NV_ENC_BUFFER_FORMAT_YUV444_10BIT)
     {
         if (py::hasattr(frame, "__dlpack__"))
         {
@@ -459,18 +556,18 @@ const NvEncInputFrame* PyNvEncoder::GetEncoderInput(py::object frame)
                 }
             }
             int64_t consumer_stream = 0;
-            if (m_CUstream == CU_STREAM_LEGACY)
+            if (stream == CU_STREAM_LEGACY)
             {
                 consumer_stream = 1;
             }
             // We mostly dont need this. The else part should take care
-            else if (m_CUstream == CU_STREAM_PER_THREAD)
+            else if (stream == CU_STREAM_PER_THREAD)
             {
                 consumer_stream = 2;
             }
             else
             {
-                consumer_stream = reinterpret_cast<int64_t>(m_CUstream);
+                consumer_stream = reinterpret_cast<int64_t>(stream);
             }
             py::capsule cap = frame.attr("__dlpack__")(consumer_stream).cast<py::capsule>();
             if (auto* tensor = static_cast<DLManagedTensor*>(cap.get_pointer()))
@@ -479,25 +576,26 @@ const NvEncInputFrame* PyNvEncoder::GetEncoderInput(py::object frame)
                 py::tuple shape(tensor->dl_tensor.ndim);//assuming its a CHW tensor, so tensor height should be 3 times actual height
                 int64_t tensorWidth = tensor->dl_tensor.shape[1];
                 int64_t tensorHeight = tensor->dl_tensor.shape[0];
-                if (tensorHeight != (m_height * 3))
+                if (tensorHeight != (height * 3))
                 {
                     std::string error = "Tensor height :";
                     error.append(std::to_string(tensorHeight));
                     error.append(" must be 3 times the actual height :");
-                    error.append(std::to_string(m_height));
+                    error.append(std::to_string(height));
                     error.append(" passed to encoder.");
                     PYNVVC_THROW_ERROR(error, NV_ENC_ERR_INVALID_PARAM);
                 }
                 srcStride = tensor->dl_tensor.strides[0] * tensor->dl_tensor.dtype.bits / 8;
-                srcChromaOffsets[0] = m_width * m_height * tensor->dl_tensor.dtype.bits / 8 ;
-                srcChromaOffsets[1] = 2 * m_width * m_height * tensor->dl_tensor.dtype.bits / 8;
+                srcChromaOffsets[0] = srcStride * height;
+                srcChromaOffsets[1] = 2 * srcStride * height;
+                numSrcChromaOffsets = 2;
             }
         }
         else
         {
-            CAIMemoryView yPlane = coerceToCudaArrayView(frame.attr("__getitem__")(0), m_eBufferFormat, m_width, m_height, 0);
-            CAIMemoryView uPlane = coerceToCudaArrayView(frame.attr("__getitem__")(1), m_eBufferFormat, m_width, m_height, 1);
-            CAIMemoryView vPlane = coerceToCudaArrayView(frame.attr("__getitem__")(2), m_eBufferFormat, m_width, m_height, 2);
+            CAIMemoryView yPlane = coerceToCudaArrayView(frame.attr("__getitem__")(0), eBufferFormat, width, height, 0);
+            CAIMemoryView uPlane = coerceToCudaArrayView(frame.attr("__getitem__")(1), eBufferFormat, width, height, 1);
+            CAIMemoryView vPlane = coerceToCudaArrayView(frame.attr("__getitem__")(2), eBufferFormat, width, height, 2);
             if (uPlane.stride[0] != vPlane.stride[0])
             {
                 PYNVVC_THROW_ERROR("unsupported argument : strides of  u, v must match", NV_ENC_ERR_INVALID_PARAM);
@@ -510,10 +608,11 @@ const NvEncInputFrame* PyNvEncoder::GetEncoderInput(py::object frame)
             }
             srcChromaOffsets[0] = uPlane.data - yPlane.data;
             srcChromaOffsets[1] = vPlane.data - yPlane.data;
+            numSrcChromaOffsets = 2;
         }
     }
 #if CHECK_API_VERSION(13,0)
-    else if (m_eBufferFormat == NV_ENC_BUFFER_FORMAT_NV16 || m_eBufferFormat == NV_ENC_BUFFER_FORMAT_P210)
+    else if (eBufferFormat == NV_ENC_BUFFER_FORMAT_NV16 || eBufferFormat == NV_ENC_BUFFER_FORMAT_P210)
     {
         if (py::hasattr(frame, "__dlpack__"))
         {
@@ -527,18 +626,18 @@ const NvEncInputFrame* PyNvEncoder::GetEncoderInput(py::object frame)
                 }
             }
             int64_t consumer_stream = 0;
-            if (m_CUstream == CU_STREAM_LEGACY)
+            if (stream == CU_STREAM_LEGACY)
             {
                 consumer_stream = 1;
             }
             // We mostly dont need this. The else part should take care
-            else if (m_CUstream == CU_STREAM_PER_THREAD)
+            else if (stream == CU_STREAM_PER_THREAD)
             {
                 consumer_stream = 2;
             }
             else
             {
-                consumer_stream = reinterpret_cast<int64_t>(m_CUstream);
+                consumer_stream = reinterpret_cast<int64_t>(stream);
             }
             py::capsule cap = frame.attr("__dlpack__")(consumer_stream).cast<py::capsule>();
             if (auto* tensor = static_cast<DLManagedTensor*>(cap.get_pointer()))
@@ -547,23 +646,24 @@ const NvEncInputFrame* PyNvEncoder::GetEncoderInput(py::object frame)
                 py::tuple shape(tensor->dl_tensor.ndim);//assuming its a CHW tensor, so tensor height should be 2 times actual height
                 int64_t tensorWidth = tensor->dl_tensor.shape[1];
                 int64_t tensorHeight = tensor->dl_tensor.shape[0];
-                if (tensorHeight != (m_height * 2))
+                if (tensorHeight != (height * 2))
                 {
                     std::string error = "Tensor height :";
                     error.append(std::to_string(tensorHeight));
                     error.append(" must be 2 times the actual height :");
-                    error.append(std::to_string(m_height));
+                    error.append(std::to_string(height));
                     error.append(" passed to encoder.");
                     PYNVVC_THROW_ERROR(error, NV_ENC_ERR_INVALID_PARAM);
                 }
                 srcStride = tensor->dl_tensor.strides[0] * tensor->dl_tensor.dtype.bits / 8;
-                srcChromaOffsets[0] = m_width * m_height * tensor->dl_tensor.dtype.bits / 8;
+                srcChromaOffsets[0] = srcStride * height;
+                numSrcChromaOffsets = 1;
             }
         }
         else
         {
-            CAIMemoryView yPlane = coerceToCudaArrayView(frame.attr("__getitem__")(0), m_eBufferFormat, m_width, m_height, 0);
-            CAIMemoryView uvPlane = coerceToCudaArrayView(frame.attr("__getitem__")(1), m_eBufferFormat, m_width, m_height, 1);
+            CAIMemoryView yPlane = coerceToCudaArrayView(frame.attr("__getitem__")(0), eBufferFormat, width, height, 0);
+            CAIMemoryView uvPlane = coerceToCudaArrayView(frame.attr("__getitem__")(1), eBufferFormat, width, height, 1);
 
             srcPtr = (void*)yPlane.data;
             srcStride = yPlane.stride[0];
@@ -572,6 +672,7 @@ const NvEncInputFrame* PyNvEncoder::GetEncoderInput(py::object frame)
                 PYNVVC_THROW_ERROR("Unsupported surface allocation. uv plane must follow yplane.", NV_ENC_ERR_INVALID_PARAM);
             }
             srcChromaOffsets[0] = static_cast<uint32_t>(uvPlane.data - yPlane.data);
+            numSrcChromaOffsets = 1;
         }
     }
 #endif
@@ -579,9 +680,51 @@ const NvEncInputFrame* PyNvEncoder::GetEncoderInput(py::object frame)
     {
         PYNVVC_THROW_ERROR_UNSUPPORTED("unsupported format.", NV_ENC_ERR_INVALID_PARAM);
     }
+
+    // The planes may lie anywhere after the luma plane. A plane not located by the input, such as the V plane
+    // of a two plane IYUV input, follows the previous one as in a contiguous frame.
+    std::vector<uint32_t> contiguousChromaOffsets;
+    NvEncoder::GetChromaSubPlaneOffsets(eBufferFormat, srcStride, height, contiguousChromaOffsets);
+    EncoderInput input;
+    input.pSrc = srcPtr;
+    input.nSrcStride = srcStride;
+    for (uint32_t i = 0; i < contiguousChromaOffsets.size() && i < 2; i++)
+    {
+        if (i < numSrcChromaOffsets)
+        {
+            input.srcChromaOffsets[i] = srcChromaOffsets[i];
+        }
+        else
+        {
+            uint32_t nPrevious = i ? input.srcChromaOffsets[i - 1] : 0;
+            uint32_t nContiguousPrevious = i ? contiguousChromaOffsets[i - 1] : 0;
+            input.srcChromaOffsets[i] = nPrevious + contiguousChromaOffsets[i] - nContiguousPrevious;
+        }
+        input.bContiguous = input.bContiguous && input.srcChromaOffsets[i] == contiguousChromaOffsets[i];
+    }
+    input.memoryType = CU_MEMORYTYPE_DEVICE;
+    input.keepAlive = frame;
+    return input;
+}
+
+// Does not touch Python objects, so it can run with the GIL released
+const NvEncInputFrame* PyNvEncoder::WriteEncoderInput(const EncoderInput& input)
+{
+    if (input.memoryType == CU_MEMORYTYPE_HOST)
+    {
+        return WriteHostEncoderInput(input);
+    }
+    auto encoderInputFrame = m_encoder->GetNextInputFrame();
+    // A registered resource is described by its base pointer and pitch only, so its planes must be contiguous
+    NV_ENC_REGISTERED_PTR registeredInput = input.bContiguous ? GetRegisteredInput((CUdeviceptr)input.pSrc, input.nSrcStride) : nullptr;
+    if (registeredInput)
+    {
+        m_encoder->SetNextInputResource(registeredInput);
+        return encoderInputFrame;
+    }
     NvEncoderCuda::CopyToDeviceFrame(m_CUcontext, 
-        (void*) srcPtr,
-        srcStride,
+        input.pSrc,
+        input.nSrcStride,
         (CUdeviceptr) encoderInputFrame->inputPtr,
         (int) encoderInputFrame->pitch,
         m_encoder->GetEncodeWidth(),
@@ -592,223 +735,739 @@ const NvEncInputFrame* PyNvEncoder::GetEncoderInput(py::object frame)
         encoderInputFrame->numChromaPlanes,
         false,
         m_CUstream,
-        srcChromaOffsets
+        input.srcChromaOffsets
         );
     return encoderInputFrame;
 }
 
-py::bytes PyNvEncoder::Encode(py::object _frame)
+// Pageable memory cannot be uploaded asynchronously. Host frames are copied to a pinned staging buffer and
+// uploaded on m_CUstream, which the encoder waits for, unless they lie in a buffer registered with RegisterHostBuffer().
+const NvEncInputFrame* PyNvEncoder::WriteHostEncoderInput(const EncoderInput& input)
 {
-    py::object frame = _frame;
-    std::vector<NvEncOutputFrame> vvByte;
+    size_t nFrameBytes = m_encoder->GetFrameSize();
+    if (input.nBytes < nFrameBytes)
+    {
+        PYNVVC_THROW_ERROR("CPU input buffer is smaller than the frame", NV_ENC_ERR_INVALID_PARAM);
+    }
+    auto encoderInputFrame = m_encoder->GetNextInputFrame();
+    bool bRegistered = IsHostBufferRegistered(input.pSrc, nFrameBytes);
+    void* pSrc = input.pSrc;
 
-    if(hasattr(frame, "cuda"))
+    CUDA_DRVAPI_CALL(cuCtxPushCurrent(m_CUcontext));
+    if (m_vStagingBuffers.empty())
     {
-        frame = frame.attr("cuda")();
-        GetEncoderInput(frame);
+        m_vStagingBuffers.resize(NUM_STAGING_BUFFERS);
     }
-    else
+    // Uploads from registered buffers take a slot of the ring as well, only to track their completion
+    HostStagingBuffer* pStaging = &m_vStagingBuffers[m_iStagingBuffer];
+    m_iStagingBuffer = (m_iStagingBuffer + 1) % m_vStagingBuffers.size();
+    if (!pStaging->event)
+    {
+        CUDA_DRVAPI_CALL(cuEventCreate(&pStaging->event, CU_EVENT_DISABLE_TIMING));
+    }
+    // The slot is free once the upload issued NUM_STAGING_BUFFERS frames ago has completed
+    CUDA_DRVAPI_CALL(cuEventSynchronize(pStaging->event));
+    if (!bRegistered)
     {
-        if (!m_bUseCPUInutBuffer)
+        if (pStaging->nBytes < nFrameBytes)
         {
-            PYNVVC_THROW_ERROR("incorrect usage of CPU inut buffer", NV_ENC_ERR_INVALID_PARAM);
+            if (pStaging->pHost)
+            {
+                CUDA_DRVAPI_CALL(cuMemFreeHost(pStaging->pHost));
+                pStaging->pHost = nullptr;
+                pStaging->nBytes = 0;
+            }
+            CUDA_DRVAPI_CALL(cuMemAllocHost(&pStaging->pHost, nFrameBytes));
+            pStaging->nBytes = nFrameBytes;
         }
-        GetEncoderInputFromCPUBuffer(frame);
+        memcpy(pStaging->pHost, input.pSrc, nFrameBytes);
+        pSrc = pStaging->pHost;
     }
-    py::gil_scoped_release release;
-    NV_ENC_PIC_PARAMS picParam = { 0 };
-    picParam.inputTimeStamp = m_frameNum++;
-    
-    m_encoder->EncodeFrame(vvByte, &picParam);
 
-    size_t totalSize = 0;
+    NvEncoderCuda::CopyToDeviceFrame(m_CUcontext,
+        pSrc,
+        input.nSrcStride,
+        (CUdeviceptr)encoderInputFrame->inputPtr,
+        (int)encoderInputFrame->pitch,
+        m_encoder->GetEncodeWidth(),
+        m_encoder->GetEncodeHeight(),
+        CU_MEMORYTYPE_HOST,
+        encoderInputFrame->bufferFormat,
+        encoderInputFrame->chromaOffsets,
+        encoderInputFrame->numChromaPlanes,
+        false,
+        m_CUstream,
+        input.srcChromaOffsets
+    );
+    // A frame of a registered buffer may be overwritten once NUM_STAGING_BUFFERS more frames have been written
+    CUDA_DRVAPI_CALL(cuEventRecord(pStaging->event, m_CUstream));
+    CUDA_DRVAPI_CALL(cuCtxPopCurrent(NULL));
+    return encoderInputFrame;
+}
 
-    for (const auto& vByte : vvByte) {
-        totalSize += vByte.frame.size();
+bool PyNvEncoder::IsHostBufferRegistered(const void* pData, size_t nBytes) const
+{
+    const uint8_t* p = static_cast<const uint8_t*>(pData);
+    auto it = m_mapHostBuffers.upper_bound(p);
+    if (it == m_mapHostBuffers.begin())
+    {
+        return false;
     }
+    --it;
+    return p + nBytes <= it->first + it->second;
+}
 
-    // Allocate a single buffer
+static size_t GetContiguousBufferSize(const py::buffer_info& info)
+{
+    py::ssize_t nStride = info.itemsize;
+    for (py::ssize_t i = info.ndim - 1; i >= 0; i--)
+    {
+        if (info.shape[i] > 1 && info.strides[i] != nStride)
+        {
+            PYNVVC_THROW_ERROR("Host buffer must be C-contiguous", NV_ENC_ERR_INVALID_PARAM);
+        }
+        nStride *= info.shape[i];
+    }
+    return (size_t)info.size * info.itemsize;
+}
 
-    std::unique_ptr<char[]> buffer(new char[totalSize]);
-    size_t offset = 0;
+void PyNvEncoder::RegisterHostBuffer(py::buffer buffer)
+{
+    py::buffer_info info = buffer.request();
+    size_t nBytes = GetContiguousBufferSize(info);
+    const uint8_t* pData = static_cast<const uint8_t*>(info.ptr);
+    if (!nBytes || IsHostBufferRegistered(pData, nBytes))
+    {
+        return;
+    }
+    CUDA_DRVAPI_CALL(cuCtxPushCurrent(m_CUcontext));
+    CUDA_DRVAPI_CALL(cuMemHostRegister(info.ptr, nBytes, 0));
+    CUDA_DRVAPI_CALL(cuCtxPopCurrent(NULL));
+    m_mapHostBuffers[pData] = nBytes;
+}
+
+void PyNvEncoder::UnregisterHostBuffer(py::buffer buffer)
+{
+    py::buffer_info info = buffer.request();
+    auto it = m_mapHostBuffers.find(static_cast<const uint8_t*>(info.ptr));
+    if (it == m_mapHostBuffers.end())
+    {
+        return;
+    }
+    CUDA_DRVAPI_CALL(cuCtxPushCurrent(m_CUcontext));
+    // an upload from the buffer may still be in flight
+    CUDA_DRVAPI_CALL(cuStreamSynchronize(m_CUstream));
+    CUDA_DRVAPI_CALL(cuMemHostUnregister(info.ptr));
+    CUDA_DRVAPI_CALL(cuCtxPopCurrent(NULL));
+    m_mapHostBuffers.erase(it);
+}
 
-    for (const auto& vByte : vvByte) {
-        if (vByte.frame.size() > 0) {
-            std::memcpy(buffer.get() + offset, vByte.frame.data(), vByte.frame.size());
-            offset += vByte.frame.size();
+void PyNvEncoder::ReleaseHostBuffers()
+{
+    if (!m_CUcontext || (m_vStagingBuffers.empty() && m_mapHostBuffers.empty()))
+    {
+        return;
+    }
+    cuCtxPushCurrent(m_CUcontext);
+    for (HostStagingBuffer& staging : m_vStagingBuffers)
+    {
+        if (staging.event)
+        {
+            cuEventSynchronize(staging.event);
+            cuEventDestroy(staging.event);
+        }
+        if (staging.pHost)
+        {
+            cuMemFreeHost(staging.pHost);
         }
     }
+    m_vStagingBuffers.clear();
+    for (auto& hostBuffer : m_mapHostBuffers)
+    {
+        cuMemHostUnregister(const_cast<uint8_t*>(hostBuffer.first));
+    }
+    m_mapHostBuffers.clear();
+    cuCtxPopCurrent(NULL);
+}
 
-    py::gil_scoped_acquire acquire;
-    return py::bytes(buffer.get(), totalSize);
+std::unique_ptr<NvEncoderCuda> PyNvEncoder::AcquireCachedSession(const std::map<std::string, std::string>& options,
+    NvEncoderClInterface& cliInterface, NV_ENC_INITIALIZE_PARAMS& params)
+{
+    std::unique_ptr<NvEncoderCuda> encoder = EncoderSessionCache::Instance().Acquire(m_sessionKey);
+    if (!encoder)
+    {
+        return nullptr;
+    }
+    // This encoder already holds a reference to the primary context, drop the one the cache held
+    cuDevicePrimaryCtxRelease(m_gpuId);
 
+    NV_ENC_INITIALIZE_PARAMS savedParams = params;
+    NV_ENC_CONFIG savedConfig = *params.encodeConfig;
+    try
+    {
+        cliInterface.SetupInitParams(params, false, encoder->GetApi(), encoder->GetEncoder(), false);
+        encoder->CreateDefaultEncoderParams(&params, params.encodeGUID, params.presetGUID, params.tuningInfo);
+        ApplyMaxResolution(options, params);
+        ApplyOutputStats(options, params);
+
+        NV_ENC_INITIALIZE_PARAMS currentParams = { NV_ENC_INITIALIZE_PARAMS_VER };
+        NV_ENC_CONFIG currentConfig = { NV_ENC_CONFIG_VER };
+        currentParams.encodeConfig = &currentConfig;
+        encoder->GetInitializeParams(&currentParams);
+        // The buffers of the session are sized for these, they cannot be changed by reconfiguration
+        bool bCompatible = params.encodeConfig->frameIntervalP == currentConfig.frameIntervalP
+            && params.encodeConfig->rcParams.lookaheadDepth == currentConfig.rcParams.lookaheadDepth
+            && params.maxEncodeWidth == currentParams.maxEncodeWidth
+            && params.maxEncodeHeight == currentParams.maxEncodeHeight
+            && params.enableEncodeAsync == currentParams.enableEncodeAsync
+            && params.enableOutputStats == currentParams.enableOutputStats;
+#if CHECK_API_VERSION(13,0)
+        if (params.encodeGUID == NV_ENC_CODEC_HEVC_GUID)
+        {
+            bCompatible = bCompatible && params.encodeConfig->encodeCodecConfig.hevcConfig.enableMVHEVC
+                == currentConfig.encodeCodecConfig.hevcConfig.enableMVHEVC;
+        }
+#endif
+        if (bCompatible)
+        {
+            NV_ENC_RECONFIGURE_PARAMS reconfigureParams = { NV_ENC_RECONFIGURE_PARAMS_VER };
+            reconfigureParams.reInitEncodeParams = params;
+            reconfigureParams.resetEncoder = 1;
+            reconfigureParams.forceIDR = 1;
+            encoder->Reconfigure(&reconfigureParams);
+            return encoder;
+        }
+    }
+    catch (const std::exception& e)
+    {
+        LOG(WARNING) << "Cached encoder session could not be reinitialized, creating a new one: " << e.what() << std::endl;
+    }
+    // Not reusable: the session is destroyed and a new one is created from the original parameters
+    encoder.reset();
+    params = savedParams;
+    *params.encodeConfig = savedConfig;
+    return nullptr;
 }
 
-// For Encode with pic flags and SEI
-py::bytes PyNvEncoder::Encode(py::object _frame, uint8_t m_picFlags, SEI_MESSAGE sei)
+bool PyNvEncoder::ReleaseToSessionCache()
 {
-    py::object frame = _frame;
-    std::vector<NvEncOutputFrame> vvByte;
+    if (!m_encoder || m_bPipelined || m_encoder->IsMotionEstimationOnly() || EncoderSessionCache::Instance().GetCapacity() == 0)
+    {
+        return false;
+    }
+    try
+    {
+        // Drop the frames still queued and the caller frames registered with the session
+        m_encoder->EndEncode([](const uint8_t*, size_t, bool) {});
+        ReleaseRegisteredInputs();
+        m_encoder->StartNewSequence();
+    }
+    catch (...)
+    {
+        return false;
+    }
+    // the callback refers to this encoder
+    m_encoder->SetFrameStatsCallback(nullptr);
+    return EncoderSessionCache::Instance().Release(m_sessionKey, m_encoder);
+}
 
-    if(hasattr(frame, "cuda"))
+void PyNvEncoder::InstallFrameStatsCallback()
+{
+    if (!m_bFrameStats)
     {
-        frame = frame.attr("cuda")();
-        GetEncoderInput(frame);
+        m_encoder->SetFrameStatsCallback(nullptr);
+        return;
     }
-    else
+    m_encoder->SetFrameStatsCallback([this](const NvEncFrameStats& stats) {
+        std::lock_guard<std::mutex> lock(m_mtxFrameStats);
+        m_statsHistogram.Add(stats);
+        // stats that are never fetched are dropped, oldest first
+        if (m_qFrameStats.size() >= MAX_QUEUED_FRAME_STATS)
+        {
+            m_qFrameStats.pop_front();
+        }
+        m_qFrameStats.push_back(stats);
+    });
+}
+
+// A synchronous call attaches the stats of the packets it wrote, which are the latest ones. Retrieve() runs concurrently
+// with the output thread, which may have reported later frames already, so its packet is looked up by timestamp.
+void PyNvEncoder::TakeFrameStats(EncodedBitstream& bitstream)
+{
+    if (!m_bFrameStats)
+    {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(m_mtxFrameStats);
+    if (m_bPipelined)
     {
-        if (!m_bUseCPUInutBuffer)
+        auto it = std::find_if(m_qFrameStats.begin(), m_qFrameStats.end(),
+            [&bitstream](const NvEncFrameStats& stats) { return stats.timeStamp == bitstream.timestamp; });
+        if (it != m_qFrameStats.end())
         {
-            PYNVVC_THROW_ERROR("incorrect usage of CPU input buffer", NV_ENC_ERR_INVALID_PARAM);
+            bitstream.stats.push_back(std::move(*it));
+            m_qFrameStats.erase(it);
         }
-        GetEncoderInputFromCPUBuffer(frame);
+        return;
     }
+    size_t nStats = std::min(m_qFrameStats.size(), (size_t)bitstream.numPackets);
+    auto itFirst = m_qFrameStats.end() - nStats;
+    bitstream.stats.assign(std::make_move_iterator(itFirst), std::make_move_iterator(m_qFrameStats.end()));
+    m_qFrameStats.erase(itFirst, m_qFrameStats.end());
+}
 
-    py::gil_scoped_release release;
+std::vector<NvEncFrameStats> PyNvEncoder::GetFrameStats()
+{
+    std::lock_guard<std::mutex> lock(m_mtxFrameStats);
+    std::vector<NvEncFrameStats> vStats(std::make_move_iterator(m_qFrameStats.begin()), std::make_move_iterator(m_qFrameStats.end()));
+    m_qFrameStats.clear();
+    return vStats;
+}
 
-    NV_ENC_PIC_PARAMS picParam = { 0 };
-    picParam.inputTimeStamp = m_frameNum++;
-    NV_ENC_SEI_PAYLOAD *pSei = NULL;
+EncoderStatsHistogram PyNvEncoder::GetStatsHistogram()
+{
+    std::lock_guard<std::mutex> lock(m_mtxFrameStats);
+    return m_statsHistogram;
+}
 
-    if (sei.size())
+void PyNvEncoder::ResetStatsHistogram()
+{
+    std::lock_guard<std::mutex> lock(m_mtxFrameStats);
+    m_statsHistogram.Reset();
+}
+
+void PyNvEncoder::ReleaseRegisteredInputs()
+{
+    for (auto& registeredInput : m_lRegisteredInputs)
     {
-        pSei = new NV_ENC_SEI_PAYLOAD[sei.size()];
-        unsigned int i = 0;
-        for (const auto& seimessage : sei) 
+        if (registeredInput.second)
         {
-            auto it = seimessage.first.find("sei_type");
-            if (it != seimessage.first.end())
-            {
-                pSei[i].payloadType = it->second;
-            }
-            else
+            m_encoder->UnregisterInputResource(registeredInput.second);
+        }
+    }
+    m_lRegisteredInputs.clear();
+    m_mapRegisteredInputs.clear();
+}
+
+NV_ENC_REGISTERED_PTR PyNvEncoder::GetRegisteredInput(CUdeviceptr dpFrame, uint32_t nPitch)
+{
+    if (m_nMaxRegisteredInputs == 0)
+    {
+        return nullptr;
+    }
+    RegisteredInputKey key(dpFrame, nPitch, m_eBufferFormat);
+    auto it = m_mapRegisteredInputs.find(key);
+    if (it != m_mapRegisteredInputs.end())
+    {
+        m_lRegisteredInputs.splice(m_lRegisteredInputs.begin(), m_lRegisteredInputs, it->second);
+        return it->second->second;
+    }
+
+    if (m_lRegisteredInputs.size() >= m_nMaxRegisteredInputs)
+    {
+        // Evict the least recently used frame that is not read by a frame in flight
+        auto itEvict = m_lRegisteredInputs.end();
+        for (auto itLru = m_lRegisteredInputs.rbegin(); itLru != m_lRegisteredInputs.rend(); ++itLru)
+        {
+            if (!itLru->second || !m_encoder->IsInputResourceInFlight(itLru->second))
             {
-                continue;
+                itEvict = std::next(itLru).base();
+                break;
             }
-            pSei[i].payloadSize = seimessage.second.size();
-            pSei[i].payload = const_cast<uint8_t*>(reinterpret_cast<const uint8_t*>(seimessage.second.data()));
-            i++;
         }
+        if (itEvict == m_lRegisteredInputs.end())
+        {
+            return nullptr;
+        }
+        if (itEvict->second)
+        {
+            m_encoder->UnregisterInputResource(itEvict->second);
+        }
+        m_mapRegisteredInputs.erase(itEvict->first);
+        m_lRegisteredInputs.erase(itEvict);
+    }
+
+    NV_ENC_REGISTERED_PTR registeredInput = nullptr;
+    try
+    {
+        registeredInput = m_encoder->RegisterResource((void*)dpFrame, NV_ENC_INPUT_RESOURCE_TYPE_CUDADEVICEPTR,
+            m_encoder->GetEncodeWidth(), m_encoder->GetEncodeHeight(), nPitch, m_eBufferFormat);
+    }
+    catch (...)
+    {
+        // The frame is copied instead, without retrying the registration on every encode
+    }
+    m_lRegisteredInputs.emplace_front(key, registeredInput);
+    m_mapRegisteredInputs[key] = m_lRegisteredInputs.begin();
+    return registeredInput;
+}
+
+EncoderInput PyNvEncoder::ParseFrame(py::object frame, NV_ENC_BUFFER_FORMAT eBufferFormat, size_t width, size_t height,
+    CUstream stream, bool bUseCPUInputBuffer)
+{
+    if(hasattr(frame, "cuda"))
+    {
+        frame = frame.attr("cuda")();
+        return ParseEncoderInput(frame, eBufferFormat, width, height, stream);
+    }
+    if (!bUseCPUInputBuffer)
+    {
+        PYNVVC_THROW_ERROR("incorrect usage of CPU input buffer", NV_ENC_ERR_INVALID_PARAM);
+    }
+    return ParseEncoderInputFromCPUBuffer(frame, eBufferFormat, width, height);
+}
+
+EncoderInput PyNvEncoder::ParseFrame(py::object frame)
+{
+    return ParseFrame(frame, m_eBufferFormat, m_width, m_height, m_CUstream, m_bUseCPUInutBuffer);
+}
+
+
+// vSei holds the SEI payloads referenced by picParam, which must outlive the encode call
+void PyNvEncoder::SetPicParams(NV_ENC_PIC_PARAMS& picParam, uint8_t picFlags, const SEI_MESSAGE& sei, std::vector<NV_ENC_SEI_PAYLOAD>& vSei)
+{
+    picParam.inputTimeStamp = m_frameNum++;
+    picParam.encodePicFlags |= picFlags;
+
+    for (const auto& seimessage : sei)
+    {
+        auto it = seimessage.first.find("sei_type");
+        if (it == seimessage.first.end())
+        {
+            continue;
+        }
+        NV_ENC_SEI_PAYLOAD payload = {};
+        payload.payloadType = it->second;
+        payload.payloadSize = seimessage.second.size();
+        payload.payload = const_cast<uint8_t*>(reinterpret_cast<const uint8_t*>(seimessage.second.data()));
+        vSei.push_back(payload);
+    }
+    if (!vSei.empty())
+    {
         if (m_encodeGUID == NV_ENC_CODEC_H264_GUID)
         {
-            picParam.codecPicParams.h264PicParams.seiPayloadArrayCnt = sei.size();
-            picParam.codecPicParams.h264PicParams.seiPayloadArray = pSei;
+            picParam.codecPicParams.h264PicParams.seiPayloadArrayCnt = vSei.size();
+            picParam.codecPicParams.h264PicParams.seiPayloadArray = vSei.data();
         }
         else if (m_encodeGUID == NV_ENC_CODEC_HEVC_GUID)
         {
-            picParam.codecPicParams.hevcPicParams.seiPayloadArrayCnt = sei.size();
-            picParam.codecPicParams.hevcPicParams.seiPayloadArray = pSei;
+            picParam.codecPicParams.hevcPicParams.seiPayloadArrayCnt = vSei.size();
+            picParam.codecPicParams.hevcPicParams.seiPayloadArray = vSei.data();
         }
         else if (m_encodeGUID == NV_ENC_CODEC_AV1_GUID)
         {
-            picParam.codecPicParams.av1PicParams.obuPayloadArrayCnt = sei.size();
-            picParam.codecPicParams.av1PicParams.obuPayloadArray = pSei;
+            picParam.codecPicParams.av1PicParams.obuPayloadArrayCnt = vSei.size();
+            picParam.codecPicParams.av1PicParams.obuPayloadArray = vSei.data();
         }
     }
-    picParam.encodePicFlags |= m_picFlags;
+}
 
-    m_encoder->EncodeFrame(vvByte, &picParam);
+int PyNvEncoder::EncodeTo(py::object frame, uint8_t picFlags, const SEI_MESSAGE& sei, const NvEncBitstreamWriter& fnWrite)
+{
+    EncoderInput input = ParseFrame(frame);
 
-    // Calculate total size
-    size_t totalSize = 0;
-    for (const auto& vByte : vvByte) {
-        totalSize += vByte.frame.size();
-    }
+    py::gil_scoped_release release;
+    WriteEncoderInput(input);
 
-    // Allocate a single buffer
-    std::unique_ptr<char[]> buffer(new char[totalSize]);
-    size_t offset = 0;
-    for (const auto& vByte : vvByte) {
-        if (vByte.frame.size() > 0) {
-            std::memcpy(buffer.get() + offset, vByte.frame.data(), vByte.frame.size());
-            offset += vByte.frame.size();
-        }
+    NV_ENC_PIC_PARAMS picParam = { 0 };
+    std::vector<NV_ENC_SEI_PAYLOAD> vSei;
+    SetPicParams(picParam, picFlags, sei, vSei);
+
+    return m_encoder->EncodeFrame(fnWrite, &picParam);
+}
+
+uint64_t PyNvEncoder::Submit(py::object frame, uint8_t picFlags, const SEI_MESSAGE& sei)
+{
+    {
+        // the input buffer of the ring is reused once the bitstream of its previous frame is locked
+        py::gil_scoped_release release;
+        m_encoder->WaitForInputFrame();
     }
+    EncoderInput input = ParseFrame(frame);
 
-    if (pSei)
-        delete[] pSei;
+    py::gil_scoped_release release;
+    WriteEncoderInput(input);
 
-    py::gil_scoped_acquire acquire;
-    return py::bytes(buffer.get(), totalSize);
-}
+    NV_ENC_PIC_PARAMS picParam = { 0 };
+    std::vector<NV_ENC_SEI_PAYLOAD> vSei;
+    SetPicParams(picParam, picFlags, sei, vSei);
 
+    m_bPipelined = true;
+    return m_encoder->SubmitFrame(&picParam);
+}
 
-// For Encode with pic flags
-py::bytes PyNvEncoder::Encode(py::object _frame, uint8_t m_picFlags) 
+std::shared_ptr<EncodedBitstream> PyNvEncoder::Retrieve(double timeout)
 {
-    py::object frame = _frame;
-    std::vector<NvEncOutputFrame> vvByte;
+    bool bRetrieved = false;
+    {
+        py::gil_scoped_release release;
+        bRetrieved = m_encoder->RetrievePacket(m_retrievedPacket, timeout < 0 ? -1 : (int)(timeout * 1000));
+    }
+    if (!bRetrieved)
+    {
+        return nullptr;
+    }
+    auto bitstream = AcquireBitstream();
+    // hand the packet buffer to Python and recycle the previous buffer of the bitstream for the next packet
+    std::swap(bitstream->data, m_retrievedPacket.frame);
+    bitstream->numPackets = 1;
+    bitstream->timestamp = m_retrievedPacket.timeStamp;
+    TakeFrameStats(*bitstream);
+    return bitstream;
+}
 
-    if(hasattr(frame, "cuda"))
+std::shared_ptr<EncodedBitstream> PyNvEncoder::EncodeBatch(py::object frames, const std::vector<uint8_t>& vPicFlags, bool bFlush)
+{
+    size_t nFrames = py::len(frames);
+    if (!vPicFlags.empty() && vPicFlags.size() != nFrames)
     {
-        frame = frame.attr("cuda")();
-        GetEncoderInput(frame);
+        PYNVVC_THROW_ERROR("picflags must hold one entry per frame", NV_ENC_ERR_INVALID_PARAM);
     }
-    else
+    // Frames are parsed up front so that the whole batch is encoded with the GIL released
+    std::vector<EncoderInput> vInput;
+    vInput.reserve(nFrames);
+    for (size_t i = 0; i < nFrames; i++)
+    {
+        vInput.push_back(ParseFrame(frames.attr("__getitem__")(i)));
+    }
+
+    auto bitstream = AcquireBitstream();
+    bitstream->offsets.push_back(0);
     {
-        if (!m_bUseCPUInutBuffer)
+        py::gil_scoped_release release;
+        NvEncBitstreamWriter fnWrite = GetBatchWriter(*bitstream);
+        const SEI_MESSAGE sei;
+        for (size_t i = 0; i < nFrames; i++)
+        {
+            WriteEncoderInput(vInput[i]);
+            NV_ENC_PIC_PARAMS picParam = { 0 };
+            std::vector<NV_ENC_SEI_PAYLOAD> vSei;
+            SetPicParams(picParam, vPicFlags.empty() ? 0 : vPicFlags[i], sei, vSei);
+            bitstream->numPackets += m_encoder->EncodeFrame(fnWrite, &picParam);
+        }
+        if (bFlush)
         {
-            PYNVVC_THROW_ERROR("incorrect usage of CPU input buffer", NV_ENC_ERR_INVALID_PARAM);
+            bitstream->numPackets += m_encoder->EndEncode(fnWrite);
         }
-        GetEncoderInputFromCPUBuffer(frame);
     }
+    TakeFrameStats(*bitstream);
+    return bitstream;
+}
 
+std::vector<std::shared_ptr<EncodedBitstream>> PyNvEncoder::Flush()
+{
+    m_encoder->FlushPipeline();
+    std::vector<std::shared_ptr<EncodedBitstream>> vBitstream;
+    while (auto bitstream = Retrieve(-1))
+    {
+        vBitstream.push_back(bitstream);
+    }
+    return vBitstream;
+}
+
+int PyNvEncoder::EndEncodeTo(const NvEncBitstreamWriter& fnWrite)
+{
     py::gil_scoped_release release;
+    if (m_encoder->IsMotionEstimationOnly())
+    {
+        // motion estimation is synchronous, nothing is queued
+        return 0;
+    }
+    return m_encoder->EndEncode(fnWrite);
+}
 
-    NV_ENC_PIC_PARAMS picParam = { 0 };
-    picParam.inputTimeStamp = m_frameNum++;
-    picParam.encodePicFlags |= m_picFlags;
+std::shared_ptr<MotionVectorField> PyNvEncoder::RunMotionEstimation(py::object frame, py::object reference)
+{
+    if (!m_encoder->IsMotionEstimationOnly())
+    {
+        PYNVVC_THROW_ERROR("RunMotionEstimation() requires an encoder created with me_only=1", NV_ENC_ERR_INVALID_CALL);
+    }
+    EncoderInput input = ParseFrame(frame);
+    EncoderInput referenceInput = ParseFrame(reference);
+    if (referenceInput.memoryType == CU_MEMORYTYPE_HOST && referenceInput.nBytes < m_encoder->GetFrameSize())
+    {
+        PYNVVC_THROW_ERROR("CPU reference buffer is smaller than the frame", NV_ENC_ERR_INVALID_PARAM);
+    }
+
+    py::gil_scoped_release release;
+    WriteEncoderInput(input);
+    // the reference buffer is not registered with the caller frame, it is always copied
+    const NvEncInputFrame* referenceFrame = m_encoder->GetNextReferenceFrame();
+    NvEncoderCuda::CopyToDeviceFrame(m_CUcontext,
+        referenceInput.pSrc,
+        referenceInput.nSrcStride,
+        (CUdeviceptr)referenceFrame->inputPtr,
+        (int)referenceFrame->pitch,
+        m_encoder->GetEncodeWidth(),
+        m_encoder->GetEncodeHeight(),
+        referenceInput.memoryType,
+        referenceFrame->bufferFormat,
+        referenceFrame->chromaOffsets,
+        referenceFrame->numChromaPlanes,
+        false,
+        m_CUstream,
+        referenceInput.srcChromaOffsets
+    );
 
-    m_encoder->EncodeFrame(vvByte, &picParam);
+    std::vector<uint8_t> vMvData;
+    m_encoder->RunMotionEstimation(vMvData);
 
-    // Calculate total size
-    size_t totalSize = 0;
-    for (const auto& vByte : vvByte) {
-        totalSize += vByte.frame.size();
+    auto field = std::make_shared<MotionVectorField>();
+    field->mbWidth = (m_encoder->GetEncodeWidth() + 15) / 16;
+    field->mbHeight = (m_encoder->GetEncodeHeight() + 15) / 16;
+    size_t nMbs = (size_t)field->mbWidth * field->mbHeight;
+    if (vMvData.size() < nMbs * sizeof(NV_ENC_H264_MV_DATA))
+    {
+        PYNVVC_THROW_ERROR("Motion vector output is smaller than the frame", NV_ENC_ERR_GENERIC);
+    }
+    const NV_ENC_H264_MV_DATA* pMvData = reinterpret_cast<const NV_ENC_H264_MV_DATA*>(vMvData.data());
+    field->mv.resize(nMbs * 8);
+    field->cost.resize(nMbs);
+    field->mbType.resize(nMbs);
+    field->partitionType.resize(nMbs);
+    for (size_t i = 0; i < nMbs; i++)
+    {
+        for (int j = 0; j < 4; j++)
+        {
+            field->mv[8 * i + 2 * j] = pMvData[i].mv[j].mvx;
+            field->mv[8 * i + 2 * j + 1] = pMvData[i].mv[j].mvy;
+        }
+        field->cost[i] = pMvData[i].mbCost;
+        field->mbType[i] = pMvData[i].mbType;
+        field->partitionType[i] = pMvData[i].partitionType;
     }
+    return field;
+}
 
-    // Allocate a single buffer
-    std::unique_ptr<char[]> buffer(new char[totalSize]);
-    size_t offset = 0;
-    for (const auto& vByte : vvByte) {
-        if (vByte.frame.size() > 0) {
-            std::memcpy(buffer.get() + offset, vByte.frame.data(), vByte.frame.size());
-            offset += vByte.frame.size();
+std::shared_ptr<EncodedBitstream> PyNvEncoder::AcquireBitstream()
+{
+    // A pooled buffer that Python no longer refers to can be reused. Only the encoder hands out references,
+    // so the use count of an idle buffer cannot grow concurrently.
+    for (size_t i = 0; i < m_vBitstreamPool.size(); i++)
+    {
+        size_t idx = (m_nNextBitstream + i) % m_vBitstreamPool.size();
+        if (m_vBitstreamPool[idx].use_count() == 1)
+        {
+            m_nNextBitstream = idx + 1;
+            m_vBitstreamPool[idx]->data.clear();
+            m_vBitstreamPool[idx]->numPackets = 0;
+            m_vBitstreamPool[idx]->timestamp = 0;
+            m_vBitstreamPool[idx]->offsets.clear();
+            m_vBitstreamPool[idx]->stats.clear();
+            return m_vBitstreamPool[idx];
+        }
+    }
+    auto bitstream = std::make_shared<EncodedBitstream>();
+    if (m_vBitstreamPool.size() < MAX_POOLED_BITSTREAMS)
+    {
+        m_vBitstreamPool.push_back(bitstream);
+    }
+    return bitstream;
+}
+
+static NvEncBitstreamWriter GetVectorWriter(std::vector<uint8_t>& vBitstream)
+{
+    return [&vBitstream](const uint8_t* pData, size_t nBytes, bool) { vBitstream.insert(vBitstream.end(), pData, pData + nBytes); };
+}
+
+// Writes straight from the locked bitstream to a file descriptor. Errors are reported after the encode call
+// since the writer runs with the output buffer locked.
+static NvEncBitstreamWriter GetFileWriter(int fd, size_t& nWritten, int& nError)
+{
+    return [fd, &nWritten, &nError](const uint8_t* pData, size_t nBytes, bool) {
+        while (nBytes && !nError)
+        {
+#if defined(_WIN32)
+            int n = _write(fd, pData, (unsigned int)nBytes);
+#else
+            ssize_t n = write(fd, pData, nBytes);
+#endif
+            if (n < 0)
+            {
+                if (errno != EINTR)
+                {
+                    nError = errno;
+                }
+                continue;
+            }
+            pData += n;
+            nBytes -= n;
+            nWritten += n;
         }
+    };
+}
+
+static void CheckFileWriter(int nError)
+{
+    if (nError)
+    {
+        PYNVVC_THROW_ERROR(std::string("Failed to write the bitstream: ") + strerror(nError), NV_ENC_ERR_GENERIC);
     }
+}
 
-    py::gil_scoped_acquire acquire;
-    return py::bytes(buffer.get(), totalSize);
+py::bytes PyNvEncoder::Encode(py::object _frame)
+{
+    m_vBitstream.clear();
+    EncodeTo(_frame, 0, SEI_MESSAGE(), GetVectorWriter(m_vBitstream));
+    return py::bytes(reinterpret_cast<const char*>(m_vBitstream.data()), m_vBitstream.size());
 }
 
+// For Encode with pic flags and SEI
+py::bytes PyNvEncoder::Encode(py::object _frame, uint8_t m_picFlags, SEI_MESSAGE sei)
+{
+    m_vBitstream.clear();
+    EncodeTo(_frame, m_picFlags, sei, GetVectorWriter(m_vBitstream));
+    return py::bytes(reinterpret_cast<const char*>(m_vBitstream.data()), m_vBitstream.size());
+}
+
+// For Encode with pic flags
+py::bytes PyNvEncoder::Encode(py::object _frame, uint8_t m_picFlags) 
+{
+    m_vBitstream.clear();
+    EncodeTo(_frame, m_picFlags, SEI_MESSAGE(), GetVectorWriter(m_vBitstream));
+    return py::bytes(reinterpret_cast<const char*>(m_vBitstream.data()), m_vBitstream.size());
+}
 
 // For EndEncode
 py::bytes PyNvEncoder::Encode()
 {
-    std::vector<NvEncOutputFrame> vvByte;
-    
-    py::gil_scoped_release release;
-    
-    m_encoder->EndEncode(vvByte);
+    m_vBitstream.clear();
+    EndEncodeTo(GetVectorWriter(m_vBitstream));
+    return py::bytes(reinterpret_cast<const char*>(m_vBitstream.data()), m_vBitstream.size());
+}
 
-    // Calculate total size
-    size_t totalSize = 0;
-    for (const auto& vByte : vvByte) {
-        totalSize += vByte.frame.size();
-    }
+std::shared_ptr<EncodedBitstream> PyNvEncoder::EncodeToBuffer(py::object frame, uint8_t picFlags, const SEI_MESSAGE& sei)
+{
+    auto bitstream = AcquireBitstream();
+    bitstream->numPackets = EncodeTo(frame, picFlags, sei, GetVectorWriter(bitstream->data));
+    TakeFrameStats(*bitstream);
+    return bitstream;
+}
 
-    // Allocate a single buffer
-    std::unique_ptr<char[]> buffer(new char[totalSize]);
-    size_t offset = 0;
-    for (const auto& vByte : vvByte) {
-        if (vByte.frame.size() > 0) {
-            std::memcpy(buffer.get() + offset, vByte.frame.data(), vByte.frame.size());
-            offset += vByte.frame.size();
-        }
-    }
+std::shared_ptr<EncodedBitstream> PyNvEncoder::EndEncodeToBuffer()
+{
+    auto bitstream = AcquireBitstream();
+    bitstream->numPackets = EndEncodeTo(GetVectorWriter(bitstream->data));
+    TakeFrameStats(*bitstream);
+    return bitstream;
+}
 
-    py::gil_scoped_acquire acquire;
-    return py::bytes(buffer.get(), totalSize);
+size_t PyNvEncoder::EncodeToFile(py::object frame, int fd, uint8_t picFlags, const SEI_MESSAGE& sei)
+{
+    size_t nWritten = 0;
+    int nError = 0;
+    EncodeTo(frame, picFlags, sei, GetFileWriter(fd, nWritten, nError));
+    CheckFileWriter(nError);
+    return nWritten;
+}
+
+size_t PyNvEncoder::EndEncodeToFile(int fd)
+{
+    size_t nWritten = 0;
+    int nError = 0;
+    EndEncodeTo(GetFileWriter(fd, nWritten, nError));
+    CheckFileWriter(nError);
+    return nWritten;
 }
 
 
@@ -817,13 +1476,22 @@ PyNvEncoder::~PyNvEncoder()
     py::gil_scoped_release release;
     m_width = 0;
     m_height = 0;
+    ReleaseHostBuffers();
 
     if(m_ReleasePrimaryContext)
     {
+        if (ReleaseToSessionCache())
+        {
+            // the cache holds the reference to the primary context along with the session
+            m_ReleasePrimaryContext = false;
+        }
         m_encoder.reset();
         pCUStream.reset();
 
-        cuDevicePrimaryCtxRelease(m_gpuId);
+        if (m_ReleasePrimaryContext)
+        {
+            cuDevicePrimaryCtxRelease(m_gpuId);
+        }
         m_ReleasePrimaryContext = false;
     }
 
@@ -847,6 +1515,30 @@ bool PyNvEncoder::Reconfigure(structEncodeReconfigureParams rcParamsToChange)
     reconfigRCParams.vbvInitialDelay = rcParamsToChange.vbvInitialDelay;
     initializeParams.frameRateDen = rcParamsToChange.frameRateDen;
     initializeParams.frameRateNum = rcParamsToChange.frameRateNum;
+    reconfigRCParams.constQP.qpInterP = rcParamsToChange.constQPInterP;
+    reconfigRCParams.constQP.qpInterB = rcParamsToChange.constQPInterB;
+    reconfigRCParams.constQP.qpIntra = rcParamsToChange.constQPIntra;
+    if (rcParamsToChange.gopLength)
+    {
+        encodeConfig.gopLength = rcParamsToChange.gopLength;
+    }
+    if (rcParamsToChange.idrPeriod)
+    {
+        GetIdrPeriod(encodeConfig, initializeParams.encodeGUID) = rcParamsToChange.idrPeriod;
+    }
+
+    // The input buffers are allocated for the max encode size, so the resolution changes without reallocating them
+    uint32_t nWidth = rcParamsToChange.encodeWidth ? rcParamsToChange.encodeWidth : initializeParams.encodeWidth;
+    uint32_t nHeight = rcParamsToChange.encodeHeight ? rcParamsToChange.encodeHeight : initializeParams.encodeHeight;
+    if (nWidth > initializeParams.maxEncodeWidth || nHeight > initializeParams.maxEncodeHeight)
+    {
+        PYNVVC_THROW_ERROR("Resolution " + std::to_string(nWidth) + "x" + std::to_string(nHeight) + " exceeds the max_res " +
+            std::to_string(initializeParams.maxEncodeWidth) + "x" + std::to_string(initializeParams.maxEncodeHeight) +
+            " set when creating the encoder", NV_ENC_ERR_INVALID_PARAM);
+    }
+    bool bResolutionChange = nWidth != initializeParams.encodeWidth || nHeight != initializeParams.encodeHeight;
+    initializeParams.encodeWidth = initializeParams.darWidth = nWidth;
+    initializeParams.encodeHeight = initializeParams.darHeight = nHeight;
 
     NV_ENC_RECONFIGURE_PARAMS reconfigureParams = { NV_ENC_RECONFIGURE_PARAMS_VER };
     memcpy(&reconfigureParams.reInitEncodeParams, &initializeParams, sizeof(initializeParams));
@@ -859,8 +1551,27 @@ bool PyNvEncoder::Reconfigure(structEncodeReconfigureParams rcParamsToChange)
     //InitEncodeReconfigureParams(initializeParams);
 
     reconfigureParams.reInitEncodeParams.tuningInfo = NV_ENC_TUNING_INFO_LOW_LATENCY;
+    reconfigureParams.resetEncoder = rcParamsToChange.resetEncoder || bResolutionChange;
+    reconfigureParams.forceIDR = rcParamsToChange.forceIDR || bResolutionChange;
+    if (reconfigureParams.resetEncoder && m_encoder->GetPendingCount())
+    {
+        PYNVVC_THROW_ERROR("Frames are pending, call EndEncode() before resetting the encoder or changing the resolution",
+            NV_ENC_ERR_INVALID_CALL);
+    }
 
-    return m_encoder->Reconfigure(const_cast<NV_ENC_RECONFIGURE_PARAMS*>(&reconfigureParams));
+    if (!m_encoder->Reconfigure(const_cast<NV_ENC_RECONFIGURE_PARAMS*>(&reconfigureParams)))
+    {
+        return false;
+    }
+    if (bResolutionChange)
+    {
+        // Caller frames were registered with the previous size
+        ReleaseRegisteredInputs();
+        m_width = nWidth;
+        m_height = nHeight;
+    }
+    InitEncodeReconfigureParams(reconfigureParams.reInitEncodeParams);
+    return true;
 
 }
 
@@ -941,6 +1652,15 @@ static CAPS PyNvEncoderCaps(
         // Return empty map
         return CAPS();
     }
+    // The capabilities of a GPU do not change, and querying them opens a CUDA context and an NVENC session
+    static std::mutex mtxCaps;
+    static std::map<std::pair<int32_t, std::string>, CAPS> mapCaps;
+    std::lock_guard<std::mutex> lock(mtxCaps);
+    auto itCaps = mapCaps.find({ gpuid, codec });
+    if (itCaps != mapCaps.end())
+    {
+        return itCaps->second;
+    }
 #if defined(_WIN32)
 #if defined(_WIN64)
     HMODULE hModule = LoadLibrary(TEXT("nvEncodeAPI64.dll"));
@@ -1023,6 +1743,7 @@ static CAPS PyNvEncoderCaps(
         caps[getCapName(static_cast<NV_ENC_CAPS>(i))] = v;
     }
 
+    m_nvenc.nvEncDestroyEncoder(hEncoder);
     cuCtxDestroy(cudacontext);
 
     if (hModule) {
@@ -1034,6 +1755,7 @@ static CAPS PyNvEncoderCaps(
         hModule = nullptr;
     }
 
+    mapCaps[{ gpuid, codec }] = caps;
     return caps;
 }
 
@@ -1061,6 +1783,82 @@ void Init_PyNvEncoder(py::module& m)
         .value("OUTPUT_RECON_FRAME", NV_ENC_PIC_FLAGS::NV_ENC_PIC_FLAG_OUTPUT_RECON_FRAME)
         .export_values();
 
+    // not exported to the module scope, the value names are single letters
+    py::enum_<NV_ENC_PIC_TYPE>(m, "NV_ENC_PIC_TYPE", py::module_local())
+        .value("P", NV_ENC_PIC_TYPE_P)
+        .value("B", NV_ENC_PIC_TYPE_B)
+        .value("I", NV_ENC_PIC_TYPE_I)
+        .value("IDR", NV_ENC_PIC_TYPE_IDR)
+        .value("BI", NV_ENC_PIC_TYPE_BI)
+        .value("SKIPPED", NV_ENC_PIC_TYPE_SKIPPED)
+        .value("INTRA_REFRESH", NV_ENC_PIC_TYPE_INTRA_REFRESH)
+        .value("NONREF_P", NV_ENC_PIC_TYPE_NONREF_P)
+#if CHECK_API_VERSION(13,0)
+        .value("SWITCH", NV_ENC_PIC_TYPE_SWITCH)
+#endif
+        .value("UNKNOWN", NV_ENC_PIC_TYPE_UNKNOWN);
+
+    py::class_<NvEncFrameStats, std::shared_ptr<NvEncFrameStats>>(m, "EncoderFrameStats", py::module_local())
+        .def_readonly("frame_idx", &NvEncFrameStats::frameIdx, "index of the frame in encode order")
+        .def_readonly("timestamp", &NvEncFrameStats::timeStamp, "timestamp of the frame, the ticket returned by Submit for the pipelined API")
+        .def_readonly("picture_type", &NvEncFrameStats::pictureType)
+        .def_readonly("avg_qp", &NvEncFrameStats::frameAvgQP, "average QP of the frame")
+        .def_readonly("satd", &NvEncFrameStats::frameSatd, "total SATD cost of the frame")
+        .def_readonly("size", &NvEncFrameStats::sizeInBytes, "size of the frame in the bitstream, in bytes")
+        .def_readonly("intra_mb_count", &NvEncFrameStats::intraMBCount, "intra MBs (H.264), CTBs (HEVC) or SBs (AV1)")
+        .def_readonly("inter_mb_count", &NvEncFrameStats::interMBCount, "inter MBs (H.264), CTBs (HEVC) or SBs (AV1), skipped ones included")
+        .def_readonly("average_mv_x", &NvEncFrameStats::averageMVX)
+        .def_readonly("average_mv_y", &NvEncFrameStats::averageMVY)
+        .def_readonly("latency_ms", &NvEncFrameStats::latencyMs, "time from the submission of the frame to the lock of its bitstream, output delay included")
+        .def_readonly("block_size", &NvEncFrameStats::blockSize, "size in pixels of the blocks of block_qp and block_bits, 0 without block_stats=1")
+        .def_property_readonly("block_qp", [](const NvEncFrameStats& self)
+            {
+                return py::array_t<uint8_t>(self.blockQP.size(), self.blockQP.data());
+            }, "QP of each block in raster order, with block_stats=1")
+        .def_property_readonly("block_bits", [](const NvEncFrameStats& self)
+            {
+                return py::array_t<uint32_t>(self.blockBits.size(), self.blockBits.data());
+            }, "bit count of each block in raster order, with block_stats=1")
+        .def("__repr__",
+            [](const NvEncFrameStats& self) {
+                std::stringstream ss;
+                ss << "EncoderFrameStats [frame_idx=" << self.frameIdx;
+                ss << ", timestamp=" << self.timeStamp;
+                ss << ", picture_type=" << self.pictureType;
+                ss << ", avg_qp=" << self.frameAvgQP;
+                ss << ", size=" << self.sizeInBytes;
+                ss << ", latency_ms=" << self.latencyMs;
+                ss << "]";
+                return ss.str();
+            })
+        ;
+
+    py::class_<EncoderStatsHistogram, std::shared_ptr<EncoderStatsHistogram>>(m, "EncoderStatsHistogram", py::module_local())
+        .def_readonly("num_frames", &EncoderStatsHistogram::numFrames)
+        .def_readonly("total_bytes", &EncoderStatsHistogram::totalBytes)
+        .def_readonly("max_latency_ms", &EncoderStatsHistogram::maxLatencyMs)
+        .def_readonly("frames_by_type", &EncoderStatsHistogram::framesByType, "number of frames of each NV_ENC_PIC_TYPE")
+        .def_readonly("qp_histogram", &EncoderStatsHistogram::qpHistogram, "number of frames of each average QP")
+        .def_readonly("size_histogram", &EncoderStatsHistogram::sizeHistogram,
+            "bin i counts the frames of 2^i to 2^(i+1) - 1 bytes")
+        .def_readonly("latency_histogram", &EncoderStatsHistogram::latencyHistogram,
+            "bin i counts the frames with a latency of 2^i to 2^(i+1) - 1 microseconds")
+        .def_property_readonly("average_qp", &EncoderStatsHistogram::GetAverageQP)
+        .def_property_readonly("average_size", &EncoderStatsHistogram::GetAverageSize)
+        .def_property_readonly("average_latency_ms", &EncoderStatsHistogram::GetAverageLatencyMs)
+        .def("__repr__",
+            [](const EncoderStatsHistogram& self) {
+                std::stringstream ss;
+                ss << "EncoderStatsHistogram [num_frames=" << self.numFrames;
+                ss << ", total_bytes=" << self.totalBytes;
+                ss << ", average_qp=" << self.GetAverageQP();
+                ss << ", average_latency_ms=" << self.GetAverageLatencyMs();
+                ss << ", max_latency_ms=" << self.maxLatencyMs;
+                ss << "]";
+                return ss.str();
+            })
+        ;
+
 
     py::class_<structEncodeReconfigureParams, std::shared_ptr<structEncodeReconfigureParams>>(m, "structEncodeReconfigureParams")
         .def(py::init<>())
@@ -1072,6 +1870,15 @@ void Init_PyNvEncoder(py::module& m)
         .def_readwrite("vbvInitialDelay", &structEncodeReconfigureParams::vbvInitialDelay)
         .def_readwrite("frameRateDen", &structEncodeReconfigureParams::frameRateDen)
         .def_readwrite("frameRateNum", &structEncodeReconfigureParams::frameRateNum)
+        .def_readwrite("encodeWidth", &structEncodeReconfigureParams::encodeWidth)
+        .def_readwrite("encodeHeight", &structEncodeReconfigureParams::encodeHeight)
+        .def_readwrite("gopLength", &structEncodeReconfigureParams::gopLength)
+        .def_readwrite("idrPeriod", &structEncodeReconfigureParams::idrPeriod)
+        .def_readwrite("constQPInterP", &structEncodeReconfigureParams::constQPInterP)
+        .def_readwrite("constQPInterB", &structEncodeReconfigureParams::constQPInterB)
+        .def_readwrite("constQPIntra", &structEncodeReconfigureParams::constQPIntra)
+        .def_readwrite("resetEncoder", &structEncodeReconfigureParams::resetEncoder)
+        .def_readwrite("forceIDR", &structEncodeReconfigureParams::forceIDR)
         .def("__repr__",
             [](std::shared_ptr<structEncodeReconfigureParams>& self)
             {
@@ -1085,16 +1892,70 @@ void Init_PyNvEncoder(py::module& m)
                 ss << ", vbvInitialDelay=" << self->vbvInitialDelay;
                 ss << ", frameRateDen=" << self->frameRateDen;
                 ss << ", frameRateNum=" << self->frameRateNum;
+                ss << ", encodeWidth=" << self->encodeWidth;
+                ss << ", encodeHeight=" << self->encodeHeight;
+                ss << ", gopLength=" << self->gopLength;
+                ss << ", idrPeriod=" << self->idrPeriod;
+                ss << ", constQP=(" << self->constQPInterP << ", " << self->constQPInterB << ", " << self->constQPIntra << ")";
+                ss << ", resetEncoder=" << self->resetEncoder;
+                ss << ", forceIDR=" << self->forceIDR;
                 ss << "]";
                 return ss.str();
             })
         ;
 
+    py::class_<EncodedBitstream, shared_ptr<EncodedBitstream>>(m, "EncodedBitstream", py::buffer_protocol(), py::module_local())
+        .def_buffer([](EncodedBitstream& self) -> py::buffer_info
+            {
+                return py::buffer_info(self.data.data(), 1, py::format_descriptor<uint8_t>::format(), 1,
+                    { (py::ssize_t)self.data.size() }, { (py::ssize_t)1 }, true);
+            })
+        .def("__len__", [](const EncodedBitstream& self) { return self.data.size(); })
+        .def("__bytes__", [](const EncodedBitstream& self)
+            {
+                return py::bytes(reinterpret_cast<const char*>(self.data.data()), self.data.size());
+            })
+        .def_readonly("num_packets", &EncodedBitstream::numPackets, "number of packets output by the encode call")
+        .def_readonly("timestamp", &EncodedBitstream::timestamp, "ticket of the frame returned by Submit, for packets returned by Retrieve")
+        .def_readonly("offsets", &EncodedBitstream::offsets, "for EncodeBatch, packet i spans offsets[i] to offsets[i + 1] of the buffer")
+        .def_readonly("stats", &EncodedBitstream::stats, "EncoderFrameStats of each packet, with frame_stats=1")
+        ;
+
+    py::class_<MotionVectorField, shared_ptr<MotionVectorField>>(m, "MotionVectorField", py::module_local())
+        .def_readonly("mb_width", &MotionVectorField::mbWidth, "number of 16x16 macroblocks per row")
+        .def_readonly("mb_height", &MotionVectorField::mbHeight, "number of 16x16 macroblock rows")
+        .def_property_readonly("mv", [](std::shared_ptr<MotionVectorField>& self)
+            {
+                return py::array_t<int16_t>({ (size_t)self->mbHeight, (size_t)self->mbWidth, (size_t)4, (size_t)2 },
+                    self->mv.data(), py::cast(self));
+            }, "int16 array of shape (mb_height, mb_width, 4, 2): (x, y) vector of each 8x8 partition in quarter pel units")
+        .def_property_readonly("cost", [](std::shared_ptr<MotionVectorField>& self)
+            {
+                return py::array_t<uint32_t>({ (size_t)self->mbHeight, (size_t)self->mbWidth }, self->cost.data(), py::cast(self));
+            }, "uint32 array of shape (mb_height, mb_width): matching cost of each macroblock")
+        .def_property_readonly("mb_type", [](std::shared_ptr<MotionVectorField>& self)
+            {
+                return py::array_t<uint8_t>({ (size_t)self->mbHeight, (size_t)self->mbWidth }, self->mbType.data(), py::cast(self));
+            }, "uint8 array of shape (mb_height, mb_width): 0 (I), 1 (P), 2 (IPCM), 3 (B)")
+        .def_property_readonly("partition_type", [](std::shared_ptr<MotionVectorField>& self)
+            {
+                return py::array_t<uint8_t>({ (size_t)self->mbHeight, (size_t)self->mbWidth }, self->partitionType.data(), py::cast(self));
+            }, "uint8 array of shape (mb_height, mb_width): 0 (16x16), 1 (8x8), 2 (16x8), 3 (8x16)")
+        ;
+
     py::class_<PyNvEncoder, shared_ptr<PyNvEncoder>>(m, "PyNvEncoder", py::module_local())
         .def(py::init<int, int, std::string,  size_t , size_t,  bool ,std::map<std::string,std::string>>(),
             R"pbdoc(
                 Constructor method. Initialize encoder session with set of particular paramters
                 :param width, height, format, cpuinputbuffer,other-optional-params,  
+                Optional parameter registered_inputs=N registers up to N device frames with the encoder, which then
+                reads them in place instead of copying them. A frame is read until its packet is returned, so it must
+                not be modified before.
+                Optional parameter frame_stats=1 reports the picture type, average QP, size and latency of each encoded
+                frame, attached to the returned EncodedBitstream or fetched with GetFrameStats, and aggregated into
+                GetStatsHistogram. block_stats=1 also reports the QP and bit count of each block.
+                Optional parameter me_only=1 creates a motion estimation only session (codec h264), which outputs
+                motion vectors through RunMotionEstimation instead of a bitstream.
             )pbdoc")
         .def(
              "Encode",
@@ -1134,6 +1995,121 @@ void Init_PyNvEncoder(py::module& m)
                  Flush encoder to retreive bitstreams in the queue. Returns encoded bitstream in CPU memory
                  :param empty
              )pbdoc")
+        .def(
+             "Submit",
+             [](std::shared_ptr<PyNvEncoder>& self, const py::object& frame, uint8_t picFlags, const SEI_MESSAGE& sei)
+             {
+                return self->Submit(frame, picFlags, sei);
+             }, py::arg("frame"), py::arg("picflags") = 0, py::arg("sei") = SEI_MESSAGE(), R"pbdoc(
+                 Submit frame for encoding without waiting for its bitstream, which an output thread collects as soon as
+                 it is encoded. Blocks only while all input buffers of the encoder hold frames in flight.
+                 Cannot be mixed with Encode/EndEncode.
+                 :param frame: NVCV Image object or any object that implements __cuda_array_interface
+                 :param picflags: NV_ENC_PIC_FLAGS flags, combined with logical OR
+                 :param sei: SEI messages to insert
+                 :return: ticket of the frame, reported as EncodedBitstream.timestamp by Retrieve
+             )pbdoc")
+        .def(
+             "Retrieve",
+             [](std::shared_ptr<PyNvEncoder>& self, double timeout)
+             {
+                return self->Retrieve(timeout);
+             }, py::arg("timeout") = -1.0, R"pbdoc(
+                 Retrieve the next encoded packet of the submitted frames, in bitstream order.
+                 With B frames or lookahead a frame completes only after later frames are submitted or Flush is called.
+                 :param timeout: seconds to wait, 0 to poll, negative to wait until a packet is ready
+                 :return: EncodedBitstream, or None if no packet is ready in time or no frame is in flight
+             )pbdoc")
+        .def(
+             "Flush",
+             [](std::shared_ptr<PyNvEncoder>& self)
+             {
+                return self->Flush();
+             }, R"pbdoc(
+                 Flush the submitted frames and return the remaining packets as a list of EncodedBitstream
+             )pbdoc")
+        .def_property_readonly(
+             "pending",
+             [](std::shared_ptr<PyNvEncoder>& self)
+             {
+                return self->GetPendingCount();
+             }, "number of submitted frames whose packet was not retrieved yet")
+        .def(
+             "EncodeBatch",
+             [](std::shared_ptr<PyNvEncoder>& self, const py::object& frames, const std::vector<uint8_t>& picFlags, bool flush)
+             {
+                return self->EncodeBatch(frames, picFlags, flush);
+             }, py::arg("frames"), py::arg("picflags") = std::vector<uint8_t>(), py::arg("flush") = false, R"pbdoc(
+                 Encode a batch of frames in one call, releasing the GIL once for the whole batch.
+                 Returns the packets output for the batch in one EncodedBitstream; packet i spans
+                 offsets[i] to offsets[i + 1] of its buffer.
+                 :param frames: sequence of frames, e.g. a list of frames or a tensor whose first dimension indexes the frames
+                 :param picflags: NV_ENC_PIC_FLAGS of each frame, or empty
+                 :param flush: also flush the encoder queue, as EndEncode does
+             )pbdoc")
+        .def(
+             "RegisterHostBuffer",
+             [](std::shared_ptr<PyNvEncoder>& self, py::buffer buffer)
+             {
+                self->RegisterHostBuffer(buffer);
+             }, py::arg("buffer"), R"pbdoc(
+                 Page-lock a C-contiguous host buffer, e.g. a numpy array reused for CPU input frames, with cuMemHostRegister.
+                 Frames within a registered buffer are uploaded directly instead of going through a pinned staging buffer.
+                 The upload is asynchronous: a frame may be overwritten once three more frames have been encoded,
+                 or after EndEncode() or UnregisterHostBuffer() returned.
+                 The buffer must stay alive until it is unregistered or the encoder is destroyed.
+             )pbdoc")
+        .def(
+             "UnregisterHostBuffer",
+             [](std::shared_ptr<PyNvEncoder>& self, py::buffer buffer)
+             {
+                self->UnregisterHostBuffer(buffer);
+             }, py::arg("buffer"), R"pbdoc(
+                 Unregister a buffer registered with RegisterHostBuffer
+             )pbdoc")
+        .def(
+             "EncodeToBuffer",
+             [](std::shared_ptr<PyNvEncoder>& self, const py::object& frame, uint8_t picFlags, const SEI_MESSAGE& sei)
+             {
+                return self->EncodeToBuffer(frame, picFlags, sei);
+             }, py::arg("frame"), py::arg("picflags") = 0, py::arg("sei") = SEI_MESSAGE(), R"pbdoc(
+                 Encode frame. Returns an EncodedBitstream holding the bitstream, copied once from the encoder output.
+                 Use memoryview() on it to access the bytes without a copy. Buffers are reused once released.
+                 :param frame: NVCV Image object or any object that implements __cuda_array_interface
+                 :param picflags: NV_ENC_PIC_FLAGS flags, combined with logical OR
+                 :param sei: SEI messages to insert
+             )pbdoc")
+        .def(
+             "EndEncodeToBuffer",
+             [](std::shared_ptr<PyNvEncoder>& self)
+             {
+                return self->EndEncodeToBuffer();
+             }, R"pbdoc(
+                 Flush encoder to retreive bitstreams in the queue. Returns an EncodedBitstream
+             )pbdoc")
+        .def(
+             "EncodeToFile",
+             [](std::shared_ptr<PyNvEncoder>& self, const py::object& frame, int fd, uint8_t picFlags, const SEI_MESSAGE& sei)
+             {
+                return self->EncodeToFile(frame, fd, picFlags, sei);
+             }, py::arg("frame"), py::arg("fd"), py::arg("picflags") = 0, py::arg("sei") = SEI_MESSAGE(), R"pbdoc(
+                 Encode frame and write the bitstream straight from the encoder output to a file descriptor
+                 :param frame: NVCV Image object or any object that implements __cuda_array_interface
+                 :param fd: file descriptor open for writing, e.g. f.fileno()
+                 :param picflags: NV_ENC_PIC_FLAGS flags, combined with logical OR
+                 :param sei: SEI messages to insert
+                 :return: number of bytes written
+             )pbdoc")
+        .def(
+             "EndEncodeToFile",
+             [](std::shared_ptr<PyNvEncoder>& self, int fd)
+             {
+                return self->EndEncodeToFile(fd);
+             }, py::arg("fd"), R"pbdoc(
+                 Flush encoder and write the queued bitstreams to a file descriptor
+                 :param fd: file descriptor open for writing
+                 :return: number of bytes written
+             )pbdoc")
           .def(
                "CopyToDeviceMemory",
                      [](std::shared_ptr<PyNvEncoder>& self, const std::string& filePath)
@@ -1159,11 +2135,53 @@ void Init_PyNvEncoder(py::module& m)
                  :param empty
              )pbdoc")
 
+        .def(
+            "RunMotionEstimation",
+            [](std::shared_ptr<PyNvEncoder>& self, const py::object& frame, const py::object& reference)
+            {
+                return self->RunMotionEstimation(frame, reference);
+            }, py::arg("frame"), py::arg("reference"), R"pbdoc(
+                 Estimate the motion of frame relative to reference, on an encoder created with me_only=1.
+                 Both frames take the format and size of the encoder, in device or host memory. Returns a
+                 MotionVectorField whose arrays are numpy arrays, which export DLPack through __dlpack__.
+                 :param frame  current frame
+                 :param reference  reference frame, e.g. the previous frame
+             )pbdoc")
+        .def(
+            "GetFrameStats",
+            [](std::shared_ptr<PyNvEncoder>& self)
+            {
+                return self->GetFrameStats();
+            }, R"pbdoc(
+                 Returns the EncoderFrameStats of the frames encoded with frame_stats=1 that were not attached to an
+                 EncodedBitstream, i.e. those of the calls returning bytes or writing to a file, and clears them.
+                 Up to the last 1024 frames are kept.
+             )pbdoc")
+        .def(
+            "GetStatsHistogram",
+            [](std::shared_ptr<PyNvEncoder>& self)
+            {
+                return self->GetStatsHistogram();
+            }, R"pbdoc(
+                 Returns the EncoderStatsHistogram of all frames encoded with frame_stats=1 since the encoder was
+                 created or ResetStatsHistogram was called.
+             )pbdoc")
+        .def(
+            "ResetStatsHistogram",
+            [](std::shared_ptr<PyNvEncoder>& self)
+            {
+                self->ResetStatsHistogram();
+            }, R"pbdoc(
+                 Clears the EncoderStatsHistogram of the encoder.
+             )pbdoc")
         .def("GetEncodeReconfigureParams", &PyNvEncoder::GetEncodeReconfigureParams,
               R"pbdoc(Get the values of reconfigure params, value to get )pbdoc")
        
         .def("Reconfigure", &PyNvEncoder::Reconfigure,
-            R"pbdoc( Encode API called with new params :reconfigure params struct)pbdoc")
+            R"pbdoc( Encode API called with new params :reconfigure params struct.
+                The resolution can change up to the max_res option given at creation, e.g. max_res="1920x1080",
+                reusing the input buffers. Resetting the encoder, which a resolution change implies, requires
+                the queued frames to be flushed with EndEncode() first.)pbdoc")
              ;
 
     m.def(
@@ -1183,4 +2201,56 @@ void Init_PyNvEncoder(py::module& m)
             :param codec: Video Codec
         )pbdoc"
     );
+
+    m.def(
+        "SetEncoderSessionCacheSize",
+        [](size_t size) {
+            py::gil_scoped_release release;
+            EncoderSessionCache::Instance().SetCapacity(size);
+        },
+        py::arg("size"),
+        R"pbdoc(
+            Set the number of idle encoder sessions kept for reuse, 0 (default) to disable caching.
+            An encoder created on the primary context of a GPU hands its session to the cache when destroyed, and
+            an encoder created later with the same codec, resolution, format, preset and tuning_info resets it with
+            a forced IDR instead of opening a new session. Idle sessions count against the NVENC session limit.
+
+            :param size: maximum number of idle sessions
+        )pbdoc"
+    );
+
+    m.def(
+        "ClearEncoderSessionCache",
+        []() {
+            py::gil_scoped_release release;
+            EncoderSessionCache::Instance().Clear();
+        },
+        R"pbdoc(
+            Destroy all idle encoder sessions
+        )pbdoc"
+    );
+
+    m.def(
+        "GetEncoderSessionCacheStats",
+        []() {
+            EncoderSessionCacheStats stats = EncoderSessionCache::Instance().GetStats();
+            py::dict dict;
+            dict["sessions_created"] = stats.sessionsCreated;
+            dict["sessions_reused"] = stats.sessionsReused;
+            dict["sessions_evicted"] = stats.sessionsEvicted;
+            dict["create_time_ms"] = stats.createTimeMs;
+            dict["reuse_time_ms"] = stats.reuseTimeMs;
+            dict["saved_time_ms"] = stats.GetSavedTimeMs();
+            return dict;
+        },
+        R"pbdoc(
+            Get the counters of the encoder session cache. saved_time_ms estimates the session creation time saved:
+            the average creation time times the number of reused sessions, minus the time spent resetting them.
+        )pbdoc"
+    );
+
+    // Idle sessions are destroyed before the interpreter and the CUDA driver shut down
+    py::module_::import("atexit").attr("register")(py::cpp_function([]() {
+        EncoderSessionCache::Instance().Clear();
+    }));
 }
@@ -0,0 +1,73 @@
+/*
+ * This copyright notice applies to this file only
+ *
+ * SPDX-FileCopyrightText: Copyright (c) 2025 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#include "EncoderFarm.hpp"
+
+namespace py = pybind11;
+
+void Init_PyNvEncoderFarm(py::module& m)
+{
+    py::class_<EncodeJobResult, std::shared_ptr<EncodeJobResult>>(m, "EncodeJobResult", py::module_local())
+        .def_readonly("job_id", &EncodeJobResult::jobId)
+        .def_readonly("bitstream", &EncodeJobResult::bitstream)
+        .def_readonly("error", &EncodeJobResult::error);
+
+    py::class_<EncoderFarm, std::shared_ptr<EncoderFarm>>(m, "EncoderFarm", py::module_local())
+        .def(py::init<const std::vector<int>&, int>(),
+            py::arg("gpu_ids") = std::vector<int>{ 0 },
+            py::arg("sessions_per_gpu") = 2,
+            R"pbdoc(
+                Create a farm of NVENC sessions encoding independent jobs in parallel
+                :param gpu_ids: GPUs to create sessions on
+                :param sessions_per_gpu: number of encoder sessions, each with a worker thread, per GPU
+            )pbdoc")
+        .def(
+             "Submit",
+             [](std::shared_ptr<EncoderFarm>& self, const py::object& frames, int width, int height, const std::string& format,
+                 const std::map<std::string, std::string>& config, const std::vector<uint8_t>& picFlags)
+             {
+                return self->Submit(frames, width, height, format, config, picFlags);
+             }, py::arg("frames"), py::arg("width"), py::arg("height"), py::arg("format"),
+             py::arg("config") = std::map<std::string, std::string>(), py::arg("picflags") = std::vector<uint8_t>(), R"pbdoc(
+                 Queue the encode of a frame sequence as an independent stream. Can be called from any thread.
+                 Returns the job id.
+                 :param frames: sequence of frames, device frames or CPU buffers
+                 :param width, height, format: frame size and format, as for the encoder constructor
+                 :param config: encoder options, as for the encoder constructor
+                 :param picflags: NV_ENC_PIC_FLAGS of each frame, or empty
+             )pbdoc")
+        .def(
+             "Retrieve",
+             [](std::shared_ptr<EncoderFarm>& self, double timeout)
+             {
+                return self->Retrieve(timeout);
+             }, py::arg("timeout") = -1.0, R"pbdoc(
+                 Return the next completed job as an EncodeJobResult, in completion order, or None if no job
+                 completes within timeout seconds or no job is pending. A negative timeout waits indefinitely.
+                 Packet i of the job spans offsets[i] to offsets[i + 1] of the result bitstream; error is set if the job failed.
+             )pbdoc")
+        .def_property_readonly("pending", &EncoderFarm::GetPendingCount)
+        .def_property_readonly("num_sessions", &EncoderFarm::GetSessionCount);
+}
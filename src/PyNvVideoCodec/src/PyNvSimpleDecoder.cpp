@@ -81,6 +81,8 @@ void Init_PyNvSimpleDecoder(py::module& m)
         .def(py::init<>())
         .def("get_batch_frames", &SimpleDecoder::GetBatchFrames)
         .def("get_batch_frames_by_index", &SimpleDecoder::GetBatchFramesByIndex)
+        .def("get_batch_tensor", &SimpleDecoder::GetBatchTensor)
+        .def("get_batch_tensor_by_index", &SimpleDecoder::GetBatchTensorByIndex)
         .def("get_stream_metadata", &SimpleDecoder::GetStreamMetadata)
         .def("get_scanned_stream_metadata", &SimpleDecoder::GetScannedStreamMetadata)
         .def("seek_to_index", &SimpleDecoder::SeekToIndex)
@@ -88,5 +90,6 @@ void Init_PyNvSimpleDecoder(py::module& m)
         .def("reconfigure_decoder", &SimpleDecoder::ReconfigureDecoder)
         .def("__getitem__", &SimpleDecoder::operator[])
         .def("get_session_init_time", &SimpleDecoder::GetSessionInitTime)
+        .def("get_batch_allocation_count", &SimpleDecoder::GetBatchAllocationCount)
         .def_static("set_session_count", &SimpleDecoder::SetSessionCount);
 }
\ No newline at end of file
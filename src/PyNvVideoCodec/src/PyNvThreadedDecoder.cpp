@@ -81,6 +81,8 @@ void Init_PyNvThreadedDecoder(py::module& m)
     py::class_<ThreadedDecoder, shared_ptr<ThreadedDecoder>>(m, "ThreadedDecoder", py::module_local())
         .def(py::init<>())
         .def("get_batch_frames", &ThreadedDecoder::GetBatchFrames)
+        .def("get_batch_tensor", &ThreadedDecoder::GetBatchTensor)
+        .def("get_batch_copied_frame_count", &ThreadedDecoder::GetBatchCopiedFrameCount)
         .def("get_stream_metadata", &ThreadedDecoder::GetStreamMetadata)
         .def("get_scanned_stream_metadata", &ThreadedDecoder::GetScannedStreamMetadata)
         .def("reconfigure_decoder", &ThreadedDecoder::ReconfigureDecoder)
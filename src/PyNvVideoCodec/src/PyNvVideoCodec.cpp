@@ -65,6 +65,7 @@ static auto ThrowOnCudaError = [](CUresult res, int lineNum = -1) {
 
 void Init_PyNvDemuxer(py::module& m);
 void Init_PyNvEncoder(py::module& m);
+void Init_PyNvEncoderFarm(py::module& m);
 void Init_PyNvDecoder(py::module& m);
 void Init_PyNvSimpleDecoder(py::module& m);
 void Init_PyNvThreadedDecoder(py::module& m);
@@ -151,9 +152,116 @@ PYBIND11_MODULE(_PyNvVideoCodec, m)
             .value("LOW", DisplayDecodeLatency::DISPLAYDECODELATENCY_LOW)
             .value("ZERO", DisplayDecodeLatency::DISPLAYDECODELATENCY_ZERO);
 
+        py::enum_<PostProcessInterpolation>(m, "PostProcessInterpolation")
+            .value("NEAREST", PostProcessInterpolation::NEAREST)
+            .value("BILINEAR", PostProcessInterpolation::BILINEAR);
+
+        py::enum_<PostProcessDataType>(m, "PostProcessDataType")
+            .value("UINT8", PostProcessDataType::UINT8)
+            .value("FLOAT16", PostProcessDataType::FLOAT16)
+            .value("FLOAT32", PostProcessDataType::FLOAT32);
+
+        py::class_<PostProcessParams>(m, "PostProcessParams", R"pbdoc(
+            Crop, resize, normalization and cast fused with the RGB/RGBP conversion of decoded frames.
+            Each output value is (rgb * scale - mean) / std with rgb in [0, 255].
+            The layout is HWC for RGB output and CHW for RGBP output.
+            )pbdoc")
+            .def(py::init<>())
+            .def_readwrite("width", &PostProcessParams::nWidth, "target width, 0 keeps the roi width")
+            .def_readwrite("height", &PostProcessParams::nHeight, "target height, 0 keeps the roi height")
+            .def_property("roi",
+                [](const PostProcessParams& self)
+                {
+                    return py::make_tuple(self.roi.x, self.roi.y, self.roi.width, self.roi.height);
+                },
+                [](PostProcessParams& self, const std::tuple<int, int, int, int>& roi)
+                {
+                    self.roi.x = std::get<0>(roi);
+                    self.roi.y = std::get<1>(roi);
+                    self.roi.width = std::get<2>(roi);
+                    self.roi.height = std::get<3>(roi);
+                }, "(x, y, width, height) region of the decoded frame, zero width or height selects the full frame")
+            .def_readwrite("interpolation", &PostProcessParams::eInterpolation)
+            .def_readwrite("scale", &PostProcessParams::scale)
+            .def_property("mean",
+                [](const PostProcessParams& self)
+                {
+                    return std::vector<float>(self.mean, self.mean + 3);
+                },
+                [](PostProcessParams& self, const std::vector<float>& mean)
+                {
+                    if (mean.size() != 3)
+                    {
+                        throw std::invalid_argument("mean must have 3 values");
+                    }
+                    std::copy(mean.begin(), mean.end(), self.mean);
+                })
+            .def_property("std",
+                [](const PostProcessParams& self)
+                {
+                    return std::vector<float>(self.std, self.std + 3);
+                },
+                [](PostProcessParams& self, const std::vector<float>& stddev)
+                {
+                    if (stddev.size() != 3)
+                    {
+                        throw std::invalid_argument("std must have 3 values");
+                    }
+                    std::copy(stddev.begin(), stddev.end(), self.std);
+                })
+            .def_readwrite("dtype", &PostProcessParams::eDataType);
+
+        py::enum_<PostProcessFormat>(m, "PostProcessFormat")
+            .value("RGB", PostProcessFormat::RGB)
+            .value("RGBP", PostProcessFormat::RGBP)
+            .value("NV12", PostProcessFormat::NV12)
+            .value("P016", PostProcessFormat::P016);
+
+        py::class_<PostProcessOutput>(m, "PostProcessOutput", R"pbdoc(
+            One output of a decoder output ladder: a resized copy of every decoded frame in its own buffer.
+            params.width and params.height are required, and must be even for NV12 and P016.
+            Normalization and dtype apply to RGB and RGBP only.
+            )pbdoc")
+            .def(py::init<>())
+            .def(py::init([](PostProcessFormat format, const PostProcessParams& params)
+                {
+                    PostProcessOutput output;
+                    output.eFormat = format;
+                    output.params = params;
+                    return output;
+                }), py::arg("format"), py::arg("params"))
+            .def_readwrite("format", &PostProcessOutput::eFormat)
+            .def_readwrite("params", &PostProcessOutput::params);
+
+        py::enum_<PostProcessColorRange>(m, "PostProcessColorRange")
+            .value("AUTO", PostProcessColorRange::AUTO)
+            .value("LIMITED", PostProcessColorRange::LIMITED)
+            .value("FULL", PostProcessColorRange::FULL);
+
+        py::enum_<PostProcessTransfer>(m, "PostProcessTransfer")
+            .value("AUTO", PostProcessTransfer::AUTO)
+            .value("SDR", PostProcessTransfer::SDR)
+            .value("PQ", PostProcessTransfer::PQ)
+            .value("HLG", PostProcessTransfer::HLG);
+
+        py::class_<PostProcessColorimetry>(m, "PostProcessColorimetry", R"pbdoc(
+            Color description used by the RGB/RGBP conversion of decoded frames, e.g. taken from the container.
+            Fields left at 0/AUTO follow the video signal description of the stream.
+            With tonemap, PQ and HLG frames are tone mapped to SDR BT.709 (BT.2390 EETF).
+            )pbdoc")
+            .def(py::init<>())
+            .def_readwrite("matrix", &PostProcessColorimetry::iMatrix, "matrix coefficients as in H.273 (1 BT.709, 6 BT.601, 9 BT.2020), 0 follows the stream")
+            .def_readwrite("range", &PostProcessColorimetry::eRange)
+            .def_readwrite("transfer", &PostProcessColorimetry::eTransfer)
+            .def_readwrite("tonemap", &PostProcessColorimetry::bToneMap)
+            .def_readwrite("peak_luminance", &PostProcessColorimetry::peakLuminance,
+                "cd/m2 of the brightest source pixel, 0 uses the HDR SEI metadata (needs enableSEIMessage) or 1000")
+            .def_readwrite("target_luminance", &PostProcessColorimetry::targetLuminance, "cd/m2 of SDR white");
+
 
     Init_PyNvDemuxer(m);
     Init_PyNvEncoder(m);
+    Init_PyNvEncoderFarm(m);
     Init_PyNvDecoder(m);
     Init_PyNvSimpleDecoder(m);
     Init_PyNvThreadedDecoder(m);
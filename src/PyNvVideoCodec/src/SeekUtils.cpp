@@ -259,7 +259,7 @@ DecodedFrame SeekUtils::GetFrame(bool bLockFrame)
         tupData = (CUdeviceptr)mDecoder->GetFrame(&tupTimestamp, &seimsg, &event);
     }
 
-    return GetCAIMemoryViewAndDLPack(mDecoder, std::make_tuple(tupData, tupTimestamp, seimsg, event));
+    return GetCAIMemoryViewAndDLPack(mDecoder, std::make_tuple(tupData, tupTimestamp, std::move(seimsg), event), &mExtBufPool);
 }
 
 int SeekUtils::GetKeyNearestKeyFrameIndexForTarget(AVStream* stream,
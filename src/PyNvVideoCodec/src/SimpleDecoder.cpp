@@ -88,6 +88,18 @@ std::vector<DecodedFrame> SimpleDecoder::GetBatchFramesByIndex(std::vector<uint3
     return decoded_frames;
 }
 
+DecodedBatch SimpleDecoder::GetBatchTensor(size_t batchSize)
+{
+    std::vector<DecodedFrame> frames = mDecoderCommon->GetPtrToSeekUtils()->GetFramesByBatch(batchSize);
+    return mDecoderCommon->GetBatchFramePool()->Pack(mDecoderCommon->GetDecoder(), frames);
+}
+
+DecodedBatch SimpleDecoder::GetBatchTensorByIndex(std::vector<uint32_t> indices)
+{
+    ResetDecoderIfRequired(indices);
+    std::vector<DecodedFrame> frames = mDecoderCommon->GetPtrToSeekUtils()->GetFramesByIdxList(indices);
+    return mDecoderCommon->GetBatchFramePool()->Pack(mDecoderCommon->GetDecoder(), frames);
+}
 
 ScannedStreamMetadata SimpleDecoder::GetScannedStreamMetadata()
 {
@@ -154,6 +166,11 @@ int64_t SimpleDecoder::GetSessionInitTime()
     return mDecoderCommon->GetDecoder()->GetSessionInitTime();
 }
 
+uint32_t SimpleDecoder::GetBatchAllocationCount()
+{
+    return mDecoderCommon->GetBatchFramePool()->GetAllocationCount();
+}
+
 void SimpleDecoder::SetSessionCount(uint32_t count)
 {
     NvDecoder::SetSessionCount(count);
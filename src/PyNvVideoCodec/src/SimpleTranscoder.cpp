@@ -52,7 +52,7 @@ SimpleTranscoder::SimpleTranscoder(
     params.encodeConfig = &encodeConfig;
     NV_ENC_BUFFER_FORMAT bufferFormat = NV_ENC_BUFFER_FORMAT_NV12;
     int width, height;
-    switch (mSimpleDecoder->GetDecoderCommonInstance()->GetDecoder()->GetOutputFormat())
+    switch (mSimpleDecoder->GetDecoderCommonInstance()->GetDecoder()->GetNativeOutputFormat())
     {
         case cudaVideoSurfaceFormat_NV12:
         {
@@ -175,6 +175,8 @@ void SimpleTranscoder::TranscodeWithMux()
         mSimpleDecoder->GetDecoderCommonInstance()->GetDemuxer()->GetHeight(),
         vSeqParams.data(), 
         vSeqParams.size()));
+    // packets and their buffers are reused across frames
+    std::vector<NvEncOutputFrame> vPacket;
     try
     {
         do {
@@ -193,7 +195,6 @@ void SimpleTranscoder::TranscodeWithMux()
                 vDts.push_back(pts);
                 
 
-                std::vector<NvEncOutputFrame> vPacket;
                 const NvEncInputFrame* encoderInputFrame = mEncoderCuda->GetNextInputFrame();
 
                 picParams.inputTimeStamp = pts;
@@ -220,7 +221,6 @@ void SimpleTranscoder::TranscodeWithMux()
             }
         } while (nBytes);
 
-        std::vector<NvEncOutputFrame> vPacket;
         mEncoderCuda->EndEncode(vPacket);
         for (int i = 0; i < (int)vPacket.size(); i++)
         {
@@ -55,12 +55,12 @@ void ThreadedDecoder::Initialize()
     mPrevBatchSize = 0;
     mDecodeStopFlag.store(false);
     mDecoderThread = NvThread(std::thread(RunDecoder<DecodedFrame>, mDecoderCommon->GetDemuxer(), mDecoderCommon->GetDecoder(),
-                    std::ref(mDecodedFrames), std::ref(mDecodeStopFlag)));
+                    std::ref(mDecodedFrames), std::ref(mDecodeStopFlag), std::ref(mExtBufPool), mDecoderCommon->GetBatchFramePool()));
 }
 
 template <typename T>
 static void RunDecoder(FFmpegDemuxer* demuxer, NvDecoder* decoder, SPSCBuffer<T>& decodedFrames,
-            std::atomic<bool>& decodeStopFlag)
+            std::atomic<bool>& decodeStopFlag, ExternalBufferPool& extBufPool, BatchFramePool* batchFramePool)
 {
     int nVideoBytes = 0, nFrameReturned = 0, nFrame = 0;
     uint8_t* pVideo = NULL;
@@ -78,8 +78,9 @@ static void RunDecoder(FFmpegDemuxer* demuxer, NvDecoder* decoder, SPSCBuffer<T>
             SEI_MESSAGE seimsg;
             CUevent event = nullptr;
             auto frame_ptr = reinterpret_cast<CUdeviceptr>(decoder->GetLockedFrame(&timestamp, &seimsg, &event));
-            auto tup = std::make_tuple(frame_ptr, timestamp, seimsg, event);
-            DecodedFrame frame = GetCAIMemoryViewAndDLPack(decoder, tup);
+            DecodedFrame frame = GetCAIMemoryViewAndDLPack(decoder, std::make_tuple(frame_ptr, timestamp, std::move(seimsg), event), &extBufPool);
+            // A frame written into a batch tensor keeps the tensor alive while it is referenced
+            frame.extBuf->SetOwner(batchFramePool->ClaimDecodeTarget(frame_ptr));
             decodedFrames.PushEntry(frame);
         }
         nFrame += nFrameReturned;
@@ -108,6 +109,8 @@ void ThreadedDecoder::End()
     // Drain the buffer so as to unlock the frames
     GetBatchFrames(0);
     mDecoderCommon->UnlockLockedFrames(mPrevBatchSize);
+    // The decoder may be replaced before the next Initialize, batch tensors attach it again
+    mDecoderCommon->GetBatchFramePool()->SetDecodeTarget(mDecoderCommon->GetDecoder(), 0);
 
     // reset state
     mPrevBatchSize = 0;
@@ -127,6 +130,26 @@ std::vector<DecodedFrame> ThreadedDecoder::GetBatchFrames(size_t batchSize)
     return frames;
 }
 
+DecodedBatch ThreadedDecoder::GetBatchTensor(size_t batchSize)
+{
+    py::gil_scoped_release release;
+    mDecoderCommon->UnlockLockedFrames(mPrevBatchSize);
+    BatchFramePool* batchFramePool = mDecoderCommon->GetBatchFramePool();
+    // Frames decoded from now on are written into batch tensors in place, Pack hands them out without copying
+    batchFramePool->SetDecodeTarget(mDecoderCommon->GetDecoder(), batchSize);
+    auto frames = mDecodedFrames.PopEntries(batchSize);
+    // As with GetBatchFrames the source frames stay locked until the next call, only the packed batch reaches Python
+    DecodedBatch batch = batchFramePool->Pack(mDecoderCommon->GetDecoder(), frames);
+    mPrevBatchSize = frames.size();
+    py::gil_scoped_acquire acquire;
+    return batch;
+}
+
+uint32_t ThreadedDecoder::GetBatchCopiedFrameCount()
+{
+    return mDecoderCommon->GetBatchFramePool()->GetCopiedFrameCount();
+}
+
 ScannedStreamMetadata ThreadedDecoder::GetScannedStreamMetadata()
 {
     return mDecoderCommon->GetScannedStreamMetadata();
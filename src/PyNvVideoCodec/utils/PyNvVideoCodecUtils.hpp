@@ -107,121 +107,192 @@ inline Pixel_Format GetPixelFormat(const NvDecoder* decoder, const OutputColorTy
 {
     switch (colorType)
     {
-        case OutputColorType::NATIVE: return GetNativeFormat(decoder->GetOutputFormat());
+        case OutputColorType::NATIVE: return GetNativeFormat(decoder->GetNativeOutputFormat());
         case OutputColorType::RGB: return Pixel_Format_RGB;
         case OutputColorType::RGBP: return Pixel_Format_RGBP;
         default: return Pixel_Format_UNDEFINED;
     }
 }
 
-inline DecodedFrame GetCAIMemoryViewAndDLPack(const NvDecoder* decoder, std::tuple<CUdeviceptr, int64_t, SEI_MESSAGE, CUevent> tup)
+inline ViewDataType GetViewDataType(PostProcessDataType eDataType)
 {
-    DecodedFrame frame;
+    switch (eDataType)
+    {
+        case PostProcessDataType::FLOAT16: return ViewDataType::FLOAT16;
+        case PostProcessDataType::FLOAT32: return ViewDataType::FLOAT32;
+        default: return ViewDataType::UINT8;
+    }
+}
 
-    frame.format = GetPixelFormat(decoder, decoder->GetUserOutputColorType());
-    auto width = size_t(decoder->GetWidth());
-    auto height = size_t(decoder->GetHeight());
-    auto data = std::get<0>(tup); 
-    frame.timestamp = std::get<1>(tup);
-	frame.seiMessage = std::get<2>(tup);
-    frame.decoderStreamEvent = reinterpret_cast<size_t>(std::get<3>(tup));
-    frame.decoderStream = reinterpret_cast<size_t>(decoder->GetStream());
+inline Pixel_Format GetPixelFormat(PostProcessFormat eFormat)
+{
+    switch (eFormat)
+    {
+        case PostProcessFormat::RGB: return Pixel_Format_RGB;
+        case PostProcessFormat::RGBP: return Pixel_Format_RGBP;
+        case PostProcessFormat::NV12: return Pixel_Format_NV12;
+        case PostProcessFormat::P016: return Pixel_Format_P016;
+        default: return Pixel_Format_UNDEFINED;
+    }
+}
+
+/**
+* @brief Describes the packed buffer of a ladder output generated along with a decoder output frame.
+*/
+inline LadderFrame GetLadderCAIMemoryViewAndDLPack(const NvDecoder* decoder, const DecodedFrame& parent, const PostProcessOutput& output,
+                                                   CUdeviceptr data, ExternalBufferPool* extBufPool)
+{
+    LadderFrame frame;
+    frame.extBuf = extBufPool ? extBufPool->Acquire() : std::make_shared<ExternalBuffer>();
+    frame.extBuf->SetReadOnly(false);
+    frame.format = GetPixelFormat(output.eFormat);
+    auto stream = parent.decoderStream;
+    auto width = size_t(output.params.nWidth);
+    auto height = size_t(output.params.nHeight);
     switch (frame.format)
     {
         case Pixel_Format_NV12:
-        {
-            frame.views.push_back(CAIMemoryView{ {height, width, 1}, {width, 1, 1}, "|u1",reinterpret_cast<size_t>(decoder->GetStream()) ,(data), false });
-            frame.views.push_back(CAIMemoryView{ {height / 2, width / 2, 2}, {width / 2 * 2, 2, 1}, "|u1",reinterpret_cast<size_t>(decoder->GetStream()),(data + width * height), false });
-            // Load DLPack Tensor
-            std::vector<size_t> shape{ (size_t)(height * 1.5), width };
-            std::vector<size_t> stride{ size_t(width), 1 };
-            int returntype = frame.extBuf->LoadDLPack(shape, stride, "|u1", data,
-                                                      decoder->IsDeviceFrame(), decoder->GetDeviceId(),
-                                                      decoder->GetContext());
-        }
-        break;
         case Pixel_Format_P016:
         {
-            frame.views.push_back(CAIMemoryView{ {height, width, 1}, {width, 1, 1}, "|u2",reinterpret_cast<size_t>(decoder->GetStream()) ,(data), false });
-            frame.views.push_back(CAIMemoryView{ {height / 2, width / 2, 2}, {width / 2 * 2, 2, 1}, "|u2",reinterpret_cast<size_t>(decoder->GetStream()),(data + 2 * (width * height)), false });
-            std::vector<size_t> stride{ size_t(width), 2 };
-            std::vector<size_t> shape{ (size_t)(height * 1.5), width };
-            int returntype = frame.extBuf->LoadDLPack(shape, stride, "|u2", data,
-                                                      decoder->IsDeviceFrame(), decoder->GetDeviceId(),
-                                                      decoder->GetContext());
+            ViewDataType dtype = frame.format == Pixel_Format_P016 ? ViewDataType::UINT16 : ViewDataType::UINT8;
+            size_t elemSize = GetElementSize(dtype);
+            size_t pitch = width * elemSize;
+            frame.views.push_back(CAIMemoryView{ {height, width, 1}, {pitch, elemSize, elemSize}, dtype, stream, (data), false });
+            frame.views.push_back(CAIMemoryView{ {height / 2, width / 2, 2}, {pitch, 2 * elemSize, elemSize}, dtype, stream, (data + pitch * height), false });
+            frame.extBuf->LoadDLPack({ height * 3 / 2, width }, { width, 1 }, dtype, data, true, decoder->GetDeviceId(), decoder->GetContext());
         }
         break;
-        case Pixel_Format_YUV444:
+        case Pixel_Format_RGB:
         {
-            frame.views.push_back(CAIMemoryView{ {height, width, 1}, {width, 1, 1}, "|u1",reinterpret_cast<size_t>(decoder->GetStream()) ,(data), false });
-            frame.views.push_back(CAIMemoryView{ {height, width, 1}, {width, 1, 1}, "|u1",reinterpret_cast<size_t>(decoder->GetStream()),(data + width * height), false });
-            frame.views.push_back(CAIMemoryView{ {height, width, 1}, {width, 1, 1}, "|u1",reinterpret_cast<size_t>(decoder->GetStream()),(data + 2 * (width * height)), false });
-            std::vector<size_t> shape{ (size_t)(height * 3), width };
-            std::vector<size_t> stride{ size_t(width), 1 };
-            int returntype = frame.extBuf->LoadDLPack(shape, stride, "|u1", data,
-                                                      decoder->IsDeviceFrame(), decoder->GetDeviceId(),
-                                                      decoder->GetContext());
+            ViewDataType dtype = GetViewDataType(output.params.eDataType);
+            size_t elemSize = GetElementSize(dtype);
+            frame.views.push_back(CAIMemoryView{ {height, width, 3}, {width * 3 * elemSize, 3 * elemSize, elemSize}, dtype, stream, (data), false });
+            frame.extBuf->LoadDLPack({ height, width, 3 }, { width * 3, 3, 1 }, dtype, data, true, decoder->GetDeviceId(), decoder->GetContext());
         }
         break;
-        case Pixel_Format_YUV444_16Bit:
+        case Pixel_Format_RGBP:
         {
-            frame.views.push_back(CAIMemoryView{ {height, width, 1}, {width, 1, 1}, "|u2",reinterpret_cast<size_t>(decoder->GetStream()) ,(data), false });
-            frame.views.push_back(CAIMemoryView{ {height, width, 1}, {width, 1, 1}, "|u2",reinterpret_cast<size_t>(decoder->GetStream()),(data +  (width * height)), false });
-            frame.views.push_back(CAIMemoryView{ {height, width, 1}, {width, 1, 1}, "|u2",reinterpret_cast<size_t>(decoder->GetStream()),(data + 2 * (width * height)), false });
-            std::vector<size_t> shape{ (size_t)(height * 3), width };
-            std::vector<size_t> stride{ size_t(width) * 2, 2 };
-            int returntype = frame.extBuf->LoadDLPack(shape, stride, "|u2", data,
-                                                      decoder->IsDeviceFrame(), decoder->GetDeviceId(),
-                                                      decoder->GetContext());
+            ViewDataType dtype = GetViewDataType(output.params.eDataType);
+            size_t elemSize = GetElementSize(dtype);
+            size_t planeSize = width * height * elemSize;
+            for (int plane = 0; plane < 3; plane++)
+            {
+                frame.views.push_back(CAIMemoryView{ {height, width}, {width * elemSize, elemSize}, dtype, stream, (data + plane * planeSize), false });
+            }
+            frame.extBuf->LoadDLPack({ 3, height, width }, { width * height, width, 1 }, dtype, data, true, decoder->GetDeviceId(), decoder->GetContext());
         }
         break;
+        default:
+        break;
+    }
+    return frame;
+}
+
+/**
+* @brief Describes a decoder output frame. With an ExternalBufferPool the whole descriptor is built without heap allocations.
+*/
+inline DecodedFrame GetCAIMemoryViewAndDLPack(const NvDecoder* decoder, std::tuple<CUdeviceptr, int64_t, SEI_MESSAGE, CUevent> tup,
+                                              ExternalBufferPool* extBufPool = nullptr)
+{
+    DecodedFrame frame;
+
+    frame.extBuf = extBufPool ? extBufPool->Acquire() : std::make_shared<ExternalBuffer>();
+    frame.format = GetPixelFormat(decoder, decoder->GetUserOutputColorType());
+    auto width = size_t(decoder->GetWidth());
+    auto height = size_t(decoder->GetHeight());
+    auto data = std::get<0>(tup); 
+    frame.timestamp = std::get<1>(tup);
+	frame.seiMessage = std::move(std::get<2>(tup));
+    frame.decoderStreamEvent = reinterpret_cast<size_t>(std::get<3>(tup));
+    frame.decoderStream = reinterpret_cast<size_t>(decoder->GetStream());
+    // Native output frames may be pitched (mapped NVDEC surfaces or pitched allocations).
+    // CAI strides are in bytes, DLPack strides are in elements.
+    auto stream = reinterpret_cast<size_t>(decoder->GetStream());
+    auto pitch = decoder->GetOutputFramePitch();
+    // mapped surfaces belong to the decoder and must not be written by consumers
+    bool readOnly = decoder->IsMappedSurfaceOutput();
+    frame.extBuf->SetReadOnly(readOnly);
+    switch (frame.format)
+    {
+        case Pixel_Format_NV12:
+        case Pixel_Format_P016:
         case Pixel_Format_NV16:
+        case Pixel_Format_P216:
         {
-            frame.views.push_back(CAIMemoryView{ {height, width, 1}, {width, 1, 1}, "|u1",reinterpret_cast<size_t>(decoder->GetStream()) ,(data), false });
-            frame.views.push_back(CAIMemoryView{ {height, width / 2, 2}, {width / 2 * 2, 2, 1}, "|u1",reinterpret_cast<size_t>(decoder->GetStream()),(data + width * height), false });
-            // Load DLPack Tensor
-            std::vector<size_t> shape{ (size_t)(height * 2), width };
-            std::vector<size_t> stride{ size_t(width), 1 };
-            int returntype = frame.extBuf->LoadDLPack(shape, stride, "|u1", data,
-                                                      decoder->IsDeviceFrame(), decoder->GetDeviceId(),
-                                                      decoder->GetContext());
+            bool is16Bit = (frame.format == Pixel_Format_P016 || frame.format == Pixel_Format_P216);
+            bool is422 = (frame.format == Pixel_Format_NV16 || frame.format == Pixel_Format_P216);
+            ViewDataType dtype = is16Bit ? ViewDataType::UINT16 : ViewDataType::UINT8;
+            size_t elemSize = GetElementSize(dtype);
+            size_t chromaHeight = is422 ? height : height / 2;
+            size_t chromaOffset = decoder->GetOutputPlaneOffset(1);
+            frame.views.push_back(CAIMemoryView{ {height, width, 1}, {pitch, elemSize, elemSize}, dtype, stream, (data), readOnly });
+            frame.views.push_back(CAIMemoryView{ {chromaHeight, width / 2, 2}, {pitch, 2 * elemSize, elemSize}, dtype, stream, (data + chromaOffset), readOnly });
+            // Load DLPack Tensor. Luma rows up to the chroma plane are part of the tensor
+            frame.extBuf->LoadDLPack({ chromaOffset / pitch + chromaHeight, width }, { pitch / elemSize, 1 }, dtype, data,
+                                     decoder->IsDeviceFrame(), decoder->GetDeviceId(),
+                                     decoder->GetContext());
         }
         break;
-        case Pixel_Format_P216:
+        case Pixel_Format_YUV444:
+        case Pixel_Format_YUV444_16Bit:
         {
-            frame.views.push_back(CAIMemoryView{ {height, width, 1}, {width, 1, 1}, "|u2",reinterpret_cast<size_t>(decoder->GetStream()) ,(data), false });
-            frame.views.push_back(CAIMemoryView{ {height, width / 2, 2}, {width / 2 * 2, 2, 1}, "|u2",reinterpret_cast<size_t>(decoder->GetStream()),(data + 2 * (width * height)), false });
-            std::vector<size_t> shape{ (size_t)(height * 2), width };
-            std::vector<size_t> stride{ size_t(width), 2 };
-            int returntype = frame.extBuf->LoadDLPack(shape, stride, "|u2", data,
-                                                      decoder->IsDeviceFrame(), decoder->GetDeviceId(),
-                                                      decoder->GetContext());
+            bool is16Bit = (frame.format == Pixel_Format_YUV444_16Bit);
+            ViewDataType dtype = is16Bit ? ViewDataType::UINT16 : ViewDataType::UINT8;
+            size_t elemSize = GetElementSize(dtype);
+            for (int plane = 0; plane < 3; plane++)
+            {
+                frame.views.push_back(CAIMemoryView{ {height, width, 1}, {pitch, elemSize, elemSize}, dtype, stream,
+                                                     (data + decoder->GetOutputPlaneOffset(plane)), readOnly });
+            }
+            frame.extBuf->LoadDLPack({ decoder->GetOutputPlaneOffset(2) / pitch + height, width }, { pitch / elemSize, 1 }, dtype, data,
+                                     decoder->IsDeviceFrame(), decoder->GetDeviceId(),
+                                     decoder->GetContext());
         }
         break;
         case Pixel_Format_RGB:
         {
-            frame.views.push_back(CAIMemoryView{ {height, width, 3}, {width * 3, 3, 1}, "|u1",reinterpret_cast<size_t>(decoder->GetStream()) ,(data), false });
-            std::vector<size_t> shape{ height, width, 3 }; // HWC
-            std::vector<size_t> stride{ width * 3, 3, 1 };
-            int returntype = frame.extBuf->LoadDLPack(shape, stride, "|u1", data,
-                                                      decoder->IsDeviceFrame(), decoder->GetDeviceId(),
-                                                      decoder->GetContext());
+            // Post-processed frames have the target size and element type
+            auto outWidth = size_t(decoder->GetOutputWidth());
+            auto outHeight = size_t(decoder->GetOutputHeight());
+            ViewDataType dtype = GetViewDataType(decoder->GetOutputDataType());
+            size_t elemSize = GetElementSize(dtype);
+            frame.views.push_back(CAIMemoryView{ {outHeight, outWidth, 3}, {outWidth * 3 * elemSize, 3 * elemSize, elemSize}, dtype, stream, (data), false });
+            // HWC
+            frame.extBuf->LoadDLPack({ outHeight, outWidth, 3 }, { outWidth * 3, 3, 1 }, dtype, data,
+                                     decoder->IsDeviceFrame(), decoder->GetDeviceId(),
+                                     decoder->GetContext());
 
         }
         break;
         case Pixel_Format_RGBP:
         {
-            frame.views.push_back(CAIMemoryView{ {height, width}, {width, 1}, "|u1",reinterpret_cast<size_t>(decoder->GetStream()) ,(data), false });
-            frame.views.push_back(CAIMemoryView{ {height, width}, {width, 1}, "|u1",reinterpret_cast<size_t>(decoder->GetStream()) ,(data + (width * height)), false });
-            frame.views.push_back(CAIMemoryView{ {height, width}, {width, 1}, "|u1",reinterpret_cast<size_t>(decoder->GetStream()) ,(data + (2*width*height)), false });
-            std::vector<size_t> shape{ 3, height, width }; // CHW
-            std::vector<size_t> stride{ width * height, width, 1 };
-            int returntype = frame.extBuf->LoadDLPack(shape, stride, "|u1", data,
-                                                      decoder->IsDeviceFrame(), decoder->GetDeviceId(),
-                                                      decoder->GetContext());
+            auto outWidth = size_t(decoder->GetOutputWidth());
+            auto outHeight = size_t(decoder->GetOutputHeight());
+            ViewDataType dtype = GetViewDataType(decoder->GetOutputDataType());
+            size_t elemSize = GetElementSize(dtype);
+            size_t planeSize = outWidth * outHeight * elemSize;
+            frame.views.push_back(CAIMemoryView{ {outHeight, outWidth}, {outWidth * elemSize, elemSize}, dtype, stream, (data), false });
+            frame.views.push_back(CAIMemoryView{ {outHeight, outWidth}, {outWidth * elemSize, elemSize}, dtype, stream, (data + planeSize), false });
+            frame.views.push_back(CAIMemoryView{ {outHeight, outWidth}, {outWidth * elemSize, elemSize}, dtype, stream, (data + 2 * planeSize), false });
+            // CHW
+            frame.extBuf->LoadDLPack({ 3, outHeight, outWidth }, { outWidth * outHeight, outWidth, 1 }, dtype, data,
+                                     decoder->IsDeviceFrame(), decoder->GetDeviceId(),
+                                     decoder->GetContext());
         }
         break;
     }
+
+    frame.pHash = decoder->GetFrameHash(reinterpret_cast<const uint8_t*>(data));
+
+    // the ladder outputs generated from the same decoded picture
+    for (int i = 0; i < decoder->GetLadderSize(); i++)
+    {
+        auto ladderData = reinterpret_cast<CUdeviceptr>(decoder->GetLadderFrame(reinterpret_cast<const uint8_t*>(data), i));
+        if (ladderData)
+        {
+            frame.ladder.push_back(GetLadderCAIMemoryViewAndDLPack(decoder, frame, decoder->GetLadderOutput(i), ladderData, extBufPool));
+        }
+    }
     
     return frame;
 }
@@ -28,6 +28,7 @@
 #include <condition_variable>
 #include <mutex>
 #include <sstream>
+#include <utility>
 #include <vector>
 
 #include "Logger.h"
@@ -103,7 +104,8 @@ public:
 
         // Pop exactly batchSize entries from the mBuffer
         for (size_t i = 0; i < batchSize; ++i) {
-            entries.push_back(mBuffer[mTail]);
+            // Move out so that the ring does not keep references to handed out entries
+            entries.push_back(std::move(mBuffer[mTail]));
             mTail = (mTail + 1) % mCapacity;
             --mCount;
         }
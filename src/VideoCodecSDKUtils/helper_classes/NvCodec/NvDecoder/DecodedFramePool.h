@@ -0,0 +1,353 @@
+/*
+ * This copyright notice applies to this file only
+ *
+ * SPDX-FileCopyrightText: Copyright (c) 2010-2025 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <functional>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+/**
+* @brief State of an output frame slot owned by DecodedFramePool.
+*/
+enum class FrameSlotState
+{
+    FREE,       // buffer available for the next decoded picture
+    WRITING,    // acquired by the display callback, output being generated
+    READY,      // decoded and waiting to be fetched by GetFrame/GetLockedFrame
+    RETURNED,   // handed out by GetFrame, recycled on the next decode call
+    LOCKED,     // handed out by GetLockedFrame, recycled only on unlock
+};
+
+/**
+* @brief Output frame slot. Holds the frame buffer together with the per-frame metadata.
+*/
+template <typename FrameEvent, typename FrameMetadata>
+struct FrameSlot
+{
+    uint8_t* pFrame = nullptr;
+    size_t nBytes = 0;
+    FrameEvent event{};
+    int64_t timestamp = 0;
+    FrameMetadata metadata{};
+    FrameSlotState state = FrameSlotState::FREE;
+    // intrusive links into the list matching the current state
+    int prev = -1;
+    int next = -1;
+};
+
+/**
+* @brief Pool of decoder output frames.
+* Slots live in a contiguous array and are addressed by index. Every slot sits in exactly one
+* intrusive FIFO list (free, ready, returned or locked), so acquiring, fetching, locking and
+* unlocking a slot are all O(1) and never move or copy the frame buffers.
+* The pool does not allocate frame memory nor create events. The owner attaches buffers
+* with SetBuffer() and releases them through ReleaseBuffers()/ForEachSlot(), which keeps the
+* pool independent of CUDA and usable with plain host memory.
+* The pool is not thread safe; callers serialize access (NvDecoder uses m_mtxVPFrame).
+*/
+template <typename FrameEvent, typename FrameMetadata>
+class DecodedFramePool
+{
+public:
+    typedef FrameSlot<FrameEvent, FrameMetadata> Slot;
+
+    explicit DecodedFramePool(size_t nCapacity = 32)
+    {
+        m_vSlots.reserve(nCapacity);
+        m_mapFrameToSlot.reserve(nCapacity);
+    }
+
+    /**
+    *   @brief  Returns a free slot in WRITING state, creating a new one if the free list is empty.
+    *   The returned slot may carry no buffer (or a buffer of a stale size); the caller checks
+    *   pFrame/nBytes and attaches a suitable buffer with SetBuffer().
+    *   @param  bCreated - set to true if a new slot was created
+    */
+    int Acquire(bool* bCreated = nullptr)
+    {
+        int id = PopFront(m_free);
+        if (bCreated)
+        {
+            *bCreated = (id < 0);
+        }
+        if (id < 0)
+        {
+            id = (int)m_vSlots.size();
+            m_vSlots.emplace_back();
+        }
+        Slot& slot = m_vSlots[id];
+        slot.state = FrameSlotState::WRITING;
+        slot.timestamp = 0;
+        slot.metadata = FrameMetadata{};
+        return id;
+    }
+
+    /**
+    *   @brief  Sets a function called with the slot index whenever a slot returns to the free list, e.g. to release a borrowed buffer.
+    */
+    void SetRecycleCallback(std::function<void(int)> fnRecycle) { m_fnRecycle = std::move(fnRecycle); }
+
+    /**
+    *   @brief  Creates a slot in FREE state. Used to populate the pool up front.
+    */
+    int CreateSlot()
+    {
+        int id = (int)m_vSlots.size();
+        m_vSlots.emplace_back();
+        PushBack(m_free, id);
+        return id;
+    }
+
+    /**
+    *   @brief  Attaches a buffer to a slot. Returns the buffer previously attached, which the caller must free.
+    */
+    uint8_t* SetBuffer(int id, uint8_t* pFrame, size_t nBytes)
+    {
+        Slot& slot = m_vSlots[id];
+        uint8_t* pOld = slot.pFrame;
+        if (pOld)
+        {
+            m_mapFrameToSlot.erase(pOld);
+        }
+        slot.pFrame = pFrame;
+        slot.nBytes = pFrame ? nBytes : 0;
+        if (pFrame)
+        {
+            m_mapFrameToSlot[pFrame] = id;
+        }
+        return pOld;
+    }
+
+    /**
+    *   @brief  Marks a WRITING slot as decoded. Ready slots are fetched in commit order.
+    */
+    void Commit(int id)
+    {
+        m_vSlots[id].state = FrameSlotState::READY;
+        PushBack(m_ready, id);
+    }
+
+    /**
+    *   @brief  Fetches the oldest ready slot, or -1 if none.
+    *   @param  bLock - keep the slot out of circulation until Unlock(); otherwise it is recycled on the next BeginDecode()
+    */
+    int PopReady(bool bLock)
+    {
+        int id = PopFront(m_ready);
+        if (id < 0)
+        {
+            return -1;
+        }
+        m_vSlots[id].state = bLock ? FrameSlotState::LOCKED : FrameSlotState::RETURNED;
+        PushBack(bLock ? m_locked : m_returned, id);
+        return id;
+    }
+
+    /**
+    *   @brief  Recycles all slots that are neither locked nor being written. Called at the start of every decode call,
+    *   which invalidates the frames returned by the previous one.
+    */
+    void BeginDecode()
+    {
+        Splice(m_returned);
+        Splice(m_ready);
+    }
+
+    /**
+    *   @brief  Returns the slot holding pFrame, or -1 if the buffer does not belong to the pool.
+    */
+    int Find(const uint8_t* pFrame) const
+    {
+        auto it = m_mapFrameToSlot.find(const_cast<uint8_t*>(pFrame));
+        return it == m_mapFrameToSlot.end() ? -1 : it->second;
+    }
+
+    /**
+    *   @brief  Returns a locked slot to the free list. Returns false if the slot is not locked.
+    */
+    bool Unlock(int id)
+    {
+        if (id < 0 || id >= (int)m_vSlots.size() || m_vSlots[id].state != FrameSlotState::LOCKED)
+        {
+            return false;
+        }
+        Unlink(m_locked, id);
+        m_vSlots[id].state = FrameSlotState::FREE;
+        PushBack(m_free, id);
+        if (m_fnRecycle)
+        {
+            m_fnRecycle(id);
+        }
+        return true;
+    }
+
+    /**
+    *   @brief  Unlocks up to nCount slots in the order they were locked. Returns the number of slots unlocked.
+    */
+    uint32_t UnlockOldest(uint32_t nCount)
+    {
+        uint32_t nUnlocked = 0;
+        for (; nUnlocked < nCount && m_locked.head >= 0; nUnlocked++)
+        {
+            Unlock(m_locked.head);
+        }
+        return nUnlocked;
+    }
+
+    /**
+    *   @brief  Detaches the buffers of all free and returned slots and passes them to fnRelease.
+    *   Ready, in-flight and locked slots keep their buffers since they still hold frames that
+    *   have not been consumed; a stale buffer is replaced when its slot is acquired again.
+    */
+    template <typename Fn>
+    void ReleaseBuffers(Fn fnRelease)
+    {
+        for (int id = 0; id < (int)m_vSlots.size(); id++)
+        {
+            FrameSlotState state = m_vSlots[id].state;
+            if ((state == FrameSlotState::FREE || state == FrameSlotState::RETURNED) && m_vSlots[id].pFrame)
+            {
+                fnRelease(SetBuffer(id, nullptr, 0));
+            }
+        }
+    }
+
+    /**
+    *   @brief  Visits every slot, regardless of state. Used for teardown.
+    */
+    template <typename Fn>
+    void ForEachSlot(Fn fn)
+    {
+        for (Slot& slot : m_vSlots)
+        {
+            fn(slot);
+        }
+    }
+
+    Slot& operator[](int id) { return m_vSlots[id]; }
+    const Slot& operator[](int id) const { return m_vSlots[id]; }
+
+    size_t Size() const { return m_vSlots.size(); }
+    size_t ReadyCount() const { return m_ready.count; }
+    size_t LockedCount() const { return m_locked.count; }
+    size_t FreeCount() const { return m_free.count; }
+
+private:
+    struct SlotList
+    {
+        int head = -1;
+        int tail = -1;
+        size_t count = 0;
+    };
+
+    void PushBack(SlotList& list, int id)
+    {
+        Slot& slot = m_vSlots[id];
+        slot.prev = list.tail;
+        slot.next = -1;
+        if (list.tail >= 0)
+        {
+            m_vSlots[list.tail].next = id;
+        }
+        else
+        {
+            list.head = id;
+        }
+        list.tail = id;
+        list.count++;
+    }
+
+    void Unlink(SlotList& list, int id)
+    {
+        Slot& slot = m_vSlots[id];
+        if (slot.prev >= 0)
+        {
+            m_vSlots[slot.prev].next = slot.next;
+        }
+        else
+        {
+            list.head = slot.next;
+        }
+        if (slot.next >= 0)
+        {
+            m_vSlots[slot.next].prev = slot.prev;
+        }
+        else
+        {
+            list.tail = slot.prev;
+        }
+        slot.prev = slot.next = -1;
+        list.count--;
+    }
+
+    int PopFront(SlotList& list)
+    {
+        int id = list.head;
+        if (id >= 0)
+        {
+            Unlink(list, id);
+        }
+        return id;
+    }
+
+    // Moves all slots of a list to the tail of the free list.
+    void Splice(SlotList& list)
+    {
+        for (int id = list.head; id >= 0; id = m_vSlots[id].next)
+        {
+            m_vSlots[id].state = FrameSlotState::FREE;
+            if (m_fnRecycle)
+            {
+                m_fnRecycle(id);
+            }
+        }
+        if (list.head < 0)
+        {
+            return;
+        }
+        if (m_free.tail >= 0)
+        {
+            m_vSlots[m_free.tail].next = list.head;
+            m_vSlots[list.head].prev = m_free.tail;
+        }
+        else
+        {
+            m_free.head = list.head;
+        }
+        m_free.tail = list.tail;
+        m_free.count += list.count;
+        list = SlotList();
+    }
+
+private:
+    std::vector<Slot> m_vSlots;
+    std::unordered_map<uint8_t*, int> m_mapFrameToSlot;
+    std::function<void(int)> m_fnRecycle;
+    SlotList m_free, m_ready, m_returned, m_locked;
+};
@@ -325,7 +325,8 @@ int NvDecoder::HandleVideoSequence(CUVIDEOFORMAT *pVideoFormat)
         videoDecodeCreateInfo.DeinterlaceMode = cudaVideoDeinterlaceMode_Weave;
     else
         videoDecodeCreateInfo.DeinterlaceMode = cudaVideoDeinterlaceMode_Adaptive;
-    videoDecodeCreateInfo.ulNumOutputSurfaces = 2;
+    // Mapped surfaces stay mapped while the application holds the frame
+    videoDecodeCreateInfo.ulNumOutputSurfaces = m_bMappedSurfaceOutput ? m_nMaxMappedSurfaces : 2;
     // With PreferCUVID, JPEG is still decoded by CUDA while video is decoded by NVDEC hardware
     videoDecodeCreateInfo.ulCreationFlags = cudaVideoCreate_PreferCUVID;
     videoDecodeCreateInfo.ulNumDecodeSurfaces = nDecodeSurface;
@@ -401,21 +402,11 @@ int NvDecoder::HandleVideoSequence(CUVIDEOFORMAT *pVideoFormat)
 
     CUDA_DRVAPI_CALL(cuCtxPushCurrent(m_cuContext));
     NVDEC_API_CALL(m_api.cuvidCreateDecoder(&m_hDecoder, &videoDecodeCreateInfo));
-    uint8_t* pFrame[8] = { NULL };
-    if (m_bUseDeviceFrame)
-    {
-        if (m_bEnableAsyncAllocations)
-        {
-            for (size_t i = 0; i < 8; i++)
-            {
-                CUDA_DRVAPI_CALL(cuMemAllocAsync((CUdeviceptr*)&pFrame[i], GetFrameSize(), m_cuvidStream));
-            }
-        }
-    }
-    else
+    if (!m_bUseDeviceFrame)
     {
-        CUDA_DRVAPI_CALL(cuMemAlloc((CUdeviceptr *)&m_dpScratchFrame, GetOutputFrameSize()));
+        CUDA_DRVAPI_CALL(cuMemAlloc((CUdeviceptr *)&m_dpScratchFrame, GetFrameBufferSize()));
     }
+    PreallocateFrames();
     CUDA_DRVAPI_CALL(cuCtxPopCurrent(NULL));
     STOP_TIMER("Session Initialization Time: ");
     NvDecoder::addDecoderSessionOverHead(getDecoderSessionID(), elapsedTime);
@@ -528,29 +519,13 @@ int NvDecoder::ReconfigureDecoder(CUVIDEOFORMAT *pVideoFormat)
     CUDA_DRVAPI_CALL(cuCtxPushCurrent(m_cuContext));
     NVDEC_API_CALL(m_api.cuvidReconfigureDecoder(m_hDecoder, &reconfigParams));
     
-    //deallocate earlier buffers
-    for (uint8_t* pFrame : m_vpFrame)
+    //deallocate earlier buffers, frames not consumed yet are reallocated when their slot is reused.
+    //Preallocated buffers are sized for max width/height and are kept as is, mapped surfaces are not owned.
+    if (!m_nPreallocFrames && !m_bMappedSurfaceOutput)
     {
-        if (m_bUseDeviceFrame)
-        {
-            if (m_bEnableAsyncAllocations)
-            {
-                CUDA_DRVAPI_CALL(cuMemFreeAsync((*(CUdeviceptr*)&pFrame), NULL));//sync on NULL stream to ensure that all work is completed before dtor
-            }
-        }
+        std::lock_guard<std::mutex> lock(m_mtxVPFrame);
+        m_framePool.ReleaseBuffers([this](uint8_t* pFrame) { FreeFrameBuffer(pFrame); });
     }
-    //recreate new buffers
-    uint8_t* pFrame[8] = { NULL };
-    if (m_bUseDeviceFrame)
-        {
-            if (m_bEnableAsyncAllocations)
-            {
-                for (size_t i = 0; i < 8; i++)
-                {
-                    CUDA_DRVAPI_CALL(cuMemAllocAsync((CUdeviceptr*)&pFrame[i], GetFrameSize(), m_cuvidStream));
-                }
-            }
-        }
     CUDA_DRVAPI_CALL(cuCtxPopCurrent(NULL));
     STOP_TIMER("Session Reconfigure Time: ");
 
@@ -569,7 +544,7 @@ std::vector<std::tuple<CUdeviceptr, int64_t, SEI_MESSAGE, CUevent>> NvDecoder::P
         CUevent event = nullptr;
         CUdeviceptr  data = (CUdeviceptr)this->GetFrame(&timestamp, &seiMessage, &event);
         auto outputFormat = this->GetOutputFormat();
-        std::tuple<CUdeviceptr, int64_t, SEI_MESSAGE, CUevent> frame(data, timestamp, seiMessage, event);
+        std::tuple<CUdeviceptr, int64_t, SEI_MESSAGE, CUevent> frame(data, timestamp, std::move(seiMessage), event);
          
         switch (outputFormat)
         {
@@ -584,7 +559,7 @@ std::vector<std::tuple<CUdeviceptr, int64_t, SEI_MESSAGE, CUevent>> NvDecoder::P
         }
         default: throw std::runtime_error("TODO: not implemented buffer format");
         }
-        frames.push_back(frame);
+        frames.push_back(std::move(frame));
     }
 
     return frames;
@@ -606,25 +581,13 @@ int NvDecoder::setReconfigParams( const Dim& mResizeDim)
     else
     {
         m_bReconfigExternal = true;
-        if ((mResizeDim.w != m_resizeDim.w) || (mResizeDim.h != m_resizeDim.h))
+        if (((mResizeDim.w != m_resizeDim.w) || (mResizeDim.h != m_resizeDim.h)) && !m_nPreallocFrames && !m_bMappedSurfaceOutput)
         {
             // Clear existing output buffers of different size
-            uint8_t* pFrame = NULL;
-            while (!m_vpFrame.empty())
-            {
-                pFrame = m_vpFrame.back();
-                m_vpFrame.pop_back();
-                if (m_bUseDeviceFrame)
-                {
-                    CUDA_DRVAPI_CALL(cuCtxPushCurrent(m_cuContext));
-                    CUDA_DRVAPI_CALL(cuMemFree((CUdeviceptr)pFrame));
-                    CUDA_DRVAPI_CALL(cuCtxPopCurrent(NULL));
-                }
-                else
-                {
-                    delete pFrame;
-                }
-            }
+            std::lock_guard<std::mutex> lock(m_mtxVPFrame);
+            CUDA_DRVAPI_CALL(cuCtxPushCurrent(m_cuContext));
+            m_framePool.ReleaseBuffers([this](uint8_t* pFrame) { FreeFrameBuffer(pFrame); });
+            CUDA_DRVAPI_CALL(cuCtxPopCurrent(NULL));
         }
         m_resizeDim.w = mResizeDim.w;
         m_resizeDim.h = mResizeDim.h;
@@ -636,6 +599,11 @@ int NvDecoder::setReconfigParams( const Dim& mResizeDim)
 
 void NvDecoder::GenerateNativeOutput(CUdeviceptr dpSrcFrame, unsigned int nSrcPitch, uint8_t* pDecodedFrame)
 {
+    if (IsBitDepthConverted())
+    {
+        GenerateConvertedNativeOutput(dpSrcFrame, nSrcPitch, pDecodedFrame);
+        return;
+    }
     // Copy luma plane
     CUDA_MEMCPY2D m = { 0 };
     m.srcMemoryType = CU_MEMORYTYPE_DEVICE;
@@ -664,10 +632,29 @@ void NvDecoder::GenerateNativeOutput(CUdeviceptr dpSrcFrame, unsigned int nSrcPi
     }
 }
 
+void NvDecoder::GenerateConvertedNativeOutput(CUdeviceptr dpSrcFrame, unsigned int nSrcPitch, uint8_t* pDecodedFrame)
+{
+    uint8_t* pDst = m_bUseDeviceFrame ? pDecodedFrame : (uint8_t*)m_dpScratchFrame;
+    int nDstPitch = m_bUseDeviceFrame && m_nDeviceFramePitch ? (int)m_nDeviceFramePitch : GetWidth();
+    // NVDEC output has luma height aligned by 2
+    size_t nSrcPlaneRows = (m_nSurfaceHeight + 1) & ~1;
+    ConvertUInt16ToUInt8Rounded((const uint16_t*)dpSrcFrame, pDst, nSrcPitch, nDstPitch, GetWidth(), m_nLumaHeight, m_bDither, m_cuvidStream);
+    for (unsigned int nPlane = 1; nPlane <= m_nNumChromaPlanes; nPlane++)
+    {
+        // semi-planar chroma rows hold GetWidth() interleaved samples as well
+        ConvertUInt16ToUInt8Rounded((const uint16_t*)(dpSrcFrame + nSrcPitch * nSrcPlaneRows * nPlane), pDst + (size_t)nDstPitch * m_nLumaHeight * nPlane,
+            nSrcPitch, nDstPitch, GetWidth(), m_nChromaHeight, m_bDither, m_cuvidStream);
+    }
+    if (!m_bUseDeviceFrame)
+    {
+        CUDA_DRVAPI_CALL(cuMemcpyDtoHAsync(pDecodedFrame, m_dpScratchFrame, GetFrameSize(), m_cuvidStream));
+    }
+}
+
 void NvDecoder::GenerateRGBOutput(CUdeviceptr dpSrcFrame, unsigned int nSrcPitch, uint8_t* pDecodedFrame)
 {   
     constexpr uint32_t perPixelComponents = 3;
-    auto matrixCoefficients = GetVideoFormatInfo().video_signal_description.matrix_coefficients;
+    auto matrixCoefficients = GetResolvedColorimetry().iMatrix;
     auto outputFormat = GetOutputFormat();
     switch (outputFormat)
     {
@@ -702,7 +689,7 @@ void NvDecoder::GenerateRGBOutput(CUdeviceptr dpSrcFrame, unsigned int nSrcPitch
 
 void NvDecoder::GenerateRGBPOutput(CUdeviceptr dpSrcFrame, unsigned int nSrcPitch, uint8_t* pDecodedFrame)
 {
-    auto matrixCoefficients = GetVideoFormatInfo().video_signal_description.matrix_coefficients;
+    auto matrixCoefficients = GetResolvedColorimetry().iMatrix;
     auto outputFormat = GetOutputFormat();
     switch (outputFormat)
     {
@@ -736,6 +723,96 @@ void NvDecoder::GenerateRGBPOutput(CUdeviceptr dpSrcFrame, unsigned int nSrcPitc
 
 }
 
+PostProcessSource NvDecoder::GetPostProcessSource(CUdeviceptr dpSrcFrame, unsigned int nSrcPitch)
+{
+    PostProcessSource src;
+    src.pFrame = (const uint8_t*)dpSrcFrame;
+    src.nPitch = nSrcPitch;
+    src.nWidth = GetWidth();
+    src.nHeight = GetHeight();
+    // chroma planes of a mapped surface start after the luma height aligned by 2
+    src.nChromaRow = (m_nSurfaceHeight + 1) & ~1;
+    src.nBytesPerSample = m_nBPP;
+    switch (GetOutputFormat())
+    {
+        case cudaVideoSurfaceFormat_NV16:
+        case cudaVideoSurfaceFormat_P216:
+            src.eChroma = PostProcessChroma::YUV422;
+            break;
+        case cudaVideoSurfaceFormat_YUV444:
+        case cudaVideoSurfaceFormat_YUV444_16Bit:
+            src.eChroma = PostProcessChroma::YUV444;
+            break;
+        default:
+            src.eChroma = PostProcessChroma::YUV420;
+            break;
+    }
+    return src;
+}
+
+void NvDecoder::GeneratePostProcessOutput(CUdeviceptr dpSrcFrame, unsigned int nSrcPitch, uint8_t* pDecodedFrame,
+    const PostProcessColorimetry& colorimetry)
+{
+    PostProcessParams params;
+    if (!ResolvePostProcessParams(m_postProcess, GetWidth(), GetHeight(), &params))
+    {
+        PYNVVC_THROW_ERROR("Post-process roi does not fit in the decoded frame", CUDA_ERROR_INVALID_VALUE);
+    }
+    // also used without post-processing for the conversions the fixed RGB kernels do not handle
+    params.eLayout = m_eUserOutputColorType == OutputColorType::RGBP ? PostProcessLayout::CHW : PostProcessLayout::HWC;
+    YuvToRgbPostProcess(GetPostProcessSource(dpSrcFrame, nSrcPitch), pDecodedFrame, params, colorimetry, m_cuvidStream);
+}
+
+void NvDecoder::GenerateLadderOutput(CUdeviceptr dpSrcFrame, unsigned int nSrcPitch, uint8_t* const* apLadderFrame)
+{
+    PostProcessOutput aOutput[PostProcessMaxOutputs];
+    for (size_t i = 0; i < m_vLadder.size(); i++)
+    {
+        if (!ResolvePostProcessOutput(m_vLadder[i], GetWidth(), GetHeight(), &aOutput[i]))
+        {
+            PYNVVC_THROW_ERROR("Ladder output roi does not fit in the decoded frame", CUDA_ERROR_INVALID_VALUE);
+        }
+    }
+    YuvToLadder(GetPostProcessSource(dpSrcFrame, nSrcPitch), aOutput, apLadderFrame, (int)m_vLadder.size(),
+        GetResolvedColorimetry(), m_cuvidStream);
+}
+
+void NvDecoder::AllocateLadderFrames(int nSlot, bool bPreallocate)
+{
+    if ((int)m_vLadderFrames.size() <= nSlot)
+    {
+        m_vLadderFrames.resize(nSlot + 1);
+    }
+    std::vector<std::pair<uint8_t*, size_t>>& vFrames = m_vLadderFrames[nSlot];
+    vFrames.resize(m_vLadder.size(), std::make_pair(nullptr, (size_t)0));
+    for (size_t i = 0; i < m_vLadder.size(); i++)
+    {
+        PostProcessOutput output = GetLadderOutput((int)i);
+        if (bPreallocate && !ResolvePostProcessOutput(m_vLadder[i], m_nMaxWidth, m_nMaxHeight, &output))
+        {
+            continue;
+        }
+        size_t nBytes = GetPostProcessOutputSize(output);
+        // Preallocated buffers hold the output of any sequence up to max width/height
+        if (vFrames[i].first && (m_nPreallocFrames ? vFrames[i].second >= nBytes : vFrames[i].second == nBytes))
+        {
+            continue;
+        }
+        if (vFrames[i].first)
+        {
+            CUDA_DRVAPI_CALL(cuMemFree((CUdeviceptr)vFrames[i].first));
+            vFrames[i].first = nullptr;
+        }
+        CUdeviceptr dpFrame = 0;
+        CUDA_DRVAPI_CALL(cuMemAlloc(&dpFrame, nBytes));
+        if (!bPreallocate)
+        {
+            m_framePoolStats.nDecodeTimeAllocations++;
+        }
+        vFrames[i] = std::make_pair((uint8_t*)dpFrame, nBytes);
+    }
+}
+
 void NvDecoder::GenerateOutput(CUdeviceptr dpSrcFrame, unsigned int nSrcPitch, uint8_t* pDecodedFrame)
 {
     switch (m_eUserOutputColorType)
@@ -746,13 +823,29 @@ void NvDecoder::GenerateOutput(CUdeviceptr dpSrcFrame, unsigned int nSrcPitch, u
         case OutputColorType::RGB:
         {
             auto deviceFrame = m_bUseDeviceFrame ? pDecodedFrame : (uint8_t*)m_dpScratchFrame;
-            GenerateRGBOutput(dpSrcFrame, nSrcPitch, deviceFrame);
+            PostProcessColorimetry colorimetry = GetResolvedColorimetry();
+            if (m_bPostProcess || colorimetry.NeedsFullConversion())
+            {
+                GeneratePostProcessOutput(dpSrcFrame, nSrcPitch, deviceFrame, colorimetry);
+            }
+            else
+            {
+                GenerateRGBOutput(dpSrcFrame, nSrcPitch, deviceFrame);
+            }
             break;
         }
         case OutputColorType::RGBP:
         {
             auto deviceFrame = m_bUseDeviceFrame ? pDecodedFrame : (uint8_t*)m_dpScratchFrame;
-            GenerateRGBPOutput(dpSrcFrame, nSrcPitch, deviceFrame);
+            PostProcessColorimetry colorimetry = GetResolvedColorimetry();
+            if (m_bPostProcess || colorimetry.NeedsFullConversion())
+            {
+                GeneratePostProcessOutput(dpSrcFrame, nSrcPitch, deviceFrame, colorimetry);
+            }
+            else
+            {
+                GenerateRGBPOutput(dpSrcFrame, nSrcPitch, deviceFrame);
+            }
             break;
         }
         default:
@@ -761,8 +854,9 @@ void NvDecoder::GenerateOutput(CUdeviceptr dpSrcFrame, unsigned int nSrcPitch, u
     }
     if (!m_bUseDeviceFrame)
     {
-        // copy the output to host
-        cuMemcpyDtoH(pDecodedFrame, m_dpScratchFrame, GetOutputFrameSize());
+        // copy the output to pinned host memory. Scratch frame is reused only by later work on the same stream,
+        // consumers sync on the frame event before reading the host buffer
+        CUDA_DRVAPI_CALL(cuMemcpyDtoHAsync(pDecodedFrame, m_dpScratchFrame, GetOutputFrameSize(), m_cuvidStream));
     }
 }
 
@@ -809,6 +903,10 @@ int NvDecoder::HandlePictureDisplay(CUVIDPARSERDISPINFO *pDispInfo) {
     unsigned int nSrcPitch = 0;
     CUDA_DRVAPI_CALL(cuCtxPushCurrent(m_cuContext));
     NVTX_SCOPED_RANGE("display")
+    if (m_bMappedSurfaceOutput)
+    {
+        return HandleMappedPictureDisplay(pDispInfo, &videoProcessingParameters);
+    }
     if (m_nSeekPts == 0 || pDispInfo->timestamp >= m_nSeekPts)
     {
 
@@ -824,46 +922,76 @@ int NvDecoder::HandlePictureDisplay(CUVIDPARSERDISPINFO *pDispInfo) {
     }
 
     uint8_t *pDecodedFrame = nullptr;
+    uint8_t *apLadderFrame[PostProcessMaxOutputs] = {};
+    uint64_t *pHash = nullptr;
+    CUevent decodedFrameEvent = NULL;
+    int nSlot = -1;
     {
         std::lock_guard<std::mutex> lock(m_mtxVPFrame);
-        if ((unsigned)++m_nDecodedFrame > m_vpFrame.size())
+        bool bNewSlot = false;
+        nSlot = m_framePool.Acquire(&bNewSlot);
+        if (bNewSlot)
+        {
+            CUDA_DRVAPI_CALL(cuEventCreate(&m_framePool[nSlot].event, CU_EVENT_DISABLE_TIMING));
+        }
+        // The size of a pitched buffer is 0 until the first allocation has set the pitch
+        size_t nFrameBytes = GetFrameBufferSize();
+        if (!m_framePool[nSlot].pFrame || !nFrameBytes || m_framePool[nSlot].nBytes != nFrameBytes)
         {
-            // Not enough frames in stock
-            m_nFrameAlloc++;
-            uint8_t *pFrame = NULL;
-            if (m_bUseDeviceFrame)
+            // Not enough frames in stock or the stocked buffer is of a different size
+            m_framePoolStats.nDecodeTimeAllocations++;
+            uint8_t* pFrame = AllocateFrameBuffer(nFrameBytes);
+            // query the size again, a pitched allocation updates the frame pitch
+            FreeFrameBuffer(m_framePool.SetBuffer(nSlot, pFrame, GetFrameBufferSize()));
+        }
+        // frames before the seek point are not generated, they get no output target
+        AcquireOutputTarget(nSlot, m_nSeekPts == 0 || pDispInfo->timestamp >= m_nSeekPts);
+        pDecodedFrame = GetSlotOutput(nSlot);
+        decodedFrameEvent = m_framePool[nSlot].event;
+        if (!m_vLadder.empty())
+        {
+            AllocateLadderFrames(nSlot);
+            for (size_t i = 0; i < m_vLadder.size(); i++)
             {
-                if (m_bDeviceFramePitched)
-                {
-                    CUDA_DRVAPI_CALL(cuMemAllocPitch((CUdeviceptr *)&pFrame, &m_nDeviceFramePitch, GetWidth() * m_nBPP, m_nLumaHeight + (m_nChromaHeight * m_nNumChromaPlanes), 16));
-                }
-                else if (m_bEnableAsyncAllocations)
-                {
-                    CUDA_DRVAPI_CALL(cuMemAllocAsync((CUdeviceptr*)&pFrame, GetOutputFrameSize(), m_cuvidStream));
-                }
-                else
-                {
-                    CUDA_DRVAPI_CALL(cuMemAlloc((CUdeviceptr *)&pFrame, GetOutputFrameSize()));
-                }
+                apLadderFrame[i] = m_vLadderFrames[nSlot][i].first;
             }
-            else
+        }
+        if (m_bFrameHash)
+        {
+            if (nSlot >= (int)m_vFrameHash.size() || !m_vFrameHash[nSlot])
             {
-                pFrame = new uint8_t[GetOutputFrameSize()];
+                m_framePoolStats.nDecodeTimeAllocations++;
             }
-            m_vpFrame.push_back(pFrame);
-            
-            CUevent event;
-            CUDA_DRVAPI_CALL(cuEventCreate(&event, 0));
-            m_DecodedFrameEvent.push_back(event);
+            pHash = GetSlotFrameHash(nSlot);
         }
-        pDecodedFrame = m_vpFrame[m_nDecodedFrame - 1];
     }
     
     if (m_nSeekPts == 0 || pDispInfo->timestamp >= m_nSeekPts)
     {
-        GenerateOutput(dpSrcFrame, nSrcPitch, pDecodedFrame);
+        if (m_bExtractSEIMessage)
+        {
+            UpdateHdrMetadata(pDispInfo->picture_index);
+        }
+        // Native device frames are copied by the hash kernel, so the surface is read once for both
+        bool bFusedHash = pHash && m_eUserOutputColorType == OutputColorType::NATIVE && m_bUseDeviceFrame && !IsBitDepthConverted();
+        if (bFusedHash)
+        {
+            GenerateFrameHash(dpSrcFrame, nSrcPitch, pDecodedFrame, pHash, true);
+        }
+        else
+        {
+            GenerateOutput(dpSrcFrame, nSrcPitch, pDecodedFrame);
+        }
+        if (!m_vLadder.empty())
+        {
+            GenerateLadderOutput(dpSrcFrame, nSrcPitch, apLadderFrame);
+        }
+        if (pHash && !bFusedHash)
+        {
+            GenerateFrameHash(dpSrcFrame, nSrcPitch, pDecodedFrame, pHash);
+        }
         // Record event for this frame on  cuvid stream. This is essential for application sync
-        CUDA_DRVAPI_CALL(cuEventRecord(m_DecodedFrameEvent[m_nDecodedFrame - 1], m_cuvidStream));
+        CUDA_DRVAPI_CALL(cuEventRecord(decodedFrameEvent, m_cuvidStream));
         if (m_bUseDeviceFrame)
         {
             if (m_bEnableAsyncAllocations)
@@ -881,10 +1009,9 @@ int NvDecoder::HandlePictureDisplay(CUVIDPARSERDISPINFO *pDispInfo) {
     }
     
 
-    if ((int)m_vTimestamp.size() < m_nDecodedFrame) {
-        m_vTimestamp.resize(m_vpFrame.size());
-    }
-    m_vTimestamp[m_nDecodedFrame - 1] = pDispInfo->timestamp;
+    // Slot is in WRITING state, so it cannot be recycled or handed out until it is committed below
+    m_framePool[nSlot].timestamp = pDispInfo->timestamp;
+    SEI_MESSAGE& seiMessage = m_framePool[nSlot].metadata;
 
     if (m_bExtractSEIMessage)
     {
@@ -897,11 +1024,7 @@ int NvDecoder::HandlePictureDisplay(CUVIDPARSERDISPINFO *pDispInfo) {
                 uint32_t seiNumMessages = m_SEIMessagesDisplayOrder[pDispInfo->picture_index][field].sei_message_count;
                 CUSEIMESSAGE* seiMessagesInfo = m_SEIMessagesDisplayOrder[pDispInfo->picture_index][field].pSEIMessage;
 
-                if ((int)m_vSEIMessage.size() < m_nDecodedFrame)
-                {
-                    m_vSEIMessage.resize(m_vpFrame.size());
-                }
-                m_vSEIMessage[m_nDecodedFrame - 1].resize(seiNumMessages);
+                seiMessage.resize(seiNumMessages);
 
                 if (m_fpSEI)
                 {
@@ -966,10 +1089,10 @@ int NvDecoder::HandlePictureDisplay(CUVIDPARSERDISPINFO *pDispInfo) {
                             fwrite(seiBuffer, seiMessagesInfo[i].sei_message_size, 1, m_fpSEI);
                         }
                         // Fill SEI_MESSAGE to send it to python
-                        m_vSEIMessage[m_nDecodedFrame - 1][i].first.insert({"sei_type", seiMessagesInfo[i].sei_message_type});
-                        m_vSEIMessage[m_nDecodedFrame - 1][i].first.insert({"sei_uncompressed", bIsUncompressed});
-                        m_vSEIMessage[m_nDecodedFrame - 1][i].second.resize(seiMessagesInfo[i].sei_message_size);
-                        m_vSEIMessage[m_nDecodedFrame - 1][i].second.assign(seiBuffer, seiBuffer + seiMessagesInfo[i].sei_message_size);
+                        seiMessage[i].first.insert({"sei_type", seiMessagesInfo[i].sei_message_type});
+                        seiMessage[i].first.insert({"sei_uncompressed", bIsUncompressed});
+                        seiMessage[i].second.resize(seiMessagesInfo[i].sei_message_size);
+                        seiMessage[i].second.assign(seiBuffer, seiBuffer + seiMessagesInfo[i].sei_message_size);
                         seiBuffer += seiMessagesInfo[i].sei_message_size;
                     }
                 }
@@ -986,9 +1109,56 @@ int NvDecoder::HandlePictureDisplay(CUVIDPARSERDISPINFO *pDispInfo) {
         NVDEC_API_CALL(m_api.cuvidUnmapVideoFrame(m_hDecoder, dpSrcFrame));
     }
 
+    {
+        std::lock_guard<std::mutex> lock(m_mtxVPFrame);
+        m_framePool.Commit(nSlot);
+        m_nDecodedFrame++;
+    }
+
     return 1;
 }
 
+void NvDecoder::UpdateHdrMetadata(int nPicIdx)
+{
+    if (m_eCodec != cudaVideoCodec_H264 && m_eCodec != cudaVideoCodec_HEVC)
+    {
+        return;
+    }
+    for (int field = 0; field < 2; field++)
+    {
+        const CUVIDSEIMESSAGEINFO& info = m_SEIMessagesDisplayOrder[nPicIdx][field];
+        const uint8_t* seiBuffer = (const uint8_t*)info.pSEIData;
+        if (!seiBuffer)
+        {
+            continue;
+        }
+        float fMaxCll = 0.0f, fMasteringPeak = 0.0f;
+        for (uint32_t i = 0; i < info.sei_message_count; i++)
+        {
+            const CUSEIMESSAGE& message = info.pSEIMessage[i];
+            if (message.sei_message_type == SEI_TYPE_CONTENT_LIGHT_LEVEL_INFO && message.sei_message_size >= sizeof(SEICONTENTLIGHTLEVELINFO))
+            {
+                fMaxCll = ((const SEICONTENTLIGHTLEVELINFO*)seiBuffer)->max_content_light_level;
+            }
+            else if (message.sei_message_type == SEI_TYPE_MASTERING_DISPLAY_COLOR_VOLUME && message.sei_message_size >= sizeof(SEIMASTERINGDISPLAYINFO))
+            {
+                // in units of 0.0001 cd/m2
+                fMasteringPeak = ((const SEIMASTERINGDISPLAYINFO*)seiBuffer)->max_display_mastering_luminance * 0.0001f;
+            }
+            seiBuffer += message.sei_message_size;
+        }
+        // the content light level describes the content itself, prefer it over the mastering display
+        if (fMaxCll > 0.0f)
+        {
+            m_fStreamPeakLuminance = fMaxCll;
+        }
+        else if (fMasteringPeak > 0.0f)
+        {
+            m_fStreamPeakLuminance = fMasteringPeak;
+        }
+    }
+}
+
 int NvDecoder::GetSEIMessage(CUVIDSEIMESSAGEINFO *pSEIMessageInfo)
 {
     uint32_t seiNumMessages = pSEIMessageInfo->sei_message_count;
@@ -1042,7 +1212,8 @@ NvDecoder::NvDecoder(int32_t gpuId, CUstream cuStream,CUcontext cuContext, bool
     ) :
     m_GpuId(gpuId), m_cuvidStream(cuStream),m_cuContext(cuContext), m_bUseDeviceFrame(bUseDeviceFrame), m_eCodec(eCodec), m_bLowLatency(bLowLatency),
     m_bEnableAsyncAllocations(bEnableAsyncAllocations),
-    m_bDeviceFramePitched(bDeviceFramePitched), m_bExtractSEIMessage(extract_user_SEI_Message), m_nMaxWidth (maxWidth), m_nMaxHeight(maxHeight),
+    // RGB/RGBP kernels write packed frames, so pitched buffers only apply to native device output
+    m_bDeviceFramePitched(bDeviceFramePitched && bUseDeviceFrame && eOutputColorType == OutputColorType::NATIVE), m_bExtractSEIMessage(extract_user_SEI_Message), m_nMaxWidth (maxWidth), m_nMaxHeight(maxHeight),
     m_eUserOutputColorType(eOutputColorType), m_bForce_zero_latency(force_zero_latency), m_bWaitForSessionWarmUp(bWaitForSessionWarmUp)
 {
     const char* err = loadCuvidSymbols(&this->m_api,
@@ -1138,45 +1309,84 @@ NvDecoder::~NvDecoder() {
         m_api.cuvidDestroyVideoParser(m_hParser);
     }
     cuCtxPushCurrent(m_cuContext);
+    std::lock_guard<std::mutex> lock(m_mtxVPFrame);
+
+    if (m_bMappedSurfaceOutput && m_hDecoder)
+    {
+        // frames still held by the application are mapped NVDEC surfaces, not owned buffers
+        m_framePool.ForEachSlot([this](DecodedFramePool<CUevent, SEI_MESSAGE>::Slot& slot) {
+            if (slot.pFrame)
+            {
+                m_api.cuvidUnmapVideoFrame(m_hDecoder, (CUdeviceptr)slot.pFrame);
+                slot.pFrame = nullptr;
+            }
+        });
+    }
     if (m_hDecoder) {
         m_api.cuvidDestroyDecoder(m_hDecoder);
     }
 
-    std::lock_guard<std::mutex> lock(m_mtxVPFrame);
-
-
-    for (uint8_t *pFrame : m_vpFrame)
-    {
+    m_framePool.ForEachSlot([this](DecodedFramePool<CUevent, SEI_MESSAGE>::Slot& slot) {
+        uint8_t* pFrame = slot.pFrame;
+        if (!pFrame)
+        {
+            return;
+        }
         if (m_bUseDeviceFrame)
         {
-            if (m_bEnableAsyncAllocations)
+            if ((m_bEnableAsyncAllocations || m_hMemPool) && !m_bDeviceFramePitched)
             {
-                cuMemFreeAsync((*(CUdeviceptr*)&pFrame), NULL);//sync on NULL stream to ensure that all work is completed before dtor
+                cuMemFreeAsync((CUdeviceptr)pFrame, NULL);//sync on NULL stream to ensure that all work is completed before dtor
             }
             else
             {
                 cuMemFree((CUdeviceptr)pFrame);
             }
-            
         }
         else
         {
-            delete[] pFrame;
+            cuMemFreeHost(pFrame);
         }
-    }
+    });
     if (!m_bUseDeviceFrame)
     {
         cuMemFree((CUdeviceptr)m_dpScratchFrame);
     }
+    for (auto& vFrames : m_vLadderFrames)
+    {
+        for (auto& frame : vFrames)
+        {
+            cuMemFree((CUdeviceptr)frame.first);
+        }
+    }
+    if (m_dpFrameHash)
+    {
+        cuMemFree(m_dpFrameHash);
+    }
+    for (uint64_t* pHash : m_vFrameHash)
+    {
+        if (pHash)
+        {
+            cuMemFreeHost(pHash);
+        }
+    }
 
     if (m_bEnableAsyncAllocations)
     {
         cuEventDestroy(m_bCUEvent);
     }
 
-    for (auto& v : m_DecodedFrameEvent)
+    m_framePool.ForEachSlot([](DecodedFramePool<CUevent, SEI_MESSAGE>::Slot& slot) {
+        if (slot.event)
+        {
+            cuEventDestroy(slot.event);
+        }
+    });
+
+    if (m_hMemPool)
     {
-        cuEventDestroy(v);
+        // released once the outstanding asynchronous frees complete
+        cuMemPoolDestroy(m_hMemPool);
     }
     
     cuCtxPopCurrent(NULL);
@@ -1207,8 +1417,11 @@ void NvDecoder::CUStreamSyncOnEvent()
 int NvDecoder::Decode(const uint8_t *pData, int nSize, int nFlags, int64_t nTimestamp)
 {
     NVTX_SCOPED_RANGE("decodehelper::decodeframe")
-    m_nDecodedFrame = 0;
-    m_nDecodedFrameReturned = 0;
+    {
+        std::lock_guard<std::mutex> lock(m_mtxVPFrame);
+        m_framePool.BeginDecode();
+        m_nDecodedFrame = 0;
+    }
     CUVIDSOURCEDATAPACKET packet = { 0 };
     packet.payload = pData;
     packet.payload_size = nSize;
@@ -1217,7 +1430,20 @@ int NvDecoder::Decode(const uint8_t *pData, int nSize, int nFlags, int64_t nTime
     if ((!pData || nSize == 0) && (nFlags != CUVID_PKT_DISCONTINUITY)){
         packet.flags |= CUVID_PKT_ENDOFSTREAM;
     }
-    NVDEC_API_CALL(m_api.cuvidParseVideoData(m_hParser, &packet));
+    CUresult result = m_api.cuvidParseVideoData(m_hParser, &packet);
+    if (m_displayError)
+    {
+        // The frames displayed before the error are dropped along with the failing one, which unmaps their surfaces
+        std::exception_ptr displayError = m_displayError;
+        m_displayError = nullptr;
+        {
+            std::lock_guard<std::mutex> lock(m_mtxVPFrame);
+            m_framePool.BeginDecode();
+            m_nDecodedFrame = 0;
+        }
+        std::rethrow_exception(displayError);
+    }
+    NVDEC_API_CALL(result);
 
     return m_nDecodedFrame;
 }
@@ -1226,17 +1452,35 @@ uint8_t* NvDecoder::GetFrame(int64_t* pTimestamp, SEI_MESSAGE *pSEIMessage, CUev
 {
     if (m_nDecodedFrame > 0)
     {
-        std::lock_guard<std::mutex> lock(m_mtxVPFrame);
-        m_nDecodedFrame--;
-        if (pTimestamp)
-            *pTimestamp = m_vTimestamp[m_nDecodedFrameReturned];
-        if (m_bExtractSEIMessage && pSEIMessage)
-            *pSEIMessage = m_vSEIMessage[m_nDecodedFrameReturned];
+        uint8_t* pFrame = NULL;
+        CUevent event = NULL;
+        {
+            std::lock_guard<std::mutex> lock(m_mtxVPFrame);
+            int nSlot = m_framePool.PopReady(false);
+            if (nSlot < 0)
+            {
+                return NULL;
+            }
+            m_nDecodedFrame--;
+            auto& slot = m_framePool[nSlot];
+            if (pTimestamp)
+                *pTimestamp = slot.timestamp;
+            // the slot is recycled on the next decode call, so the SEI message can be handed over
+            if (m_bExtractSEIMessage && pSEIMessage)
+                *pSEIMessage = std::move(slot.metadata);
+            pFrame = GetSlotOutput(nSlot);
+            event = slot.event;
+        }
         if (decoderFrameEvent)
         {
-            *decoderFrameEvent = m_DecodedFrameEvent[m_nDecodedFrameReturned];
+            // the caller waits on the event before it reads a host frame
+            *decoderFrameEvent = event;
+        }
+        else
+        {
+            WaitForHostFrame(event);
         }
-        return m_vpFrame[m_nDecodedFrameReturned++];
+        return pFrame;
     }
 
     return NULL;
@@ -1244,120 +1488,556 @@ uint8_t* NvDecoder::GetFrame(int64_t* pTimestamp, SEI_MESSAGE *pSEIMessage, CUev
 
 uint8_t* NvDecoder::GetLockedFrame(int64_t* pTimestamp, SEI_MESSAGE *pSEIMessage, CUevent* decoderFrameEvent)
 {
-    uint8_t *pFrame;
-    uint64_t timestamp;
     if (m_nDecodedFrame > 0) {
-        std::lock_guard<std::mutex> lock(m_mtxVPFrame);
-        m_nDecodedFrame--;
-        // Frame related
-        pFrame = m_vpFrame[0];
-        m_vpFrame.erase(m_vpFrame.begin(), m_vpFrame.begin() + 1);
-        m_LockedFrames.push_back(pFrame);
-        // event related
-        auto event = m_DecodedFrameEvent[0];
-        m_DecodedFrameEvent.erase(m_DecodedFrameEvent.begin(), m_DecodedFrameEvent.begin() + 1);
-        m_LockedEvents.push_back(event);
+        uint8_t* pFrame = NULL;
+        CUevent event = NULL;
+        {
+            std::lock_guard<std::mutex> lock(m_mtxVPFrame);
+            int nSlot = m_framePool.PopReady(true);
+            if (nSlot < 0)
+            {
+                return NULL;
+            }
+            m_nDecodedFrame--;
+            auto& slot = m_framePool[nSlot];
+            if (pTimestamp)
+                *pTimestamp = slot.timestamp;
+
+            // the slot is recycled on unlock, so the SEI message can be handed over
+            if (m_bExtractSEIMessage && pSEIMessage)
+            {
+                *pSEIMessage = std::move(slot.metadata);
+            }
+            pFrame = GetSlotOutput(nSlot);
+            event = slot.event;
+        }
         if (decoderFrameEvent)
         {
+            // the caller waits on the event before it reads a host frame
             *decoderFrameEvent = event;
         }
-        //timestamp related  
-        timestamp = m_vTimestamp[0];
-        m_vTimestamp.erase(m_vTimestamp.begin(), m_vTimestamp.begin() + 1);
-        
-        if (pTimestamp)
-            *pTimestamp = timestamp;
-
-        // sei message related
-        if (m_bExtractSEIMessage && pSEIMessage)
+        else
         {
-            auto seiMessage = m_vSEIMessage[0];
-            m_vSEIMessage.erase(m_vSEIMessage.begin(), m_vSEIMessage.begin() + 1);
-            *pSEIMessage = seiMessage;
+            WaitForHostFrame(event);
         }
-        
-        
         return pFrame;
     }
 
     return NULL;
 }
 
+void NvDecoder::WaitForHostFrame(CUevent event)
+{
+    // Device frames are ordered through the event by the consumer. A caller that does not take the event
+    // reads a host frame right away, so wait for the asynchronous copy of this frame only.
+    if (!m_bUseDeviceFrame && event)
+    {
+        CUDA_DRVAPI_CALL(cuCtxPushCurrent(m_cuContext));
+        CUDA_DRVAPI_CALL(cuEventSynchronize(event));
+        CUDA_DRVAPI_CALL(cuCtxPopCurrent(NULL));
+    }
+}
+
 void NvDecoder::UnlockFrame(uint8_t **pFrame)
+{
+    UnlockFrame(pFrame[0]);
+}
+
+void NvDecoder::UnlockFrame(uint8_t* pFrame)
 {
     std::lock_guard<std::mutex> lock(m_mtxVPFrame);
-    m_vpFrame.insert(m_vpFrame.end(), &pFrame[0], &pFrame[1]);
-    
-    // add a dummy entry for timestamp
-    uint64_t timestamp[2] = {0};
-    m_vTimestamp.insert(m_vTimestamp.end(), &timestamp[0], &timestamp[1]);
-    if (m_bExtractSEIMessage)
+    if (!m_framePool.Unlock(FindOutputSlot(pFrame)))
     {
-        m_vSEIMessage.resize(m_vSEIMessage.size() + 2);
+        LOG(WARNING) << "Frame " << (void*)pFrame << " is not locked by the decoder";
     }
-    
 }
 
-void NvDecoder::UnlockFrame(uint8_t* pFrame)
+// Unlock in order of locking. We might need a overload where we take in frames to unlock. This
+// will be needed if we decide to expose unlock to application.
+void NvDecoder::UnlockLockedFrames(uint32_t size)
 {
     std::lock_guard<std::mutex> lock(m_mtxVPFrame);
+    if (size > m_framePool.LockedCount())
+    {
+        LOG(WARNING) << "Size of unlock requests exceeds locked frames. Got "
+                     << size << ". Max allowed is " << m_framePool.LockedCount()
+                     << ". Unlocking " << m_framePool.LockedCount() << " frames";
+    }
+    m_framePool.UnlockOldest(size);
+}
 
-    if (m_LockedFrames.size() != m_LockedEvents.size())
+uint8_t* NvDecoder::AllocateFrameBuffer(size_t nBytes)
+{
+    uint8_t *pFrame = NULL;
+    m_framePoolStats.nAllocations++;
+    if (m_bUseDeviceFrame)
     {
-        LOG(ERROR) << "Locked frames and locked events queues have mismatch in size\n";
+        if (m_bDeviceFramePitched)
+        {
+            // Preallocated frames share the pitch of the max resolution so that any smaller output fits
+            unsigned int nWidth = m_nPreallocFrames ? m_nMaxWidth : GetWidth();
+            unsigned int nHeight = m_nPreallocFrames ? m_nMaxHeight : m_nLumaHeight;
+            unsigned int nChromaHeight = m_nPreallocFrames ? (unsigned int)ceil(nHeight * GetChromaHeightFactor(m_eOutputFormat)) : m_nChromaHeight;
+            CUDA_DRVAPI_CALL(cuMemAllocPitch((CUdeviceptr *)&pFrame, &m_nDeviceFramePitch, nWidth * GetOutputBPP(), nHeight + (nChromaHeight * m_nNumChromaPlanes), 16));
+        }
+        else if (m_hMemPool)
+        {
+            CUDA_DRVAPI_CALL(cuMemAllocFromPoolAsync((CUdeviceptr*)&pFrame, nBytes, m_hMemPool, m_cuvidStream));
+        }
+        else if (m_bEnableAsyncAllocations)
+        {
+            CUDA_DRVAPI_CALL(cuMemAllocAsync((CUdeviceptr*)&pFrame, nBytes, m_cuvidStream));
+        }
+        else
+        {
+            CUDA_DRVAPI_CALL(cuMemAlloc((CUdeviceptr *)&pFrame, nBytes));
+        }
+    }
+    else
+    {
+        // page-locked so that the device to host copy of the output is asynchronous
+        CUDA_DRVAPI_CALL(cuMemHostAlloc((void**)&pFrame, nBytes, 0));
     }
-    // Remove if present in m_LockedFrames
-    auto lockedFrames = m_LockedFrames.begin();
-    auto lockedEvents = m_LockedEvents.begin();
-    for (; lockedFrames != m_LockedFrames.end() && lockedEvents != m_LockedEvents.end(); ++lockedFrames, ++lockedEvents )
+    return pFrame;
+}
+
+// Expects the decoder context to be current for device frames
+void NvDecoder::FreeFrameBuffer(uint8_t* pFrame)
+{
+    if (!pFrame)
+    {
+        return;
+    }
+    m_framePoolStats.nFrees++;
+    if (m_bUseDeviceFrame)
     {
-        if (*lockedFrames == pFrame)
+        // pitched buffers come from cuMemAllocPitch and cannot be released to a stream ordered pool
+        if ((m_bEnableAsyncAllocations || m_hMemPool) && !m_bDeviceFramePitched)
         {
-            m_vpFrame.insert(m_vpFrame.end(), pFrame);
+            CUDA_DRVAPI_CALL(cuMemFreeAsync((CUdeviceptr)pFrame, m_cuvidStream));
+        }
+        else
+        {
+            CUDA_DRVAPI_CALL(cuMemFree((CUdeviceptr)pFrame));
+        }
+    }
+    else
+    {
+        CUDA_DRVAPI_CALL(cuMemFreeHost(pFrame));
+    }
+}
 
-            // add a dummy entry for timestamp
-            uint64_t timestamp[1] = { 0 };
-            m_vTimestamp.insert(m_vTimestamp.end(), timestamp[0]);
+size_t NvDecoder::GetFrameBufferSize()
+{
+    if (!m_nPreallocFrames)
+    {
+        if (m_bDeviceFramePitched)
+        {
+            // Sized by the pitch of the last allocation. Before the first allocation, or with a pitch narrower
+            // than the current width, the size is unknown and 0 is returned, which forces a new allocation.
+            size_t nRowBytes = (size_t)GetWidth() * GetOutputBPP();
+            return m_nDeviceFramePitch >= nRowBytes ? m_nDeviceFramePitch * (m_nLumaHeight + m_nChromaHeight * m_nNumChromaPlanes) : 0;
+        }
+        return GetOutputFrameSize();
+    }
+    // Size for the max resolution so that buffers survive reconfiguration to any smaller resolution
+    size_t nWidth = m_nMaxWidth, nHeight = m_nMaxHeight;
+    if (m_eOutputFormat == cudaVideoSurfaceFormat_NV12 || m_eOutputFormat == cudaVideoSurfaceFormat_P016
+        || m_eOutputFormat == cudaVideoSurfaceFormat_NV16 || m_eOutputFormat == cudaVideoSurfaceFormat_P216)
+    {
+        nWidth = (nWidth + 1) & ~1;
+    }
+    switch (m_eUserOutputColorType)
+    {
+        case OutputColorType::RGB:
+        case OutputColorType::RGBP:
+            if (m_bPostProcess)
+            {
+                PostProcessParams params;
+                ResolvePostProcessParams(m_postProcess, (int)nWidth, (int)nHeight, &params);
+                nWidth = params.nWidth;
+                nHeight = params.nHeight;
+            }
+            return nWidth * nHeight * 3 * GetPostProcessElementSize(GetOutputDataType());
+        default:
+            return nWidth * (nHeight + (size_t)ceil(nHeight * GetChromaHeightFactor(m_eOutputFormat)) * m_nNumChromaPlanes) * GetOutputBPP();
+    }
+}
 
-            m_LockedFrames.erase(lockedFrames);
-            m_DecodedFrameEvent.insert(m_DecodedFrameEvent.end(), *lockedEvents);
-            m_LockedEvents.erase(lockedEvents);
-            break;
+void NvDecoder::SetFramePoolPolicy(uint32_t nPreallocFrames, bool bUseMemPool)
+{
+    if (m_hDecoder)
+    {
+        PYNVVC_THROW_ERROR("Frame pool policy must be set before the first sequence is decoded", CUDA_ERROR_NOT_PERMITTED);
+    }
+    m_nPreallocFrames = nPreallocFrames;
+    m_bUseMemPool = bUseMemPool;
+}
+
+// Expects the decoder context to be current
+void NvDecoder::PreallocateFrames()
+{
+    if (!m_nPreallocFrames || m_bMappedSurfaceOutput)
+    {
+        return;
+    }
+    if (m_bUseMemPool && m_bUseDeviceFrame && !m_bDeviceFramePitched && !m_hMemPool)
+    {
+        CUmemPoolProps poolProps = {};
+        poolProps.allocType = CU_MEM_ALLOCATION_TYPE_PINNED;
+        poolProps.location.type = CU_MEM_LOCATION_TYPE_DEVICE;
+        poolProps.location.id = m_GpuId;
+        CUDA_DRVAPI_CALL(cuMemPoolCreate(&m_hMemPool, &poolProps));
+        // keep freed memory reserved in the pool instead of returning it to the OS at every sync
+        cuuint64_t nReleaseThreshold = UINT64_MAX;
+        CUDA_DRVAPI_CALL(cuMemPoolSetAttribute(m_hMemPool, CU_MEMPOOL_ATTR_RELEASE_THRESHOLD, &nReleaseThreshold));
+    }
+
+    std::lock_guard<std::mutex> lock(m_mtxVPFrame);
+    size_t nBytes = GetFrameBufferSize();
+    for (uint32_t i = (uint32_t)m_framePool.Size(); i < m_nPreallocFrames; i++)
+    {
+        int nSlot = m_framePool.CreateSlot();
+        CUDA_DRVAPI_CALL(cuEventCreate(&m_framePool[nSlot].event, CU_EVENT_DISABLE_TIMING));
+        m_framePool.SetBuffer(nSlot, AllocateFrameBuffer(nBytes), nBytes);
+        m_framePoolStats.nPreallocatedFrames++;
+        if (!m_vLadder.empty())
+        {
+            AllocateLadderFrames(nSlot, true);
+        }
+        if (m_bFrameHash)
+        {
+            GetSlotFrameHash(nSlot);
         }
     }
-    if (m_bExtractSEIMessage)
+    if (m_bFrameHash && !m_dpFrameHash)
     {
-        m_vSEIMessage.resize(m_vSEIMessage.size() + 1);
+        CUDA_DRVAPI_CALL(cuMemAlloc(&m_dpFrameHash, sizeof(uint64_t)));
     }
-    
 }
 
-// Unlock in order of locking. We might need a overload where we take in frames to unlock. This
-// will be needed if we decide to expose unlock to application.
-void NvDecoder::UnlockLockedFrames(uint32_t size)
+void NvDecoder::SetPostProcess(const PostProcessParams& params)
+{
+    if (m_hDecoder)
+    {
+        PYNVVC_THROW_ERROR("Post-processing must be set before the first sequence is decoded", CUDA_ERROR_NOT_PERMITTED);
+    }
+    m_postProcess = params;
+    m_bPostProcess = !params.IsIdentity();
+    if (!m_bPostProcess)
+    {
+        return;
+    }
+    if (m_eUserOutputColorType == OutputColorType::NATIVE)
+    {
+        PYNVVC_THROW_ERROR_UNSUPPORTED("Post-processing is supported only for RGB and RGBP output", CUDA_ERROR_NOT_SUPPORTED);
+    }
+    const PostProcessRoi& roi = params.roi;
+    if (params.nWidth < 0 || params.nHeight < 0 || roi.x < 0 || roi.y < 0 || roi.width < 0 || roi.height < 0
+        || params.std[0] == 0.0f || params.std[1] == 0.0f || params.std[2] == 0.0f)
+    {
+        PYNVVC_THROW_ERROR("Invalid post-process parameters", CUDA_ERROR_INVALID_VALUE);
+    }
+    m_postProcess.eLayout = m_eUserOutputColorType == OutputColorType::RGBP ? PostProcessLayout::CHW : PostProcessLayout::HWC;
+}
+
+void NvDecoder::SetOutputLadder(const std::vector<PostProcessOutput>& vOutputs)
+{
+    if (m_hDecoder)
+    {
+        PYNVVC_THROW_ERROR("Output ladder must be set before the first sequence is decoded", CUDA_ERROR_NOT_PERMITTED);
+    }
+    if (!vOutputs.empty() && (!m_bUseDeviceFrame || m_bMappedSurfaceOutput))
+    {
+        PYNVVC_THROW_ERROR_UNSUPPORTED("Output ladder is supported only for device memory without mapped surface output", CUDA_ERROR_NOT_SUPPORTED);
+    }
+    if (vOutputs.size() > (size_t)PostProcessMaxOutputs)
+    {
+        PYNVVC_THROW_ERROR("Too many ladder outputs", CUDA_ERROR_INVALID_VALUE);
+    }
+    for (const PostProcessOutput& output : vOutputs)
+    {
+        const PostProcessParams& params = output.params;
+        const PostProcessRoi& roi = params.roi;
+        bool bYuv = output.eFormat == PostProcessFormat::NV12 || output.eFormat == PostProcessFormat::P016;
+        if (params.nWidth <= 0 || params.nHeight <= 0 || (bYuv && ((params.nWidth | params.nHeight) & 1))
+            || roi.x < 0 || roi.y < 0 || roi.width < 0 || roi.height < 0
+            || params.std[0] == 0.0f || params.std[1] == 0.0f || params.std[2] == 0.0f)
+        {
+            PYNVVC_THROW_ERROR("Invalid ladder output parameters", CUDA_ERROR_INVALID_VALUE);
+        }
+    }
+    m_vLadder = vOutputs;
+}
+
+uint8_t* NvDecoder::GetLadderFrame(const uint8_t* pFrame, int i) const
 {
     std::lock_guard<std::mutex> lock(m_mtxVPFrame);
-    if (size > m_LockedFrames.size())
+    int nSlot = FindOutputSlot(pFrame);
+    if (nSlot < 0 || nSlot >= (int)m_vLadderFrames.size() || i < 0 || i >= (int)m_vLadderFrames[nSlot].size())
     {
-        LOG(WARNING) << "Size of unlock requests exceeds locked frames. Got "
-                     << size << ". Max allowed is " << m_LockedFrames.size()
-                     << ". Unlocking " << size << " frames";
-        size = m_LockedFrames.size();
+        return nullptr;
     }
-    if (size > m_LockedEvents.size())
+    return m_vLadderFrames[nSlot][i].first;
+}
+
+const uint64_t* NvDecoder::GetFrameHash(const uint8_t* pFrame) const
+{
+    std::lock_guard<std::mutex> lock(m_mtxVPFrame);
+    int nSlot = FindOutputSlot(pFrame);
+    if (!m_bFrameHash || nSlot < 0 || nSlot >= (int)m_vFrameHash.size())
     {
-        LOG(WARNING) << "Size of unlock requests exceeds locked events. Got "
-                     << size << ". Max allowed is " << m_LockedEvents.size()
-                     << ". Unlocking " << size << " frames";
-        size = m_LockedEvents.size();
+        return nullptr;
     }
-    m_vpFrame.insert(m_vpFrame.end(), m_LockedFrames.begin(), m_LockedFrames.begin() + size);
-    m_vTimestamp.insert(m_vTimestamp.end(), size, 0);
-    m_DecodedFrameEvent.insert(m_DecodedFrameEvent.end(), m_LockedEvents.begin(), m_LockedEvents.begin() + size);
-    if (m_bExtractSEIMessage)
+    return m_vFrameHash[nSlot];
+}
+
+void NvDecoder::SetFrameHash(bool bEnable)
+{
+    if (m_hDecoder)
     {
-        m_vSEIMessage.resize(m_vSEIMessage.size() + size);
+        PYNVVC_THROW_ERROR("Frame hash must be set before the first sequence is decoded", CUDA_ERROR_NOT_PERMITTED);
     }
-    m_LockedFrames.erase(m_LockedFrames.begin(), m_LockedFrames.begin() + size);
-    m_LockedEvents.erase(m_LockedEvents.begin(), m_LockedEvents.begin() + size);
-}
\ No newline at end of file
+    m_bFrameHash = bEnable;
+}
+
+uint64_t* NvDecoder::GetSlotFrameHash(int nSlot)
+{
+    if ((int)m_vFrameHash.size() <= nSlot)
+    {
+        m_vFrameHash.resize(nSlot + 1, nullptr);
+    }
+    if (!m_vFrameHash[nSlot])
+    {
+        CUDA_DRVAPI_CALL(cuMemAllocHost((void**)&m_vFrameHash[nSlot], sizeof(uint64_t)));
+        *m_vFrameHash[nSlot] = 0;
+    }
+    return m_vFrameHash[nSlot];
+}
+
+void NvDecoder::GenerateFrameHash(CUdeviceptr dpSrcFrame, unsigned int nSrcPitch, uint8_t* pDecodedFrame, uint64_t* pHash, bool bCopyOutput)
+{
+    if (!m_dpFrameHash)
+    {
+        CUDA_DRVAPI_CALL(cuMemAlloc(&m_dpFrameHash, sizeof(uint64_t)));
+    }
+    FrameHashPlane aPlane[FrameHashMaxPlanes];
+    int nPlanes = 1;
+    if (m_eUserOutputColorType != OutputColorType::NATIVE)
+    {
+        // RGB/RGBP frames are packed in device memory, host frames in the scratch frame
+        aPlane[0].pData = m_bUseDeviceFrame ? pDecodedFrame : (const uint8_t*)m_dpScratchFrame;
+        aPlane[0].nPitch = aPlane[0].nRowBytes = GetOutputFrameSize();
+        aPlane[0].nRows = 1;
+    }
+    else
+    {
+        const uint8_t* pSrc = (const uint8_t*)dpSrcFrame;
+        size_t nPitch = nSrcPitch;
+        // NVDEC output has luma height aligned by 2
+        size_t nPlaneRows = (m_nSurfaceHeight + 1) & ~1;
+        if (IsBitDepthConverted())
+        {
+            pSrc = m_bUseDeviceFrame ? pDecodedFrame : (const uint8_t*)m_dpScratchFrame;
+            nPitch = m_bUseDeviceFrame && m_nDeviceFramePitch ? m_nDeviceFramePitch : GetWidth();
+            nPlaneRows = m_nLumaHeight;
+        }
+        nPlanes = 1 + m_nNumChromaPlanes;
+        for (int i = 0; i < nPlanes; i++)
+        {
+            aPlane[i].pData = pSrc + nPitch * nPlaneRows * i;
+            aPlane[i].nPitch = nPitch;
+            aPlane[i].nRowBytes = (size_t)GetWidth() * GetOutputBPP();
+            aPlane[i].nRows = i ? m_nChromaHeight : m_nLumaHeight;
+        }
+    }
+    if (bCopyOutput)
+    {
+        // Same destination layout as GenerateNativeOutput()
+        FrameHashCopyPlane aDst[FrameHashMaxPlanes];
+        size_t nDstPitch = m_nDeviceFramePitch ? m_nDeviceFramePitch : (size_t)GetWidth() * m_nBPP;
+        for (int i = 0; i < nPlanes; i++)
+        {
+            aDst[i].pData = pDecodedFrame + nDstPitch * m_nLumaHeight * i;
+            aDst[i].nPitch = nDstPitch;
+        }
+        CopyFrameWithHash(aPlane, aDst, nPlanes, (uint64_t*)m_dpFrameHash, m_cuvidStream);
+    }
+    else
+    {
+        ComputeFrameHash(aPlane, nPlanes, (uint64_t*)m_dpFrameHash, m_cuvidStream);
+    }
+    CUDA_DRVAPI_CALL(cuMemcpyDtoHAsync(pHash, m_dpFrameHash, sizeof(uint64_t), m_cuvidStream));
+}
+
+void NvDecoder::SetBitDepthConversion(bool bTo8Bit, bool bDither)
+{
+    if (m_hDecoder)
+    {
+        PYNVVC_THROW_ERROR("Bit depth conversion must be set before the first sequence is decoded", CUDA_ERROR_NOT_PERMITTED);
+    }
+    if (bTo8Bit && m_bMappedSurfaceOutput)
+    {
+        PYNVVC_THROW_ERROR_UNSUPPORTED("Bit depth conversion is not supported with mapped surface output", CUDA_ERROR_NOT_SUPPORTED);
+    }
+    m_bTo8Bit = bTo8Bit;
+    m_bDither = bTo8Bit && bDither;
+}
+
+void NvDecoder::SetColorimetry(const PostProcessColorimetry& colorimetry)
+{
+    if (colorimetry.iMatrix < 0 || colorimetry.peakLuminance < 0.0f || colorimetry.targetLuminance < 0.0f)
+    {
+        PYNVVC_THROW_ERROR("Invalid colorimetry", CUDA_ERROR_INVALID_VALUE);
+    }
+    m_colorimetry = colorimetry;
+}
+
+void NvDecoder::SetMappedSurfaceOutput(bool bEnable, uint32_t nMaxMappedSurfaces)
+{
+    if (m_hDecoder)
+    {
+        PYNVVC_THROW_ERROR("Mapped surface output must be set before the first sequence is decoded", CUDA_ERROR_NOT_PERMITTED);
+    }
+    if (bEnable && (!m_bUseDeviceFrame || m_eUserOutputColorType != OutputColorType::NATIVE || m_bExtractSEIMessage || !m_vLadder.empty() || m_bTo8Bit))
+    {
+        PYNVVC_THROW_ERROR_UNSUPPORTED("Mapped surface output is supported only for device memory and native output format without SEI extraction, output ladder or bit depth conversion", CUDA_ERROR_NOT_SUPPORTED);
+    }
+    m_bMappedSurfaceOutput = bEnable;
+    m_nMaxMappedSurfaces = nMaxMappedSurfaces;
+    if (!bEnable)
+    {
+        m_framePool.SetRecycleCallback(nullptr);
+        return;
+    }
+    // Unmap the surface as soon as its slot is recycled, i.e. on unlock or on the next decode call.
+    // Called with m_mtxVPFrame held.
+    m_framePool.SetRecycleCallback([this](int nSlot) {
+        uint8_t* pFrame = m_framePool.SetBuffer(nSlot, nullptr, 0);
+        if (pFrame)
+        {
+            CUDA_DRVAPI_CALL(cuCtxPushCurrent(m_cuContext));
+            NVDEC_API_CALL(m_api.cuvidUnmapVideoFrame(m_hDecoder, (CUdeviceptr)pFrame));
+            CUDA_DRVAPI_CALL(cuCtxPopCurrent(NULL));
+            m_nMappedSurfaces--;
+        }
+    });
+}
+
+void NvDecoder::SetOutputTargetCallback(OutputTargetCallback fnTarget)
+{
+    std::lock_guard<std::mutex> lock(m_mtxVPFrame);
+    m_fnOutputTarget = std::move(fnTarget);
+}
+
+void NvDecoder::AcquireOutputTarget(int nSlot, bool bGenerated)
+{
+    if ((int)m_vSlotOutputTarget.size() <= nSlot)
+    {
+        m_vSlotOutputTarget.resize(nSlot + 1, nullptr);
+    }
+    m_vSlotOutputTarget[nSlot] = nullptr;
+    if (!m_fnOutputTarget || !m_bUseDeviceFrame || !bGenerated)
+    {
+        return;
+    }
+    size_t nFrameBytes = GetOutputFrameSize();
+    size_t nPitch = GetOutputFramePitch();
+    if (m_eUserOutputColorType == OutputColorType::NATIVE)
+    {
+        // native frames are written at the pitch of the pool buffers, padded rows included
+        nFrameBytes = nPitch * (m_nLumaHeight + m_nChromaHeight * m_nNumChromaPlanes);
+    }
+    else
+    {
+        nPitch = (size_t)GetOutputWidth() * GetPostProcessElementSize(GetOutputDataType()) * (m_eUserOutputColorType == OutputColorType::RGB ? 3 : 1);
+    }
+    m_vSlotOutputTarget[nSlot] = m_fnOutputTarget(nFrameBytes, nPitch);
+}
+
+int NvDecoder::FindOutputSlot(const uint8_t* pFrame) const
+{
+    int nSlot = m_framePool.Find(pFrame);
+    if (nSlot >= 0 || !pFrame)
+    {
+        return nSlot;
+    }
+    // A target may be handed out again once the caller is done with it, while the slot of its previous frame
+    // is not recycled yet. Prefer the frame that is still locked.
+    for (int i = 0; i < (int)m_vSlotOutputTarget.size(); i++)
+    {
+        if (m_vSlotOutputTarget[i] == pFrame && m_framePool[i].state != FrameSlotState::FREE
+            && (nSlot < 0 || m_framePool[i].state == FrameSlotState::LOCKED))
+        {
+            nSlot = i;
+        }
+    }
+    return nSlot;
+}
+
+// Expects the decoder context to be current, pops it before returning
+int NvDecoder::HandleMappedPictureDisplay(CUVIDPARSERDISPINFO *pDispInfo, CUVIDPROCPARAMS *pProcParams)
+{
+    // Frames before the seek point are dropped without mapping their surface
+    if (m_nSeekPts != 0 && pDispInfo->timestamp < m_nSeekPts)
+    {
+        CUDA_DRVAPI_CALL(cuCtxPopCurrent(NULL));
+        return 1;
+    }
+
+    CUdeviceptr dpSrcFrame = 0;
+    unsigned int nSrcPitch = 0;
+    {
+        // Only unlocking decrements the count concurrently, so the check holds until the surface is mapped below
+        std::lock_guard<std::mutex> lock(m_mtxVPFrame);
+        if (m_nMappedSurfaces >= m_nMaxMappedSurfaces)
+        {
+            CUDA_DRVAPI_CALL(cuCtxPopCurrent(NULL));
+            // Exceptions must not unwind through the parser, Decode() raises the error once parsing returns
+            if (!m_displayError)
+            {
+                std::ostringstream errorLog;
+                errorLog << "All " << m_nMaxMappedSurfaces << " output surfaces are mapped. Unlock frames before decoding further";
+                m_displayError = std::make_exception_ptr(PyNvVCException<PyNvVCGenericError>::makePyNvVCException(
+                    errorLog.str(), CUDA_ERROR_OUT_OF_MEMORY, __FUNCTION__, __FILE__, __LINE__));
+            }
+            return 0;
+        }
+    }
+    NVDEC_API_CALL(m_api.cuvidMapVideoFrame(m_hDecoder, pDispInfo->picture_index, &dpSrcFrame, &nSrcPitch, pProcParams));
+    m_nMappedPitch = nSrcPitch;
+
+    CUVIDGETDECODESTATUS DecodeStatus;
+    memset(&DecodeStatus, 0, sizeof(DecodeStatus));
+    CUresult result = m_api.cuvidGetDecodeStatus(m_hDecoder, pDispInfo->picture_index, &DecodeStatus);
+    if (result == CUDA_SUCCESS && (DecodeStatus.decodeStatus == cuvidDecodeStatus_Error || DecodeStatus.decodeStatus == cuvidDecodeStatus_Error_Concealed))
+    {
+        printf("Decode Error occurred for picture %d\n", m_nPicNumInDecodeOrder[pDispInfo->picture_index]);
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_mtxVPFrame);
+        bool bNewSlot = false;
+        int nSlot = m_framePool.Acquire(&bNewSlot);
+        if (bNewSlot)
+        {
+            CUDA_DRVAPI_CALL(cuEventCreate(&m_framePool[nSlot].event, CU_EVENT_DISABLE_TIMING));
+        }
+        // The surface is borrowed from the decoder, slot does not own it
+        m_framePool.SetBuffer(nSlot, (uint8_t*)dpSrcFrame, 0);
+        // Counted once the slot holds the surface, the recycle callback decrements it when unmapping
+        m_nMappedSurfaces++;
+        m_framePool[nSlot].timestamp = pDispInfo->timestamp;
+        if (m_bFrameHash)
+        {
+            GenerateFrameHash(dpSrcFrame, nSrcPitch, (uint8_t*)dpSrcFrame, GetSlotFrameHash(nSlot));
+        }
+        // Post processing of the mapped surface is done on the cuvid stream
+        CUDA_DRVAPI_CALL(cuEventRecord(m_framePool[nSlot].event, m_cuvidStream));
+        m_framePool.Commit(nSlot);
+        m_nDecodedFrame++;
+    }
+    CUDA_DRVAPI_CALL(cuCtxPopCurrent(NULL));
+
+    return 1;
+}
@@ -29,6 +29,7 @@
 #include <deque>
 #include <stdint.h>
 #include <mutex>
+#include <exception>
 #include <vector>
 #include <string>
 #include <iostream>
@@ -36,7 +37,10 @@
 #include <string.h>
 #include "../../../Interface/nvcuvid.h"
 #include "../Utils/NvCodecUtils.h"
+#include "../Utils/PostProcess.h"
+#include "../Utils/FrameHash.h"
 #include "cuvidFunctions.h"
+#include "DecodedFramePool.h"
 #include <map>
 #include "functional"
 
@@ -134,6 +138,17 @@ public:
 
 
 
+/**
+* @brief Output frame allocation counters. Decode time allocations stay at zero after warm-up when frames are preallocated.
+*/
+struct FramePoolStats
+{
+    uint32_t nPreallocatedFrames = 0;       // frames allocated up front at max width/height
+    uint32_t nDecodeTimeAllocations = 0;    // frames allocated from the display callback
+    uint32_t nAllocations = 0;              // all output frame allocations
+    uint32_t nFrees = 0;                    // all output frame deallocations before teardown
+};
+
 /**
 * @brief Base class for decoder interface.
 */
@@ -248,7 +263,7 @@ public:
     /**
     *   @brief  This function is used to get the current frame size based on pixel format.
     */
-    int GetFrameSize() { assert(m_nWidth); return GetWidth() * (m_nLumaHeight + (m_nChromaHeight * m_nNumChromaPlanes)) * m_nBPP; }
+    int GetFrameSize() { assert(m_nWidth); return GetWidth() * (m_nLumaHeight + (m_nChromaHeight * m_nNumChromaPlanes)) * GetOutputBPP(); }
 
     /**
     *   @brief  This function is used to get the current frame size based on color type.
@@ -261,7 +276,7 @@ public:
                 return GetFrameSize();
             case OutputColorType::RGB:
             case OutputColorType::RGBP:
-                return GetWidth() * GetHeight() * 3;
+                return GetOutputWidth() * GetOutputHeight() * 3 * GetPostProcessElementSize(GetOutputDataType());
             default:
                 // unknown format. return native
                 return GetFrameSize();
@@ -271,17 +286,17 @@ public:
     /**
     *   @brief  This function is used to get the current frame Luma plane size.
     */
-    int GetLumaPlaneSize() { assert(m_nWidth); return GetWidth() * m_nLumaHeight * m_nBPP; }
+    int GetLumaPlaneSize() { assert(m_nWidth); return GetWidth() * m_nLumaHeight * GetOutputBPP(); }
 
     /**
     *   @brief  This function is used to get the current frame chroma plane size.
     */
-    int GetChromaPlaneSize() { assert(m_nWidth); return GetWidth() *  (m_nChromaHeight * m_nNumChromaPlanes) * m_nBPP; }
+    int GetChromaPlaneSize() { assert(m_nWidth); return GetWidth() *  (m_nChromaHeight * m_nNumChromaPlanes) * GetOutputBPP(); }
 
     /**
     *  @brief  This function is used to get the pitch of the device buffer holding the decoded frame.
     */
-    int GetDeviceFramePitch() { assert(m_nWidth); return m_nDeviceFramePitch ? (int)m_nDeviceFramePitch : GetWidth() * m_nBPP; }
+    int GetDeviceFramePitch() { assert(m_nWidth); return m_nDeviceFramePitch ? (int)m_nDeviceFramePitch : GetWidth() * GetOutputBPP(); }
 
     /**
     *   @brief  This function is used to get the bit depth associated with the pixel format.
@@ -289,15 +304,39 @@ public:
     int GetBitDepth() { assert(m_nWidth); return m_nBitDepthMinus8 + 8; }
 
     /**
-    *   @brief  This function is used to get the bytes used per pixel.
+    *   @brief  This function is used to get the bytes used per pixel of the output frames.
     */
-    int GetBPP() { assert(m_nWidth); return m_nBPP; }
+    int GetBPP() { assert(m_nWidth); return GetOutputBPP(); }
 
     /**
-    *   @brief  This function is used to get the YUV chroma format
+    *   @brief  This function is used to get the bytes per sample of output frames, 1 when 16 bit surfaces are converted to 8 bit.
+    */
+    int GetOutputBPP() const { return IsBitDepthConverted() ? 1 : m_nBPP; }
+
+    /**
+    *   @brief  This function is used to get the YUV chroma format of the decoded surfaces
     */
     cudaVideoSurfaceFormat GetOutputFormat() const { return m_eOutputFormat; }
 
+    /**
+    *   @brief  This function is used to get the YUV format of native output frames, which is the 8 bit
+    *   counterpart of the surface format when 16 bit surfaces are converted to 8 bit.
+    */
+    cudaVideoSurfaceFormat GetNativeOutputFormat() const
+    {
+        if (!IsBitDepthConverted())
+        {
+            return m_eOutputFormat;
+        }
+        switch (m_eOutputFormat)
+        {
+            case cudaVideoSurfaceFormat_P016: return cudaVideoSurfaceFormat_NV12;
+            case cudaVideoSurfaceFormat_YUV444_16Bit: return cudaVideoSurfaceFormat_YUV444;
+            case cudaVideoSurfaceFormat_P216: return cudaVideoSurfaceFormat_NV16;
+            default: return m_eOutputFormat;
+        }
+    }
+
     /**
     *   @brief  This function is used to get the use requested color type
     */
@@ -332,6 +371,8 @@ public:
     /**
     *   @brief  This function returns a decoded frame and timestamp. This function should be called in a loop for
     *   fetching all the frames that are available for display.
+    *   The host output frame is copied asynchronously. If decoderFrameEvent is given, the caller synchronizes on
+    *   the returned event before reading the frame, otherwise this function waits for the copy.
     */
     uint8_t* GetFrame(int64_t* pTimestamp = nullptr, SEI_MESSAGE *pSEIMessage = nullptr, CUevent* decoderFrameEvent = nullptr);
 
@@ -340,7 +381,7 @@ public:
     *   @brief  This function decodes a frame and returns the locked frame buffers
     *   This makes the buffers available for use by the application without the buffers
     *   getting overwritten, even if subsequent decode calls are made. The frame buffers
-    *   remain locked, until UnlockFrame() is called
+    *   remain locked, until UnlockFrame() is called. Host frames are synchronized as in GetFrame().
     */
     uint8_t* GetLockedFrame(int64_t* pTimestamp = nullptr, SEI_MESSAGE *pSEIMessage = nullptr, CUevent* decoderFrameEvent = nullptr);
 
@@ -410,6 +451,177 @@ public:
 
     static void SetSessionCount(uint32_t count) { return NvDecoderPerf::SetSessionCount(count); }
 
+    /**
+    *   @brief  This function sets the output frame allocation policy. Must be called before the first decode call.
+    *   @param  nPreallocFrames - number of output frames allocated at max width/height when the session is created,
+    *                             and reused across reconfiguration. 0 allocates frames lazily at the current resolution
+    *   @param  bUseMemPool - back device output frames with a dedicated CUDA memory pool
+    */
+    void SetFramePoolPolicy(uint32_t nPreallocFrames, bool bUseMemPool = false);
+
+    /**
+    *   @brief  This function makes the decoder hand out mapped NVDEC surfaces instead of copying them into output frames.
+    *   A surface stays mapped until its frame is unlocked or, for frames from GetFrame, until the next decode call.
+    *   Supported only for device memory with native output format. Must be called before the first decode call.
+    *   @param  bEnable - enable zero-copy mapped surface output
+    *   @param  nMaxMappedSurfaces - number of surfaces that can be mapped simultaneously
+    */
+    void SetMappedSurfaceOutput(bool bEnable, uint32_t nMaxMappedSurfaces = 16);
+
+    /**
+    *   @brief  Callback supplying caller device memory for the output of one displayed frame, given the size in bytes
+    *   and the row pitch the frame is written at. Returning nullptr writes the frame to the frame pool as usual.
+    */
+    typedef std::function<uint8_t*(size_t nFrameBytes, size_t nPitch)> OutputTargetCallback;
+
+    /**
+    *   @brief  This function makes the decoder write each displayed frame to the memory supplied by fnTarget instead of
+    *   a buffer of the frame pool, so that a caller packing frames into a larger tensor receives them in place.
+    *   GetFrame/GetLockedFrame return the target, which must stay valid until the frame is unlocked or recycled.
+    *   Device frames only, ignored with mapped surface output. Native frames are written at the pitch passed to fnTarget, which
+    *   is the pitch of the pool buffers. fnTarget is called by the decode thread with the frame pool lock held and may be changed
+    *   between decode calls.
+    *   @param  fnTarget - supplies the output memory of each frame, nullptr restores pool output
+    */
+    void SetOutputTargetCallback(OutputTargetCallback fnTarget);
+
+    /**
+    *   @brief  This function returns true if output frames are mapped NVDEC surfaces.
+    */
+    bool IsMappedSurfaceOutput() const { return m_bMappedSurfaceOutput; }
+
+    /**
+    *   @brief  This function returns the pitch in bytes of the output frames, including mapped surfaces.
+    */
+    size_t GetOutputFramePitch() const
+    {
+        if (m_bMappedSurfaceOutput)
+        {
+            return m_nMappedPitch;
+        }
+        return m_nDeviceFramePitch ? m_nDeviceFramePitch : (size_t)GetWidth() * GetOutputBPP();
+    }
+
+    /**
+    *   @brief  This function makes native output frames of 10/12 bit streams 8 bit (P016 to NV12, YUV444_16Bit to YUV444,
+    *   P216 to NV16), halving their size. RGB/RGBP output is always 8 bit and ignores it.
+    *   Not supported with mapped surface output. Must be called before the first sequence is decoded.
+    *   @param  bTo8Bit - convert 16 bit surfaces to 8 bit output frames, rounding to nearest
+    *   @param  bDither - use 8x8 ordered dithering instead of rounding, which avoids banding in gradients
+    */
+    void SetBitDepthConversion(bool bTo8Bit, bool bDither = false);
+
+    /**
+    *   @brief  This function returns true if 16 bit surfaces are converted to 8 bit output frames.
+    */
+    bool IsBitDepthConverted() const { return m_bTo8Bit && m_nBPP == 2 && m_eUserOutputColorType == OutputColorType::NATIVE; }
+
+    /**
+    *   @brief  This function returns the byte offset of a plane from the start of an output frame.
+    *   Mapped surfaces have their luma height aligned by 2.
+    *   @param  nPlane - 0 for luma, 1 and 2 for chroma planes
+    */
+    size_t GetOutputPlaneOffset(int nPlane) const
+    {
+        size_t nRows = m_bMappedSurfaceOutput ? ((m_nSurfaceHeight + 1) & ~1) : m_nLumaHeight;
+        return nPlane * GetOutputFramePitch() * nRows;
+    }
+
+    /**
+    *   @brief  This function sets the crop, resize, normalization and cast fused with the RGB/RGBP conversion.
+    *   The output layout follows the output color type. Must be called before the first sequence is decoded.
+    */
+    void SetPostProcess(const PostProcessParams& params);
+
+    /**
+    *   @brief  This function returns true if RGB/RGBP output frames are post-processed.
+    */
+    bool IsPostProcessEnabled() const { return m_bPostProcess; }
+
+    /**
+    *   @brief  These functions return the size of RGB/RGBP output frames, which differs from the decoded size when post-processing.
+    */
+    int GetOutputWidth() const { return m_bPostProcess ? GetResolvedPostProcess().nWidth : GetWidth(); }
+    int GetOutputHeight() const { return m_bPostProcess ? GetResolvedPostProcess().nHeight : GetHeight(); }
+
+    /**
+    *   @brief  This function returns the element type of RGB/RGBP output frames.
+    */
+    PostProcessDataType GetOutputDataType() const { return m_bPostProcess ? m_postProcess.eDataType : PostProcessDataType::UINT8; }
+
+    /**
+    *   @brief  This function sets the color description used for RGB/RGBP output, e.g. from container metadata.
+    *   Fields left at 0/AUTO follow the video signal description of the stream; the peak luminance follows the
+    *   HDR SEI metadata when SEI extraction is enabled. Takes effect from the next converted frame.
+    */
+    void SetColorimetry(const PostProcessColorimetry& colorimetry);
+
+    /**
+    *   @brief  This function returns the colorimetry applied to the frames being decoded, with all fields resolved.
+    */
+    PostProcessColorimetry GetResolvedColorimetry() const
+    {
+        const CUVIDEOFORMAT& format = m_videoFormat;
+        return ResolvePostProcessColorimetry(m_colorimetry, format.video_signal_description.matrix_coefficients,
+            format.video_signal_description.video_full_range_flag != 0, format.video_signal_description.transfer_characteristics,
+            m_fStreamPeakLuminance);
+    }
+
+    /**
+    *   @brief  This function sets a ladder of additional outputs generated from every decoded frame by a single kernel,
+    *   e.g. a RGBP thumbnail and NV12 renditions at several sizes. Each output gets its own device buffer per frame,
+    *   recycled together with the frame. Supported only for device memory without mapped surface output.
+    *   Must be called before the first sequence is decoded.
+    *   @param  vOutputs - up to PostProcessMaxOutputs outputs; an empty list disables the ladder
+    */
+    void SetOutputLadder(const std::vector<PostProcessOutput>& vOutputs);
+
+    /**
+    *   @brief  This function returns the number of ladder outputs.
+    */
+    int GetLadderSize() const { return (int)m_vLadder.size(); }
+
+    /**
+    *   @brief  This function returns ladder output i resolved for the current sequence.
+    */
+    PostProcessOutput GetLadderOutput(int i) const
+    {
+        PostProcessOutput output;
+        ResolvePostProcessOutput(m_vLadder[i], GetWidth(), GetHeight(), &output);
+        return output;
+    }
+
+    /**
+    *   @brief  This function returns the buffer of ladder output i generated along with the frame pFrame,
+    *   which stays valid as long as pFrame does. Returns nullptr if pFrame is not an output frame of this decoder.
+    */
+    uint8_t* GetLadderFrame(const uint8_t* pFrame, int i) const;
+
+    /**
+    *   @brief  This function enables a 64 bit content hash of every output frame, computed on the decode stream right
+    *   after the frame is generated. It matches ComputeFrameHashHost() on the packed bytes of the frame, regardless
+    *   of the output pitch, and can be used to detect corrupted decodes or to deduplicate identical frames.
+    *   Must be called before the first sequence is decoded.
+    */
+    void SetFrameHash(bool bEnable);
+
+    /**
+    *   @brief  This function returns true if output frames are hashed.
+    */
+    bool IsFrameHashEnabled() const { return m_bFrameHash; }
+
+    /**
+    *   @brief  This function returns the location in page-locked host memory of the hash of the frame pFrame, which stays
+    *   valid as long as pFrame does. The hash is written by the decode stream; read it only after the frame event
+    *   completed. Returns nullptr if hashing is disabled or pFrame is not an output frame of this decoder.
+    */
+    const uint64_t* GetFrameHash(const uint8_t* pFrame) const;
+
+    /**
+    *   @brief  This function returns the output frame allocation counters.
+    */
+    FramePoolStats GetFramePoolStats() { std::lock_guard<std::mutex> lock(m_mtxVPFrame); return m_framePoolStats; }
+
 
 
 private:
@@ -472,6 +684,11 @@ private:
     */
     int HandlePictureDisplay(CUVIDPARSERDISPINFO *pDispInfo);
 
+    /**
+    *   @brief  This function maps a picture available for display and queues the mapped surface as output frame
+    */
+    int HandleMappedPictureDisplay(CUVIDPARSERDISPINFO *pDispInfo, CUVIDPROCPARAMS *pProcParams);
+
     /**
     *   @brief  This function gets called when AV1 sequence encounter more than one operating points
     */
@@ -487,13 +704,109 @@ private:
     */
     int ReconfigureDecoder(CUVIDEOFORMAT *pVideoFormat);
 
+    /**
+    *   @brief  Returns the slot whose output frame is pFrame, a pool buffer or an output target. Expects m_mtxVPFrame held.
+    */
+    int FindOutputSlot(const uint8_t* pFrame) const;
+
+    /**
+    *   @brief  Returns the output frame of a slot, its output target if it has one. Expects m_mtxVPFrame held.
+    */
+    uint8_t* GetSlotOutput(int nSlot) const
+    {
+        return nSlot < (int)m_vSlotOutputTarget.size() && m_vSlotOutputTarget[nSlot] ? m_vSlotOutputTarget[nSlot] : m_framePool[nSlot].pFrame;
+    }
+
+    /**
+    *   @brief  Asks the output target callback for the memory of the frame in nSlot if it is generated. Expects m_mtxVPFrame held.
+    */
+    void AcquireOutputTarget(int nSlot, bool bGenerated);
+
     /**
     *   @brief  This function generates the output in user requested format.
     */
     void GenerateOutput(CUdeviceptr dpSrcFrame, unsigned int nSrcPitch, uint8_t* pDecodedFrame);
     void GenerateNativeOutput(CUdeviceptr dpSrcFrame, unsigned int nSrcPitch, uint8_t* pDecodedFrame);
+
+    /**
+    *   @brief  This function converts 16 bit surfaces to 8 bit native output frames
+    */
+    void GenerateConvertedNativeOutput(CUdeviceptr dpSrcFrame, unsigned int nSrcPitch, uint8_t* pDecodedFrame);
     void GenerateRGBOutput(CUdeviceptr dpSrcFrame, unsigned int nSrcPitch, uint8_t* pDecodedFrame);
     void GenerateRGBPOutput(CUdeviceptr dpSrcFrame, unsigned int nSrcPitch, uint8_t* pDecodedFrame);
+    void GeneratePostProcessOutput(CUdeviceptr dpSrcFrame, unsigned int nSrcPitch, uint8_t* pDecodedFrame,
+        const PostProcessColorimetry& colorimetry);
+
+    /**
+    *   @brief  This function generates all ladder outputs of a frame into the buffers apLadderFrame with one kernel launch
+    */
+    void GenerateLadderOutput(CUdeviceptr dpSrcFrame, unsigned int nSrcPitch, uint8_t* const* apLadderFrame);
+
+    /**
+    *   @brief  This function (re)allocates the ladder buffers of a slot whose size does not match the current sequence.
+    *   With preallocated frames the buffers are sized for max width/height and kept for any smaller sequence.
+    *   Called with m_mtxVPFrame held.
+    *   @param  bPreallocate - allocate up front for max width/height instead of from the display callback
+    */
+    void AllocateLadderFrames(int nSlot, bool bPreallocate = false);
+
+    /**
+    *   @brief  This function hashes the output frame pDecodedFrame generated from a mapped surface into pHash, asynchronously
+    *   on the decode stream. Native frames are hashed from the surface, which holds the same bytes at a different pitch.
+    *   With bCopyOutput, native frames in device memory are also copied to pDecodedFrame by the hash kernel, in place of
+    *   GenerateNativeOutput().
+    */
+    void GenerateFrameHash(CUdeviceptr dpSrcFrame, unsigned int nSrcPitch, uint8_t* pDecodedFrame, uint64_t* pHash, bool bCopyOutput = false);
+
+    /**
+    *   @brief  This function returns the page-locked hash location of a slot, allocating it on first use.
+    *   Called with m_mtxVPFrame held.
+    */
+    uint64_t* GetSlotFrameHash(int nSlot);
+
+    /**
+    *   @brief  This function describes a mapped decoded surface as the source of post-processing kernels
+    */
+    PostProcessSource GetPostProcessSource(CUdeviceptr dpSrcFrame, unsigned int nSrcPitch);
+
+    /**
+    *   @brief  This function picks up the peak luminance from the HDR SEI messages of a picture.
+    */
+    void UpdateHdrMetadata(int nPicIdx);
+
+    /**
+    *   @brief  This function returns the post-process parameters with the roi and target size resolved for the current frame size.
+    */
+    PostProcessParams GetResolvedPostProcess() const
+    {
+        PostProcessParams params;
+        ResolvePostProcessParams(m_postProcess, GetWidth(), GetHeight(), &params);
+        return params;
+    }
+
+    /**
+    *   @brief  These functions allocate and free an output frame buffer in the memory type selected for the session.
+    *   Host frames are page-locked.
+    */
+    uint8_t* AllocateFrameBuffer(size_t nBytes);
+    void FreeFrameBuffer(uint8_t* pFrame);
+
+    /**
+    *   @brief  This function waits for the asynchronous copy of a host output frame to complete, for callers
+    *   of GetFrame()/GetLockedFrame() that do not take the frame event.
+    */
+    void WaitForHostFrame(CUevent event);
+
+    /**
+    *   @brief  This function returns the size of the output frame buffers, which is the max frame size when preallocating.
+    */
+    size_t GetFrameBufferSize();
+
+    /**
+    *   @brief  This function allocates the frames requested through SetFramePoolPolicy(), along with their ladder
+    *   buffers and hash locations.
+    */
+    void PreallocateFrames();
 
 private:
     CUcontext m_cuContext = NULL;
@@ -513,29 +826,45 @@ private:
     int m_nBPP = 1;
     CUVIDEOFORMAT m_videoFormat = {};
     Rect m_displayRect = {};
-    // stock of frames
-    std::vector<uint8_t *> m_vpFrame;
-    // collection of cuda events for decoded frames
-    std::vector<CUevent> m_DecodedFrameEvent;
-    // timestamps of decoded frames
-    std::vector<int64_t> m_vTimestamp;
-    // collection of locked frames
-    std::deque<uint8_t*> m_LockedFrames;
-    // collection of locked events
-    std::deque<CUevent> m_LockedEvents;
-    std::vector<SEI_MESSAGE> m_vSEIMessage;
-    int m_nDecodedFrame = 0, m_nDecodedFrameReturned = 0;
+    // stock of output frames along with their events, timestamps and SEI messages
+    DecodedFramePool<CUevent, SEI_MESSAGE> m_framePool{ MAX_FRM_CNT };
+    int m_nDecodedFrame = 0;
     int m_nDecodePicCnt = 0, m_nPicNumInDecodeOrder[MAX_FRM_CNT];
     CUVIDSEIMESSAGEINFO *m_pCurrSEIMessage = NULL;
     CUVIDSEIMESSAGEINFO m_SEIMessagesDisplayOrder[MAX_FRM_CNT][2];
     FILE *m_fpSEI = NULL;
     bool m_bEndDecodeDone = false;
-    std::mutex m_mtxVPFrame;
-    int m_nFrameAlloc = 0;
+    mutable std::mutex m_mtxVPFrame;
+    FramePoolStats m_framePoolStats;
+    uint32_t m_nPreallocFrames = 0;
+    bool m_bUseMemPool = false;
+    CUmemoryPool m_hMemPool = NULL;
+    bool m_bMappedSurfaceOutput = false;
+    uint32_t m_nMaxMappedSurfaces = 16;
+    uint32_t m_nMappedSurfaces = 0;
+    // error of a display callback, raised by Decode() once the parser returns
+    std::exception_ptr m_displayError;
+    unsigned int m_nMappedPitch = 0;
     CUstream m_cuvidStream = 0;
     bool m_bDeviceFramePitched = false;
     size_t m_nDeviceFramePitch = 0;
     Dim m_resizeDim = {};
+    bool m_bPostProcess = false;
+    PostProcessParams m_postProcess;
+    PostProcessColorimetry m_colorimetry;
+    float m_fStreamPeakLuminance = 0.0f;
+    bool m_bTo8Bit = false;
+    bool m_bDither = false;
+    std::vector<PostProcessOutput> m_vLadder;
+    // ladder buffers of each frame slot with their sizes, indexed by slot and output
+    std::vector<std::vector<std::pair<uint8_t*, size_t>>> m_vLadderFrames;
+    bool m_bFrameHash = false;
+    // device accumulator of the hash kernel and page-locked hash of each frame slot
+    CUdeviceptr m_dpFrameHash = 0;
+    std::vector<uint64_t*> m_vFrameHash;
+    OutputTargetCallback m_fnOutputTarget;
+    // caller memory holding the output of each frame slot in place of its pool buffer, nullptr if none
+    std::vector<uint8_t*> m_vSlotOutputTarget;
 
     std::ostringstream m_videoInfo;
     unsigned int m_nMaxWidth = 0, m_nMaxHeight = 0;
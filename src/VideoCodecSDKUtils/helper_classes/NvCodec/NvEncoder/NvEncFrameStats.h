@@ -0,0 +1,64 @@
+/*
+ * This copyright notice applies to this header file only:
+ *
+ * Copyright (c) 2010-2025 NVIDIA Corporation
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the software, and to permit persons to whom the
+ * software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <functional>
+#include <stdint.h>
+#include <vector>
+#include "configNvEncVer.h"
+#ifdef NVENC_VER_13_0
+#include "nvEncodeAPI_130.h"
+#else
+#include "nvEncodeAPI_121.h"
+#endif
+
+/**
+* @brief Statistics of one encoded frame, read from NV_ENC_LOCK_BITSTREAM when its bitstream is locked.
+*/
+struct NvEncFrameStats
+{
+    uint32_t frameIdx = 0;
+    uint64_t timeStamp = 0;
+    NV_ENC_PIC_TYPE pictureType = NV_ENC_PIC_TYPE_UNKNOWN;
+    uint32_t frameAvgQP = 0;
+    uint32_t frameSatd = 0;
+    uint32_t sizeInBytes = 0;
+    // MBs for H.264, CTBs for HEVC, SBs for AV1
+    uint32_t intraMBCount = 0;
+    uint32_t interMBCount = 0;
+    int32_t averageMVX = 0;
+    int32_t averageMVY = 0;
+    // from the submission of the frame to the lock of its bitstream, including the output delay
+    double latencyMs = 0;
+    // QP and bit count of each block in raster order, if the encoder outputs block stats
+    uint32_t blockSize = 0;
+    std::vector<uint8_t> blockQP;
+    std::vector<uint32_t> blockBits;
+};
+
+typedef std::function<void(const NvEncFrameStats& stats)> NvEncFrameStatsCallback;
@@ -44,6 +44,8 @@ NvEncoderCuda::NvEncoderCuda(CUcontext cuContext, CUstream cuStream, uint32_t nW
 
 NvEncoderCuda::~NvEncoderCuda()
 {
+    // the output thread of SubmitFrame() uses the input resources released below
+    StopPipeline();
     ReleaseCudaResources();
 }
 
@@ -183,8 +185,16 @@ void NvEncoderCuda::CopyToDeviceFrame(CUcontext device,
         CUDA_DRVAPI_CALL(stream == NULL? cuMemcpy2D(&m) : cuMemcpy2DAsync(&m, stream));
     }
 
+    // Chroma planes follow the luma rows unless the caller locates them
     std::vector<uint32_t> srcChromaOffsets;
-    NvEncoder::GetChromaSubPlaneOffsets(pixelFormat, srcPitch, height, srcChromaOffsets);
+    if (_srcChromaOffsets)
+    {
+        srcChromaOffsets.assign(_srcChromaOffsets, _srcChromaOffsets + numChromaPlanes);
+    }
+    else
+    {
+        NvEncoder::GetChromaSubPlaneOffsets(pixelFormat, srcPitch, height, srcChromaOffsets);
+    }
     uint32_t chromaHeight = NvEncoder::GetChromaHeight(pixelFormat, height);
     uint32_t destChromaPitch = NvEncoder::GetChromaPitch(pixelFormat, dstPitch);
     uint32_t srcChromaPitch = NvEncoder::GetChromaPitch(pixelFormat, srcPitch);
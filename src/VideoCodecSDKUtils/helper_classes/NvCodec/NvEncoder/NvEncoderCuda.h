@@ -61,7 +61,8 @@ public:
 
     /**
     *  @brief This is a static function to copy input data from host memory to device memory.
-    *  This function assumes YUV plane is a single contiguous memory segment.
+    *  The chroma planes are read at srcChromaOffsets bytes from pSrcFrame, one entry per chroma plane.
+    *  Without srcChromaOffsets the YUV planes are assumed to be a single contiguous memory segment.
     */
     static void CopyToDeviceFrame(CUcontext device,
         void* pSrcFrame,
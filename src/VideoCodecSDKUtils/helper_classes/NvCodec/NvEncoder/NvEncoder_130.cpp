@@ -28,6 +28,7 @@
 #ifdef NVENC_VER_13_0
 
 #include "NvEncoder/NvEncoder_130.h"
+#include <algorithm>
 
 #ifndef _WIN32
 #ifndef BOOLEAN_OPERATOR_EQ_GUID
@@ -471,6 +472,7 @@ void NvEncoder::CreateEncoder(const NV_ENC_INITIALIZE_PARAMS* pEncoderParams)
 #endif
 
     m_vMappedInputBuffers.resize(m_nEncoderBuffer, nullptr);
+    m_vExternalInputResources.resize(m_nEncoderBuffer, nullptr);
 
     if (m_bMotionEstimationOnly)
     {
@@ -500,6 +502,7 @@ void NvEncoder::DestroyEncoder()
         return;
     }
 
+    StopPipeline();
     ReleaseInputBuffers();
 
     DestroyHWEncoder();
@@ -507,6 +510,7 @@ void NvEncoder::DestroyEncoder()
 
 void NvEncoder::DestroyHWEncoder()
 {
+    StopPipeline();
     if (!m_hEncoder)
     {
         return;
@@ -564,14 +568,32 @@ const NvEncInputFrame* NvEncoder::GetNextReferenceFrame()
     return &m_vReferenceFrames[i];
 }
 
+void NvEncoder::SetNextInputResource(NV_ENC_REGISTERED_PTR registeredResource)
+{
+    m_pNextInputResource = registeredResource;
+}
+
+bool NvEncoder::IsInputResourceInFlight(NV_ENC_REGISTERED_PTR registeredResource)
+{
+    std::lock_guard<std::mutex> lock(m_mtxPipeline);
+    return std::find(m_vExternalInputResources.begin(), m_vExternalInputResources.end(), registeredResource) != m_vExternalInputResources.end();
+}
+
 void NvEncoder::MapResources(uint32_t bfrIdx)
 {
     NVTX_SCOPED_RANGE("MapResources")
     NV_ENC_MAP_INPUT_RESOURCE mapInputResource = { NV_ENC_MAP_INPUT_RESOURCE_VER };
 
-    mapInputResource.registeredResource = m_vRegisteredResources[bfrIdx];
+    NV_ENC_REGISTERED_PTR registeredResource = m_pNextInputResource ? m_pNextInputResource : m_vRegisteredResources[bfrIdx];
+    m_pNextInputResource = nullptr;
+    mapInputResource.registeredResource = registeredResource;
     NVENC_API_CALL(m_nvenc.nvEncMapInputResource(m_hEncoder, &mapInputResource));
     m_vMappedInputBuffers[bfrIdx] = mapInputResource.mappedResource;
+    if (registeredResource != m_vRegisteredResources[bfrIdx])
+    {
+        std::lock_guard<std::mutex> lock(m_mtxPipeline);
+        m_vExternalInputResources[bfrIdx] = registeredResource;
+    }
 
     if (m_bMotionEstimationOnly)
     {
@@ -581,25 +603,32 @@ void NvEncoder::MapResources(uint32_t bfrIdx)
     }
 }
 
-void NvEncoder::EncodeFrame(std::vector<NvEncOutputFrame> &vPacket, NV_ENC_PIC_PARAMS *pPicParams)
+void NvEncoder::EncodeInputFrame(NV_ENC_PIC_PARAMS *pPicParams)
 {
-    NVTX_SCOPED_RANGE("EncodeFrame")
-    vPacket.clear();
     if (!IsHWEncoderInitialized())
     {
         PYNVVC_THROW_ERROR("Encoder device not found", NV_ENC_ERR_NO_ENCODE_DEVICE);
     }
+    if (m_bMotionEstimationOnly)
+    {
+        // a motion estimation only session has no bitstream buffers
+        PYNVVC_THROW_ERROR("Motion estimation only sessions cannot encode frames, use RunMotionEstimation()", NV_ENC_ERR_INVALID_CALL);
+    }
 
     int bfrIdx = m_iToSend % m_nEncoderBuffer;
 
     MapResources(bfrIdx);
 
+    if (m_fnFrameStats && bfrIdx < (int)m_vSubmitTime.size())
+    {
+        m_vSubmitTime[bfrIdx] = std::chrono::steady_clock::now();
+    }
     NVENCSTATUS nvStatus = DoEncode(m_vMappedInputBuffers[bfrIdx], m_vBitstreamOutputBuffer[bfrIdx], pPicParams);
 
     if (nvStatus == NV_ENC_SUCCESS || nvStatus == NV_ENC_ERR_NEED_MORE_INPUT)
     {
+        std::lock_guard<std::mutex> lock(m_mtxPipeline);
         m_iToSend++;
-        GetEncodedPacket(m_vBitstreamOutputBuffer, vPacket, true);
     }
     else
     {
@@ -607,6 +636,22 @@ void NvEncoder::EncodeFrame(std::vector<NvEncOutputFrame> &vPacket, NV_ENC_PIC_P
     }
 }
 
+void NvEncoder::EncodeFrame(std::vector<NvEncOutputFrame> &vPacket, NV_ENC_PIC_PARAMS *pPicParams)
+{
+    NVTX_SCOPED_RANGE("EncodeFrame")
+    CheckNotPipelined();
+    EncodeInputFrame(pPicParams);
+    GetEncodedPacket(m_vBitstreamOutputBuffer, vPacket, true);
+}
+
+int NvEncoder::EncodeFrame(const NvEncBitstreamWriter &fnWrite, NV_ENC_PIC_PARAMS *pPicParams)
+{
+    NVTX_SCOPED_RANGE("EncodeFrame")
+    CheckNotPipelined();
+    EncodeInputFrame(pPicParams);
+    return GetEncodedPacket(m_vBitstreamOutputBuffer, fnWrite, true);
+}
+
 
 void NvEncoder::RunMotionEstimation(std::vector<uint8_t> &mvData)
 {
@@ -730,68 +775,359 @@ void NvEncoder::SendEOS()
 
 void NvEncoder::EndEncode(std::vector<NvEncOutputFrame> &vPacket)
 {
-    vPacket.clear();
     if (!IsHWEncoderInitialized())
     {
         PYNVVC_THROW_ERROR("Encoder device not initialized", NV_ENC_ERR_ENCODER_NOT_INITIALIZED);
     }
 
+    CheckNotPipelined();
     SendEOS();
 
     GetEncodedPacket(m_vBitstreamOutputBuffer, vPacket, false);
 }
 
-void NvEncoder::GetEncodedPacket(std::vector<NV_ENC_OUTPUT_PTR> &vOutputBuffer, std::vector<NvEncOutputFrame> &vPacket, bool bOutputDelay)
+int NvEncoder::EndEncode(const NvEncBitstreamWriter &fnWrite)
+{
+    if (!IsHWEncoderInitialized())
+    {
+        PYNVVC_THROW_ERROR("Encoder device not initialized", NV_ENC_ERR_ENCODER_NOT_INITIALIZED);
+    }
+
+    CheckNotPipelined();
+    SendEOS();
+
+    return GetEncodedPacket(m_vBitstreamOutputBuffer, fnWrite, false);
+}
+
+void NvEncoder::LockEncodedPacket(NV_ENC_OUTPUT_PTR outputBuffer, int iBuffer, const std::function<void(const NV_ENC_LOCK_BITSTREAM &)> &fnPacket)
+{
+    WaitForCompletionEvent(iBuffer);
+    NV_ENC_LOCK_BITSTREAM lockBitstreamData = { NV_ENC_LOCK_BITSTREAM_VER };
+    lockBitstreamData.outputBitstream = outputBuffer;
+    lockBitstreamData.doNotWait = false;
+    bool bFrameStats = m_fnFrameStats && !m_bMotionEstimationOnly;
+    if (bFrameStats)
+    {
+        lockBitstreamData.getRCStats = 1;
+        if (m_initializeParams.enableOutputStats && m_initializeParams.outputStatsLevel == NV_ENC_OUTPUT_STATS_BLOCK_LEVEL)
+        {
+            // sized for 16x16 blocks at the maximum resolution, which covers every codec and reconfiguration
+            size_t nBlocks = (size_t)((m_nMaxEncodeWidth + 15) / 16) * ((m_nMaxEncodeHeight + 15) / 16);
+            if (m_vOutputStatsBlocks.size() < nBlocks)
+            {
+                NV_ENC_OUTPUT_STATS_BLOCK block = { NV_ENC_OUTPUT_STATS_BLOCK_VER };
+                m_vOutputStatsBlocks.resize(nBlocks, block);
+            }
+            lockBitstreamData.outputStatsPtrSize = (uint32_t)(m_vOutputStatsBlocks.size() * sizeof(NV_ENC_OUTPUT_STATS_BLOCK));
+            lockBitstreamData.outputStatsPtr = m_vOutputStatsBlocks.data();
+        }
+    }
+    NVENC_API_CALL(m_nvenc.nvEncLockBitstream(m_hEncoder, &lockBitstreamData));
+
+    try
+    {
+        fnPacket(lockBitstreamData);
+        if (bFrameStats)
+        {
+            NvEncFrameStats stats;
+            stats.frameIdx = lockBitstreamData.frameIdx;
+            stats.timeStamp = lockBitstreamData.outputTimeStamp;
+            stats.pictureType = lockBitstreamData.pictureType;
+            stats.frameAvgQP = lockBitstreamData.frameAvgQP;
+            stats.frameSatd = lockBitstreamData.frameSatd;
+            stats.sizeInBytes = lockBitstreamData.bitstreamSizeInBytes;
+            stats.intraMBCount = lockBitstreamData.intraMBCount;
+            stats.interMBCount = lockBitstreamData.interMBCount;
+            stats.averageMVX = lockBitstreamData.averageMVX;
+            stats.averageMVY = lockBitstreamData.averageMVY;
+            if (iBuffer < (int)m_vSubmitTime.size())
+            {
+                stats.latencyMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - m_vSubmitTime[iBuffer]).count();
+            }
+            if (lockBitstreamData.outputStatsPtr)
+            {
+                stats.blockSize = GetOutputStatsBlockSize();
+                size_t nBlocks = (size_t)((m_nWidth + stats.blockSize - 1) / stats.blockSize) * ((m_nHeight + stats.blockSize - 1) / stats.blockSize);
+                nBlocks = std::min(nBlocks, m_vOutputStatsBlocks.size());
+                stats.blockQP.resize(nBlocks);
+                stats.blockBits.resize(nBlocks);
+                for (size_t i = 0; i < nBlocks; i++)
+                {
+                    stats.blockQP[i] = m_vOutputStatsBlocks[i].QP;
+                    stats.blockBits[i] = m_vOutputStatsBlocks[i].bitcount;
+                }
+            }
+            m_fnFrameStats(stats);
+        }
+    }
+    catch (...)
+    {
+        m_nvenc.nvEncUnlockBitstream(m_hEncoder, lockBitstreamData.outputBitstream);
+        throw;
+    }
+
+    NVENC_API_CALL(m_nvenc.nvEncUnlockBitstream(m_hEncoder, lockBitstreamData.outputBitstream));
+
+    if (m_vMappedInputBuffers[iBuffer])
+    {
+        NVENC_API_CALL(m_nvenc.nvEncUnmapInputResource(m_hEncoder, m_vMappedInputBuffers[iBuffer]));
+        m_vMappedInputBuffers[iBuffer] = nullptr;
+    }
+    if (m_vExternalInputResources[iBuffer])
+    {
+        std::lock_guard<std::mutex> lock(m_mtxPipeline);
+        m_vExternalInputResources[iBuffer] = nullptr;
+    }
+
+    if (m_bMotionEstimationOnly && m_vMappedRefBuffers[iBuffer])
+    {
+        NVENC_API_CALL(m_nvenc.nvEncUnmapInputResource(m_hEncoder, m_vMappedRefBuffers[iBuffer]));
+        m_vMappedRefBuffers[iBuffer] = nullptr;
+    }
+}
+
+void NvEncoder::LockEncodedPackets(std::vector<NV_ENC_OUTPUT_PTR> &vOutputBuffer, bool bOutputDelay,
+    const std::function<void(const NV_ENC_LOCK_BITSTREAM &)> &fnPacket)
 {
-    unsigned i = 0;
     int iEnd = bOutputDelay ? m_iToSend - m_nOutputDelay : m_iToSend;
     for (; m_iGot < iEnd; m_iGot++)
     {
-        WaitForCompletionEvent(m_iGot % m_nEncoderBuffer);
-        NV_ENC_LOCK_BITSTREAM lockBitstreamData = { NV_ENC_LOCK_BITSTREAM_VER };
-        lockBitstreamData.outputBitstream = vOutputBuffer[m_iGot % m_nEncoderBuffer];
-        lockBitstreamData.doNotWait = false;
-        NVENC_API_CALL(m_nvenc.nvEncLockBitstream(m_hEncoder, &lockBitstreamData));
-  
-        uint8_t *pData = (uint8_t *)lockBitstreamData.bitstreamBufferPtr;
-        if (vPacket.size() < i + 1)
+        LockEncodedPacket(vOutputBuffer[m_iGot % m_nEncoderBuffer], m_iGot % m_nEncoderBuffer, fnPacket);
+    }
+}
+
+void NvEncoder::CheckNotPipelined()
+{
+    if (m_pipelineThread.joinable())
+    {
+        PYNVVC_THROW_ERROR("EncodeFrame()/EndEncode() cannot be used after SubmitFrame()", NV_ENC_ERR_INVALID_CALL);
+    }
+}
+
+uint64_t NvEncoder::SubmitFrame(NV_ENC_PIC_PARAMS *pPicParams)
+{
+    NVTX_SCOPED_RANGE("SubmitFrame")
+    {
+        std::lock_guard<std::mutex> lock(m_mtxPipeline);
+        if (m_pipelineError)
         {
-            NvEncOutputFrame nvEncOutputFrame;
-            vPacket.push_back(nvEncOutputFrame);
+            std::rethrow_exception(m_pipelineError);
         }
-        vPacket[i].frame.clear();
-       
-        if ((m_initializeParams.encodeGUID == NV_ENC_CODEC_AV1_GUID) && (m_bUseIVFContainer))
+        if (m_bPipelineFlushed)
+        {
+            PYNVVC_THROW_ERROR("Frames cannot be submitted after FlushPipeline()", NV_ENC_ERR_INVALID_CALL);
+        }
+        if (m_iToSend - m_iGot >= m_nEncoderBuffer)
+        {
+            PYNVVC_THROW_ERROR("No free input buffer, call WaitForInputFrame() before writing the input frame", NV_ENC_ERR_ENCODER_BUSY);
+        }
+    }
+    if (!m_pipelineThread.joinable())
+    {
+        // frames encoded synchronously before are already retrieved up to the output delay; flush them first
+        if (m_iGot != m_iToSend)
+        {
+            PYNVVC_THROW_ERROR("SubmitFrame() cannot follow EncodeFrame() with frames in flight", NV_ENC_ERR_INVALID_CALL);
+        }
+        m_bStopPipeline = false;
+        m_pipelineThread = std::thread(&NvEncoder::PipelineOutputLoop, this);
+    }
+    uint64_t nTicket = m_nInputTimeStamp;
+    EncodeInputFrame(pPicParams);
+    m_cvPipeline.notify_all();
+    return nTicket;
+}
+
+void NvEncoder::WaitForInputFrame()
+{
+    std::unique_lock<std::mutex> lock(m_mtxPipeline);
+    m_cvPipeline.wait(lock, [this] { return m_iToSend - m_iGot < m_nEncoderBuffer || m_pipelineError; });
+    if (m_pipelineError)
+    {
+        std::rethrow_exception(m_pipelineError);
+    }
+}
+
+// Locks the bitstreams of the submitted frames in order. nvEncLockBitstream blocks until the frame is encoded,
+// so the output buffer of a frame is copied as soon as it completes while the submitting thread goes on.
+void NvEncoder::PipelineOutputLoop()
+{
+    try
+    {
+        while (true)
         {
-            if (m_bWriteIVFFileHeader)
+            int iGot = 0;
+            NvEncOutputFrame packet;
+            {
+                std::unique_lock<std::mutex> lock(m_mtxPipeline);
+                // nvEncLockBitstream must not run on a frame still waiting for input while frames are submitted
+                m_cvPipeline.wait(lock, [this] { return m_bStopPipeline || m_iGot < GetPipelineLockEnd(); });
+                if (m_iGot >= GetPipelineLockEnd())
+                {
+                    return;
+                }
+                iGot = m_iGot;
+                if (!m_vFreePackets.empty())
+                {
+                    packet = std::move(m_vFreePackets.back());
+                    m_vFreePackets.pop_back();
+                }
+            }
+            int iBuffer = iGot % m_nEncoderBuffer;
+            LockEncodedPacket(m_vBitstreamOutputBuffer[iBuffer], iBuffer, [&](const NV_ENC_LOCK_BITSTREAM &lockBitstreamData) {
+                uint8_t *pData = (uint8_t *)lockBitstreamData.bitstreamBufferPtr;
+                packet.frame.clear();
+                WriteIVFHeaders(packet.frame, lockBitstreamData);
+                packet.frame.insert(packet.frame.end(), &pData[0], &pData[lockBitstreamData.bitstreamSizeInBytes]);
+                packet.pictureType = lockBitstreamData.pictureType;
+                packet.timeStamp = lockBitstreamData.outputTimeStamp;
+            });
             {
-                m_IVFUtils.WriteFileHeader(vPacket[i].frame, MAKE_FOURCC('A', 'V', '0', '1'), m_initializeParams.encodeWidth, m_initializeParams.encodeHeight, m_initializeParams.frameRateNum, m_initializeParams.frameRateDen, 0xFFFF);
-                m_bWriteIVFFileHeader = false;
+                std::lock_guard<std::mutex> lock(m_mtxPipeline);
+                m_qCompletedPackets.push_back(std::move(packet));
+                m_iGot++;
             }
+            m_cvPipeline.notify_all();
+        }
+    }
+    catch (...)
+    {
+        std::lock_guard<std::mutex> lock(m_mtxPipeline);
+        m_pipelineError = std::current_exception();
+        m_cvPipeline.notify_all();
+    }
+}
 
-            m_IVFUtils.WriteFrameHeader(vPacket[i].frame, lockBitstreamData.bitstreamSizeInBytes, lockBitstreamData.outputTimeStamp);
+bool NvEncoder::RetrievePacket(NvEncOutputFrame &packet, int nTimeoutMs)
+{
+    std::unique_lock<std::mutex> lock(m_mtxPipeline);
+    // no packet completes while the frames in flight are all held back for more input
+    auto isReady = [this] { return !m_qCompletedPackets.empty() || m_pipelineError || m_iGot >= GetPipelineLockEnd(); };
+    if (nTimeoutMs < 0)
+    {
+        m_cvPipeline.wait(lock, isReady);
+    }
+    else
+    {
+        m_cvPipeline.wait_for(lock, std::chrono::milliseconds(nTimeoutMs), isReady);
+    }
+    if (m_qCompletedPackets.empty())
+    {
+        if (m_pipelineError)
+        {
+            std::rethrow_exception(m_pipelineError);
         }
-        vPacket[i].frame.insert(vPacket[i].frame.end(), &pData[0], &pData[lockBitstreamData.bitstreamSizeInBytes]);
-        vPacket[i].pictureType = lockBitstreamData.pictureType;
-        vPacket[i].timeStamp = lockBitstreamData.outputTimeStamp;
-        i++;
+        return false;
+    }
+    if (packet.frame.capacity())
+    {
+        m_vFreePackets.push_back(std::move(packet));
+    }
+    packet = std::move(m_qCompletedPackets.front());
+    m_qCompletedPackets.pop_front();
+    return true;
+}
+
+void NvEncoder::FlushPipeline()
+{
+    if (!IsHWEncoderInitialized())
+    {
+        PYNVVC_THROW_ERROR("Encoder device not initialized", NV_ENC_ERR_ENCODER_NOT_INITIALIZED);
+    }
+    {
+        std::lock_guard<std::mutex> lock(m_mtxPipeline);
+        if (!m_bPipelineFlushed)
+        {
+            SendEOS();
+            m_bPipelineFlushed = true;
+        }
+    }
+    // the frames held back for more input can be locked now
+    m_cvPipeline.notify_all();
+}
 
-        NVENC_API_CALL(m_nvenc.nvEncUnlockBitstream(m_hEncoder, lockBitstreamData.outputBitstream));
+size_t NvEncoder::GetPendingCount()
+{
+    std::lock_guard<std::mutex> lock(m_mtxPipeline);
+    return (m_iToSend - m_iGot) + m_qCompletedPackets.size();
+}
 
-        if (m_vMappedInputBuffers[m_iGot % m_nEncoderBuffer])
+void NvEncoder::StopPipeline()
+{
+    if (!m_pipelineThread.joinable())
+    {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(m_mtxPipeline);
+        // frames waiting for more input complete only once the queue is flushed
+        if (!m_bPipelineFlushed && m_iGot < m_iToSend && !m_pipelineError)
         {
-            NVENC_API_CALL(m_nvenc.nvEncUnmapInputResource(m_hEncoder, m_vMappedInputBuffers[m_iGot % m_nEncoderBuffer]));
-            m_vMappedInputBuffers[m_iGot % m_nEncoderBuffer] = nullptr;
+            try
+            {
+                SendEOS();
+                m_bPipelineFlushed = true;
+            }
+            catch (...)
+            {
+            }
         }
+        m_bStopPipeline = true;
+    }
+    m_cvPipeline.notify_all();
+    m_pipelineThread.join();
+}
 
-        if (m_bMotionEstimationOnly && m_vMappedRefBuffers[m_iGot % m_nEncoderBuffer])
+void NvEncoder::WriteIVFHeaders(std::vector<uint8_t> &vHeader, const NV_ENC_LOCK_BITSTREAM &lockBitstreamData)
+{
+    if ((m_initializeParams.encodeGUID == NV_ENC_CODEC_AV1_GUID) && (m_bUseIVFContainer))
+    {
+        if (m_bWriteIVFFileHeader)
         {
-            NVENC_API_CALL(m_nvenc.nvEncUnmapInputResource(m_hEncoder, m_vMappedRefBuffers[m_iGot % m_nEncoderBuffer]));
-            m_vMappedRefBuffers[m_iGot % m_nEncoderBuffer] = nullptr;
+            m_IVFUtils.WriteFileHeader(vHeader, MAKE_FOURCC('A', 'V', '0', '1'), m_initializeParams.encodeWidth, m_initializeParams.encodeHeight, m_initializeParams.frameRateNum, m_initializeParams.frameRateDen, 0xFFFF);
+            m_bWriteIVFFileHeader = false;
         }
+
+        m_IVFUtils.WriteFrameHeader(vHeader, lockBitstreamData.bitstreamSizeInBytes, lockBitstreamData.outputTimeStamp);
     }
 }
 
+void NvEncoder::GetEncodedPacket(std::vector<NV_ENC_OUTPUT_PTR> &vOutputBuffer, std::vector<NvEncOutputFrame> &vPacket, bool bOutputDelay)
+{
+    size_t i = 0;
+    LockEncodedPackets(vOutputBuffer, bOutputDelay, [&](const NV_ENC_LOCK_BITSTREAM &lockBitstreamData) {
+        uint8_t *pData = (uint8_t *)lockBitstreamData.bitstreamBufferPtr;
+        // packets of a vector reused across calls are recycled along with their buffers
+        if (vPacket.size() < i + 1)
+        {
+            vPacket.emplace_back();
+        }
+        vPacket[i].frame.clear();
+        WriteIVFHeaders(vPacket[i].frame, lockBitstreamData);
+        vPacket[i].frame.insert(vPacket[i].frame.end(), &pData[0], &pData[lockBitstreamData.bitstreamSizeInBytes]);
+        vPacket[i].pictureType = lockBitstreamData.pictureType;
+        vPacket[i].timeStamp = lockBitstreamData.outputTimeStamp;
+        i++;
+    });
+    vPacket.resize(i);
+}
+
+int NvEncoder::GetEncodedPacket(std::vector<NV_ENC_OUTPUT_PTR> &vOutputBuffer, const NvEncBitstreamWriter &fnWrite, bool bOutputDelay)
+{
+    int nPackets = 0;
+    LockEncodedPackets(vOutputBuffer, bOutputDelay, [&](const NV_ENC_LOCK_BITSTREAM &lockBitstreamData) {
+        m_vIVFHeader.clear();
+        WriteIVFHeaders(m_vIVFHeader, lockBitstreamData);
+        if (!m_vIVFHeader.empty())
+        {
+            fnWrite(m_vIVFHeader.data(), m_vIVFHeader.size(), false);
+        }
+        fnWrite((const uint8_t *)lockBitstreamData.bitstreamBufferPtr, lockBitstreamData.bitstreamSizeInBytes, true);
+        nPackets++;
+    });
+    return nPackets;
+}
+
 bool NvEncoder::Reconfigure(const NV_ENC_RECONFIGURE_PARAMS *pReconfigureParams)
 {
     NVENC_API_CALL(m_nvenc.nvEncReconfigureEncoder(m_hEncoder, const_cast<NV_ENC_RECONFIGURE_PARAMS*>(pReconfigureParams)));
@@ -892,6 +1228,40 @@ void NvEncoder::ResetCounter()
     m_nInputTimeStamp = 0;
 }
 
+void NvEncoder::StartNewSequence()
+{
+    ResetCounter();
+    m_bWriteIVFFileHeader = true;
+}
+
+void NvEncoder::SetFrameStatsCallback(NvEncFrameStatsCallback fnFrameStats)
+{
+    m_fnFrameStats = std::move(fnFrameStats);
+    m_vSubmitTime.assign(m_fnFrameStats ? m_nEncoderBuffer : 0, std::chrono::steady_clock::time_point());
+}
+
+uint32_t NvEncoder::GetOutputStatsBlockSize() const
+{
+    if (m_initializeParams.encodeGUID == NV_ENC_CODEC_HEVC_GUID)
+    {
+        // the blocks are CTBs, 32x32 unless set otherwise
+        switch (m_encodeConfig.encodeCodecConfig.hevcConfig.maxCUSize)
+        {
+        case NV_ENC_HEVC_CUSIZE_16x16:
+            return 16;
+        case NV_ENC_HEVC_CUSIZE_64x64:
+            return 64;
+        default:
+            return 32;
+        }
+    }
+    if (m_initializeParams.encodeGUID == NV_ENC_CODEC_AV1_GUID)
+    {
+        return 64;
+    }
+    return 16;
+}
+
 void NvEncoder::UnregisterInputResources()
 {
     FlushEncoder();
@@ -916,6 +1286,8 @@ void NvEncoder::UnregisterInputResources()
         }
     }
     m_vMappedInputBuffers.clear();
+    m_vExternalInputResources.clear();
+    m_pNextInputResource = nullptr;
 
     for (uint32_t i = 0; i < m_vRegisteredResources.size(); ++i)
     {
@@ -33,6 +33,12 @@
 #pragma once
 
 #include <vector>
+#include <functional>
+#include <deque>
+#include <thread>
+#include <condition_variable>
+#include <chrono>
+#include <exception>
 #include "nvEncodeAPI_130.h"
 #include <stdint.h>
 #include <mutex>
@@ -41,6 +47,7 @@
 #include <sstream>
 #include <string.h>
 #include "NvCodecUtils.h"
+#include "NvEncFrameStats.h"
 
 #define NVENC_API_CALL( nvencAPI )                                                                                   \
     do                                                                                                               \
@@ -87,6 +94,13 @@ struct NvEncOutputFrame
     uint64_t timeStamp;
 };
 
+/**
+* @brief Receives the encoded bitstream straight from the locked NVENC output buffers, in bitstream order:
+* the IVF headers (AV1 in IVF container) and the payload of each packet. The data is valid only during the call.
+* bEndOfPacket is set on the last write of a packet.
+*/
+typedef std::function<void(const uint8_t* pData, size_t nBytes, bool bEndOfPacket)> NvEncBitstreamWriter;
+
 /**
 * @brief Shared base class for different encoder interfaces.
 */
@@ -125,6 +139,19 @@ public:
     const NvEncInputFrame* GetNextInputFrame();
     const NvEncInputFrame* GetNextInputFrame(uint32_t frameIdx);
 
+    /**
+    *  @brief  This function makes the next encoded frame read its input from a resource registered with
+    *  RegisterResource() instead of the buffer returned by GetNextInputFrame(), which saves the copy of the frame.
+    *  The resource is read until the packet of the frame is output; it must not be modified nor unregistered before,
+    *  see IsInputResourceInFlight().
+    */
+    void SetNextInputResource(NV_ENC_REGISTERED_PTR registeredResource);
+
+    /**
+    *  @brief  This function returns true if a frame encoded from registeredResource has not been output yet.
+    */
+    bool IsInputResourceInFlight(NV_ENC_REGISTERED_PTR registeredResource);
+
 
     /**
     *  @brief  This function is used to encode a frame.
@@ -134,6 +161,13 @@ public:
     */
     virtual void EncodeFrame(std::vector<NvEncOutputFrame> &vPacket, NV_ENC_PIC_PARAMS *pPicParams = nullptr);
 
+    /**
+    *  @brief  This function is used to encode a frame and pass the bitstream of the packets output by the call
+    *  to fnWrite, which copies it once from the locked output buffers, e.g. to a reused buffer or a file.
+    *  Returns the number of packets.
+    */
+    int EncodeFrame(const NvEncBitstreamWriter &fnWrite, NV_ENC_PIC_PARAMS *pPicParams = nullptr);
+
     /**
     *  @brief  This function to flush the encoder queue.
     *  The encoder might be queuing frames for B picture encoding or lookahead;
@@ -143,6 +177,45 @@ public:
     */
     virtual void EndEncode(std::vector<NvEncOutputFrame> &vPacket);
 
+    /**
+    *  @brief  This function is used to flush the encoder queue, passing the bitstream of the queued packets to fnWrite.
+    *  Returns the number of packets.
+    */
+    int EndEncode(const NvEncBitstreamWriter &fnWrite);
+
+    /**
+    *  @brief  This function is used to submit the frame copied to the input buffer obtained from GetNextInputFrame()
+    *  without waiting for its bitstream. The first call starts an output thread which locks the bitstreams in
+    *  submission order as they complete; retrieve them with RetrievePacket(). EncodeFrame() and EndEncode() cannot
+    *  be used once frames are submitted. Returns the ticket of the frame, which is the timeStamp of its packet.
+    */
+    uint64_t SubmitFrame(NV_ENC_PIC_PARAMS *pPicParams = nullptr);
+
+    /**
+    *  @brief  This function blocks until the input buffer returned by GetNextInputFrame() is no longer used by a
+    *  frame in flight. Call it before writing the next input frame of SubmitFrame().
+    */
+    void WaitForInputFrame();
+
+    /**
+    *  @brief  This function returns the next packet completed by the output thread into packet, whose previous
+    *  buffer is recycled. Returns false if no packet completed within nTimeoutMs (negative waits indefinitely,
+    *  0 polls) or if no frame can complete. The last frames, up to the output delay of the encoder (B frames,
+    *  lookahead), complete only after later frames are submitted or FlushPipeline() is called.
+    */
+    bool RetrievePacket(NvEncOutputFrame &packet, int nTimeoutMs = -1);
+
+    /**
+    *  @brief  This function is used to flush the encoder queue of submitted frames. The queued packets are
+    *  retrieved with RetrievePacket().
+    */
+    void FlushPipeline();
+
+    /**
+    *  @brief  This function returns the number of submitted frames whose packet was not retrieved yet.
+    */
+    size_t GetPendingCount();
+
     /**
     *  @brief  This function is used to query hardware encoder capabilities.
     *  Applications can call this function to query capabilities like maximum encode
@@ -212,6 +285,11 @@ public:
     */
     const NvEncInputFrame* GetNextReferenceFrame();
 
+    /**
+    *  @brief This function returns true for a motion estimation only session.
+    */
+    bool IsMotionEstimationOnly() const { return m_bMotionEstimationOnly; }
+
     /**
     *  @brief This function is used to get sequence and picture parameter headers.
     *  Application can call this function after encoder is initialized to get SPS and PPS
@@ -289,6 +367,26 @@ public:
    *  @brief This function is used to reset the encoded frame count
    */
     void ResetCounter();
+
+    /**
+    *  @brief This function prepares an encoder flushed with EndEncode() to encode an independent sequence:
+    *  timestamps restart from 0 and the IVF file header is written again. The first frame of the sequence
+    *  must be encoded with NV_ENC_PIC_FLAG_FORCEIDR and NV_ENC_PIC_FLAG_OUTPUT_SPSPPS.
+    */
+    void StartNewSequence();
+
+    /**
+    *  @brief This function sets a callback receiving the statistics of each encoded frame, called in bitstream order
+    *  from the thread locking the bitstream. Per block QP and bit counts are reported if the encoder is initialized
+    *  with enableOutputStats and NV_ENC_OUTPUT_STATS_BLOCK_LEVEL. Must be called after CreateEncoder() and before
+    *  the first frame is encoded; an empty function disables the statistics.
+    */
+    void SetFrameStatsCallback(NvEncFrameStatsCallback fnFrameStats);
+
+    /**
+    *  @brief This function returns the size in pixels of the blocks of the output block stats.
+    */
+    uint32_t GetOutputStatsBlockSize() const;
 protected:
 
     /**
@@ -388,6 +486,45 @@ private:
     *  this may return without any output data.
     */
     void GetEncodedPacket(std::vector<NV_ENC_OUTPUT_PTR> &vOutputBuffer, std::vector<NvEncOutputFrame> &vPacket, bool bOutputDelay);
+    int GetEncodedPacket(std::vector<NV_ENC_OUTPUT_PTR> &vOutputBuffer, const NvEncBitstreamWriter &fnWrite, bool bOutputDelay);
+
+    /**
+    *  @brief This is a private function which locks the output buffers of the completed frames in order
+    *         and passes each locked bitstream to fnPacket, then unlocks it and unmaps the input resources.
+    */
+    void LockEncodedPackets(std::vector<NV_ENC_OUTPUT_PTR> &vOutputBuffer, bool bOutputDelay,
+        const std::function<void(const NV_ENC_LOCK_BITSTREAM &)> &fnPacket);
+
+    /**
+    *  @brief This is a private function which appends the IVF file and frame headers of a packet to vHeader
+    *         when AV1 is written in IVF container.
+    */
+    void WriteIVFHeaders(std::vector<uint8_t> &vHeader, const NV_ENC_LOCK_BITSTREAM &lockBitstreamData);
+
+    /**
+    *  @brief This is a private function which submits the current input frame to the encoder.
+    */
+    void EncodeInputFrame(NV_ENC_PIC_PARAMS *pPicParams);
+
+    /**
+    *  @brief This is a private function which locks the bitstream of the frame in buffer iBuffer, passes it
+    *         to fnPacket, then unlocks it and unmaps the input resources of the frame.
+    */
+    void LockEncodedPacket(NV_ENC_OUTPUT_PTR outputBuffer, int iBuffer, const std::function<void(const NV_ENC_LOCK_BITSTREAM &)> &fnPacket);
+
+    /**
+    *  @brief These are private functions which run the output thread of SubmitFrame() and check that
+    *         synchronous encoding is not mixed with it.
+    */
+    void PipelineOutputLoop();
+    void CheckNotPipelined();
+
+    /**
+    *  @brief This function returns the end of the frames the output thread may lock. Like LockEncodedPackets(), it
+    *         holds back the last m_nOutputDelay frames, which wait for later input, until FlushPipeline() sent EOS.
+    *         Must be called with m_mtxPipeline held.
+    */
+    int32_t GetPipelineLockEnd() const { return m_bPipelineFlushed ? m_iToSend : m_iToSend - m_nOutputDelay; }
 
     /**
     *  @brief This is a private function which is used to initialize the bitstream buffers.
@@ -437,6 +574,12 @@ private:
     virtual void ReleaseInputBuffers() = 0;
 
 protected:
+    /**
+    *  @brief This function stops the output thread of SubmitFrame(), flushing the frames in flight.
+    *         Derived classes call it before releasing the input resources.
+    */
+    void StopPipeline();
+
     bool m_bMotionEstimationOnly = false;
     bool m_bOutputInVideoMemory = false;
     bool m_bIsDX12Encode = false;
@@ -458,6 +601,24 @@ protected:
     IVFUtils m_IVFUtils;
     bool m_bWriteIVFFileHeader = true;
     bool m_bUseIVFContainer = true;
+    // IVF headers of the packet being written through a NvEncBitstreamWriter
+    std::vector<uint8_t> m_vIVFHeader;
+    // output thread of SubmitFrame(). m_iToSend and m_iGot are guarded by m_mtxPipeline while it runs.
+    std::thread m_pipelineThread;
+    std::mutex m_mtxPipeline;
+    std::condition_variable m_cvPipeline;
+    bool m_bStopPipeline = false;
+    bool m_bPipelineFlushed = false;
+    std::deque<NvEncOutputFrame> m_qCompletedPackets;
+    std::vector<NvEncOutputFrame> m_vFreePackets;
+    std::exception_ptr m_pipelineError;
+    // resource of SetNextInputResource(), and the external resource each buffer of the ring was mapped from
+    NV_ENC_REGISTERED_PTR m_pNextInputResource = nullptr;
+    std::vector<NV_ENC_REGISTERED_PTR> m_vExternalInputResources;
+    // statistics of SetFrameStatsCallback(): submission time of the frame of each buffer, and the block stats buffer
+    NvEncFrameStatsCallback m_fnFrameStats;
+    std::vector<std::chrono::steady_clock::time_point> m_vSubmitTime;
+    std::vector<NV_ENC_OUTPUT_STATS_BLOCK> m_vOutputStatsBlocks;
     bool m_bRepeatSequenceHeader = false;
 	std::vector<NV_ENC_OUTPUT_PTR> m_vBitstreamOutputBuffer;
 #if defined(_WIN32) 
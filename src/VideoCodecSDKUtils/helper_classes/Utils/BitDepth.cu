@@ -26,6 +26,7 @@
 #include <cuda_runtime.h>
 #include <stdint.h>
 #include <stdio.h>
+#include "BitDepth.h"
 
 static __global__ void ConvertUInt8ToUInt16Kernel(uint8_t *dpUInt8, uint16_t *dpUInt16, int nSrcPitch, int nDestPitch, int nWidth, int nHeight)
 {
@@ -53,6 +54,19 @@ static __global__ void ConvertUInt16ToUInt8Kernel(uint16_t *dpUInt16, uint8_t *d
     dpUInt8[y * nDestPitch + x] = ((uchar2 *)&dpUInt16[y * srcStrideInPixels + x])->y;
 }
 
+static __global__ void ConvertUInt16ToUInt8RoundedKernel(const uint16_t *dpUInt16, uint8_t *dpUInt8, int nSrcPitch, int nDestPitch, int nWidth, int nHeight, bool bDither)
+{
+    int x = blockIdx.x * blockDim.x + threadIdx.x,
+        y = blockIdx.y * blockDim.y + threadIdx.y;
+
+    if (x >= nWidth || y >= nHeight)
+    {
+        return;
+    }
+    uint16_t s = *(const uint16_t *)((const uint8_t *)dpUInt16 + (size_t)y * nSrcPitch + x * sizeof(uint16_t));
+    dpUInt8[(size_t)y * nDestPitch + x] = BitDepthToUInt8(s, x, y, bDither);
+}
+
 void ConvertUInt8ToUInt16(uint8_t *dpUInt8, uint16_t *dpUInt16, int nSrcPitch, int nDestPitch, int nWidth, int nHeight)
 {
     dim3 blockSize(16, 16, 1);
@@ -66,3 +80,10 @@ void ConvertUInt16ToUInt8(uint16_t *dpUInt16, uint8_t *dpUInt8, int nSrcPitch, i
     dim3 gridSize(((uint32_t)nWidth + blockSize.x - 1) / blockSize.x, ((uint32_t)nHeight + blockSize.y - 1) / blockSize.y, 1);
     ConvertUInt16ToUInt8Kernel <<<gridSize, blockSize >>>(dpUInt16, dpUInt8, nSrcPitch, nDestPitch, nWidth, nHeight);
 }
+
+void ConvertUInt16ToUInt8Rounded(const uint16_t *dpUInt16, uint8_t *dpUInt8, int nSrcPitch, int nDestPitch, int nWidth, int nHeight, bool bDither, cudaStream_t stream)
+{
+    dim3 blockSize(32, 8, 1);
+    dim3 gridSize(((uint32_t)nWidth + blockSize.x - 1) / blockSize.x, ((uint32_t)nHeight + blockSize.y - 1) / blockSize.y, 1);
+    ConvertUInt16ToUInt8RoundedKernel <<<gridSize, blockSize, 0, stream >>>(dpUInt16, dpUInt8, nSrcPitch, nDestPitch, nWidth, nHeight, bDither);
+}
@@ -0,0 +1,83 @@
+/*
+ * This copyright notice applies to this file only
+ *
+ * SPDX-FileCopyrightText: Copyright (c) 2010-2025 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Per-sample functions are shared by the CUDA kernel and the host reference implementation
+#if defined(__CUDACC__)
+#define BD_HOST_DEVICE __host__ __device__
+#else
+#define BD_HOST_DEVICE
+#endif
+
+/**
+*   @brief  Threshold of an 8x8 Bayer ordered dither matrix, in [0, 64). Position (x, y) is taken modulo 8.
+*   Built from the bits of x ^ y and y, so the kernel needs no table in constant memory.
+*/
+BD_HOST_DEVICE inline int BitDepthBayer8x8(int x, int y)
+{
+    int d = x ^ y;
+    return ((d & 1) << 5) | ((y & 1) << 4) | ((d & 2) << 2) | ((y & 2) << 1) | ((d & 4) >> 1) | ((y & 4) >> 2);
+}
+
+/**
+*   @brief  Converts an MSB aligned 16 bit sample at (x, y) to 8 bit, 65535 mapping to 255.
+*   Without dithering the sample is rounded to nearest; ordered dithering replaces the constant 1/2 output step
+*   offset with (threshold + 1/2) / 64, which has the same mean. Integer arithmetic keeps the kernel and the
+*   host reference identical: floor(s / 257 + t / 128) is computed as (128 s + 257 t) / 32896.
+*/
+BD_HOST_DEVICE inline uint8_t BitDepthToUInt8(uint16_t s, int x, int y, bool bDither)
+{
+    int t = bDither ? 2 * BitDepthBayer8x8(x, y) + 1 : 64;
+    int v = (128 * (int)s + 257 * t) / 32896;
+    return (uint8_t)(v > 255 ? 255 : v);
+}
+
+/**
+*   @brief  Host reference of ConvertUInt16ToUInt8Rounded(). Pitches are in bytes.
+*/
+inline void ConvertUInt16ToUInt8RoundedHost(const uint16_t *pUInt16, uint8_t *pUInt8, int nSrcPitch, int nDestPitch, int nWidth, int nHeight, bool bDither)
+{
+    for (int y = 0; y < nHeight; y++)
+    {
+        const uint16_t *pSrc = (const uint16_t *)((const uint8_t *)pUInt16 + (size_t)y * nSrcPitch);
+        for (int x = 0; x < nWidth; x++)
+        {
+            pUInt8[(size_t)y * nDestPitch + x] = BitDepthToUInt8(pSrc[x], x, y, bDither);
+        }
+    }
+}
+
+struct CUstream_st;
+
+/**
+*   @brief  Converts MSB aligned 16 bit samples in device memory to 8 bit with BitDepthToUInt8(), on stream.
+*   Pitches are in bytes.
+*/
+void ConvertUInt16ToUInt8Rounded(const uint16_t *dpUInt16, uint8_t *dpUInt8, int nSrcPitch, int nDestPitch, int nWidth, int nHeight,
+    bool bDither = false, CUstream_st *stream = 0);
@@ -24,6 +24,7 @@
  */
 
 #include "ColorSpace.h"
+#include "PostProcess.h"
 
 #include <cuda.h>
 
@@ -517,6 +518,56 @@ void P216ToColor24Planar(uint8_t *dpP216, int nP216Pitch, uint8_t *dpRGBP, int n
 }
 template void P216ToColor24Planar<RGB24>(uint8_t *dpP216, int nP216Pitch, uint8_t *dpRGBP, int nRGBPPitch, int nWidth, int nHeight, int nDstHeight, int iMatrix, CUstream stream);
 
+// One thread per output pixel; the frame is read once and the model-ready tensor written once
+__global__ static void YuvToRgbPostProcessKernel(PostProcessSource src, uint8_t *pDst, PostProcessParams params, PostProcessColorMatrix mat) {
+    int x = threadIdx.x + blockIdx.x * blockDim.x;
+    int y = threadIdx.y + blockIdx.y * blockDim.y;
+    if (x >= params.nWidth || y >= params.nHeight) {
+        return;
+    }
+    PostProcessPixel(src, mat, params, x, y, pDst);
+}
+
+void YuvToRgbPostProcess(const PostProcessSource &src, uint8_t *dpDst, const PostProcessParams &params,
+    const PostProcessColorimetry &colorimetry, CUstream_st *stream) {
+    PostProcessColorMatrix mat = GetPostProcessColorMatrix(colorimetry, src.nBytesPerSample);
+    YuvToRgbPostProcessKernel
+        <<<dim3((params.nWidth + 31) / 32, (params.nHeight + 3) / 4), dim3(32, 4), 0, stream>>>
+        (src, dpDst, params, mat);
+}
+
+struct YuvToLadderArgs {
+    PostProcessOutput aOutput[PostProcessMaxOutputs];
+    uint8_t *apDst[PostProcessMaxOutputs];
+};
+
+// blockIdx.z selects the output; all outputs of a launch read the same source frame through L2
+__global__ static void YuvToLadderKernel(PostProcessSource src, YuvToLadderArgs args, PostProcessColorMatrix mat) {
+    int x = threadIdx.x + blockIdx.x * blockDim.x;
+    int y = threadIdx.y + blockIdx.y * blockDim.y;
+    PostProcessOutputPixel(src, mat, args.aOutput[blockIdx.z], x, y, args.apDst[blockIdx.z]);
+}
+
+void YuvToLadder(const PostProcessSource &src, const PostProcessOutput *pOutputs, uint8_t *const *dpDst, int nOutputs,
+    const PostProcessColorimetry &colorimetry, CUstream_st *stream) {
+    if (nOutputs <= 0) {
+        return;
+    }
+    YuvToLadderArgs args = {};
+    int nMaxWidth = 0, nMaxHeight = 0;
+    nOutputs = nOutputs < PostProcessMaxOutputs ? nOutputs : PostProcessMaxOutputs;
+    for (int i = 0; i < nOutputs; i++) {
+        args.aOutput[i] = pOutputs[i];
+        args.apDst[i] = dpDst[i];
+        nMaxWidth = pOutputs[i].params.nWidth > nMaxWidth ? pOutputs[i].params.nWidth : nMaxWidth;
+        nMaxHeight = pOutputs[i].params.nHeight > nMaxHeight ? pOutputs[i].params.nHeight : nMaxHeight;
+    }
+    PostProcessColorMatrix mat = GetPostProcessColorMatrix(colorimetry, src.nBytesPerSample);
+    YuvToLadderKernel
+        <<<dim3((nMaxWidth + 31) / 32, (nMaxHeight + 3) / 4, nOutputs), dim3(32, 4), 0, stream>>>
+        (src, args, mat);
+}
+
 template<class YuvUnit, class RgbUnit>
 __device__ inline YuvUnit RgbToY(RgbUnit r, RgbUnit g, RgbUnit b) {
     const YuvUnit low = 1 << (sizeof(YuvUnit) * 8 - 4);
@@ -0,0 +1,454 @@
+/*
+ * This copyright notice applies to this file only
+ *
+ * SPDX-FileCopyrightText: Copyright (c) 2010-2025 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#include "ColorSpaceHost.h"
+#include "PostProcess.h"
+
+#include <atomic>
+#include <stddef.h>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define CS_HOST_X86
+#include <immintrin.h>
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#define CS_TARGET_SSE41
+#define CS_TARGET_AVX2
+#else
+#define CS_TARGET_SSE41 __attribute__((target("sse4.1")))
+#define CS_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#define CS_HOST_NEON
+#include <arm_neon.h>
+#endif
+
+namespace
+{
+
+// One row of a conversion. The chroma samples of pixel x are pU[(x >> nChromaShift) * nChromaStep] and
+// the same element of pV, counted in samples. Output channels are written every nDstStep bytes.
+struct RowParams
+{
+    const uint8_t *pY = nullptr, *pU = nullptr, *pV = nullptr;
+    int nChromaStep = 1;
+    int nChromaShift = 0;
+    uint8_t *pR = nullptr, *pG = nullptr, *pB = nullptr;
+    int nDstStep = 3;
+    int nWidth = 0;
+};
+
+// Mirrors YuvToRgbForPixel() in ColorSpace.cu
+template <typename YuvUnit>
+void ConvertRowScalar(const RowParams &row, const PostProcessColorMatrix &m, int nFirst)
+{
+    const YuvUnit *pY = (const YuvUnit *)row.pY, *pU = (const YuvUnit *)row.pU, *pV = (const YuvUnit *)row.pV;
+    const int nShift = (int)(sizeof(YuvUnit) - 1) * 8;
+    const int low = (int)m.low, mid = (int)m.mid;
+    for (int x = nFirst; x < row.nWidth; x++)
+    {
+        int c = (x >> row.nChromaShift) * row.nChromaStep;
+        float fy = (float)((int)pY[x] - low), fu = (float)((int)pU[c] - mid), fv = (float)((int)pV[c] - mid);
+        uint8_t *pDst[3] = { row.pR, row.pG, row.pB };
+        for (int i = 0; i < 3; i++)
+        {
+            float value = m.mat[i][0] * fy + m.mat[i][1] * fu + m.mat[i][2] * fv;
+            value = value < 0.0f ? 0.0f : (value > m.maxValue ? m.maxValue : value);
+            pDst[i][x * row.nDstStep] = (uint8_t)((YuvUnit)value >> nShift);
+        }
+    }
+}
+
+// SIMD rows handle 8 bit samples with either semi-planar subsampled chroma (UV interleaved) or planar full chroma,
+// writing interleaved or planar RGB. They return the number of pixels converted; the scalar path finishes the row.
+bool IsSemiPlanarRow(const RowParams &row)
+{
+    return row.nChromaShift == 1 && row.nChromaStep == 2 && row.pV == row.pU + 1;
+}
+
+bool IsPlanarRow(const RowParams &row)
+{
+    return row.nChromaShift == 0 && row.nChromaStep == 1;
+}
+
+bool IsInterleavedOutput(const RowParams &row)
+{
+    return row.nDstStep == 3 && row.pG == row.pR + 1 && row.pB == row.pR + 2;
+}
+
+#if defined(CS_HOST_X86)
+
+CS_TARGET_SSE41 inline __m128i ConvertChannelSse41(const float *k, __m128 fy, __m128 fu, __m128 fv, __m128 maxValue)
+{
+    __m128 value = _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(k[0]), fy), _mm_mul_ps(_mm_set1_ps(k[1]), fu)),
+                              _mm_mul_ps(_mm_set1_ps(k[2]), fv));
+    return _mm_cvttps_epi32(_mm_min_ps(_mm_max_ps(value, _mm_setzero_ps()), maxValue));
+}
+
+// Loads the samples of 8 pixels, chroma upsampled horizontally if needed
+CS_TARGET_SSE41 inline void LoadPixelsSse41(const RowParams &row, bool bSemiPlanar, int x, __m128i *y8, __m128i *u8, __m128i *v8)
+{
+    *y8 = _mm_loadl_epi64((const __m128i *)(row.pY + x));
+    if (bSemiPlanar)
+    {
+        __m128i uv = _mm_loadl_epi64((const __m128i *)(row.pU + x));
+        *u8 = _mm_shuffle_epi8(uv, _mm_setr_epi8(0, 0, 2, 2, 4, 4, 6, 6, -1, -1, -1, -1, -1, -1, -1, -1));
+        *v8 = _mm_shuffle_epi8(uv, _mm_setr_epi8(1, 1, 3, 3, 5, 5, 7, 7, -1, -1, -1, -1, -1, -1, -1, -1));
+    }
+    else
+    {
+        *u8 = _mm_loadl_epi64((const __m128i *)(row.pU + x));
+        *v8 = _mm_loadl_epi64((const __m128i *)(row.pV + x));
+    }
+}
+
+// Stores 8 pixels given as 8 bytes per channel
+CS_TARGET_SSE41 inline void StorePixelsSse41(const RowParams &row, bool bInterleaved, int x, __m128i r8, __m128i g8, __m128i b8)
+{
+    if (!bInterleaved)
+    {
+        _mm_storel_epi64((__m128i *)(row.pR + x), r8);
+        _mm_storel_epi64((__m128i *)(row.pG + x), g8);
+        _mm_storel_epi64((__m128i *)(row.pB + x), b8);
+        return;
+    }
+    __m128i rg = _mm_unpacklo_epi64(r8, g8);
+    __m128i lo = _mm_or_si128(
+        _mm_shuffle_epi8(rg, _mm_setr_epi8(0, 8, -1, 1, 9, -1, 2, 10, -1, 3, 11, -1, 4, 12, -1, 5)),
+        _mm_shuffle_epi8(b8, _mm_setr_epi8(-1, -1, 0, -1, -1, 1, -1, -1, 2, -1, -1, 3, -1, -1, 4, -1)));
+    __m128i hi = _mm_or_si128(
+        _mm_shuffle_epi8(rg, _mm_setr_epi8(13, -1, 6, 14, -1, 7, 15, -1, -1, -1, -1, -1, -1, -1, -1, -1)),
+        _mm_shuffle_epi8(b8, _mm_setr_epi8(-1, 5, -1, -1, 6, -1, -1, 7, -1, -1, -1, -1, -1, -1, -1, -1)));
+    _mm_storeu_si128((__m128i *)(row.pR + x * 3), lo);
+    _mm_storel_epi64((__m128i *)(row.pR + x * 3 + 16), hi);
+}
+
+CS_TARGET_SSE41 int ConvertRowSse41(const RowParams &row, const PostProcessColorMatrix &m)
+{
+    bool bSemiPlanar = IsSemiPlanarRow(row), bInterleaved = IsInterleavedOutput(row);
+    if ((!bSemiPlanar && !IsPlanarRow(row)) || (!bInterleaved && row.nDstStep != 1))
+    {
+        return 0;
+    }
+    const __m128 low = _mm_set1_ps(m.low), mid = _mm_set1_ps(m.mid), maxValue = _mm_set1_ps(m.maxValue);
+    int x = 0;
+    for (; x + 8 <= row.nWidth; x += 8)
+    {
+        __m128i y8, u8, v8;
+        LoadPixelsSse41(row, bSemiPlanar, x, &y8, &u8, &v8);
+        __m128i rgb[3][2];
+        for (int h = 0; h < 2; h++)
+        {
+            __m128 fy = _mm_sub_ps(_mm_cvtepi32_ps(_mm_cvtepu8_epi32(y8)), low);
+            __m128 fu = _mm_sub_ps(_mm_cvtepi32_ps(_mm_cvtepu8_epi32(u8)), mid);
+            __m128 fv = _mm_sub_ps(_mm_cvtepi32_ps(_mm_cvtepu8_epi32(v8)), mid);
+            for (int i = 0; i < 3; i++)
+            {
+                rgb[i][h] = ConvertChannelSse41(m.mat[i], fy, fu, fv, maxValue);
+            }
+            y8 = _mm_srli_si128(y8, 4);
+            u8 = _mm_srli_si128(u8, 4);
+            v8 = _mm_srli_si128(v8, 4);
+        }
+        __m128i zero = _mm_setzero_si128();
+        StorePixelsSse41(row, bInterleaved, x,
+            _mm_packus_epi16(_mm_packus_epi32(rgb[0][0], rgb[0][1]), zero),
+            _mm_packus_epi16(_mm_packus_epi32(rgb[1][0], rgb[1][1]), zero),
+            _mm_packus_epi16(_mm_packus_epi32(rgb[2][0], rgb[2][1]), zero));
+    }
+    return x;
+}
+
+CS_TARGET_AVX2 inline __m128i ConvertChannelAvx2(const float *k, __m256 fy, __m256 fu, __m256 fv, __m256 maxValue)
+{
+    __m256 value = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(k[0]), fy), _mm256_mul_ps(_mm256_set1_ps(k[1]), fu)),
+                                 _mm256_mul_ps(_mm256_set1_ps(k[2]), fv));
+    __m256i value32 = _mm256_cvttps_epi32(_mm256_min_ps(_mm256_max_ps(value, _mm256_setzero_ps()), maxValue));
+    __m128i value16 = _mm_packus_epi32(_mm256_castsi256_si128(value32), _mm256_extracti128_si256(value32, 1));
+    return _mm_packus_epi16(value16, _mm_setzero_si128());
+}
+
+CS_TARGET_AVX2 int ConvertRowAvx2(const RowParams &row, const PostProcessColorMatrix &m)
+{
+    bool bSemiPlanar = IsSemiPlanarRow(row), bInterleaved = IsInterleavedOutput(row);
+    if ((!bSemiPlanar && !IsPlanarRow(row)) || (!bInterleaved && row.nDstStep != 1))
+    {
+        return 0;
+    }
+    const __m256 low = _mm256_set1_ps(m.low), mid = _mm256_set1_ps(m.mid), maxValue = _mm256_set1_ps(m.maxValue);
+    int x = 0;
+    for (; x + 8 <= row.nWidth; x += 8)
+    {
+        __m128i y8, u8, v8;
+        LoadPixelsSse41(row, bSemiPlanar, x, &y8, &u8, &v8);
+        __m256 fy = _mm256_sub_ps(_mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(y8)), low);
+        __m256 fu = _mm256_sub_ps(_mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(u8)), mid);
+        __m256 fv = _mm256_sub_ps(_mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(v8)), mid);
+        StorePixelsSse41(row, bInterleaved, x,
+            ConvertChannelAvx2(m.mat[0], fy, fu, fv, maxValue),
+            ConvertChannelAvx2(m.mat[1], fy, fu, fv, maxValue),
+            ConvertChannelAvx2(m.mat[2], fy, fu, fv, maxValue));
+    }
+    return x;
+}
+
+#endif
+
+#if defined(CS_HOST_NEON)
+
+inline uint8x8_t ConvertChannelNeon(const float *k, const float32x4_t *fy, const float32x4_t *fu, const float32x4_t *fv, float32x4_t maxValue)
+{
+    uint32x4_t value32[2];
+    for (int h = 0; h < 2; h++)
+    {
+        float32x4_t value = vaddq_f32(vaddq_f32(vmulq_n_f32(fy[h], k[0]), vmulq_n_f32(fu[h], k[1])), vmulq_n_f32(fv[h], k[2]));
+        value32[h] = vcvtq_u32_f32(vminq_f32(vmaxq_f32(value, vdupq_n_f32(0.0f)), maxValue));
+    }
+    return vqmovn_u16(vcombine_u16(vmovn_u32(value32[0]), vmovn_u32(value32[1])));
+}
+
+int ConvertRowNeon(const RowParams &row, const PostProcessColorMatrix &m)
+{
+    bool bSemiPlanar = IsSemiPlanarRow(row), bInterleaved = IsInterleavedOutput(row);
+    if ((!bSemiPlanar && !IsPlanarRow(row)) || (!bInterleaved && row.nDstStep != 1))
+    {
+        return 0;
+    }
+    const uint8_t dupU[8] = { 0, 0, 2, 2, 4, 4, 6, 6 }, dupV[8] = { 1, 1, 3, 3, 5, 5, 7, 7 };
+    const uint8x8_t idxU = vld1_u8(dupU), idxV = vld1_u8(dupV);
+    const float32x4_t low = vdupq_n_f32(m.low), mid = vdupq_n_f32(m.mid), maxValue = vdupq_n_f32(m.maxValue);
+    int x = 0;
+    for (; x + 8 <= row.nWidth; x += 8)
+    {
+        uint8x8_t y8 = vld1_u8(row.pY + x), u8, v8;
+        if (bSemiPlanar)
+        {
+            uint8x8_t uv = vld1_u8(row.pU + x);
+            u8 = vtbl1_u8(uv, idxU);
+            v8 = vtbl1_u8(uv, idxV);
+        }
+        else
+        {
+            u8 = vld1_u8(row.pU + x);
+            v8 = vld1_u8(row.pV + x);
+        }
+        uint16x8_t y16 = vmovl_u8(y8), u16 = vmovl_u8(u8), v16 = vmovl_u8(v8);
+        float32x4_t fy[2] = { vsubq_f32(vcvtq_f32_u32(vmovl_u16(vget_low_u16(y16))), low), vsubq_f32(vcvtq_f32_u32(vmovl_u16(vget_high_u16(y16))), low) };
+        float32x4_t fu[2] = { vsubq_f32(vcvtq_f32_u32(vmovl_u16(vget_low_u16(u16))), mid), vsubq_f32(vcvtq_f32_u32(vmovl_u16(vget_high_u16(u16))), mid) };
+        float32x4_t fv[2] = { vsubq_f32(vcvtq_f32_u32(vmovl_u16(vget_low_u16(v16))), mid), vsubq_f32(vcvtq_f32_u32(vmovl_u16(vget_high_u16(v16))), mid) };
+        uint8x8x3_t rgb;
+        rgb.val[0] = ConvertChannelNeon(m.mat[0], fy, fu, fv, maxValue);
+        rgb.val[1] = ConvertChannelNeon(m.mat[1], fy, fu, fv, maxValue);
+        rgb.val[2] = ConvertChannelNeon(m.mat[2], fy, fu, fv, maxValue);
+        if (bInterleaved)
+        {
+            vst3_u8(row.pR + x * 3, rgb);
+        }
+        else
+        {
+            vst1_u8(row.pR + x, rgb.val[0]);
+            vst1_u8(row.pG + x, rgb.val[1]);
+            vst1_u8(row.pB + x, rgb.val[2]);
+        }
+    }
+    return x;
+}
+
+#endif
+
+HostSimdLevel DetectHostSimdLevel()
+{
+#if defined(CS_HOST_X86)
+#if defined(_MSC_VER) && !defined(__clang__)
+    int info[4] = {};
+    __cpuid(info, 0);
+    int nIds = info[0];
+    __cpuid(info, 1);
+    bool bSse41 = (info[2] & (1 << 19)) != 0;
+    bool bAvx = (info[2] & (1 << 28)) != 0 && (info[2] & (1 << 27)) != 0 && (_xgetbv(0) & 6) == 6;
+    bool bAvx2 = false;
+    if (nIds >= 7 && bAvx)
+    {
+        __cpuidex(info, 7, 0);
+        bAvx2 = (info[1] & (1 << 5)) != 0;
+    }
+#else
+    __builtin_cpu_init();
+    bool bSse41 = __builtin_cpu_supports("sse4.1") != 0;
+    bool bAvx2 = __builtin_cpu_supports("avx2") != 0;
+#endif
+    return bAvx2 ? HostSimdLevel::AVX2 : (bSse41 ? HostSimdLevel::SSE41 : HostSimdLevel::SCALAR);
+#elif defined(CS_HOST_NEON)
+    return HostSimdLevel::NEON;
+#else
+    return HostSimdLevel::SCALAR;
+#endif
+}
+
+std::atomic<int> g_nMaxHostSimdLevel((int)HostSimdLevel::NEON);
+
+typedef int (*ConvertRowSimdFn)(const RowParams &row, const PostProcessColorMatrix &m);
+
+ConvertRowSimdFn GetConvertRowSimd()
+{
+    switch (GetHostSimdLevel())
+    {
+#if defined(CS_HOST_X86)
+    case HostSimdLevel::AVX2:
+        return ConvertRowAvx2;
+    case HostSimdLevel::SSE41:
+        return ConvertRowSse41;
+#endif
+#if defined(CS_HOST_NEON)
+    case HostSimdLevel::NEON:
+        return ConvertRowNeon;
+#endif
+    default:
+        return nullptr;
+    }
+}
+
+// Converts nRows rows. Chroma rows start nChromaRow rows after the luma plane, as in the device kernels.
+// Planar output planes are nRows rows apart.
+void ConvertFrame(const uint8_t *pSrc, int nSrcPitch, int nBytesPerSample, PostProcessChroma eChroma, int nChromaRow,
+                  uint8_t *pDst, int nDstPitch, bool bPlanar, int nWidth, int nRows, int iMatrix)
+{
+    PostProcessColorMatrix m = GetPostProcessColorMatrix(iMatrix, nBytesPerSample);
+    ConvertRowSimdFn fnConvertRowSimd = nBytesPerSample == 1 ? GetConvertRowSimd() : nullptr;
+    size_t nPlaneSize = (size_t)nDstPitch * nRows;
+    for (int y = 0; y < nRows; y++)
+    {
+        RowParams row;
+        row.pY = pSrc + (size_t)y * nSrcPitch;
+        switch (eChroma)
+        {
+        case PostProcessChroma::YUV444:
+            row.pU = pSrc + (size_t)(nChromaRow + y) * nSrcPitch;
+            row.pV = pSrc + (size_t)(2 * nChromaRow + y) * nSrcPitch;
+            break;
+        default:
+            row.pU = pSrc + (size_t)(nChromaRow + (eChroma == PostProcessChroma::YUV420 ? y / 2 : y)) * nSrcPitch;
+            row.pV = row.pU + nBytesPerSample;
+            row.nChromaStep = 2;
+            row.nChromaShift = 1;
+            break;
+        }
+        uint8_t *pRow = pDst + (size_t)y * nDstPitch;
+        row.pR = pRow;
+        row.pG = bPlanar ? pRow + nPlaneSize : pRow + 1;
+        row.pB = bPlanar ? pRow + 2 * nPlaneSize : pRow + 2;
+        row.nDstStep = bPlanar ? 1 : 3;
+        row.nWidth = nWidth;
+
+        int x = fnConvertRowSimd ? fnConvertRowSimd(row, m) : 0;
+        if (nBytesPerSample == 2)
+        {
+            ConvertRowScalar<uint16_t>(row, m, x);
+        }
+        else
+        {
+            ConvertRowScalar<uint8_t>(row, m, x);
+        }
+    }
+}
+
+} // namespace
+
+HostSimdLevel GetHostSimdLevel()
+{
+    static const HostSimdLevel eDetected = DetectHostSimdLevel();
+    HostSimdLevel eMax = (HostSimdLevel)g_nMaxHostSimdLevel.load();
+    if (eMax >= eDetected)
+    {
+        return eDetected;
+    }
+    // NEON is the only level on ARM, x86 levels are ordered
+    return eDetected == HostSimdLevel::NEON ? HostSimdLevel::SCALAR : eMax;
+}
+
+void SetHostSimdLevel(HostSimdLevel eLevel)
+{
+    g_nMaxHostSimdLevel.store((int)eLevel);
+}
+
+void Nv12ToColor24Host(const uint8_t *pNv12, int nNv12Pitch, uint8_t *pRGB, int nRGBPitch, int nWidth, int nHeight, int iMatrix)
+{
+    ConvertFrame(pNv12, nNv12Pitch, 1, PostProcessChroma::YUV420, nHeight, pRGB, nRGBPitch, false, nWidth, nHeight, iMatrix);
+}
+
+void Nv12ToColor24PlanarHost(const uint8_t *pNv12, int nNv12Pitch, uint8_t *pRGBP, int nRGBPPitch, int nWidth, int nHeight, int nDstHeight, int iMatrix)
+{
+    ConvertFrame(pNv12, nNv12Pitch, 1, PostProcessChroma::YUV420, nHeight, pRGBP, nRGBPPitch, true, nWidth, nDstHeight ? nDstHeight : nHeight, iMatrix);
+}
+
+void P016ToColor24Host(const uint8_t *pP016, int nP016Pitch, uint8_t *pRGB, int nRGBPitch, int nWidth, int nHeight, int iMatrix)
+{
+    ConvertFrame(pP016, nP016Pitch, 2, PostProcessChroma::YUV420, nHeight, pRGB, nRGBPitch, false, nWidth, nHeight, iMatrix);
+}
+
+void P016ToColor24PlanarHost(const uint8_t *pP016, int nP016Pitch, uint8_t *pRGBP, int nRGBPPitch, int nWidth, int nHeight, int nDstHeight, int iMatrix)
+{
+    ConvertFrame(pP016, nP016Pitch, 2, PostProcessChroma::YUV420, nHeight, pRGBP, nRGBPPitch, true, nWidth, nDstHeight ? nDstHeight : nHeight, iMatrix);
+}
+
+void YUV444ToColor24Host(const uint8_t *pYUV444, int nPitch, uint8_t *pRGB, int nRGBPitch, int nWidth, int nHeight, int iMatrix)
+{
+    ConvertFrame(pYUV444, nPitch, 1, PostProcessChroma::YUV444, nHeight, pRGB, nRGBPitch, false, nWidth, nHeight, iMatrix);
+}
+
+void YUV444ToColor24PlanarHost(const uint8_t *pYUV444, int nPitch, uint8_t *pRGBP, int nRGBPPitch, int nWidth, int nHeight, int nDstHeight, int iMatrix)
+{
+    ConvertFrame(pYUV444, nPitch, 1, PostProcessChroma::YUV444, nHeight, pRGBP, nRGBPPitch, true, nWidth, nDstHeight ? nDstHeight : nHeight, iMatrix);
+}
+
+void YUV444P16ToColor24Host(const uint8_t *pYUV444, int nPitch, uint8_t *pRGB, int nRGBPitch, int nWidth, int nHeight, int iMatrix)
+{
+    ConvertFrame(pYUV444, nPitch, 2, PostProcessChroma::YUV444, nHeight, pRGB, nRGBPitch, false, nWidth, nHeight, iMatrix);
+}
+
+void YUV444P16ToColor24PlanarHost(const uint8_t *pYUV444, int nPitch, uint8_t *pRGBP, int nRGBPPitch, int nWidth, int nHeight, int nDstHeight, int iMatrix)
+{
+    ConvertFrame(pYUV444, nPitch, 2, PostProcessChroma::YUV444, nHeight, pRGBP, nRGBPPitch, true, nWidth, nDstHeight ? nDstHeight : nHeight, iMatrix);
+}
+
+void Nv16ToColor24Host(const uint8_t *pNv16, int nNv16Pitch, uint8_t *pRGB, int nRGBPitch, int nWidth, int nSurfaceHeight, int nHeight, int iMatrix)
+{
+    ConvertFrame(pNv16, nNv16Pitch, 1, PostProcessChroma::YUV422, nSurfaceHeight, pRGB, nRGBPitch, false, nWidth, nHeight, iMatrix);
+}
+
+void Nv16ToColor24PlanarHost(const uint8_t *pNv16, int nNv16Pitch, uint8_t *pRGBP, int nRGBPPitch, int nWidth, int nHeight, int nDstHeight, int iMatrix)
+{
+    ConvertFrame(pNv16, nNv16Pitch, 1, PostProcessChroma::YUV422, nHeight, pRGBP, nRGBPPitch, true, nWidth, nDstHeight ? nDstHeight : nHeight, iMatrix);
+}
+
+void P216ToColor24Host(const uint8_t *pP216, int nP216Pitch, uint8_t *pRGB, int nRGBPitch, int nWidth, int nSurfaceHeight, int nHeight, int iMatrix)
+{
+    ConvertFrame(pP216, nP216Pitch, 2, PostProcessChroma::YUV422, nSurfaceHeight, pRGB, nRGBPitch, false, nWidth, nHeight, iMatrix);
+}
+
+void P216ToColor24PlanarHost(const uint8_t *pP216, int nP216Pitch, uint8_t *pRGBP, int nRGBPPitch, int nWidth, int nHeight, int nDstHeight, int iMatrix)
+{
+    ConvertFrame(pP216, nP216Pitch, 2, PostProcessChroma::YUV422, nHeight, pRGBP, nRGBPPitch, true, nWidth, nDstHeight ? nDstHeight : nHeight, iMatrix);
+}
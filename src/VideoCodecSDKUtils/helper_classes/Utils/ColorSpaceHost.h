@@ -0,0 +1,66 @@
+/*
+ * This copyright notice applies to this file only
+ *
+ * SPDX-FileCopyrightText: Copyright (c) 2010-2025 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#pragma once
+#include <stdint.h>
+
+/**
+* @brief Instruction set used by the host color space conversions.
+*/
+enum class HostSimdLevel
+{
+    SCALAR,
+    SSE41,
+    AVX2,
+    NEON,
+};
+
+/**
+*   @brief  Returns the instruction set the host conversions run with: the best one supported by the CPU,
+*   limited by SetHostSimdLevel().
+*/
+HostSimdLevel GetHostSimdLevel();
+
+/**
+*   @brief  Limits the instruction set used by the host conversions, e.g. to compare SIMD paths against SCALAR.
+*   Levels not supported by the CPU fall back to the best supported one below them.
+*/
+void SetHostSimdLevel(HostSimdLevel eLevel);
+
+// Host counterparts of the CUDA conversions in ColorSpace.cu. Arguments have the same meaning as for the
+// device functions; the output is RGB24, interleaved or planar, and uses the matrices of SetMatYuv2Rgb().
+// 8 bit formats are vectorized, 16 bit formats use the scalar path.
+void Nv12ToColor24Host(const uint8_t *pNv12, int nNv12Pitch, uint8_t *pRGB, int nRGBPitch, int nWidth, int nHeight, int iMatrix = 0);
+void Nv12ToColor24PlanarHost(const uint8_t *pNv12, int nNv12Pitch, uint8_t *pRGBP, int nRGBPPitch, int nWidth, int nHeight, int nDstHeight, int iMatrix = 0);
+void P016ToColor24Host(const uint8_t *pP016, int nP016Pitch, uint8_t *pRGB, int nRGBPitch, int nWidth, int nHeight, int iMatrix = 4);
+void P016ToColor24PlanarHost(const uint8_t *pP016, int nP016Pitch, uint8_t *pRGBP, int nRGBPPitch, int nWidth, int nHeight, int nDstHeight, int iMatrix = 4);
+void YUV444ToColor24Host(const uint8_t *pYUV444, int nPitch, uint8_t *pRGB, int nRGBPitch, int nWidth, int nHeight, int iMatrix = 0);
+void YUV444ToColor24PlanarHost(const uint8_t *pYUV444, int nPitch, uint8_t *pRGBP, int nRGBPPitch, int nWidth, int nHeight, int nDstHeight, int iMatrix = 0);
+void YUV444P16ToColor24Host(const uint8_t *pYUV444, int nPitch, uint8_t *pRGB, int nRGBPitch, int nWidth, int nHeight, int iMatrix = 4);
+void YUV444P16ToColor24PlanarHost(const uint8_t *pYUV444, int nPitch, uint8_t *pRGBP, int nRGBPPitch, int nWidth, int nHeight, int nDstHeight, int iMatrix = 4);
+void Nv16ToColor24Host(const uint8_t *pNv16, int nNv16Pitch, uint8_t *pRGB, int nRGBPitch, int nWidth, int nSurfaceHeight, int nHeight, int iMatrix = 0);
+void Nv16ToColor24PlanarHost(const uint8_t *pNv16, int nNv16Pitch, uint8_t *pRGBP, int nRGBPPitch, int nWidth, int nHeight, int nDstHeight, int iMatrix = 0);
+void P216ToColor24Host(const uint8_t *pP216, int nP216Pitch, uint8_t *pRGB, int nRGBPitch, int nWidth, int nSurfaceHeight, int nHeight, int iMatrix = 4);
+void P216ToColor24PlanarHost(const uint8_t *pP216, int nP216Pitch, uint8_t *pRGBP, int nRGBPPitch, int nWidth, int nHeight, int nDstHeight, int iMatrix = 4);
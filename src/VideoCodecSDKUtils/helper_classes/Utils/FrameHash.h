@@ -0,0 +1,158 @@
+/*
+ * This copyright notice applies to this file only
+ *
+ * SPDX-FileCopyrightText: Copyright (c) 2025 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+#if defined(__CUDACC__)
+#define FH_HOST_DEVICE __host__ __device__
+#else
+#define FH_HOST_DEVICE
+#endif
+
+/**
+* @brief A plane of a frame to hash. Only the first nRowBytes of each row contribute: the hash is defined on the
+* packed bytes of the planes in order, so it does not depend on the pitch and matches the hash of a contiguous copy
+* of the frame, e.g. a numpy array.
+*/
+struct FrameHashPlane
+{
+    const uint8_t* pData = nullptr;
+    size_t nPitch = 0;
+    size_t nRowBytes = 0;
+    int nRows = 0;
+};
+
+/**
+* @brief Destination of a plane copied by CopyFrameWithHash(). The copy has the rows and row size of the source plane.
+*/
+struct FrameHashCopyPlane
+{
+    uint8_t* pData = nullptr;
+    size_t nPitch = 0;
+};
+
+/**
+* @brief Maximum number of planes hashed together.
+*/
+const int FrameHashMaxPlanes = 3;
+
+/**
+*   @brief  splitmix64 finalizer
+*/
+FH_HOST_DEVICE inline uint64_t FrameHashMix(uint64_t x)
+{
+    x ^= x >> 30;
+    x *= 0xbf58476d1ce4e5b9ULL;
+    x ^= x >> 27;
+    x *= 0x94d049bb133111ebULL;
+    x ^= x >> 31;
+    return x;
+}
+
+/**
+*   @brief  Contribution of the little endian word iWord, i.e. bytes 8 * iWord to 8 * iWord + 7 of the packed frame,
+*   with the last word zero padded. The frame hash is the sum of all contributions, so words can be hashed in any order
+*   and reduced in parallel, while the position key keeps the hash sensitive to moved content.
+*/
+FH_HOST_DEVICE inline uint64_t FrameHashWord(uint64_t iWord, uint64_t word)
+{
+    return FrameHashMix(word ^ ((iWord + 1) * 0x9e3779b97f4a7c15ULL));
+}
+
+/**
+*   @brief  Final hash from the sum of the word contributions and the number of bytes hashed
+*/
+FH_HOST_DEVICE inline uint64_t FrameHashFinalize(uint64_t sum, uint64_t nBytes)
+{
+    return FrameHashMix(sum ^ FrameHashMix(nBytes));
+}
+
+/**
+*   @brief  Returns the number of bytes hashed for a set of planes
+*/
+inline uint64_t GetFrameHashSize(const FrameHashPlane* pPlanes, int nPlanes)
+{
+    uint64_t nBytes = 0;
+    for (int i = 0; i < nPlanes; i++)
+    {
+        nBytes += (uint64_t)pPlanes[i].nRowBytes * pPlanes[i].nRows;
+    }
+    return nBytes;
+}
+
+/**
+*   @brief  Host implementation of the frame hash of a contiguous buffer, matching ComputeFrameHash() bit for bit.
+*/
+inline uint64_t ComputeFrameHashHost(const uint8_t* pData, uint64_t nBytes)
+{
+    uint64_t sum = 0;
+    for (uint64_t x = 0; x < nBytes; x += 8)
+    {
+        uint64_t word = 0;
+        uint64_t n = nBytes - x < 8 ? nBytes - x : 8;
+        for (uint64_t i = 0; i < n; i++)
+        {
+            word |= (uint64_t)pData[x + i] << (8 * i);
+        }
+        sum += FrameHashWord(x / 8, word);
+    }
+    return FrameHashFinalize(sum, nBytes);
+}
+
+/**
+*   @brief  Host implementation of the frame hash of pitched planes in host memory, matching ComputeFrameHash() bit for bit.
+*/
+inline uint64_t ComputeFrameHashHost(const FrameHashPlane* pPlanes, int nPlanes)
+{
+    std::vector<uint8_t> vPacked;
+    vPacked.reserve(GetFrameHashSize(pPlanes, nPlanes));
+    for (int iPlane = 0; iPlane < nPlanes; iPlane++)
+    {
+        for (int iRow = 0; iRow < pPlanes[iPlane].nRows; iRow++)
+        {
+            const uint8_t* pRow = pPlanes[iPlane].pData + (size_t)iRow * pPlanes[iPlane].nPitch;
+            vPacked.insert(vPacked.end(), pRow, pRow + pPlanes[iPlane].nRowBytes);
+        }
+    }
+    return ComputeFrameHashHost(vPacked.data(), vPacked.size());
+}
+
+struct CUstream_st;
+
+/**
+*   @brief  Computes the 64 bit hash of up to FrameHashMaxPlanes planes in device memory on a stream and stores it to dpHash,
+*   a device pointer to 8 bytes. Matches ComputeFrameHashHost().
+*/
+void ComputeFrameHash(const FrameHashPlane* pPlanes, int nPlanes, uint64_t* dpHash, CUstream_st* stream);
+
+/**
+*   @brief  Copies up to FrameHashMaxPlanes planes in device memory to pDstPlanes and computes the hash of ComputeFrameHash()
+*   in the same pass, so the source is read once. Stores the hash to dpHash, a device pointer to 8 bytes.
+*/
+void CopyFrameWithHash(const FrameHashPlane* pPlanes, const FrameHashCopyPlane* pDstPlanes, int nPlanes, uint64_t* dpHash, CUstream_st* stream);
@@ -48,6 +48,8 @@
 #ifndef DEMUX_ONLY
 #include <cuda.h>
 #endif
+#include "YuvConverter.h"
+#include "BitDepth.h"
 
 extern simplelogger::Logger *logger;
 
@@ -345,79 +347,6 @@ private:
     uint64_t nSize = 0;
 };
 
-/**
-* @brief Template class to facilitate color space conversion
-*/
-template<typename T>
-class YuvConverter {
-public:
-    YuvConverter(int nWidth, int nHeight) : nWidth(nWidth), nHeight(nHeight) {
-        pQuad = new T[((nWidth + 1) / 2) * ((nHeight + 1) / 2)];
-    }
-    ~YuvConverter() {
-        delete[] pQuad;
-    }
-    void PlanarToUVInterleaved(T *pFrame, int nPitch = 0) {
-        if (nPitch == 0) {
-            nPitch = nWidth;
-        }
-
-        // sizes of source surface plane
-        int nSizePlaneY = nPitch * nHeight;
-        int nSizePlaneU = ((nPitch + 1) / 2) * ((nHeight + 1) / 2);
-        int nSizePlaneV = nSizePlaneU;
-
-        T *puv = pFrame + nSizePlaneY;
-        if (nPitch == nWidth) {
-            memcpy(pQuad, puv, nSizePlaneU * sizeof(T));
-        } else {
-            for (int i = 0; i < (nHeight + 1) / 2; i++) {
-                memcpy(pQuad + ((nWidth + 1) / 2) * i, puv + ((nPitch + 1) / 2) * i, ((nWidth + 1) / 2) * sizeof(T));
-            }
-        }
-        T *pv = puv + nSizePlaneU;
-        for (int y = 0; y < (nHeight + 1) / 2; y++) {
-            for (int x = 0; x < (nWidth + 1) / 2; x++) {
-                puv[y * nPitch + x * 2] = pQuad[y * ((nWidth + 1) / 2) + x];
-                puv[y * nPitch + x * 2 + 1] = pv[y * ((nPitch + 1) / 2) + x];
-            }
-        }
-    }
-    void UVInterleavedToPlanar(T *pFrame, int nPitch = 0) {
-        if (nPitch == 0) {
-            nPitch = nWidth;
-        }
-
-        // sizes of source surface plane
-        int nSizePlaneY = nPitch * nHeight;
-        int nSizePlaneU = ((nPitch + 1) / 2) * ((nHeight + 1) / 2);
-        int nSizePlaneV = nSizePlaneU;
-
-        T *puv = pFrame + nSizePlaneY,
-            *pu = puv, 
-            *pv = puv + nSizePlaneU;
-
-        // split chroma from interleave to planar
-        for (int y = 0; y < (nHeight + 1) / 2; y++) {
-            for (int x = 0; x < (nWidth + 1) / 2; x++) {
-                pu[y * ((nPitch + 1) / 2) + x] = puv[y * nPitch + x * 2];
-                pQuad[y * ((nWidth + 1) / 2) + x] = puv[y * nPitch + x * 2 + 1];
-            }
-        }
-        if (nPitch == nWidth) {
-            memcpy(pv, pQuad, nSizePlaneV * sizeof(T));
-        } else {
-            for (int i = 0; i < (nHeight + 1) / 2; i++) {
-                memcpy(pv + ((nPitch + 1) / 2) * i, pQuad + ((nWidth + 1) / 2) * i, ((nWidth + 1) / 2) * sizeof(T));
-            }
-        }
-    }
-
-private:
-    T *pQuad;
-    int nWidth, nHeight;
-};
-
 /**
 * @brief Class for writing IVF format header for AV1 codec
 */
@@ -0,0 +1,742 @@
+/*
+ * This copyright notice applies to this file only
+ *
+ * SPDX-FileCopyrightText: Copyright (c) 2010-2025 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#pragma once
+#include <math.h>
+#include <stdint.h>
+#include <string.h>
+
+// Per-pixel functions are shared by the CUDA kernel and the host reference implementation
+#if defined(__CUDACC__)
+#define PP_HOST_DEVICE __host__ __device__
+#else
+#define PP_HOST_DEVICE
+#endif
+
+/**
+* @brief Interpolation used when the region of interest is resized to the target size.
+*/
+enum class PostProcessInterpolation
+{
+    NEAREST,
+    BILINEAR,
+};
+
+/**
+* @brief Element type of the post-processed output.
+*/
+enum class PostProcessDataType
+{
+    UINT8,
+    FLOAT16,
+    FLOAT32,
+};
+
+/**
+* @brief Memory layout of the post-processed output.
+*/
+enum class PostProcessLayout
+{
+    HWC, // interleaved RGB
+    CHW, // planar RGB
+};
+
+/**
+* @brief Chroma layout of the YUV source frame.
+*/
+enum class PostProcessChroma
+{
+    YUV420, // semi-planar, e.g. NV12, P016
+    YUV422, // semi-planar, e.g. NV16, P216
+    YUV444, // planar
+};
+
+/**
+* @brief Quantization range of the YUV samples.
+*/
+enum class PostProcessColorRange
+{
+    AUTO,    // as signalled in the stream
+    LIMITED, // e.g. 16-235 for 8 bit luma
+    FULL,    // e.g. 0-255 for 8 bit luma
+};
+
+/**
+* @brief Transfer characteristics of the YUV samples.
+*/
+enum class PostProcessTransfer
+{
+    AUTO, // as signalled in the stream
+    SDR,  // BT.709/BT.601 gamma, converted as is
+    PQ,   // SMPTE ST 2084
+    HLG,  // ARIB STD-B67
+};
+
+/**
+* @brief Color description used by the YUV to RGB conversion. Fields left at 0/AUTO are taken from the stream.
+* With bToneMap, PQ and HLG frames are tone mapped to SDR BT.709 using the BT.2390 EETF on luminance.
+*/
+struct PostProcessColorimetry
+{
+    int iMatrix = 0; // ColorSpaceStandard, 0 selects the matrix signalled in the stream
+    PostProcessColorRange eRange = PostProcessColorRange::AUTO;
+    PostProcessTransfer eTransfer = PostProcessTransfer::AUTO;
+    bool bToneMap = false;
+    float peakLuminance = 0.0f;     // cd/m2 of the brightest source pixel, 0 uses the HDR SEI metadata or 1000
+    float targetLuminance = 100.0f; // cd/m2 of SDR white
+
+    /**
+    *   @brief  Returns true if frames described by this resolved colorimetry need the full conversion path
+    *   rather than the fixed limited range kernels.
+    */
+    bool NeedsFullConversion() const
+    {
+        return eRange == PostProcessColorRange::FULL || (bToneMap && (eTransfer == PostProcessTransfer::PQ || eTransfer == PostProcessTransfer::HLG));
+    }
+};
+
+/**
+* @brief Region of the decoded frame fed to the post-processing. A zero width or height selects the full frame.
+*/
+struct PostProcessRoi
+{
+    int x = 0;
+    int y = 0;
+    int width = 0;
+    int height = 0;
+};
+
+/**
+* @brief Descriptor of the transform fused with the YUV to RGB conversion:
+* crop to roi, resize to nWidth x nHeight, then out = (rgb * scale - mean) / std per channel,
+* where rgb is in [0, 255]. The result is cast to eDataType and stored packed in eLayout.
+*/
+struct PostProcessParams
+{
+    int nWidth = 0;  // target width, 0 keeps the roi width
+    int nHeight = 0; // target height, 0 keeps the roi height
+    PostProcessRoi roi;
+    PostProcessInterpolation eInterpolation = PostProcessInterpolation::BILINEAR;
+    float scale = 1.0f;
+    float mean[3] = { 0.0f, 0.0f, 0.0f };
+    float std[3] = { 1.0f, 1.0f, 1.0f };
+    PostProcessDataType eDataType = PostProcessDataType::UINT8;
+    PostProcessLayout eLayout = PostProcessLayout::HWC;
+
+    /**
+    *   @brief  Returns true if the transform is a plain color conversion at native resolution.
+    */
+    bool IsIdentity() const
+    {
+        return nWidth == 0 && nHeight == 0 && roi.width == 0 && roi.height == 0 && roi.x == 0 && roi.y == 0
+            && scale == 1.0f && mean[0] == 0.0f && mean[1] == 0.0f && mean[2] == 0.0f
+            && std[0] == 1.0f && std[1] == 1.0f && std[2] == 1.0f && eDataType == PostProcessDataType::UINT8;
+    }
+};
+
+/**
+* @brief YUV source frame. Chroma planes start at nChromaRow rows after the luma plane; samples are 1 or 2 bytes.
+*/
+struct PostProcessSource
+{
+    const uint8_t* pFrame = nullptr;
+    int nPitch = 0;
+    int nWidth = 0;
+    int nHeight = 0;
+    int nChromaRow = 0;
+    int nBytesPerSample = 1;
+    PostProcessChroma eChroma = PostProcessChroma::YUV420;
+};
+
+/**
+* @brief YUV to RGB matrix in normalized sample units, matching SetMatYuv2Rgb() in ColorSpace.cu.
+*/
+struct PostProcessColorMatrix
+{
+    float mat[3][3];
+    float low;  // luma black level
+    float mid;  // chroma zero level
+    float maxValue;
+    PostProcessTransfer eToneMap; // SDR when no tone mapping is applied
+    float peakLuminance;          // cd/m2
+    float targetLuminance;        // cd/m2
+    float peakPq;                 // PQ code value of peakLuminance
+    float targetPq;               // PQ code value of targetLuminance
+};
+
+inline int GetPostProcessElementSize(PostProcessDataType eDataType)
+{
+    return eDataType == PostProcessDataType::FLOAT32 ? 4 : (eDataType == PostProcessDataType::FLOAT16 ? 2 : 1);
+}
+
+/**
+*   @brief  Fills in the roi and target size left at 0 for a frame of nWidth x nHeight.
+*   Returns false if the roi does not fit in the frame.
+*/
+inline bool ResolvePostProcessParams(const PostProcessParams& params, int nWidth, int nHeight, PostProcessParams* pResolved)
+{
+    *pResolved = params;
+    PostProcessRoi& roi = pResolved->roi;
+    if (roi.width == 0 || roi.height == 0)
+    {
+        roi.x = roi.y = 0;
+        roi.width = nWidth;
+        roi.height = nHeight;
+    }
+    if (pResolved->nWidth == 0 || pResolved->nHeight == 0)
+    {
+        pResolved->nWidth = roi.width;
+        pResolved->nHeight = roi.height;
+    }
+    return roi.x >= 0 && roi.y >= 0 && roi.width > 0 && roi.height > 0
+        && roi.x + roi.width <= nWidth && roi.y + roi.height <= nHeight;
+}
+
+/**
+*   @brief  SMPTE ST 2084 EOTF. Converts a PQ code value in [0, 1] to cd/m2.
+*/
+PP_HOST_DEVICE inline float PostProcessPqToLinear(float e)
+{
+    const float m1 = 0.1593017578125f, m2 = 78.84375f, c1 = 0.8359375f, c2 = 18.8515625f, c3 = 18.6875f;
+    float p = powf(e < 0.0f ? 0.0f : e, 1.0f / m2);
+    float num = p - c1;
+    return 10000.0f * powf((num < 0.0f ? 0.0f : num) / (c2 - c3 * p), 1.0f / m1);
+}
+
+/**
+*   @brief  Inverse of PostProcessPqToLinear().
+*/
+PP_HOST_DEVICE inline float PostProcessLinearToPq(float nits)
+{
+    const float m1 = 0.1593017578125f, m2 = 78.84375f, c1 = 0.8359375f, c2 = 18.8515625f, c3 = 18.6875f;
+    float y = powf((nits < 0.0f ? 0.0f : nits) / 10000.0f, m1);
+    return powf((c1 + c2 * y) / (1.0f + c3 * y), m2);
+}
+
+/**
+*   @brief  Resolves the colorimetry fields left at 0/AUTO from the values signalled in the stream.
+*   @param  iStreamMatrix - matrix_coefficients of the video signal description
+*   @param  bStreamFullRange - video_full_range_flag of the video signal description
+*   @param  iStreamTransfer - transfer_characteristics of the video signal description
+*   @param  streamPeakLuminance - peak luminance from the HDR SEI metadata, 0 if not present
+*/
+inline PostProcessColorimetry ResolvePostProcessColorimetry(const PostProcessColorimetry& colorimetry, int iStreamMatrix,
+    bool bStreamFullRange, int iStreamTransfer, float streamPeakLuminance)
+{
+    PostProcessColorimetry resolved = colorimetry;
+    if (resolved.iMatrix == 0)
+    {
+        resolved.iMatrix = iStreamMatrix;
+    }
+    if (resolved.eRange == PostProcessColorRange::AUTO)
+    {
+        resolved.eRange = bStreamFullRange ? PostProcessColorRange::FULL : PostProcessColorRange::LIMITED;
+    }
+    if (resolved.eTransfer == PostProcessTransfer::AUTO)
+    {
+        // transfer_characteristics 16 is SMPTE ST 2084, 18 is ARIB STD-B67
+        resolved.eTransfer = iStreamTransfer == 16 ? PostProcessTransfer::PQ : (iStreamTransfer == 18 ? PostProcessTransfer::HLG : PostProcessTransfer::SDR);
+    }
+    if (resolved.peakLuminance <= 0.0f)
+    {
+        resolved.peakLuminance = streamPeakLuminance > 0.0f ? streamPeakLuminance : 1000.0f;
+    }
+    if (resolved.targetLuminance <= 0.0f)
+    {
+        resolved.targetLuminance = 100.0f;
+    }
+    return resolved;
+}
+
+/**
+*   @brief  Returns the conversion constants for a resolved colorimetry.
+*/
+inline PostProcessColorMatrix GetPostProcessColorMatrix(const PostProcessColorimetry& colorimetry, int nBytesPerSample)
+{
+    int iMatrix = colorimetry.iMatrix;
+    bool bFullRange = colorimetry.eRange == PostProcessColorRange::FULL;
+    float wr = 0.2126f, wb = 0.0722f;
+    float black = 16.0f, white = 235.0f, maxValue = 255.0f;
+    switch (iMatrix)
+    {
+    case 4: // FCC
+        wr = 0.30f; wb = 0.11f;
+        break;
+    case 5: // BT470
+    case 6: // BT601
+        wr = 0.2990f; wb = 0.1140f;
+        break;
+    case 7: // SMPTE240M
+        wr = 0.212f; wb = 0.087f;
+        break;
+    case 9: // BT2020
+    case 10: // BT2020C
+        wr = 0.2627f; wb = 0.0593f;
+        black = 64.0f * 64; white = 940.0f * 64; maxValue = 65535.0f;
+        break;
+    default: // BT709
+        break;
+    }
+    float base[3][3] = {
+        { 1.0f, 0.0f, (1.0f - wr) / 0.5f },
+        { 1.0f, -wb * (1.0f - wb) / 0.5f / (1 - wb - wr), -wr * (1 - wr) / 0.5f / (1 - wb - wr) },
+        { 1.0f, (1.0f - wb) / 0.5f, 0.0f },
+    };
+    PostProcessColorMatrix m;
+    for (int i = 0; i < 3; i++)
+    {
+        for (int j = 0; j < 3; j++)
+        {
+            m.mat[i][j] = bFullRange ? base[i][j] : (float)(1.0 * maxValue / (white - black) * base[i][j]);
+        }
+    }
+    int nBits = nBytesPerSample * 8;
+    m.low = bFullRange ? 0.0f : (float)(1 << (nBits - 4));
+    m.mid = (float)(1 << (nBits - 1));
+    m.maxValue = (float)((1 << nBits) - 1);
+    bool bHdr = colorimetry.eTransfer == PostProcessTransfer::PQ || colorimetry.eTransfer == PostProcessTransfer::HLG;
+    m.eToneMap = colorimetry.bToneMap && bHdr ? colorimetry.eTransfer : PostProcessTransfer::SDR;
+    m.peakLuminance = colorimetry.peakLuminance > 0.0f ? colorimetry.peakLuminance : 1000.0f;
+    m.targetLuminance = colorimetry.targetLuminance > 0.0f ? colorimetry.targetLuminance : 100.0f;
+    m.peakPq = PostProcessLinearToPq(m.peakLuminance);
+    m.targetPq = PostProcessLinearToPq(m.targetLuminance);
+    return m;
+}
+
+/**
+*   @brief  Returns the limited range SDR conversion constants of a matrix, as used by SetMatYuv2Rgb().
+*/
+inline PostProcessColorMatrix GetPostProcessColorMatrix(int iMatrix, int nBytesPerSample)
+{
+    PostProcessColorimetry colorimetry;
+    colorimetry.iMatrix = iMatrix;
+    colorimetry.eRange = PostProcessColorRange::LIMITED;
+    colorimetry.eTransfer = PostProcessTransfer::SDR;
+    return GetPostProcessColorMatrix(colorimetry, nBytesPerSample);
+}
+
+/**
+*   @brief  Tone maps one BT.2020 PQ or HLG pixel to SDR BT.709. rgb holds nonlinear values in [0, 1] and
+*   receives BT.1886 (gamma 2.4) encoded values in [0, 1].
+*/
+PP_HOST_DEVICE inline void PostProcessToneMap(float rgb[3], const PostProcessColorMatrix& m)
+{
+    float lin[3];
+    if (m.eToneMap == PostProcessTransfer::PQ)
+    {
+        for (int c = 0; c < 3; c++)
+        {
+            lin[c] = PostProcessPqToLinear(rgb[c]);
+        }
+    }
+    else
+    {
+        // HLG inverse OETF, then the BT.2100 OOTF for a display of peakLuminance
+        const float a = 0.17883277f, b = 0.28466892f, c0 = 0.55991073f;
+        for (int c = 0; c < 3; c++)
+        {
+            float e = rgb[c];
+            lin[c] = e <= 0.5f ? e * e / 3.0f : (expf((e - c0) / a) + b) / 12.0f;
+        }
+        float gamma = 1.2f + 0.42f * log10f(m.peakLuminance / 1000.0f);
+        float ys = 0.2627f * lin[0] + 0.6780f * lin[1] + 0.0593f * lin[2];
+        float ootf = ys > 0.0f ? m.peakLuminance * powf(ys, gamma - 1.0f) : 0.0f;
+        for (int c = 0; c < 3; c++)
+        {
+            lin[c] *= ootf;
+        }
+    }
+
+    // BT.2390 EETF applied to luminance in the PQ domain, which keeps the hue
+    float y = 0.2627f * lin[0] + 0.6780f * lin[1] + 0.0593f * lin[2];
+    float scale = 0.0f;
+    if (y > 0.0f)
+    {
+        float e1 = PostProcessLinearToPq(y) / m.peakPq;
+        e1 = e1 > 1.0f ? 1.0f : e1;
+        float maxLum = m.targetPq / m.peakPq;
+        float ks = 1.5f * maxLum - 0.5f;
+        float e2 = e1;
+        if (e1 > ks && ks < 1.0f)
+        {
+            float t = (e1 - ks) / (1.0f - ks), t2 = t * t, t3 = t2 * t;
+            e2 = (2.0f * t3 - 3.0f * t2 + 1.0f) * ks + (t3 - 2.0f * t2 + t) * (1.0f - ks) + (-2.0f * t3 + 3.0f * t2) * maxLum;
+        }
+        scale = PostProcessPqToLinear(e2 * m.peakPq) / y / m.targetLuminance;
+    }
+
+    // BT.2020 to BT.709 primaries, then BT.1886 encoding
+    const float gamut[3][3] = {
+        { 1.6605f, -0.5876f, -0.0728f },
+        { -0.1246f, 1.1329f, -0.0083f },
+        { -0.0182f, -0.1006f, 1.1187f },
+    };
+    for (int c = 0; c < 3; c++)
+    {
+        float value = (gamut[c][0] * lin[0] + gamut[c][1] * lin[1] + gamut[c][2] * lin[2]) * scale;
+        value = value < 0.0f ? 0.0f : (value > 1.0f ? 1.0f : value);
+        rgb[c] = powf(value, 1.0f / 2.4f);
+    }
+}
+
+/**
+*   @brief  Converts a float to IEEE half precision bits, rounding to nearest even like __float2half_rn.
+*/
+PP_HOST_DEVICE inline uint16_t PostProcessFloatToHalf(float f)
+{
+    uint32_t x;
+    memcpy(&x, &f, sizeof(x));
+    uint32_t sign = (x >> 16) & 0x8000;
+    uint32_t absx = x & 0x7fffffff;
+    if (absx >= 0x7f800000)
+    {
+        // inf or nan
+        return (uint16_t)(sign | 0x7c00 | (absx > 0x7f800000 ? 0x200 : 0));
+    }
+    if (absx >= 0x477ff000)
+    {
+        // overflows to inf after rounding
+        return (uint16_t)(sign | 0x7c00);
+    }
+    if (absx < 0x38800000)
+    {
+        // subnormal or zero
+        if (absx < 0x33000000)
+        {
+            return (uint16_t)sign;
+        }
+        uint32_t shift = 126 - (absx >> 23);
+        uint32_t mant = (absx & 0x7fffff) | 0x800000;
+        uint32_t half = mant >> shift;
+        uint32_t rem = mant & ((1u << shift) - 1);
+        uint32_t halfway = 1u << (shift - 1);
+        if (rem > halfway || (rem == halfway && (half & 1)))
+        {
+            half++;
+        }
+        return (uint16_t)(sign | half);
+    }
+    uint32_t half = ((absx - 0x38000000) >> 13);
+    uint32_t rem = absx & 0x1fff;
+    if (rem > 0x1000 || (rem == 0x1000 && (half & 1)))
+    {
+        half++;
+    }
+    return (uint16_t)(sign | half);
+}
+
+PP_HOST_DEVICE inline float PostProcessLoadSample(const uint8_t* pRow, int x, int nBytesPerSample, int nComponents, int iComponent)
+{
+    int i = x * nComponents + iComponent;
+    return nBytesPerSample == 2 ? (float)((const uint16_t*)pRow)[i] : (float)pRow[i];
+}
+
+/**
+*   @brief  Samples one component of a plane at (fx, fy), in plane pixel coordinates. Edges are clamped.
+*/
+PP_HOST_DEVICE inline float PostProcessSamplePlane(const uint8_t* pPlane, int nPitch, int nWidth, int nHeight, int nBytesPerSample,
+    int nComponents, int iComponent, float fx, float fy, PostProcessInterpolation eInterpolation)
+{
+    if (eInterpolation == PostProcessInterpolation::NEAREST)
+    {
+        int x = (int)floorf(fx + 0.5f), y = (int)floorf(fy + 0.5f);
+        x = x < 0 ? 0 : (x >= nWidth ? nWidth - 1 : x);
+        y = y < 0 ? 0 : (y >= nHeight ? nHeight - 1 : y);
+        return PostProcessLoadSample(pPlane + (size_t)y * nPitch, x, nBytesPerSample, nComponents, iComponent);
+    }
+    fx = fx < 0.0f ? 0.0f : (fx > nWidth - 1 ? (float)(nWidth - 1) : fx);
+    fy = fy < 0.0f ? 0.0f : (fy > nHeight - 1 ? (float)(nHeight - 1) : fy);
+    int x0 = (int)fx, y0 = (int)fy;
+    int x1 = x0 + 1 < nWidth ? x0 + 1 : x0, y1 = y0 + 1 < nHeight ? y0 + 1 : y0;
+    float ax = fx - x0, ay = fy - y0;
+    const uint8_t* pRow0 = pPlane + (size_t)y0 * nPitch;
+    const uint8_t* pRow1 = pPlane + (size_t)y1 * nPitch;
+    float top = PostProcessLoadSample(pRow0, x0, nBytesPerSample, nComponents, iComponent) * (1.0f - ax)
+        + PostProcessLoadSample(pRow0, x1, nBytesPerSample, nComponents, iComponent) * ax;
+    float bottom = PostProcessLoadSample(pRow1, x0, nBytesPerSample, nComponents, iComponent) * (1.0f - ax)
+        + PostProcessLoadSample(pRow1, x1, nBytesPerSample, nComponents, iComponent) * ax;
+    return top * (1.0f - ay) + bottom * ay;
+}
+
+/**
+*   @brief  Samples the chroma of the source at luma position (fx, fy). Chroma is sited at the center of its luma block.
+*/
+PP_HOST_DEVICE inline void PostProcessSampleChroma(const PostProcessSource& src, float fx, float fy,
+    PostProcessInterpolation eInterpolation, float* u, float* v)
+{
+    const uint8_t* pChroma = src.pFrame + (size_t)src.nChromaRow * src.nPitch;
+    if (src.eChroma == PostProcessChroma::YUV444)
+    {
+        const uint8_t* pV = pChroma + (size_t)src.nChromaRow * src.nPitch;
+        *u = PostProcessSamplePlane(pChroma, src.nPitch, src.nWidth, src.nHeight, src.nBytesPerSample, 1, 0, fx, fy, eInterpolation);
+        *v = PostProcessSamplePlane(pV, src.nPitch, src.nWidth, src.nHeight, src.nBytesPerSample, 1, 0, fx, fy, eInterpolation);
+        return;
+    }
+    bool b420 = src.eChroma == PostProcessChroma::YUV420;
+    int nChromaWidth = (src.nWidth + 1) / 2, nChromaHeight = b420 ? (src.nHeight + 1) / 2 : src.nHeight;
+    float cx = (fx + 0.5f) * 0.5f - 0.5f, cy = b420 ? (fy + 0.5f) * 0.5f - 0.5f : fy;
+    *u = PostProcessSamplePlane(pChroma, src.nPitch, nChromaWidth, nChromaHeight, src.nBytesPerSample, 2, 0, cx, cy, eInterpolation);
+    *v = PostProcessSamplePlane(pChroma, src.nPitch, nChromaWidth, nChromaHeight, src.nBytesPerSample, 2, 1, cx, cy, eInterpolation);
+}
+
+/**
+*   @brief  Computes and stores output pixel (dx, dy). params must be resolved with ResolvePostProcessParams().
+*   Source coordinates use pixel centers, chroma is sited at the center of its luma block.
+*/
+PP_HOST_DEVICE inline void PostProcessPixel(const PostProcessSource& src, const PostProcessColorMatrix& m,
+    const PostProcessParams& params, int dx, int dy, uint8_t* pDst)
+{
+    float sx = (float)params.roi.width / params.nWidth, sy = (float)params.roi.height / params.nHeight;
+    float fx = params.roi.x + (dx + 0.5f) * sx - 0.5f;
+    float fy = params.roi.y + (dy + 0.5f) * sy - 0.5f;
+
+    float y = PostProcessSamplePlane(src.pFrame, src.nPitch, src.nWidth, src.nHeight, src.nBytesPerSample, 1, 0, fx, fy, params.eInterpolation);
+    float u, v;
+    PostProcessSampleChroma(src, fx, fy, params.eInterpolation, &u, &v);
+
+    y -= m.low;
+    u -= m.mid;
+    v -= m.mid;
+    float rgb[3];
+    for (int c = 0; c < 3; c++)
+    {
+        float value = m.mat[c][0] * y + m.mat[c][1] * u + m.mat[c][2] * v;
+        rgb[c] = value < 0.0f ? 0.0f : (value > m.maxValue ? m.maxValue : value);
+    }
+    if (m.eToneMap != PostProcessTransfer::SDR)
+    {
+        for (int c = 0; c < 3; c++)
+        {
+            rgb[c] /= m.maxValue;
+        }
+        PostProcessToneMap(rgb, m);
+        for (int c = 0; c < 3; c++)
+        {
+            rgb[c] *= m.maxValue;
+        }
+    }
+    size_t nPlaneSize = (size_t)params.nWidth * params.nHeight;
+    size_t iPixel = (size_t)dy * params.nWidth + dx;
+    for (int c = 0; c < 3; c++)
+    {
+        float value = rgb[c] * (255.0f / m.maxValue) * params.scale;
+        value = (value - params.mean[c]) / params.std[c];
+        size_t i = params.eLayout == PostProcessLayout::HWC ? iPixel * 3 + c : c * nPlaneSize + iPixel;
+        switch (params.eDataType)
+        {
+        case PostProcessDataType::FLOAT32:
+            ((float*)pDst)[i] = value;
+            break;
+        case PostProcessDataType::FLOAT16:
+            ((uint16_t*)pDst)[i] = PostProcessFloatToHalf(value);
+            break;
+        default:
+            value = floorf(value + 0.5f);
+            pDst[i] = (uint8_t)(value < 0.0f ? 0.0f : (value > 255.0f ? 255.0f : value));
+            break;
+        }
+    }
+}
+
+/**
+*   @brief  Host reference of YuvToRgbPostProcess(). Writes params.nWidth x params.nHeight pixels to pDst.
+*   params must be resolved with ResolvePostProcessParams() and colorimetry with ResolvePostProcessColorimetry().
+*/
+inline void YuvToRgbPostProcessHost(const PostProcessSource& src, uint8_t* pDst, const PostProcessParams& params,
+    const PostProcessColorimetry& colorimetry)
+{
+    PostProcessColorMatrix m = GetPostProcessColorMatrix(colorimetry, src.nBytesPerSample);
+    for (int dy = 0; dy < params.nHeight; dy++)
+    {
+        for (int dx = 0; dx < params.nWidth; dx++)
+        {
+            PostProcessPixel(src, m, params, dx, dy, pDst);
+        }
+    }
+}
+
+/**
+*   @brief  Format of an output of a ladder.
+*/
+enum class PostProcessFormat
+{
+    RGB,  // interleaved RGB, normalization and element type as in PostProcessParams
+    RGBP, // planar RGB, normalization and element type as in PostProcessParams
+    NV12, // 8 bit 4:2:0 semi-planar, packed
+    P016, // 16 bit 4:2:0 semi-planar, packed
+};
+
+/**
+* @brief One output of a ladder: a resized copy of each decoded frame in its own buffer.
+* params.nWidth and params.nHeight must be set; they must be even for NV12 and P016.
+*/
+struct PostProcessOutput
+{
+    PostProcessFormat eFormat = PostProcessFormat::RGB;
+    PostProcessParams params;
+};
+
+/**
+* @brief Maximum number of outputs generated by one YuvToLadder() call.
+*/
+const int PostProcessMaxOutputs = 8;
+
+/**
+*   @brief  Returns the size in bytes of a resolved ladder output.
+*/
+inline size_t GetPostProcessOutputSize(const PostProcessOutput& output)
+{
+    size_t nPixels = (size_t)output.params.nWidth * output.params.nHeight;
+    switch (output.eFormat)
+    {
+    case PostProcessFormat::NV12:
+        return nPixels * 3 / 2;
+    case PostProcessFormat::P016:
+        return nPixels * 3;
+    default:
+        return nPixels * 3 * GetPostProcessElementSize(output.params.eDataType);
+    }
+}
+
+/**
+*   @brief  Computes and stores pixel (dx, dy) of a NV12 or P016 output, and the chroma of its 2x2 block when dx and dy are even.
+*   params must be resolved with ResolvePostProcessParams(); normalization and element type are ignored.
+*/
+PP_HOST_DEVICE inline void PostProcessYuvPixel(const PostProcessSource& src, const PostProcessParams& params,
+    int nDstBytesPerSample, int dx, int dy, uint8_t* pDst)
+{
+    float sx = (float)params.roi.width / params.nWidth, sy = (float)params.roi.height / params.nHeight;
+    float scale = nDstBytesPerSample == src.nBytesPerSample ? 1.0f : (nDstBytesPerSample == 2 ? 257.0f : 1.0f / 257.0f);
+    float maxValue = nDstBytesPerSample == 2 ? 65535.0f : 255.0f;
+    float samples[3];
+    int nSamples = 1;
+    samples[0] = PostProcessSamplePlane(src.pFrame, src.nPitch, src.nWidth, src.nHeight, src.nBytesPerSample, 1, 0,
+        params.roi.x + (dx + 0.5f) * sx - 0.5f, params.roi.y + (dy + 0.5f) * sy - 0.5f, params.eInterpolation);
+    if ((dx & 1) == 0 && (dy & 1) == 0)
+    {
+        // the chroma sample is sited at the center of the 2x2 luma block
+        PostProcessSampleChroma(src, params.roi.x + (dx + 1.0f) * sx - 0.5f, params.roi.y + (dy + 1.0f) * sy - 0.5f,
+            params.eInterpolation, &samples[1], &samples[2]);
+        nSamples = 3;
+    }
+    size_t aIndex[3] = {
+        (size_t)dy * params.nWidth + dx,
+        (size_t)params.nWidth * params.nHeight + (size_t)(dy / 2) * params.nWidth + dx,
+        (size_t)params.nWidth * params.nHeight + (size_t)(dy / 2) * params.nWidth + dx + 1,
+    };
+    for (int i = 0; i < nSamples; i++)
+    {
+        float value = floorf(samples[i] * scale + 0.5f);
+        value = value < 0.0f ? 0.0f : (value > maxValue ? maxValue : value);
+        if (nDstBytesPerSample == 2)
+        {
+            ((uint16_t*)pDst)[aIndex[i]] = (uint16_t)value;
+        }
+        else
+        {
+            pDst[aIndex[i]] = (uint8_t)value;
+        }
+    }
+}
+
+/**
+*   @brief  Computes and stores pixel (dx, dy) of a resolved ladder output. Pixels outside the output are ignored.
+*/
+PP_HOST_DEVICE inline void PostProcessOutputPixel(const PostProcessSource& src, const PostProcessColorMatrix& m,
+    const PostProcessOutput& output, int dx, int dy, uint8_t* pDst)
+{
+    if (dx >= output.params.nWidth || dy >= output.params.nHeight)
+    {
+        return;
+    }
+    switch (output.eFormat)
+    {
+    case PostProcessFormat::NV12:
+        PostProcessYuvPixel(src, output.params, 1, dx, dy, pDst);
+        break;
+    case PostProcessFormat::P016:
+        PostProcessYuvPixel(src, output.params, 2, dx, dy, pDst);
+        break;
+    default:
+        PostProcessPixel(src, m, output.params, dx, dy, pDst);
+        break;
+    }
+}
+
+/**
+*   @brief  Resolves the roi of a ladder output for a frame of nWidth x nHeight and sets the layout from the format.
+*   Returns false if the output is invalid for the frame.
+*/
+inline bool ResolvePostProcessOutput(const PostProcessOutput& output, int nWidth, int nHeight, PostProcessOutput* pResolved)
+{
+    *pResolved = output;
+    bool bYuv = output.eFormat == PostProcessFormat::NV12 || output.eFormat == PostProcessFormat::P016;
+    if (output.params.nWidth <= 0 || output.params.nHeight <= 0 || (bYuv && ((output.params.nWidth | output.params.nHeight) & 1)))
+    {
+        return false;
+    }
+    bool bValid = ResolvePostProcessParams(output.params, nWidth, nHeight, &pResolved->params);
+    // set after resolving, which copies the params over the resolved ones
+    pResolved->params.eLayout = output.eFormat == PostProcessFormat::RGBP ? PostProcessLayout::CHW : PostProcessLayout::HWC;
+    return bValid;
+}
+
+/**
+*   @brief  Host reference of YuvToLadder(). Outputs must be resolved with ResolvePostProcessOutput() and
+*   colorimetry with ResolvePostProcessColorimetry().
+*/
+inline void YuvToLadderHost(const PostProcessSource& src, const PostProcessOutput* pOutputs, uint8_t* const* ppDst, int nOutputs,
+    const PostProcessColorimetry& colorimetry)
+{
+    PostProcessColorMatrix m = GetPostProcessColorMatrix(colorimetry, src.nBytesPerSample);
+    for (int i = 0; i < nOutputs; i++)
+    {
+        for (int dy = 0; dy < pOutputs[i].params.nHeight; dy++)
+        {
+            for (int dx = 0; dx < pOutputs[i].params.nWidth; dx++)
+            {
+                PostProcessOutputPixel(src, m, pOutputs[i], dx, dy, ppDst[i]);
+            }
+        }
+    }
+}
+
+struct CUstream_st;
+
+/**
+*   @brief  Converts a YUV frame in device memory to RGB and applies the crop, resize, normalization and cast
+*   described by params in a single pass. Writes params.nWidth x params.nHeight pixels to dpDst, packed.
+*   params must be resolved with ResolvePostProcessParams() and colorimetry with ResolvePostProcessColorimetry().
+*/
+void YuvToRgbPostProcess(const PostProcessSource& src, uint8_t* dpDst, const PostProcessParams& params,
+    const PostProcessColorimetry& colorimetry, CUstream_st* stream);
+
+/**
+*   @brief  Generates up to PostProcessMaxOutputs resized copies of a YUV frame in device memory with one kernel launch,
+*   so that the outputs share the reads of the source frame. Output i is written packed to dpDst[i].
+*   Outputs must be resolved with ResolvePostProcessOutput() and colorimetry with ResolvePostProcessColorimetry().
+*/
+void YuvToLadder(const PostProcessSource& src, const PostProcessOutput* pOutputs, uint8_t* const* dpDst, int nOutputs,
+    const PostProcessColorimetry& colorimetry, CUstream_st* stream);
@@ -0,0 +1,231 @@
+/*
+ * This copyright notice applies to this file only
+ *
+ * SPDX-FileCopyrightText: Copyright (c) 2010-2025 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#pragma once
+#include <stdint.h>
+#include <string.h>
+#include <vector>
+#if !defined(__CUDA_ARCH__)
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define YUV_CONVERTER_SSE2
+#elif defined(__ARM_NEON) || defined(_M_ARM64)
+#include <arm_neon.h>
+#define YUV_CONVERTER_NEON
+#endif
+#endif
+
+/**
+* @brief Template class to facilitate color space conversion
+* Converts the chroma of a 4:2:0 frame between planar (IYUV) and interleaved (NV12/P016) layout in place.
+* The chroma rows are first moved to their destination one row at a time by following the cycles of the
+* row permutation, then each row is interleaved or deinterleaved while it is in cache with SSE2/NEON.
+* Only one row of scratch memory is kept, instead of a copy of a whole chroma plane.
+* bSimd = false keeps the scalar row loops only; it is used as the reference by the tests and the benchmark.
+*/
+template<typename T, bool bSimd = true>
+class YuvConverter {
+    static_assert(sizeof(T) == 1 || sizeof(T) == 2, "YuvConverter supports 8 and 16 bit samples");
+public:
+    YuvConverter(int nWidth, int nHeight) : nWidth(nWidth), nHeight(nHeight) {
+        vRowScratch.resize(nWidth + 1);
+        vRowMoved.resize(nHeight + 2);
+    }
+    void PlanarToUVInterleaved(T *pFrame, int nPitch = 0) {
+        if (nPitch == 0) {
+            nPitch = nWidth;
+        }
+        int nChromaWidth = (nWidth + 1) / 2, nChromaHeight = (nHeight + 1) / 2;
+        T *puv = pFrame + (size_t)nPitch * nHeight;
+        if (nPitch % 2) {
+            PlanarToUVInterleavedOddPitch(puv, nPitch);
+            return;
+        }
+        int nHalfPitch = nPitch / 2;
+        // row y of the interleaved plane holds U row y followed by V row y, i.e. half rows 2y and 2y+1 of
+        // the planar chroma, which are taken from half rows y and nChromaHeight + y
+        PermuteHalfRows(puv, nHalfPitch, nChromaWidth, nChromaHeight, [nChromaHeight](int i) {
+            return i % 2 ? nChromaHeight + i / 2 : i / 2;
+        });
+        T *pu = vRowScratch.data();
+        for (int y = 0; y < nChromaHeight; y++) {
+            T *pRow = puv + (size_t)y * nPitch;
+            memcpy(pu, pRow, nChromaWidth * sizeof(T));
+            // V is read ahead of the interleaved output, so it can stay in place
+            InterleaveRow(pu, pRow + nHalfPitch, pRow, nChromaWidth);
+        }
+    }
+    void UVInterleavedToPlanar(T *pFrame, int nPitch = 0) {
+        if (nPitch == 0) {
+            nPitch = nWidth;
+        }
+        int nChromaWidth = (nWidth + 1) / 2, nChromaHeight = (nHeight + 1) / 2;
+        T *puv = pFrame + (size_t)nPitch * nHeight;
+        if (nPitch % 2) {
+            UVInterleavedToPlanarOddPitch(puv, nPitch);
+            return;
+        }
+        int nHalfPitch = nPitch / 2;
+        T *pv = vRowScratch.data();
+        for (int y = 0; y < nChromaHeight; y++) {
+            T *pRow = puv + (size_t)y * nPitch;
+            // U is written behind the interleaved input, V goes through the scratch row
+            DeinterleaveRow(pRow, pRow, pv, nChromaWidth);
+            memcpy(pRow + nHalfPitch, pv, nChromaWidth * sizeof(T));
+        }
+        PermuteHalfRows(puv, nHalfPitch, nChromaWidth, nChromaHeight, [nChromaHeight](int i) {
+            return i < nChromaHeight ? 2 * i : 2 * (i - nChromaHeight) + 1;
+        });
+    }
+
+private:
+    /**
+    *   @brief  Rearranges the 2 * nChromaHeight half rows of nHalfPitch samples starting at p so that half row i
+    *   receives the content of half row fnSource(i). Only the first nChromaWidth samples of each half row are moved.
+    */
+    template <typename Fn>
+    void PermuteHalfRows(T *p, int nHalfPitch, int nChromaWidth, int nChromaHeight, Fn fnSource) {
+        int nHalfRows = 2 * nChromaHeight;
+        vRowMoved.assign(nHalfRows, 0);
+        T *pTmp = vRowScratch.data();
+        size_t nBytes = nChromaWidth * sizeof(T);
+        for (int i = 0; i < nHalfRows; i++) {
+            if (vRowMoved[i]) {
+                continue;
+            }
+            vRowMoved[i] = 1;
+            int j = i, k = fnSource(i);
+            if (k == i) {
+                continue;
+            }
+            memcpy(pTmp, p + (size_t)i * nHalfPitch, nBytes);
+            for (; k != i; j = k, k = fnSource(k)) {
+                memcpy(p + (size_t)j * nHalfPitch, p + (size_t)k * nHalfPitch, nBytes);
+                vRowMoved[k] = 1;
+            }
+            memcpy(p + (size_t)j * nHalfPitch, pTmp, nBytes);
+        }
+    }
+
+    // Each SIMD iteration loads its input before storing, which lets the callers overlap source and destination
+    static void InterleaveRow(const T *pu, const T *pv, T *puv, int n) {
+        int x = 0;
+#if defined(YUV_CONVERTER_SSE2)
+        const int nStep = 16 / sizeof(T);
+        for (; bSimd && x + nStep <= n; x += nStep) {
+            __m128i u = _mm_loadu_si128((const __m128i *)(pu + x));
+            __m128i v = _mm_loadu_si128((const __m128i *)(pv + x));
+            __m128i lo = sizeof(T) == 1 ? _mm_unpacklo_epi8(u, v) : _mm_unpacklo_epi16(u, v);
+            __m128i hi = sizeof(T) == 1 ? _mm_unpackhi_epi8(u, v) : _mm_unpackhi_epi16(u, v);
+            _mm_storeu_si128((__m128i *)(puv + 2 * x), lo);
+            _mm_storeu_si128((__m128i *)(puv + 2 * x + nStep), hi);
+        }
+#elif defined(YUV_CONVERTER_NEON)
+        const int nStep = 16 / sizeof(T);
+        for (; bSimd && x + nStep <= n; x += nStep) {
+            if (sizeof(T) == 1) {
+                uint8x16x2_t uv = { { vld1q_u8((const uint8_t *)(pu + x)), vld1q_u8((const uint8_t *)(pv + x)) } };
+                vst2q_u8((uint8_t *)(puv + 2 * x), uv);
+            } else {
+                uint16x8x2_t uv = { { vld1q_u16((const uint16_t *)(pu + x)), vld1q_u16((const uint16_t *)(pv + x)) } };
+                vst2q_u16((uint16_t *)(puv + 2 * x), uv);
+            }
+        }
+#endif
+        for (; x < n; x++) {
+            T u = pu[x], v = pv[x];
+            puv[2 * x] = u;
+            puv[2 * x + 1] = v;
+        }
+    }
+    static void DeinterleaveRow(const T *puv, T *pu, T *pv, int n) {
+        int x = 0;
+#if defined(YUV_CONVERTER_SSE2)
+        const int nStep = 16 / sizeof(T);
+        const __m128i mask = sizeof(T) == 1 ? _mm_set1_epi16(0x00ff) : _mm_set1_epi32(0x0000ffff);
+        for (; bSimd && x + nStep <= n; x += nStep) {
+            __m128i a = _mm_loadu_si128((const __m128i *)(puv + 2 * x));
+            __m128i b = _mm_loadu_si128((const __m128i *)(puv + 2 * x + nStep));
+            __m128i u, v;
+            if (sizeof(T) == 1) {
+                u = _mm_packus_epi16(_mm_and_si128(a, mask), _mm_and_si128(b, mask));
+                v = _mm_packus_epi16(_mm_srli_epi16(a, 8), _mm_srli_epi16(b, 8));
+            } else {
+                // SSE2 has no unsigned 32 to 16 bit pack; bias the samples into the signed range instead
+                const __m128i bias32 = _mm_set1_epi32(0x8000);
+                const __m128i bias16 = _mm_set1_epi16((short)0x8000);
+                u = _mm_xor_si128(_mm_packs_epi32(_mm_sub_epi32(_mm_and_si128(a, mask), bias32),
+                    _mm_sub_epi32(_mm_and_si128(b, mask), bias32)), bias16);
+                v = _mm_xor_si128(_mm_packs_epi32(_mm_sub_epi32(_mm_srli_epi32(a, 16), bias32),
+                    _mm_sub_epi32(_mm_srli_epi32(b, 16), bias32)), bias16);
+            }
+            _mm_storeu_si128((__m128i *)(pu + x), u);
+            _mm_storeu_si128((__m128i *)(pv + x), v);
+        }
+#elif defined(YUV_CONVERTER_NEON)
+        const int nStep = 16 / sizeof(T);
+        for (; bSimd && x + nStep <= n; x += nStep) {
+            if (sizeof(T) == 1) {
+                uint8x16x2_t uv = vld2q_u8((const uint8_t *)(puv + 2 * x));
+                vst1q_u8((uint8_t *)(pu + x), uv.val[0]);
+                vst1q_u8((uint8_t *)(pv + x), uv.val[1]);
+            } else {
+                uint16x8x2_t uv = vld2q_u16((const uint16_t *)(puv + 2 * x));
+                vst1q_u16((uint16_t *)(pu + x), uv.val[0]);
+                vst1q_u16((uint16_t *)(pv + x), uv.val[1]);
+            }
+        }
+#endif
+        for (; x < n; x++) {
+            T u = puv[2 * x], v = puv[2 * x + 1];
+            pu[x] = u;
+            pv[x] = v;
+        }
+    }
+
+    // With an odd pitch the interleaved rows do not line up with pairs of planar rows; go through a copy of the chroma
+    void PlanarToUVInterleavedOddPitch(T *puv, int nPitch) {
+        int nChromaWidth = (nWidth + 1) / 2, nChromaHeight = (nHeight + 1) / 2, nPlanarPitch = (nPitch + 1) / 2;
+        vPlaneScratch.assign(puv, puv + (size_t)2 * nPlanarPitch * nChromaHeight);
+        const T *pu = vPlaneScratch.data(), *pv = pu + (size_t)nPlanarPitch * nChromaHeight;
+        for (int y = 0; y < nChromaHeight; y++) {
+            InterleaveRow(pu + (size_t)y * nPlanarPitch, pv + (size_t)y * nPlanarPitch, puv + (size_t)y * nPitch, nChromaWidth);
+        }
+    }
+    void UVInterleavedToPlanarOddPitch(T *puv, int nPitch) {
+        int nChromaWidth = (nWidth + 1) / 2, nChromaHeight = (nHeight + 1) / 2, nPlanarPitch = (nPitch + 1) / 2;
+        vPlaneScratch.assign(puv, puv + (size_t)nPitch * nChromaHeight + 1);
+        T *pu = puv, *pv = puv + (size_t)nPlanarPitch * nChromaHeight;
+        for (int y = 0; y < nChromaHeight; y++) {
+            DeinterleaveRow(vPlaneScratch.data() + (size_t)y * nPitch, pu + (size_t)y * nPlanarPitch, pv + (size_t)y * nPlanarPitch, nChromaWidth);
+        }
+    }
+
+private:
+    int nWidth, nHeight;
+    std::vector<T> vRowScratch;
+    std::vector<uint8_t> vRowMoved;
+    std::vector<T> vPlaneScratch;
+};
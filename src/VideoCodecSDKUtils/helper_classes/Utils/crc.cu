@@ -25,6 +25,7 @@
 
 #include <cuda_runtime.h>
 #include "NvCodecUtils.h"
+#include "FrameHash.h"
 
 /*
 * CRC32 lookup table
@@ -138,3 +139,166 @@ void ComputeCRC(uint8_t *pBuffer, uint32_t *crcValue, cudaStream_t outputCUStrea
 
     ComputeCRCKernel <<<gridSize, blockSize, 0, outputCUStream >>>(pBuffer, crcValue);
 }
+
+struct FrameHashArgs
+{
+    FrameHashPlane aPlane[FrameHashMaxPlanes];
+    // destination of each plane when the frame is copied while it is hashed
+    FrameHashCopyPlane aDst[FrameHashMaxPlanes];
+    // offset of each plane in the packed frame
+    uint64_t anOffset[FrameHashMaxPlanes + 1];
+    int nPlanes;
+};
+
+// Loads byte iByte of the packed frame, and stores it to the destination when copying
+template <bool bCopy>
+static __device__ uint8_t FrameHashLoadByte(const FrameHashArgs &args, uint64_t iByte)
+{
+    int iPlane = 0;
+    while (iPlane < args.nPlanes - 1 && iByte >= args.anOffset[iPlane + 1])
+    {
+        iPlane++;
+    }
+    const FrameHashPlane &plane = args.aPlane[iPlane];
+    uint64_t nOffset = iByte - args.anOffset[iPlane];
+    uint64_t nRow = nOffset / plane.nRowBytes, x = nOffset % plane.nRowBytes;
+    uint8_t value = plane.pData[nRow * plane.nPitch + x];
+    if (bCopy)
+    {
+        args.aDst[iPlane].pData[nRow * args.aDst[iPlane].nPitch + x] = value;
+    }
+    return value;
+}
+
+// One thread per 8 byte word of the packed frame. Words within an aligned row are read with a single load, words
+// across rows or planes byte by byte. Contributions are summed per block with warp shuffles and added to the frame
+// sum with a single atomic per block. With bCopy each word is also stored to the destination planes, so a frame
+// that is copied and hashed is read once.
+template <bool bCopy>
+static __global__ void FrameHashKernel(FrameHashArgs args, unsigned long long *dpSum)
+{
+    uint64_t iWord = (uint64_t)blockIdx.x * blockDim.x + threadIdx.x;
+    uint64_t iByte = iWord * 8, nBytes = args.anOffset[args.nPlanes];
+    uint64_t value = 0;
+    if (iByte < nBytes)
+    {
+        int iPlane = 0;
+        while (iPlane < args.nPlanes - 1 && iByte >= args.anOffset[iPlane + 1])
+        {
+            iPlane++;
+        }
+        const FrameHashPlane &plane = args.aPlane[iPlane];
+        uint64_t nOffset = iByte - args.anOffset[iPlane];
+        uint64_t nRow = nOffset / plane.nRowBytes, x = nOffset % plane.nRowBytes;
+        const uint8_t *p = plane.pData + nRow * plane.nPitch + x;
+        uint8_t *q = bCopy ? args.aDst[iPlane].pData + nRow * args.aDst[iPlane].nPitch + x : nullptr;
+        uint64_t word = 0;
+        if (x + 8 <= plane.nRowBytes && ((uintptr_t)p & 7) == 0)
+        {
+            word = *(const uint64_t *)p;
+            if (bCopy && ((uintptr_t)q & 7) == 0)
+            {
+                *(uint64_t *)q = word;
+            }
+            else if (bCopy)
+            {
+                for (int i = 0; i < 8; i++)
+                {
+                    q[i] = (uint8_t)(word >> (8 * i));
+                }
+            }
+        }
+        else
+        {
+            uint64_t n = nBytes - iByte < 8 ? nBytes - iByte : 8;
+            for (uint64_t i = 0; i < n; i++)
+            {
+                uint8_t byte;
+                if (x + i < plane.nRowBytes)
+                {
+                    byte = p[i];
+                    if (bCopy)
+                    {
+                        q[i] = byte;
+                    }
+                }
+                else
+                {
+                    byte = FrameHashLoadByte<bCopy>(args, iByte + i);
+                }
+                word |= (uint64_t)byte << (8 * i);
+            }
+        }
+        value = FrameHashWord(iWord, word);
+    }
+    for (int offset = 16; offset > 0; offset /= 2)
+    {
+        value += __shfl_down_sync(0xffffffff, value, offset);
+    }
+    __shared__ uint64_t aWarpSum[32];
+    if (threadIdx.x % 32 == 0)
+    {
+        aWarpSum[threadIdx.x / 32] = value;
+    }
+    __syncthreads();
+    if (threadIdx.x == 0)
+    {
+        uint64_t sum = 0;
+        for (int i = 0; i < (int)blockDim.x / 32; i++)
+        {
+            sum += aWarpSum[i];
+        }
+        atomicAdd(dpSum, (unsigned long long)sum);
+    }
+}
+
+static __global__ void FrameHashFinalizeKernel(uint64_t *dpHash, uint64_t nBytes)
+{
+    *dpHash = FrameHashFinalize(*dpHash, nBytes);
+}
+
+static void LaunchFrameHash(const FrameHashPlane *pPlanes, const FrameHashCopyPlane *pDstPlanes, int nPlanes, uint64_t *dpHash, cudaStream_t stream)
+{
+    const int nThreads = 256;
+    FrameHashArgs args = {};
+    for (int i = 0; i < nPlanes && i < FrameHashMaxPlanes; i++)
+    {
+        if (!pPlanes[i].nRowBytes || !pPlanes[i].nRows)
+        {
+            continue;
+        }
+        args.aPlane[args.nPlanes] = pPlanes[i];
+        if (pDstPlanes)
+        {
+            args.aDst[args.nPlanes] = pDstPlanes[i];
+        }
+        args.anOffset[args.nPlanes + 1] = args.anOffset[args.nPlanes] + (uint64_t)pPlanes[i].nRowBytes * pPlanes[i].nRows;
+        args.nPlanes++;
+    }
+    uint64_t nBytes = args.anOffset[args.nPlanes];
+    cudaMemsetAsync(dpHash, 0, sizeof(uint64_t), stream);
+    if (nBytes)
+    {
+        uint64_t nWords = (nBytes + 7) / 8;
+        unsigned int nBlocks = (unsigned int)((nWords + nThreads - 1) / nThreads);
+        if (pDstPlanes)
+        {
+            FrameHashKernel<true> <<<nBlocks, nThreads, 0, stream >>>(args, (unsigned long long *)dpHash);
+        }
+        else
+        {
+            FrameHashKernel<false> <<<nBlocks, nThreads, 0, stream >>>(args, (unsigned long long *)dpHash);
+        }
+    }
+    FrameHashFinalizeKernel <<<1, 1, 0, stream >>>(dpHash, nBytes);
+}
+
+void ComputeFrameHash(const FrameHashPlane *pPlanes, int nPlanes, uint64_t *dpHash, cudaStream_t stream)
+{
+    LaunchFrameHash(pPlanes, nullptr, nPlanes, dpHash, stream);
+}
+
+void CopyFrameWithHash(const FrameHashPlane *pPlanes, const FrameHashCopyPlane *pDstPlanes, int nPlanes, uint64_t *dpHash, cudaStream_t stream)
+{
+    LaunchFrameHash(pPlanes, pDstPlanes, nPlanes, dpHash, stream);
+}
@@ -0,0 +1,126 @@
+/*
+ * This copyright notice applies to this file only
+ *
+ * SPDX-FileCopyrightText: Copyright (c) 2025 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#include "BitDepth.h"
+
+#include <gtest/gtest.h>
+
+#include <math.h>
+#include <stdlib.h>
+#include <vector>
+
+namespace
+{
+
+// The 8x8 Bayer matrix the conversion was specified with
+const int g_aBayer8x8[8][8] = {
+    { 0, 32,  8, 40,  2, 34, 10, 42},
+    {48, 16, 56, 24, 50, 18, 58, 26},
+    {12, 44,  4, 36, 14, 46,  6, 38},
+    {60, 28, 52, 20, 62, 30, 54, 22},
+    { 3, 35, 11, 43,  1, 33,  9, 41},
+    {51, 19, 59, 27, 49, 17, 57, 25},
+    {15, 47,  7, 39, 13, 45,  5, 37},
+    {63, 31, 55, 23, 61, 29, 53, 21},
+};
+
+}  // namespace
+
+TEST(BitDepthTest, BayerThresholdsMatchTheMatrix)
+{
+    for (int y = 0; y < 16; y++)
+    {
+        for (int x = 0; x < 16; x++)
+        {
+            ASSERT_EQ(BitDepthBayer8x8(x, y), g_aBayer8x8[y & 7][x & 7]) << "x " << x << " y " << y;
+        }
+    }
+}
+
+TEST(BitDepthTest, RoundsToNearest)
+{
+    for (int s = 0; s <= 65535; s++)
+    {
+        ASSERT_EQ(BitDepthToUInt8((uint16_t)s, 0, 0, false), (int)floor(s / 257.0 + 0.5)) << "sample " << s;
+    }
+    EXPECT_EQ(BitDepthToUInt8(65535, 0, 0, false), 255);
+    // 10 bit samples are MSB aligned: 1023 and 512 become 65472 / 257 = 254.75 and 32768 / 257 = 127.5
+    EXPECT_EQ(BitDepthToUInt8(1023 << 6, 0, 0, false), 255);
+    EXPECT_EQ(BitDepthToUInt8(512 << 6, 0, 0, false), 128);
+}
+
+TEST(BitDepthTest, DitherStaysWithinOneStepAndKeepsTheMean)
+{
+    for (int s = 0; s <= 65535; s += 7)
+    {
+        int nLow = s / 257, nSum = 0;
+        for (int y = 0; y < 8; y++)
+        {
+            for (int x = 0; x < 8; x++)
+            {
+                int v = BitDepthToUInt8((uint16_t)s, x, y, true);
+                ASSERT_TRUE(v == nLow || v == nLow + 1) << "sample " << s << " x " << x << " y " << y;
+                nSum += v;
+            }
+        }
+        // over an 8x8 tile the mean is s / 257 to within half a threshold step
+        ASSERT_NEAR(nSum / 64.0, s / 257.0, 1.0 / 128 + 1e-9) << "sample " << s;
+    }
+}
+
+TEST(BitDepthTest, DitherKeepsExactLevels)
+{
+    for (int v = 0; v <= 255; v++)
+    {
+        for (int i = 0; i < 64; i++)
+        {
+            ASSERT_EQ(BitDepthToUInt8((uint16_t)(v * 257), i % 8, i / 8, true), v);
+        }
+    }
+}
+
+TEST(BitDepthTest, HostReferenceHonorsPitches)
+{
+    const int nWidth = 21, nHeight = 11, nSrcPitch = 48 * 2, nDestPitch = 32;
+    std::vector<uint16_t> src(nSrcPitch / 2 * nHeight);
+    srand(1);
+    for (uint16_t& s : src)
+    {
+        s = (uint16_t)rand();
+    }
+    for (bool bDither : { false, true })
+    {
+        std::vector<uint8_t> dst((size_t)nDestPitch * nHeight, 0xa5);
+        ConvertUInt16ToUInt8RoundedHost(src.data(), dst.data(), nSrcPitch, nDestPitch, nWidth, nHeight, bDither);
+        for (int y = 0; y < nHeight; y++)
+        {
+            for (int x = 0; x < nDestPitch; x++)
+            {
+                uint8_t expected = x < nWidth ? BitDepthToUInt8(src[(size_t)y * nSrcPitch / 2 + x], x, y, bDither) : 0xa5;
+                ASSERT_EQ(dst[(size_t)y * nDestPitch + x], expected) << "x " << x << " y " << y;
+            }
+        }
+    }
+}
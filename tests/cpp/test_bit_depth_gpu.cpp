@@ -0,0 +1,76 @@
+/*
+ * This copyright notice applies to this file only
+ *
+ * SPDX-FileCopyrightText: Copyright (c) 2025 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#include "BitDepth.h"
+
+#include <cuda_runtime.h>
+#include <gtest/gtest.h>
+
+#include <stdlib.h>
+#include <vector>
+
+namespace
+{
+
+bool HasGpu()
+{
+    int nGpu = 0;
+    return cudaGetDeviceCount(&nGpu) == cudaSuccess && nGpu > 0;
+}
+
+}  // namespace
+
+// The kernel and the host reference share BitDepthToUInt8(), which uses integer arithmetic only
+TEST(BitDepthGpuTest, KernelMatchesHostReference)
+{
+    if (!HasGpu())
+    {
+        GTEST_SKIP() << "no CUDA device";
+    }
+    const int nWidth = 131, nHeight = 75;
+    size_t nSrcPitch = 0, nDestPitch = 0;
+    std::vector<uint16_t> src((size_t)nWidth * nHeight);
+    srand(1);
+    for (uint16_t& s : src)
+    {
+        s = (uint16_t)rand();
+    }
+    uint16_t* dpSrc = nullptr;
+    uint8_t* dpDst = nullptr;
+    ASSERT_EQ(cudaMallocPitch((void**)&dpSrc, &nSrcPitch, nWidth * sizeof(uint16_t), nHeight), cudaSuccess);
+    ASSERT_EQ(cudaMallocPitch((void**)&dpDst, &nDestPitch, nWidth, nHeight), cudaSuccess);
+    ASSERT_EQ(cudaMemcpy2D(dpSrc, nSrcPitch, src.data(), nWidth * sizeof(uint16_t), nWidth * sizeof(uint16_t), nHeight,
+        cudaMemcpyHostToDevice), cudaSuccess);
+    for (bool bDither : { false, true })
+    {
+        std::vector<uint8_t> expected((size_t)nWidth * nHeight), actual((size_t)nWidth * nHeight);
+        ConvertUInt16ToUInt8RoundedHost(src.data(), expected.data(), nWidth * sizeof(uint16_t), nWidth, nWidth, nHeight, bDither);
+        ConvertUInt16ToUInt8Rounded(dpSrc, dpDst, (int)nSrcPitch, (int)nDestPitch, nWidth, nHeight, bDither, nullptr);
+        ASSERT_EQ(cudaMemcpy2D(actual.data(), nWidth, dpDst, nDestPitch, nWidth, nHeight, cudaMemcpyDeviceToHost), cudaSuccess);
+        EXPECT_EQ(actual, expected) << (bDither ? "dither" : "round to nearest");
+    }
+    cudaFree(dpSrc);
+    cudaFree(dpDst);
+}
@@ -0,0 +1,196 @@
+/*
+ * This copyright notice applies to this file only
+ *
+ * SPDX-FileCopyrightText: Copyright (c) 2025 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#include "ColorSpaceHost.h"
+
+#include <gtest/gtest.h>
+
+#include <stdlib.h>
+#include <string>
+#include <vector>
+
+namespace
+{
+
+typedef void (*ConvertFn)(const uint8_t* pSrc, int nSrcPitch, uint8_t* pDst, int nDstPitch, int nWidth, int nHeight, int iMatrix);
+
+struct Conversion
+{
+    const char* name;
+    ConvertFn fnConvert;
+    bool bPlanarOutput;
+    // source rows per luma row, e.g. 1.5 for 4:2:0
+    int nChromaRowsNum, nChromaRowsDen;
+};
+
+void Nv12Interleaved(const uint8_t* pSrc, int nSrcPitch, uint8_t* pDst, int nDstPitch, int nWidth, int nHeight, int iMatrix)
+{
+    Nv12ToColor24Host(pSrc, nSrcPitch, pDst, nDstPitch, nWidth, nHeight, iMatrix);
+}
+
+void Nv12Planar(const uint8_t* pSrc, int nSrcPitch, uint8_t* pDst, int nDstPitch, int nWidth, int nHeight, int iMatrix)
+{
+    Nv12ToColor24PlanarHost(pSrc, nSrcPitch, pDst, nDstPitch, nWidth, nHeight, 0, iMatrix);
+}
+
+void Nv16Interleaved(const uint8_t* pSrc, int nSrcPitch, uint8_t* pDst, int nDstPitch, int nWidth, int nHeight, int iMatrix)
+{
+    Nv16ToColor24Host(pSrc, nSrcPitch, pDst, nDstPitch, nWidth, nHeight, nHeight, iMatrix);
+}
+
+void Nv16Planar(const uint8_t* pSrc, int nSrcPitch, uint8_t* pDst, int nDstPitch, int nWidth, int nHeight, int iMatrix)
+{
+    Nv16ToColor24PlanarHost(pSrc, nSrcPitch, pDst, nDstPitch, nWidth, nHeight, 0, iMatrix);
+}
+
+void Yuv444Interleaved(const uint8_t* pSrc, int nSrcPitch, uint8_t* pDst, int nDstPitch, int nWidth, int nHeight, int iMatrix)
+{
+    YUV444ToColor24Host(pSrc, nSrcPitch, pDst, nDstPitch, nWidth, nHeight, iMatrix);
+}
+
+void Yuv444Planar(const uint8_t* pSrc, int nSrcPitch, uint8_t* pDst, int nDstPitch, int nWidth, int nHeight, int iMatrix)
+{
+    YUV444ToColor24PlanarHost(pSrc, nSrcPitch, pDst, nDstPitch, nWidth, nHeight, 0, iMatrix);
+}
+
+const Conversion g_aConversion[] = {
+    { "nv12", Nv12Interleaved, false, 3, 2 },
+    { "nv12_planar", Nv12Planar, true, 3, 2 },
+    { "nv16", Nv16Interleaved, false, 2, 1 },
+    { "nv16_planar", Nv16Planar, true, 2, 1 },
+    { "yuv444", Yuv444Interleaved, false, 3, 1 },
+    { "yuv444_planar", Yuv444Planar, true, 3, 1 },
+};
+
+const uint8_t SENTINEL = 0xa5;
+
+// Converts a random frame at the given SIMD level. Rows are padded so that writes beyond the row show up.
+std::vector<uint8_t> Convert(const Conversion& conversion, HostSimdLevel eLevel, int nWidth, int nHeight, int iMatrix, int* pnDstPitch)
+{
+    int nSrcPitch = nWidth + 5;
+    // 4:2:0 chroma of odd heights has one more row
+    int nSrcRows = nHeight + (nHeight * (conversion.nChromaRowsNum - conversion.nChromaRowsDen) + conversion.nChromaRowsDen - 1) / conversion.nChromaRowsDen;
+    std::vector<uint8_t> src((size_t)nSrcPitch * nSrcRows);
+    srand(nWidth * 131 + nHeight);
+    for (uint8_t& value : src)
+    {
+        value = (uint8_t)(rand() & 0xff);
+    }
+    *pnDstPitch = (conversion.bPlanarOutput ? nWidth : nWidth * 3) + 7;
+    std::vector<uint8_t> dst((size_t)*pnDstPitch * nHeight * (conversion.bPlanarOutput ? 3 : 1), SENTINEL);
+    SetHostSimdLevel(eLevel);
+    conversion.fnConvert(src.data(), nSrcPitch, dst.data(), *pnDstPitch, nWidth, nHeight, iMatrix);
+    SetHostSimdLevel(HostSimdLevel::NEON);
+    return dst;
+}
+
+class ColorSpaceHostSimdTest : public ::testing::TestWithParam<HostSimdLevel>
+{
+protected:
+    void SetUp() override
+    {
+        SetHostSimdLevel(GetParam());
+        bool bSupported = GetHostSimdLevel() == GetParam();
+        SetHostSimdLevel(HostSimdLevel::NEON);
+        if (!bSupported)
+        {
+            GTEST_SKIP() << "instruction set not supported by this CPU";
+        }
+    }
+};
+
+std::string LevelName(const ::testing::TestParamInfo<HostSimdLevel>& info)
+{
+    switch (info.param)
+    {
+    case HostSimdLevel::SSE41:
+        return "SSE41";
+    case HostSimdLevel::AVX2:
+        return "AVX2";
+    case HostSimdLevel::NEON:
+        return "NEON";
+    default:
+        return "SCALAR";
+    }
+}
+
+}  // namespace
+
+TEST(ColorSpaceHostTest, LevelIsLimitedBySetHostSimdLevel)
+{
+    SetHostSimdLevel(HostSimdLevel::SCALAR);
+    EXPECT_EQ(GetHostSimdLevel(), HostSimdLevel::SCALAR);
+    SetHostSimdLevel(HostSimdLevel::SSE41);
+    HostSimdLevel eLevel = GetHostSimdLevel();
+    EXPECT_TRUE(eLevel == HostSimdLevel::SCALAR || eLevel == HostSimdLevel::SSE41);
+    SetHostSimdLevel(HostSimdLevel::NEON);
+}
+
+// Widths cover rows shorter than one vector, exact multiples of 8 and every tail length
+TEST_P(ColorSpaceHostSimdTest, MatchesScalar)
+{
+    const int aWidth[] = { 1, 2, 3, 7, 8, 9, 15, 16, 17, 31, 33, 63, 64, 71 };
+    const int aHeight[] = { 1, 2, 5 };
+    const int aMatrix[] = { 1, 6, 9 };
+    for (const Conversion& conversion : g_aConversion)
+    {
+        for (int nWidth : aWidth)
+        {
+            for (int nHeight : aHeight)
+            {
+                for (int iMatrix : aMatrix)
+                {
+                    int nDstPitch = 0;
+                    std::vector<uint8_t> expected = Convert(conversion, HostSimdLevel::SCALAR, nWidth, nHeight, iMatrix, &nDstPitch);
+                    std::vector<uint8_t> actual = Convert(conversion, GetParam(), nWidth, nHeight, iMatrix, &nDstPitch);
+                    ASSERT_EQ(actual, expected) << conversion.name << " " << nWidth << "x" << nHeight << " matrix " << iMatrix;
+                }
+            }
+        }
+    }
+}
+
+TEST_P(ColorSpaceHostSimdTest, WritesOnlyTheRow)
+{
+    for (const Conversion& conversion : g_aConversion)
+    {
+        for (int nWidth : { 8, 13, 24 })
+        {
+            int nDstPitch = 0;
+            std::vector<uint8_t> dst = Convert(conversion, GetParam(), nWidth, 3, 1, &nDstPitch);
+            int nRowBytes = conversion.bPlanarOutput ? nWidth : nWidth * 3;
+            for (size_t nRow = 0; nRow < dst.size() / nDstPitch; nRow++)
+            {
+                for (int x = nRowBytes; x < nDstPitch; x++)
+                {
+                    ASSERT_EQ(dst[nRow * nDstPitch + x], SENTINEL) << conversion.name << " width " << nWidth << " row " << nRow << " byte " << x;
+                }
+            }
+        }
+    }
+}
+
+INSTANTIATE_TEST_SUITE_P(Levels, ColorSpaceHostSimdTest,
+    ::testing::Values(HostSimdLevel::SCALAR, HostSimdLevel::SSE41, HostSimdLevel::AVX2, HostSimdLevel::NEON), LevelName);
@@ -0,0 +1,225 @@
+/*
+ * This copyright notice applies to this file only
+ *
+ * SPDX-FileCopyrightText: Copyright (c) 2025 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#include "DecodedFramePool.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <set>
+#include <vector>
+
+namespace
+{
+
+struct Metadata
+{
+    int value = 0;
+};
+
+typedef DecodedFramePool<int, Metadata> Pool;
+
+// Host memory mode: the pool manages plain host buffers, as NvDecoder does for CPU output
+class HostFramePoolTest : public ::testing::Test
+{
+protected:
+    static constexpr size_t FRAME_BYTES = 64;
+
+    int AcquireWithBuffer()
+    {
+        bool bCreated = false;
+        int id = pool.Acquire(&bCreated);
+        if (!pool[id].pFrame)
+        {
+            buffers.emplace_back(FRAME_BYTES);
+            pool.SetBuffer(id, buffers.back().data(), FRAME_BYTES);
+            nAllocated++;
+        }
+        return id;
+    }
+
+    // Decodes nFrames frames in one decode call and returns their slots in fetch order
+    std::vector<int> DecodeAndFetch(int nFrames, bool bLock = false)
+    {
+        pool.BeginDecode();
+        for (int i = 0; i < nFrames; i++)
+        {
+            int id = AcquireWithBuffer();
+            pool[id].timestamp = timestamp++;
+            pool.Commit(id);
+        }
+        std::vector<int> ids;
+        for (int id; (id = pool.PopReady(bLock)) >= 0;)
+        {
+            ids.push_back(id);
+        }
+        return ids;
+    }
+
+    Pool pool;
+    std::vector<std::vector<uint8_t>> buffers;
+    int nAllocated = 0;
+    int64_t timestamp = 0;
+};
+
+TEST_F(HostFramePoolTest, ReadyFramesAreFetchedInCommitOrder)
+{
+    pool.BeginDecode();
+    int a = AcquireWithBuffer(), b = AcquireWithBuffer();
+    pool[a].timestamp = 10;
+    pool[b].timestamp = 20;
+    pool.Commit(b);
+    pool.Commit(a);
+    EXPECT_EQ(pool.ReadyCount(), 2u);
+    EXPECT_EQ(pool.PopReady(false), b);
+    EXPECT_EQ(pool.PopReady(false), a);
+    EXPECT_EQ(pool.PopReady(false), -1);
+    EXPECT_EQ(pool[a].state, FrameSlotState::RETURNED);
+}
+
+TEST_F(HostFramePoolTest, ReturnedSlotsAreReusedOnNextDecode)
+{
+    std::vector<int> first = DecodeAndFetch(4);
+    ASSERT_EQ(first.size(), 4u);
+    EXPECT_EQ(nAllocated, 4);
+    for (int i = 0; i < 10; i++)
+    {
+        std::vector<int> next = DecodeAndFetch(4);
+        ASSERT_EQ(next.size(), 4u);
+        EXPECT_EQ(std::set<int>(next.begin(), next.end()), std::set<int>(first.begin(), first.end()));
+    }
+    // steady state decodes neither create slots nor allocate buffers
+    EXPECT_EQ(pool.Size(), 4u);
+    EXPECT_EQ(nAllocated, 4);
+}
+
+TEST_F(HostFramePoolTest, AcquireResetsSlotMetadata)
+{
+    pool.BeginDecode();
+    int id = AcquireWithBuffer();
+    pool[id].timestamp = 42;
+    pool[id].metadata.value = 7;
+    pool.Commit(id);
+    ASSERT_EQ(pool.PopReady(false), id);
+    pool.BeginDecode();
+    EXPECT_EQ(pool.Acquire(), id);
+    EXPECT_EQ(pool[id].timestamp, 0);
+    EXPECT_EQ(pool[id].metadata.value, 0);
+    EXPECT_EQ(pool[id].state, FrameSlotState::WRITING);
+}
+
+TEST_F(HostFramePoolTest, LockedSlotsSurviveDecodesUntilUnlocked)
+{
+    std::vector<int> locked = DecodeAndFetch(2, true);
+    ASSERT_EQ(locked.size(), 2u);
+    EXPECT_EQ(pool.LockedCount(), 2u);
+
+    std::vector<int> returned = DecodeAndFetch(3);
+    for (int id : returned)
+    {
+        EXPECT_EQ(std::count(locked.begin(), locked.end(), id), 0);
+    }
+    EXPECT_EQ(pool.Size(), 5u);
+
+    EXPECT_TRUE(pool.Unlock(locked[0]));
+    EXPECT_FALSE(pool.Unlock(locked[0]));
+    EXPECT_FALSE(pool.Unlock(returned[0]));
+    EXPECT_EQ(pool.UnlockOldest(8), 1u);
+    EXPECT_EQ(pool.LockedCount(), 0u);
+
+    // all five slots are recycled by the next decode, none is created
+    DecodeAndFetch(5);
+    EXPECT_EQ(pool.Size(), 5u);
+    EXPECT_EQ(nAllocated, 5);
+}
+
+TEST_F(HostFramePoolTest, RecycleCallbackReportsFreedSlots)
+{
+    std::vector<int> recycled;
+    pool.SetRecycleCallback([&recycled](int id) { recycled.push_back(id); });
+    std::vector<int> ids = DecodeAndFetch(3);
+    EXPECT_TRUE(recycled.empty());
+    pool.BeginDecode();
+    EXPECT_EQ(std::set<int>(recycled.begin(), recycled.end()), std::set<int>(ids.begin(), ids.end()));
+
+    recycled.clear();
+    std::vector<int> locked = DecodeAndFetch(1, true);
+    pool.BeginDecode();
+    EXPECT_TRUE(recycled.empty());
+    pool.Unlock(locked[0]);
+    EXPECT_EQ(recycled, locked);
+}
+
+TEST_F(HostFramePoolTest, FindMapsBuffersToSlots)
+{
+    std::vector<int> ids = DecodeAndFetch(2);
+    for (int id : ids)
+    {
+        EXPECT_EQ(pool.Find(pool[id].pFrame), id);
+    }
+    uint8_t other = 0;
+    EXPECT_EQ(pool.Find(&other), -1);
+}
+
+TEST_F(HostFramePoolTest, ReleaseBuffersKeepsPendingFrames)
+{
+    std::vector<int> locked = DecodeAndFetch(1, true);
+    std::vector<int> returned = DecodeAndFetch(2);
+    // a frame committed but not fetched yet
+    int ready = AcquireWithBuffer();
+    pool.Commit(ready);
+
+    std::vector<uint8_t*> released;
+    pool.ReleaseBuffers([&released](uint8_t* pFrame) { released.push_back(pFrame); });
+    EXPECT_EQ(released.size(), 2u);
+    EXPECT_NE(pool[locked[0]].pFrame, nullptr);
+    EXPECT_NE(pool[ready].pFrame, nullptr);
+    for (uint8_t* pFrame : released)
+    {
+        EXPECT_EQ(pool.Find(pFrame), -1);
+    }
+
+    // a slot without a buffer gets a new one when it is acquired again
+    int nBefore = nAllocated;
+    DecodeAndFetch(3);
+    EXPECT_EQ(nAllocated, nBefore + 2);
+}
+
+TEST_F(HostFramePoolTest, CreateSlotPopulatesTheFreeList)
+{
+    for (int i = 0; i < 3; i++)
+    {
+        int id = pool.CreateSlot();
+        buffers.emplace_back(FRAME_BYTES);
+        pool.SetBuffer(id, buffers.back().data(), FRAME_BYTES);
+    }
+    EXPECT_EQ(pool.FreeCount(), 3u);
+    bool bCreated = true;
+    pool.Acquire(&bCreated);
+    EXPECT_FALSE(bCreated);
+    EXPECT_EQ(pool.FreeCount(), 2u);
+}
+
+} // namespace
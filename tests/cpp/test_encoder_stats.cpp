@@ -0,0 +1,154 @@
+/*
+ * This copyright notice applies to this file only
+ *
+ * SPDX-FileCopyrightText: Copyright (c) 2025 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#include "EncoderStats.hpp"
+
+#include <gtest/gtest.h>
+
+#include <stdint.h>
+
+namespace
+{
+
+NvEncFrameStats MakeStats(uint32_t nBytes, uint32_t qp = 0, double latencyMs = 0, NV_ENC_PIC_TYPE type = NV_ENC_PIC_TYPE_P)
+{
+    NvEncFrameStats stats;
+    stats.sizeInBytes = nBytes;
+    stats.frameAvgQP = qp;
+    stats.latencyMs = latencyMs;
+    stats.pictureType = type;
+    return stats;
+}
+
+// bin of the size histogram a single frame of nBytes falls in
+size_t SizeBin(uint32_t nBytes)
+{
+    EncoderStatsHistogram histogram;
+    histogram.Add(MakeStats(nBytes));
+    for (size_t i = 0; i < histogram.sizeHistogram.size(); i++)
+    {
+        if (histogram.sizeHistogram[i])
+        {
+            return i;
+        }
+    }
+    return histogram.sizeHistogram.size();
+}
+
+}  // namespace
+
+TEST(EncoderStatsTest, ZeroAndOneFallInTheFirstBin)
+{
+    EXPECT_EQ(SizeBin(0), 0u);
+    EXPECT_EQ(SizeBin(1), 0u);
+}
+
+TEST(EncoderStatsTest, PowersOfTwoStartABin)
+{
+    for (size_t k = 1; k < 32; k++)
+    {
+        EXPECT_EQ(SizeBin((uint32_t)1 << k), k) << "2^" << k;
+        EXPECT_EQ(SizeBin(((uint32_t)1 << k) - 1), k - 1) << "2^" << k << "-1";
+    }
+}
+
+TEST(EncoderStatsTest, LargeValuesFallInTheLastBin)
+{
+    const size_t lastBin = EncoderStatsHistogram::NUM_LOG2_BINS - 1;
+    EXPECT_EQ(SizeBin(UINT32_MAX), lastBin);
+
+    // latencies are binned in microseconds and exceed 32 bits
+    EncoderStatsHistogram histogram;
+    histogram.Add(MakeStats(0, 0, 1e9));
+    EXPECT_EQ(histogram.latencyHistogram[lastBin], 1u);
+    histogram.Add(MakeStats(0, 0, 1.0));
+    // 1000 us
+    EXPECT_EQ(histogram.latencyHistogram[9], 1u);
+}
+
+TEST(EncoderStatsTest, QPIsClampedToTheLastBin)
+{
+    EncoderStatsHistogram histogram;
+    histogram.Add(MakeStats(0, 51));
+    histogram.Add(MakeStats(0, 255));
+    histogram.Add(MakeStats(0, 1000));
+    EXPECT_EQ(histogram.qpHistogram[51], 1u);
+    EXPECT_EQ(histogram.qpHistogram[EncoderStatsHistogram::NUM_QP_BINS - 1], 2u);
+    // the average keeps the unclamped value
+    EXPECT_DOUBLE_EQ(histogram.GetAverageQP(), (51 + 255 + 1000) / 3.0);
+}
+
+TEST(EncoderStatsTest, Averages)
+{
+    EncoderStatsHistogram histogram;
+    EXPECT_EQ(histogram.GetAverageQP(), 0);
+    EXPECT_EQ(histogram.GetAverageSize(), 0);
+    EXPECT_EQ(histogram.GetAverageLatencyMs(), 0);
+
+    histogram.Add(MakeStats(1000, 20, 2.0, NV_ENC_PIC_TYPE_IDR));
+    histogram.Add(MakeStats(200, 30, 4.0));
+    histogram.Add(MakeStats(300, 31, 9.0));
+    EXPECT_EQ(histogram.numFrames, 3u);
+    EXPECT_EQ(histogram.totalBytes, 1500u);
+    EXPECT_DOUBLE_EQ(histogram.GetAverageQP(), 27.0);
+    EXPECT_DOUBLE_EQ(histogram.GetAverageSize(), 500.0);
+    EXPECT_DOUBLE_EQ(histogram.GetAverageLatencyMs(), 5.0);
+    EXPECT_DOUBLE_EQ(histogram.maxLatencyMs, 9.0);
+    EXPECT_EQ(histogram.framesByType[NV_ENC_PIC_TYPE_IDR], 1u);
+    EXPECT_EQ(histogram.framesByType[NV_ENC_PIC_TYPE_P], 2u);
+}
+
+TEST(EncoderStatsTest, ResetClearsEverything)
+{
+    EncoderStatsHistogram histogram;
+    histogram.Add(MakeStats(1000, 20, 2.0, NV_ENC_PIC_TYPE_IDR));
+    histogram.Add(MakeStats(UINT32_MAX, 300, 1e9));
+    histogram.Reset();
+
+    EXPECT_EQ(histogram.numFrames, 0u);
+    EXPECT_EQ(histogram.totalBytes, 0u);
+    EXPECT_EQ(histogram.totalQP, 0u);
+    EXPECT_EQ(histogram.totalLatencyMs, 0);
+    EXPECT_EQ(histogram.maxLatencyMs, 0);
+    EXPECT_TRUE(histogram.framesByType.empty());
+    ASSERT_EQ(histogram.qpHistogram.size(), EncoderStatsHistogram::NUM_QP_BINS);
+    ASSERT_EQ(histogram.sizeHistogram.size(), EncoderStatsHistogram::NUM_LOG2_BINS);
+    ASSERT_EQ(histogram.latencyHistogram.size(), EncoderStatsHistogram::NUM_LOG2_BINS);
+    for (uint64_t n : histogram.qpHistogram)
+    {
+        EXPECT_EQ(n, 0u);
+    }
+    for (size_t i = 0; i < EncoderStatsHistogram::NUM_LOG2_BINS; i++)
+    {
+        EXPECT_EQ(histogram.sizeHistogram[i], 0u);
+        EXPECT_EQ(histogram.latencyHistogram[i], 0u);
+    }
+
+    // still usable after the reset
+    histogram.Add(MakeStats(4, 10));
+    EXPECT_EQ(histogram.numFrames, 1u);
+    EXPECT_EQ(histogram.sizeHistogram[2], 1u);
+    EXPECT_EQ(histogram.qpHistogram[10], 1u);
+}
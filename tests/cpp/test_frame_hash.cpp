@@ -0,0 +1,132 @@
+/*
+ * This copyright notice applies to this file only
+ *
+ * SPDX-FileCopyrightText: Copyright (c) 2025 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#include "FrameHash.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <set>
+#include <stdlib.h>
+#include <vector>
+
+namespace
+{
+
+std::vector<uint8_t> RandomBytes(size_t n, unsigned int seed)
+{
+    std::vector<uint8_t> v(n);
+    srand(seed);
+    for (uint8_t& b : v)
+    {
+        b = (uint8_t)rand();
+    }
+    return v;
+}
+
+}  // namespace
+
+TEST(FrameHashTest, PitchDoesNotChangeTheHash)
+{
+    const int nRowBytes = 37, nRows = 9, nPitch = 64;
+    std::vector<uint8_t> packed = RandomBytes((size_t)nRowBytes * nRows, 1);
+    // padding holds different bytes than the rows
+    std::vector<uint8_t> pitched = RandomBytes((size_t)nPitch * nRows, 2);
+    for (int y = 0; y < nRows; y++)
+    {
+        std::copy(packed.begin() + (size_t)y * nRowBytes, packed.begin() + (size_t)(y + 1) * nRowBytes, pitched.begin() + (size_t)y * nPitch);
+    }
+    FrameHashPlane plane;
+    plane.pData = pitched.data();
+    plane.nPitch = nPitch;
+    plane.nRowBytes = nRowBytes;
+    plane.nRows = nRows;
+    EXPECT_EQ(ComputeFrameHashHost(&plane, 1), ComputeFrameHashHost(packed.data(), packed.size()));
+    EXPECT_EQ(GetFrameHashSize(&plane, 1), packed.size());
+}
+
+TEST(FrameHashTest, PlanesHashAsTheirConcatenation)
+{
+    // a 4:2:0 frame with three planes of odd row sizes
+    std::vector<uint8_t> packed = RandomBytes(35 * 11 + 2 * 18 * 6, 3);
+    FrameHashPlane aPlane[3];
+    aPlane[0].pData = packed.data();
+    aPlane[0].nPitch = aPlane[0].nRowBytes = 35;
+    aPlane[0].nRows = 11;
+    for (int i = 1; i < 3; i++)
+    {
+        aPlane[i].pData = packed.data() + 35 * 11 + (i - 1) * 18 * 6;
+        aPlane[i].nPitch = aPlane[i].nRowBytes = 18;
+        aPlane[i].nRows = 6;
+    }
+    EXPECT_EQ(ComputeFrameHashHost(aPlane, 3), ComputeFrameHashHost(packed.data(), packed.size()));
+    EXPECT_EQ(GetFrameHashSize(aPlane, 3), packed.size());
+}
+
+TEST(FrameHashTest, LengthIsPartOfTheHash)
+{
+    // the last word is zero padded, so trailing zero bytes are told apart by the length only
+    std::vector<uint8_t> zeros(24, 0);
+    std::set<uint64_t> hashes;
+    for (size_t n = 0; n <= zeros.size(); n++)
+    {
+        hashes.insert(ComputeFrameHashHost(zeros.data(), n));
+    }
+    EXPECT_EQ(hashes.size(), zeros.size() + 1);
+}
+
+TEST(FrameHashTest, MovedWordsChangeTheHash)
+{
+    std::vector<uint8_t> frame = RandomBytes(64, 4);
+    uint64_t hash = ComputeFrameHashHost(frame.data(), frame.size());
+    std::vector<uint8_t> swapped = frame;
+    std::swap_ranges(swapped.begin(), swapped.begin() + 8, swapped.begin() + 24);
+    EXPECT_NE(ComputeFrameHashHost(swapped.data(), swapped.size()), hash);
+}
+
+TEST(FrameHashTest, EveryBitFlipChangesTheHash)
+{
+    std::vector<uint8_t> frame = RandomBytes(61, 5);
+    std::set<uint64_t> hashes = { ComputeFrameHashHost(frame.data(), frame.size()) };
+    for (size_t i = 0; i < frame.size() * 8; i++)
+    {
+        frame[i / 8] ^= (uint8_t)(1 << (i % 8));
+        hashes.insert(ComputeFrameHashHost(frame.data(), frame.size()));
+        frame[i / 8] ^= (uint8_t)(1 << (i % 8));
+    }
+    EXPECT_EQ(hashes.size(), frame.size() * 8 + 1);
+}
+
+// DecodedFrame.hash values are compared with hashes stored by callers, so the definition must not change
+TEST(FrameHashTest, DefinitionIsStable)
+{
+    std::vector<uint8_t> frame(1000);
+    for (size_t i = 0; i < frame.size(); i++)
+    {
+        frame[i] = (uint8_t)(i * 7);
+    }
+    EXPECT_EQ(ComputeFrameHashHost(frame.data(), frame.size()), 0x6303b7894315927eULL);
+    EXPECT_EQ(ComputeFrameHashHost(frame.data(), 0), 0u);
+}
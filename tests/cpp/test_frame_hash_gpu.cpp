@@ -0,0 +1,195 @@
+/*
+ * This copyright notice applies to this file only
+ *
+ * SPDX-FileCopyrightText: Copyright (c) 2025 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#include "FrameHash.h"
+
+#include <cuda_runtime.h>
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <stdlib.h>
+#include <string>
+#include <vector>
+
+namespace
+{
+
+bool HasGpu()
+{
+    int nGpu = 0;
+    return cudaGetDeviceCount(&nGpu) == cudaSuccess && nGpu > 0;
+}
+
+struct PlaneLayout
+{
+    size_t nOffset;
+    size_t nPitch;
+    size_t nRowBytes;
+    int nRows;
+};
+
+struct HashCase
+{
+    const char* name;
+    std::vector<PlaneLayout> vPlane;
+};
+
+// Row sizes that are and are not multiples of the 8 byte word, words crossing rows and planes, and unaligned planes
+std::vector<HashCase> GetCases()
+{
+    return {
+        { "packed_aligned", { { 0, 256, 256, 64 } } },
+        { "nv12_pitched", { { 0, 256, 131, 75 }, { 256 * 76, 256, 131, 38 } } },
+        { "yuv444_unaligned", { { 3, 160, 101, 33 }, { 3 + 160 * 33, 160, 101, 33 }, { 5 + 160 * 66, 160, 101, 33 } } },
+        { "short_rows", { { 1, 8, 3, 17 }, { 1 + 8 * 17, 5, 5, 9 } } },
+        { "single_byte", { { 0, 1, 1, 1 } } },
+    };
+}
+
+size_t BufferSize(const HashCase& c)
+{
+    size_t n = 0;
+    for (const PlaneLayout& p : c.vPlane)
+    {
+        n = std::max(n, p.nOffset + p.nPitch * p.nRows);
+    }
+    return n;
+}
+
+std::vector<FrameHashPlane> Planes(const HashCase& c, const uint8_t* pBase)
+{
+    std::vector<FrameHashPlane> vPlane;
+    for (const PlaneLayout& p : c.vPlane)
+    {
+        FrameHashPlane plane;
+        plane.pData = pBase + p.nOffset;
+        plane.nPitch = p.nPitch;
+        plane.nRowBytes = p.nRowBytes;
+        plane.nRows = p.nRows;
+        vPlane.push_back(plane);
+    }
+    return vPlane;
+}
+
+class FrameHashGpuTest : public ::testing::TestWithParam<HashCase>
+{
+};
+
+}  // namespace
+
+TEST_P(FrameHashGpuTest, KernelMatchesHostHash)
+{
+    if (!HasGpu())
+    {
+        GTEST_SKIP() << "no CUDA device";
+    }
+    const HashCase& c = GetParam();
+    std::vector<uint8_t> frame(BufferSize(c));
+    srand(1);
+    for (uint8_t& b : frame)
+    {
+        b = (uint8_t)rand();
+    }
+    std::vector<FrameHashPlane> vHostPlane = Planes(c, frame.data());
+    uint64_t expected = ComputeFrameHashHost(vHostPlane.data(), (int)vHostPlane.size());
+
+    uint8_t* dpFrame = nullptr;
+    uint64_t* dpHash = nullptr;
+    ASSERT_EQ(cudaMalloc(&dpFrame, frame.size()), cudaSuccess);
+    ASSERT_EQ(cudaMalloc(&dpHash, sizeof(uint64_t)), cudaSuccess);
+    ASSERT_EQ(cudaMemcpy(dpFrame, frame.data(), frame.size(), cudaMemcpyHostToDevice), cudaSuccess);
+    std::vector<FrameHashPlane> vPlane = Planes(c, dpFrame);
+    ComputeFrameHash(vPlane.data(), (int)vPlane.size(), dpHash, nullptr);
+    uint64_t actual = 0;
+    ASSERT_EQ(cudaMemcpy(&actual, dpHash, sizeof(uint64_t), cudaMemcpyDeviceToHost), cudaSuccess);
+    cudaFree(dpFrame);
+    cudaFree(dpHash);
+    EXPECT_EQ(actual, expected);
+}
+
+// The fused copy gives the same hash and writes the rows of each plane, and only those, to the destination
+TEST_P(FrameHashGpuTest, CopyWithHashCopiesTheRows)
+{
+    if (!HasGpu())
+    {
+        GTEST_SKIP() << "no CUDA device";
+    }
+    const HashCase& c = GetParam();
+    std::vector<uint8_t> frame(BufferSize(c));
+    srand(2);
+    for (uint8_t& b : frame)
+    {
+        b = (uint8_t)rand();
+    }
+    std::vector<FrameHashPlane> vHostPlane = Planes(c, frame.data());
+    uint64_t expected = ComputeFrameHashHost(vHostPlane.data(), (int)vHostPlane.size());
+
+    // destination planes at another pitch and alignment
+    std::vector<FrameHashCopyPlane> vDst(c.vPlane.size());
+    std::vector<size_t> vDstOffset(c.vPlane.size());
+    size_t nDstSize = 7;
+    for (size_t i = 0; i < c.vPlane.size(); i++)
+    {
+        vDstOffset[i] = nDstSize;
+        vDst[i].nPitch = c.vPlane[i].nRowBytes + 9;
+        nDstSize += vDst[i].nPitch * c.vPlane[i].nRows;
+    }
+    uint8_t *dpFrame = nullptr, *dpDst = nullptr;
+    uint64_t* dpHash = nullptr;
+    ASSERT_EQ(cudaMalloc(&dpFrame, frame.size()), cudaSuccess);
+    ASSERT_EQ(cudaMalloc(&dpDst, nDstSize), cudaSuccess);
+    ASSERT_EQ(cudaMalloc(&dpHash, sizeof(uint64_t)), cudaSuccess);
+    ASSERT_EQ(cudaMemcpy(dpFrame, frame.data(), frame.size(), cudaMemcpyHostToDevice), cudaSuccess);
+    ASSERT_EQ(cudaMemset(dpDst, 0xa5, nDstSize), cudaSuccess);
+    for (size_t i = 0; i < vDst.size(); i++)
+    {
+        vDst[i].pData = dpDst + vDstOffset[i];
+    }
+    std::vector<FrameHashPlane> vPlane = Planes(c, dpFrame);
+    CopyFrameWithHash(vPlane.data(), vDst.data(), (int)vPlane.size(), dpHash, nullptr);
+    uint64_t actual = 0;
+    std::vector<uint8_t> dst(nDstSize);
+    ASSERT_EQ(cudaMemcpy(&actual, dpHash, sizeof(uint64_t), cudaMemcpyDeviceToHost), cudaSuccess);
+    ASSERT_EQ(cudaMemcpy(dst.data(), dpDst, nDstSize, cudaMemcpyDeviceToHost), cudaSuccess);
+    cudaFree(dpFrame);
+    cudaFree(dpDst);
+    cudaFree(dpHash);
+    EXPECT_EQ(actual, expected);
+
+    std::vector<uint8_t> expectedDst(nDstSize, 0xa5);
+    for (size_t i = 0; i < c.vPlane.size(); i++)
+    {
+        const PlaneLayout& p = c.vPlane[i];
+        for (int y = 0; y < p.nRows; y++)
+        {
+            const uint8_t* pRow = frame.data() + p.nOffset + p.nPitch * y;
+            std::copy(pRow, pRow + p.nRowBytes, expectedDst.begin() + vDstOffset[i] + vDst[i].nPitch * y);
+        }
+    }
+    EXPECT_EQ(dst, expectedDst);
+}
+
+INSTANTIATE_TEST_SUITE_P(Layouts, FrameHashGpuTest, ::testing::ValuesIn(GetCases()),
+    [](const ::testing::TestParamInfo<HashCase>& info) { return std::string(info.param.name); });
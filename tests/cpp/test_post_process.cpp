@@ -0,0 +1,517 @@
+/*
+ * This copyright notice applies to this file only
+ *
+ * SPDX-FileCopyrightText: Copyright (c) 2025 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#include "PostProcess.h"
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+namespace
+{
+
+// NV12 frame with a gradient luma and a chroma that changes every 2x2 block
+struct Nv12Frame
+{
+    int nWidth, nHeight;
+    std::vector<uint8_t> data;
+
+    Nv12Frame(int width, int height) : nWidth(width), nHeight(height), data((size_t)width * height * 3 / 2)
+    {
+        for (int y = 0; y < nHeight; y++)
+        {
+            for (int x = 0; x < nWidth; x++)
+            {
+                data[(size_t)y * nWidth + x] = (uint8_t)(16 + (x * 3 + y * 5) % 220);
+            }
+        }
+        for (int y = 0; y < nHeight / 2; y++)
+        {
+            for (int x = 0; x < nWidth; x++)
+            {
+                data[(size_t)(nHeight + y) * nWidth + x] = (uint8_t)(64 + (x * 7 + y * 11) % 128);
+            }
+        }
+    }
+
+    PostProcessSource Source() const
+    {
+        PostProcessSource src;
+        src.pFrame = data.data();
+        src.nPitch = nWidth;
+        src.nWidth = nWidth;
+        src.nHeight = nHeight;
+        src.nChromaRow = nHeight;
+        return src;
+    }
+};
+
+PostProcessColorimetry Bt709Limited()
+{
+    return ResolvePostProcessColorimetry(PostProcessColorimetry(), 1, false, 1, 0.0f);
+}
+
+template <typename T>
+std::vector<T> Convert(const PostProcessSource& src, const PostProcessParams& params, const PostProcessColorimetry& colorimetry)
+{
+    PostProcessParams resolved;
+    EXPECT_TRUE(ResolvePostProcessParams(params, src.nWidth, src.nHeight, &resolved));
+    std::vector<T> out((size_t)resolved.nWidth * resolved.nHeight * 3);
+    YuvToRgbPostProcessHost(src, (uint8_t*)out.data(), resolved, colorimetry);
+    return out;
+}
+
+}  // namespace
+
+TEST(PostProcessHostTest, ResolveFillsRoiAndTargetSize)
+{
+    PostProcessParams params;
+    PostProcessParams resolved;
+    ASSERT_TRUE(ResolvePostProcessParams(params, 64, 32, &resolved));
+    EXPECT_EQ(resolved.roi.width, 64);
+    EXPECT_EQ(resolved.roi.height, 32);
+    EXPECT_EQ(resolved.nWidth, 64);
+    EXPECT_EQ(resolved.nHeight, 32);
+
+    params.roi = { 8, 4, 16, 8 };
+    ASSERT_TRUE(ResolvePostProcessParams(params, 64, 32, &resolved));
+    EXPECT_EQ(resolved.nWidth, 16);
+    EXPECT_EQ(resolved.nHeight, 8);
+
+    params.roi = { 56, 0, 16, 8 };
+    EXPECT_FALSE(ResolvePostProcessParams(params, 64, 32, &resolved));
+}
+
+TEST(PostProcessHostTest, GrayConvertsToGray)
+{
+    Nv12Frame frame(32, 16);
+    std::fill(frame.data.begin(), frame.data.begin() + 32 * 16, 126);
+    std::fill(frame.data.begin() + 32 * 16, frame.data.end(), 128);
+    PostProcessParams params;
+    params.nWidth = 13;
+    params.nHeight = 7;
+    // (126 - 16) * 255 / 219 = 128.08, whatever the interpolation
+    for (PostProcessInterpolation eInterpolation : { PostProcessInterpolation::NEAREST, PostProcessInterpolation::BILINEAR })
+    {
+        params.eInterpolation = eInterpolation;
+        for (uint8_t value : Convert<uint8_t>(frame.Source(), params, Bt709Limited()))
+        {
+            ASSERT_EQ(value, 128);
+        }
+    }
+}
+
+TEST(PostProcessHostTest, CropAtNativeScaleMatchesFullFrame)
+{
+    Nv12Frame frame(48, 32);
+    PostProcessParams params;
+    for (PostProcessInterpolation eInterpolation : { PostProcessInterpolation::NEAREST, PostProcessInterpolation::BILINEAR })
+    {
+        params.eInterpolation = eInterpolation;
+        params.roi = PostProcessRoi();
+        std::vector<uint8_t> full = Convert<uint8_t>(frame.Source(), params, Bt709Limited());
+        // even offsets keep the chroma siting of the full frame
+        params.roi = { 10, 6, 20, 14 };
+        std::vector<uint8_t> crop = Convert<uint8_t>(frame.Source(), params, Bt709Limited());
+        for (int y = 0; y < params.roi.height; y++)
+        {
+            for (int x = 0; x < params.roi.width * 3; x++)
+            {
+                ASSERT_EQ(crop[(size_t)y * params.roi.width * 3 + x], full[(size_t)(y + params.roi.y) * 48 * 3 + params.roi.x * 3 + x])
+                    << "x " << x / 3 << " y " << y;
+            }
+        }
+    }
+}
+
+TEST(PostProcessHostTest, PlanarHoldsTheInterleavedChannels)
+{
+    Nv12Frame frame(24, 16);
+    PostProcessParams params;
+    params.nWidth = 17;
+    params.nHeight = 9;
+    std::vector<uint8_t> hwc = Convert<uint8_t>(frame.Source(), params, Bt709Limited());
+    params.eLayout = PostProcessLayout::CHW;
+    std::vector<uint8_t> chw = Convert<uint8_t>(frame.Source(), params, Bt709Limited());
+    size_t nPixels = 17 * 9;
+    for (size_t i = 0; i < nPixels; i++)
+    {
+        for (size_t c = 0; c < 3; c++)
+        {
+            ASSERT_EQ(chw[c * nPixels + i], hwc[i * 3 + c]);
+        }
+    }
+}
+
+TEST(PostProcessHostTest, NormalizationAppliesScaleMeanAndStd)
+{
+    Nv12Frame frame(32, 16);
+    PostProcessParams params;
+    params.nWidth = 20;
+    params.nHeight = 10;
+    params.eDataType = PostProcessDataType::FLOAT32;
+    std::vector<float> rgb = Convert<float>(frame.Source(), params, Bt709Limited());
+
+    params.scale = 1.0f / 255.0f;
+    params.mean[0] = 0.485f; params.mean[1] = 0.456f; params.mean[2] = 0.406f;
+    params.std[0] = 0.229f; params.std[1] = 0.224f; params.std[2] = 0.225f;
+    std::vector<float> normalized = Convert<float>(frame.Source(), params, Bt709Limited());
+    for (size_t i = 0; i < rgb.size(); i++)
+    {
+        int c = (int)(i % 3);
+        ASSERT_NEAR(normalized[i], (rgb[i] / 255.0f - params.mean[c]) / params.std[c], 1e-5f);
+    }
+}
+
+TEST(PostProcessHostTest, FloatToHalfRoundsToNearestEven)
+{
+    EXPECT_EQ(PostProcessFloatToHalf(0.0f), 0x0000);
+    EXPECT_EQ(PostProcessFloatToHalf(-0.0f), 0x8000);
+    EXPECT_EQ(PostProcessFloatToHalf(1.0f), 0x3c00);
+    EXPECT_EQ(PostProcessFloatToHalf(-2.0f), 0xc000);
+    EXPECT_EQ(PostProcessFloatToHalf(0.5f), 0x3800);
+    EXPECT_EQ(PostProcessFloatToHalf(65504.0f), 0x7bff);
+    // halfway between 65504 and 65536 rounds to even, which overflows
+    EXPECT_EQ(PostProcessFloatToHalf(65520.0f), 0x7c00);
+    // 1 + 2^-11 is halfway between 1 and the next half, the even neighbour is 1
+    EXPECT_EQ(PostProcessFloatToHalf(1.0f + 1.0f / 2048), 0x3c00);
+    EXPECT_EQ(PostProcessFloatToHalf(1.0f + 3.0f / 2048), 0x3c02);
+    // smallest subnormal half
+    EXPECT_EQ(PostProcessFloatToHalf(5.9604645e-8f), 0x0001);
+    EXPECT_EQ(PostProcessFloatToHalf(2.0e-8f), 0x0000);
+}
+
+namespace
+{
+
+// 4:2:0 frame of a single color, with 1 or 2 byte samples
+struct UniformFrame
+{
+    int nBytesPerSample;
+    std::vector<uint8_t> data;
+
+    UniformFrame(int bytesPerSample, int y, int u, int v) : nBytesPerSample(bytesPerSample), data((size_t)4 * 4 * 3 / 2 * bytesPerSample)
+    {
+        for (int i = 0; i < 4 * 4 * 3 / 2; i++)
+        {
+            int value = i < 16 ? y : (i % 2 ? v : u);
+            memcpy(&data[(size_t)i * nBytesPerSample], &value, nBytesPerSample);
+        }
+    }
+
+    PostProcessSource Source() const
+    {
+        PostProcessSource src;
+        src.pFrame = data.data();
+        src.nPitch = 4 * nBytesPerSample;
+        src.nWidth = 4;
+        src.nHeight = 4;
+        src.nChromaRow = 4;
+        src.nBytesPerSample = nBytesPerSample;
+        return src;
+    }
+
+    std::vector<uint8_t> Rgb(const PostProcessColorimetry& colorimetry) const
+    {
+        return Convert<uint8_t>(Source(), PostProcessParams(), colorimetry);
+    }
+};
+
+// 16 bit sample of a 10 bit limited range BT.2020 gray pixel at nits cd/m2 encoded with PQ
+int PqGrayLuma(float nits)
+{
+    return (int)floorf(64.0f + PostProcessLinearToPq(nits) * 876.0f + 0.5f) << 6;
+}
+
+PostProcessColorimetry Bt2020Pq(bool bToneMap)
+{
+    PostProcessColorimetry colorimetry;
+    colorimetry.bToneMap = bToneMap;
+    return ResolvePostProcessColorimetry(colorimetry, 9, false, 16, 1000.0f);
+}
+
+}  // namespace
+
+TEST(PostProcessColorimetryTest, ResolveTakesAutoFieldsFromTheStream)
+{
+    PostProcessColorimetry resolved = ResolvePostProcessColorimetry(PostProcessColorimetry(), 9, true, 16, 4000.0f);
+    EXPECT_EQ(resolved.iMatrix, 9);
+    EXPECT_EQ(resolved.eRange, PostProcessColorRange::FULL);
+    EXPECT_EQ(resolved.eTransfer, PostProcessTransfer::PQ);
+    EXPECT_EQ(resolved.peakLuminance, 4000.0f);
+    EXPECT_EQ(resolved.targetLuminance, 100.0f);
+
+    resolved = ResolvePostProcessColorimetry(PostProcessColorimetry(), 1, false, 18, 0.0f);
+    EXPECT_EQ(resolved.eRange, PostProcessColorRange::LIMITED);
+    EXPECT_EQ(resolved.eTransfer, PostProcessTransfer::HLG);
+    // without HDR SEI metadata the peak defaults to 1000 cd/m2
+    EXPECT_EQ(resolved.peakLuminance, 1000.0f);
+
+    EXPECT_EQ(ResolvePostProcessColorimetry(PostProcessColorimetry(), 1, false, 1, 0.0f).eTransfer, PostProcessTransfer::SDR);
+}
+
+TEST(PostProcessColorimetryTest, ResolveKeepsExplicitFields)
+{
+    PostProcessColorimetry colorimetry;
+    colorimetry.iMatrix = 6;
+    colorimetry.eRange = PostProcessColorRange::LIMITED;
+    colorimetry.eTransfer = PostProcessTransfer::SDR;
+    colorimetry.peakLuminance = 600.0f;
+    colorimetry.targetLuminance = 203.0f;
+    PostProcessColorimetry resolved = ResolvePostProcessColorimetry(colorimetry, 9, true, 16, 4000.0f);
+    EXPECT_EQ(resolved.iMatrix, 6);
+    EXPECT_EQ(resolved.eRange, PostProcessColorRange::LIMITED);
+    EXPECT_EQ(resolved.eTransfer, PostProcessTransfer::SDR);
+    EXPECT_EQ(resolved.peakLuminance, 600.0f);
+    EXPECT_EQ(resolved.targetLuminance, 203.0f);
+}
+
+TEST(PostProcessColorimetryTest, OnlyFullRangeAndToneMappedHdrNeedTheFullConversion)
+{
+    EXPECT_FALSE(Bt709Limited().NeedsFullConversion());
+    EXPECT_TRUE(ResolvePostProcessColorimetry(PostProcessColorimetry(), 1, true, 1, 0.0f).NeedsFullConversion());
+    EXPECT_FALSE(Bt2020Pq(false).NeedsFullConversion());
+    EXPECT_TRUE(Bt2020Pq(true).NeedsFullConversion());
+}
+
+TEST(PostProcessColorimetryTest, RangeSelectsBlackAndWhiteLevels)
+{
+    PostProcessColorimetry full = ResolvePostProcessColorimetry(PostProcessColorimetry(), 1, true, 1, 0.0f);
+    EXPECT_EQ(UniformFrame(1, 16, 128, 128).Rgb(Bt709Limited())[0], 0);
+    EXPECT_EQ(UniformFrame(1, 235, 128, 128).Rgb(Bt709Limited())[0], 255);
+    EXPECT_EQ(UniformFrame(1, 16, 128, 128).Rgb(full)[0], 16);
+    EXPECT_EQ(UniformFrame(1, 235, 128, 128).Rgb(full)[0], 235);
+    EXPECT_EQ(UniformFrame(1, 255, 128, 128).Rgb(full)[0], 255);
+    // 16 bit samples scale the black level by 256
+    EXPECT_EQ(UniformFrame(2, 16 << 8, 128 << 8, 128 << 8).Rgb(Bt709Limited())[1], 0);
+    EXPECT_EQ(UniformFrame(2, 16 << 8, 128 << 8, 128 << 8).Rgb(full)[1], 16);
+}
+
+TEST(PostProcessColorimetryTest, MatrixSelectsCoefficients)
+{
+    // full range R = Y + 2 * (1 - Kr) * (V - 128)
+    UniformFrame frame(1, 128, 128, 178);
+    EXPECT_EQ(frame.Rgb(ResolvePostProcessColorimetry(PostProcessColorimetry(), 1, true, 1, 0.0f))[0], 207);
+    EXPECT_EQ(frame.Rgb(ResolvePostProcessColorimetry(PostProcessColorimetry(), 6, true, 1, 0.0f))[0], 198);
+}
+
+TEST(PostProcessColorimetryTest, PqTransferRoundTrips)
+{
+    EXPECT_NEAR(PostProcessPqToLinear(0.0f), 0.0f, 1e-6f);
+    EXPECT_NEAR(PostProcessPqToLinear(1.0f), 10000.0f, 1e-1f);
+    // reference code values of ST 2084
+    EXPECT_NEAR(PostProcessLinearToPq(100.0f), 0.5081f, 1e-4f);
+    EXPECT_NEAR(PostProcessLinearToPq(1000.0f), 0.7518f, 1e-4f);
+    for (float nits : { 0.1f, 1.0f, 10.0f, 100.0f, 203.0f, 1000.0f, 4000.0f })
+    {
+        EXPECT_NEAR(PostProcessPqToLinear(PostProcessLinearToPq(nits)), nits, nits * 1e-3f);
+    }
+}
+
+TEST(PostProcessColorimetryTest, ToneMapKeepsGrayMonotonicAndNeutral)
+{
+    for (PostProcessTransfer eTransfer : { PostProcessTransfer::PQ, PostProcessTransfer::HLG })
+    {
+        PostProcessColorimetry colorimetry = Bt2020Pq(true);
+        colorimetry.eTransfer = eTransfer;
+        PostProcessColorMatrix m = GetPostProcessColorMatrix(colorimetry, 2);
+        float last = -1.0f;
+        for (int i = 0; i <= 64; i++)
+        {
+            float rgb[3] = { i / 64.0f, i / 64.0f, i / 64.0f };
+            PostProcessToneMap(rgb, m);
+            ASSERT_NEAR(rgb[0], rgb[1], 1e-3f) << "code " << i / 64.0f;
+            ASSERT_NEAR(rgb[2], rgb[1], 1e-3f) << "code " << i / 64.0f;
+            ASSERT_GE(rgb[1], last - 1e-5f) << "code " << i / 64.0f;
+            last = rgb[1];
+        }
+        EXPECT_NEAR(last, 1.0f, 1e-3f);
+    }
+}
+
+TEST(PostProcessColorimetryTest, ToneMapBlackIsBlack)
+{
+    PostProcessColorMatrix m = GetPostProcessColorMatrix(Bt2020Pq(true), 2);
+    float rgb[3] = { 0.0f, 0.0f, 0.0f };
+    PostProcessToneMap(rgb, m);
+    EXPECT_EQ(rgb[0], 0.0f);
+    EXPECT_EQ(rgb[1], 0.0f);
+    EXPECT_EQ(rgb[2], 0.0f);
+}
+
+TEST(PostProcessColorimetryTest, PqToneMapMapsPeakToWhiteAndKeepsShadows)
+{
+    // at the peak luminance of the content the EETF reaches SDR white
+    EXPECT_EQ(UniformFrame(2, PqGrayLuma(1000.0f), 512 << 6, 512 << 6).Rgb(Bt2020Pq(true))[1], 255);
+    // below the knee the EETF is the identity: 10 cd/m2 is 10% of SDR white, 255 * 0.1^(1 / 2.4) = 97.7
+    EXPECT_NEAR(UniformFrame(2, PqGrayLuma(10.0f), 512 << 6, 512 << 6).Rgb(Bt2020Pq(true))[1], 98, 1);
+    // without tone mapping the PQ code values are passed through: 255 * 0.7518 = 191.7
+    EXPECT_NEAR(UniformFrame(2, PqGrayLuma(1000.0f), 512 << 6, 512 << 6).Rgb(Bt2020Pq(false))[1], 192, 1);
+}
+
+TEST(PostProcessColorimetryTest, HigherTargetLuminanceDarkensTheOutput)
+{
+    UniformFrame frame(2, PqGrayLuma(100.0f), 512 << 6, 512 << 6);
+    PostProcessColorimetry colorimetry = Bt2020Pq(true);
+    uint8_t sdr = frame.Rgb(colorimetry)[1];
+    colorimetry.targetLuminance = 203.0f;
+    EXPECT_LT(frame.Rgb(colorimetry)[1], sdr);
+}
+
+namespace
+{
+
+PostProcessOutput MakeOutput(PostProcessFormat eFormat, int nWidth, int nHeight)
+{
+    PostProcessOutput output;
+    output.eFormat = eFormat;
+    output.params.nWidth = nWidth;
+    output.params.nHeight = nHeight;
+    return output;
+}
+
+std::vector<uint8_t> Ladder(const PostProcessSource& src, const PostProcessOutput& output)
+{
+    PostProcessOutput resolved;
+    EXPECT_TRUE(ResolvePostProcessOutput(output, src.nWidth, src.nHeight, &resolved));
+    std::vector<uint8_t> out(GetPostProcessOutputSize(resolved));
+    uint8_t* pDst = out.data();
+    YuvToLadderHost(src, &resolved, &pDst, 1, Bt709Limited());
+    return out;
+}
+
+}  // namespace
+
+TEST(PostProcessLadderTest, ResolveChecksSizeAndSetsLayout)
+{
+    PostProcessOutput resolved;
+    EXPECT_FALSE(ResolvePostProcessOutput(MakeOutput(PostProcessFormat::RGB, 0, 32), 64, 32, &resolved));
+    // NV12 and P016 need an even size for the 2x2 chroma blocks
+    EXPECT_FALSE(ResolvePostProcessOutput(MakeOutput(PostProcessFormat::NV12, 33, 16), 64, 32, &resolved));
+    EXPECT_FALSE(ResolvePostProcessOutput(MakeOutput(PostProcessFormat::P016, 32, 17), 64, 32, &resolved));
+    EXPECT_TRUE(ResolvePostProcessOutput(MakeOutput(PostProcessFormat::RGB, 33, 17), 64, 32, &resolved));
+    EXPECT_EQ(resolved.params.eLayout, PostProcessLayout::HWC);
+    EXPECT_EQ(resolved.params.roi.width, 64);
+    EXPECT_TRUE(ResolvePostProcessOutput(MakeOutput(PostProcessFormat::RGBP, 32, 16), 64, 32, &resolved));
+    EXPECT_EQ(resolved.params.eLayout, PostProcessLayout::CHW);
+
+    PostProcessOutput output = MakeOutput(PostProcessFormat::NV12, 16, 8);
+    output.params.roi = { 56, 0, 16, 8 };
+    EXPECT_FALSE(ResolvePostProcessOutput(output, 64, 32, &resolved));
+}
+
+TEST(PostProcessLadderTest, OutputSizeFollowsFormat)
+{
+    EXPECT_EQ(GetPostProcessOutputSize(MakeOutput(PostProcessFormat::NV12, 64, 32)), 64u * 32 * 3 / 2);
+    EXPECT_EQ(GetPostProcessOutputSize(MakeOutput(PostProcessFormat::P016, 64, 32)), 64u * 32 * 3);
+    EXPECT_EQ(GetPostProcessOutputSize(MakeOutput(PostProcessFormat::RGB, 64, 32)), 64u * 32 * 3);
+    PostProcessOutput output = MakeOutput(PostProcessFormat::RGBP, 64, 32);
+    output.params.eDataType = PostProcessDataType::FLOAT32;
+    EXPECT_EQ(GetPostProcessOutputSize(output), 64u * 32 * 3 * 4);
+}
+
+TEST(PostProcessLadderTest, Nv12AtNativeSizeCopiesTheFrame)
+{
+    Nv12Frame frame(48, 32);
+    for (PostProcessInterpolation eInterpolation : { PostProcessInterpolation::NEAREST, PostProcessInterpolation::BILINEAR })
+    {
+        PostProcessOutput output = MakeOutput(PostProcessFormat::NV12, 48, 32);
+        output.params.eInterpolation = eInterpolation;
+        EXPECT_EQ(Ladder(frame.Source(), output), frame.data);
+    }
+}
+
+TEST(PostProcessLadderTest, Nv12CropAtNativeScaleCopiesTheRegion)
+{
+    Nv12Frame frame(48, 32);
+    PostProcessOutput output = MakeOutput(PostProcessFormat::NV12, 20, 14);
+    output.params.roi = { 10, 6, 20, 14 };
+    output.params.eInterpolation = PostProcessInterpolation::NEAREST;
+    std::vector<uint8_t> crop = Ladder(frame.Source(), output);
+    for (int y = 0; y < 14; y++)
+    {
+        for (int x = 0; x < 20; x++)
+        {
+            ASSERT_EQ(crop[(size_t)y * 20 + x], frame.data[(size_t)(y + 6) * 48 + x + 10]) << "luma x " << x << " y " << y;
+        }
+    }
+    for (int y = 0; y < 7; y++)
+    {
+        for (int x = 0; x < 20; x++)
+        {
+            ASSERT_EQ(crop[(size_t)(14 + y) * 20 + x], frame.data[(size_t)(32 + y + 3) * 48 + x + 10]) << "chroma x " << x << " y " << y;
+        }
+    }
+}
+
+TEST(PostProcessLadderTest, P016RescalesTo8Bit)
+{
+    Nv12Frame frame(32, 16);
+    std::vector<uint8_t> p016 = Ladder(frame.Source(), MakeOutput(PostProcessFormat::P016, 32, 16));
+    const uint16_t* pWide = (const uint16_t*)p016.data();
+    for (size_t i = 0; i < frame.data.size(); i++)
+    {
+        ASSERT_EQ(pWide[i], frame.data[i] * 257) << "sample " << i;
+    }
+
+    // and back: a P016 source converted to NV12 gives the 8 bit samples again
+    PostProcessSource src = frame.Source();
+    src.pFrame = p016.data();
+    src.nPitch = 32 * 2;
+    src.nBytesPerSample = 2;
+    EXPECT_EQ(Ladder(src, MakeOutput(PostProcessFormat::NV12, 32, 16)), frame.data);
+}
+
+TEST(PostProcessLadderTest, RgbOutputsMatchTheSingleOutputPath)
+{
+    Nv12Frame frame(64, 32);
+    PostProcessOutput outputs[3] = {
+        MakeOutput(PostProcessFormat::RGB, 40, 20),
+        MakeOutput(PostProcessFormat::RGBP, 23, 11),
+        MakeOutput(PostProcessFormat::NV12, 32, 16),
+    };
+    outputs[1].params.roi = { 4, 2, 50, 26 };
+    outputs[1].params.eDataType = PostProcessDataType::FLOAT32;
+    PostProcessOutput resolved[3];
+    std::vector<uint8_t> out[3];
+    uint8_t* apDst[3];
+    for (int i = 0; i < 3; i++)
+    {
+        ASSERT_TRUE(ResolvePostProcessOutput(outputs[i], 64, 32, &resolved[i]));
+        out[i].resize(GetPostProcessOutputSize(resolved[i]));
+        apDst[i] = out[i].data();
+    }
+    YuvToLadderHost(frame.Source(), resolved, apDst, 3, Bt709Limited());
+
+    // the RGB entries of a ladder are the same conversions as YuvToRgbPostProcessHost()
+    std::vector<uint8_t> rgb = Convert<uint8_t>(frame.Source(), outputs[0].params, Bt709Limited());
+    EXPECT_EQ(out[0], rgb);
+    PostProcessParams params = outputs[1].params;
+    params.eLayout = PostProcessLayout::CHW;
+    std::vector<float> rgbp = Convert<float>(frame.Source(), params, Bt709Limited());
+    ASSERT_EQ(out[1].size(), rgbp.size() * sizeof(float));
+    EXPECT_EQ(memcmp(out[1].data(), rgbp.data(), out[1].size()), 0);
+    EXPECT_EQ(out[2], Ladder(frame.Source(), outputs[2]));
+}
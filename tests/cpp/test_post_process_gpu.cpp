@@ -0,0 +1,292 @@
+/*
+ * This copyright notice applies to this file only
+ *
+ * SPDX-FileCopyrightText: Copyright (c) 2025 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#include "PostProcess.h"
+
+#include <cuda_runtime.h>
+#include <gtest/gtest.h>
+
+#include <math.h>
+#include <stdlib.h>
+#include <string>
+#include <vector>
+
+namespace
+{
+
+struct PostProcessCase
+{
+    const char* name;
+    PostProcessChroma eChroma;
+    int nBytesPerSample;
+    PostProcessParams params;
+    PostProcessColorimetry colorimetry;
+};
+
+bool HasGpu()
+{
+    int nGpu = 0;
+    return cudaGetDeviceCount(&nGpu) == cudaSuccess && nGpu > 0;
+}
+
+// Frame of nWidth x nHeight with pseudo random samples, chroma planes follow the luma rows
+std::vector<uint8_t> MakeFrame(PostProcessChroma eChroma, int nBytesPerSample, int nWidth, int nHeight, int* pnChromaRows)
+{
+    *pnChromaRows = eChroma == PostProcessChroma::YUV420 ? (nHeight + 1) / 2 : (eChroma == PostProcessChroma::YUV422 ? nHeight : 2 * nHeight);
+    std::vector<uint8_t> frame((size_t)nWidth * nBytesPerSample * (nHeight + *pnChromaRows));
+    srand(1);
+    for (uint8_t& value : frame)
+    {
+        value = (uint8_t)(rand() & 0xff);
+    }
+    return frame;
+}
+
+PostProcessCase MakeCase(const char* name, PostProcessChroma eChroma, int nBytesPerSample)
+{
+    PostProcessCase c = { name, eChroma, nBytesPerSample, PostProcessParams(), PostProcessColorimetry() };
+    return c;
+}
+
+std::vector<PostProcessCase> GetCases()
+{
+    std::vector<PostProcessCase> cases;
+    cases.push_back(MakeCase("nv12_native", PostProcessChroma::YUV420, 1));
+
+    PostProcessCase c = MakeCase("nv12_crop_resize_nearest", PostProcessChroma::YUV420, 1);
+    c.params.roi = { 6, 4, 90, 50 };
+    c.params.nWidth = 64;
+    c.params.nHeight = 37;
+    c.params.eInterpolation = PostProcessInterpolation::NEAREST;
+    cases.push_back(c);
+
+    c = MakeCase("nv12_upscale_fp32_chw", PostProcessChroma::YUV420, 1);
+    c.params.nWidth = 211;
+    c.params.nHeight = 97;
+    c.params.scale = 1.0f / 255.0f;
+    c.params.mean[0] = 0.485f; c.params.mean[1] = 0.456f; c.params.mean[2] = 0.406f;
+    c.params.std[0] = 0.229f; c.params.std[1] = 0.224f; c.params.std[2] = 0.225f;
+    c.params.eDataType = PostProcessDataType::FLOAT32;
+    c.params.eLayout = PostProcessLayout::CHW;
+    cases.push_back(c);
+
+    c = MakeCase("p016_fp16", PostProcessChroma::YUV420, 2);
+    c.params.nWidth = 80;
+    c.params.nHeight = 45;
+    c.params.eDataType = PostProcessDataType::FLOAT16;
+    cases.push_back(c);
+
+    c = MakeCase("nv16_full_range", PostProcessChroma::YUV422, 1);
+    c.colorimetry.eRange = PostProcessColorRange::FULL;
+    cases.push_back(c);
+
+    c = MakeCase("yuv444_bt601", PostProcessChroma::YUV444, 1);
+    c.colorimetry.iMatrix = 6;
+    c.params.nWidth = 50;
+    c.params.nHeight = 30;
+    cases.push_back(c);
+
+    c = MakeCase("p016_pq_tone_mapped", PostProcessChroma::YUV420, 2);
+    c.colorimetry.iMatrix = 9;
+    c.colorimetry.eTransfer = PostProcessTransfer::PQ;
+    c.colorimetry.bToneMap = true;
+    cases.push_back(c);
+
+    c = MakeCase("p016_hlg_tone_mapped", PostProcessChroma::YUV420, 2);
+    c.colorimetry.iMatrix = 9;
+    c.colorimetry.eTransfer = PostProcessTransfer::HLG;
+    c.colorimetry.bToneMap = true;
+    c.colorimetry.peakLuminance = 600.0f;
+    cases.push_back(c);
+    return cases;
+}
+
+class PostProcessGpuTest : public ::testing::TestWithParam<PostProcessCase>
+{
+};
+
+}  // namespace
+
+// The kernel and the host reference share the per pixel code, they may only differ by floating point contraction
+TEST_P(PostProcessGpuTest, KernelMatchesHostReference)
+{
+    if (!HasGpu())
+    {
+        GTEST_SKIP() << "no CUDA device";
+    }
+    const PostProcessCase& c = GetParam();
+    const int nWidth = 131, nHeight = 75;
+    int nChromaRows = 0;
+    std::vector<uint8_t> frame = MakeFrame(c.eChroma, c.nBytesPerSample, nWidth, nHeight, &nChromaRows);
+
+    PostProcessParams params;
+    ASSERT_TRUE(ResolvePostProcessParams(c.params, nWidth, nHeight, &params));
+    // BT.709 limited range SDR unless the case says otherwise
+    PostProcessColorimetry colorimetry = ResolvePostProcessColorimetry(c.colorimetry, 1, false, 1, 0.0f);
+    size_t nElements = (size_t)params.nWidth * params.nHeight * 3;
+    size_t nOutBytes = nElements * GetPostProcessElementSize(params.eDataType);
+
+    PostProcessSource src;
+    src.nPitch = nWidth * c.nBytesPerSample;
+    src.nWidth = nWidth;
+    src.nHeight = nHeight;
+    src.nChromaRow = nHeight;
+    src.nBytesPerSample = c.nBytesPerSample;
+    src.eChroma = c.eChroma;
+
+    src.pFrame = frame.data();
+    std::vector<uint8_t> expected(nOutBytes);
+    YuvToRgbPostProcessHost(src, expected.data(), params, colorimetry);
+
+    uint8_t *dpFrame = nullptr, *dpOut = nullptr;
+    ASSERT_EQ(cudaMalloc(&dpFrame, frame.size()), cudaSuccess);
+    ASSERT_EQ(cudaMalloc(&dpOut, nOutBytes), cudaSuccess);
+    ASSERT_EQ(cudaMemcpy(dpFrame, frame.data(), frame.size(), cudaMemcpyHostToDevice), cudaSuccess);
+    src.pFrame = dpFrame;
+    YuvToRgbPostProcess(src, dpOut, params, colorimetry, nullptr);
+    std::vector<uint8_t> actual(nOutBytes);
+    ASSERT_EQ(cudaMemcpy(actual.data(), dpOut, nOutBytes, cudaMemcpyDeviceToHost), cudaSuccess);
+    cudaFree(dpFrame);
+    cudaFree(dpOut);
+
+    size_t nMismatches = 0;
+    for (size_t i = 0; i < nElements; i++)
+    {
+        bool bMatch = true;
+        switch (params.eDataType)
+        {
+        case PostProcessDataType::FLOAT32:
+        {
+            float a = ((const float*)actual.data())[i], e = ((const float*)expected.data())[i];
+            bMatch = fabsf(a - e) <= 1e-3f * (1.0f + fabsf(e));
+            break;
+        }
+        case PostProcessDataType::FLOAT16:
+            bMatch = abs((int)((const uint16_t*)actual.data())[i] - (int)((const uint16_t*)expected.data())[i]) <= 1;
+            break;
+        default:
+            bMatch = abs((int)actual[i] - (int)expected[i]) <= 1;
+            break;
+        }
+        if (!bMatch && nMismatches++ < 8)
+        {
+            ADD_FAILURE() << c.name << ": element " << i << " differs";
+        }
+    }
+    EXPECT_EQ(nMismatches, 0u);
+}
+
+INSTANTIATE_TEST_SUITE_P(Cases, PostProcessGpuTest, ::testing::ValuesIn(GetCases()),
+    [](const ::testing::TestParamInfo<PostProcessCase>& info) { return std::string(info.param.name); });
+
+// One launch generating every output format, from 8 and 16 bit sources
+TEST(PostProcessLadderGpuTest, KernelMatchesHostReference)
+{
+    if (!HasGpu())
+    {
+        GTEST_SKIP() << "no CUDA device";
+    }
+    const int nWidth = 131, nHeight = 75;
+    for (int nBytesPerSample : { 1, 2 })
+    {
+        int nChromaRows = 0;
+        std::vector<uint8_t> frame = MakeFrame(PostProcessChroma::YUV420, nBytesPerSample, nWidth, nHeight, &nChromaRows);
+        PostProcessSource src;
+        src.nPitch = nWidth * nBytesPerSample;
+        src.nWidth = nWidth;
+        src.nHeight = nHeight;
+        src.nChromaRow = nHeight;
+        src.nBytesPerSample = nBytesPerSample;
+
+        PostProcessOutput outputs[4];
+        outputs[0].eFormat = PostProcessFormat::NV12;
+        outputs[0].params.nWidth = 64;
+        outputs[0].params.nHeight = 36;
+        outputs[1].eFormat = PostProcessFormat::P016;
+        outputs[1].params.roi = { 6, 4, 90, 50 };
+        outputs[1].params.nWidth = 90;
+        outputs[1].params.nHeight = 50;
+        outputs[1].params.eInterpolation = PostProcessInterpolation::NEAREST;
+        outputs[2].eFormat = PostProcessFormat::RGB;
+        outputs[2].params.nWidth = 211;
+        outputs[2].params.nHeight = 97;
+        outputs[3].eFormat = PostProcessFormat::RGBP;
+        outputs[3].params.nWidth = 50;
+        outputs[3].params.nHeight = 30;
+        outputs[3].params.eDataType = PostProcessDataType::FLOAT32;
+        PostProcessOutput resolved[4];
+        std::vector<uint8_t> expected[4];
+        uint8_t* apExpected[4];
+        uint8_t* dpOut[4];
+        for (int i = 0; i < 4; i++)
+        {
+            ASSERT_TRUE(ResolvePostProcessOutput(outputs[i], nWidth, nHeight, &resolved[i]));
+            expected[i].resize(GetPostProcessOutputSize(resolved[i]));
+            apExpected[i] = expected[i].data();
+            ASSERT_EQ(cudaMalloc(&dpOut[i], expected[i].size()), cudaSuccess);
+        }
+        PostProcessColorimetry colorimetry = ResolvePostProcessColorimetry(PostProcessColorimetry(), 1, false, 1, 0.0f);
+        src.pFrame = frame.data();
+        YuvToLadderHost(src, resolved, apExpected, 4, colorimetry);
+
+        uint8_t* dpFrame = nullptr;
+        ASSERT_EQ(cudaMalloc(&dpFrame, frame.size()), cudaSuccess);
+        ASSERT_EQ(cudaMemcpy(dpFrame, frame.data(), frame.size(), cudaMemcpyHostToDevice), cudaSuccess);
+        src.pFrame = dpFrame;
+        YuvToLadder(src, resolved, dpOut, 4, colorimetry, nullptr);
+        for (int i = 0; i < 4; i++)
+        {
+            std::vector<uint8_t> actual(expected[i].size());
+            ASSERT_EQ(cudaMemcpy(actual.data(), dpOut[i], actual.size(), cudaMemcpyDeviceToHost), cudaSuccess);
+            cudaFree(dpOut[i]);
+            size_t nMismatches = 0;
+            for (size_t j = 0; j < actual.size(); j++)
+            {
+                bool bMatch = true;
+                switch (resolved[i].eFormat)
+                {
+                case PostProcessFormat::P016:
+                    bMatch = j % 2 || abs((int)((const uint16_t*)actual.data())[j / 2] - (int)((const uint16_t*)expected[i].data())[j / 2]) <= 1;
+                    break;
+                case PostProcessFormat::RGBP:
+                {
+                    float a = ((const float*)actual.data())[j / 4], e = ((const float*)expected[i].data())[j / 4];
+                    bMatch = j % 4 || fabsf(a - e) <= 1e-3f * (1.0f + fabsf(e));
+                    break;
+                }
+                default:
+                    bMatch = abs((int)actual[j] - (int)expected[i][j]) <= 1;
+                    break;
+                }
+                if (!bMatch && nMismatches++ < 8)
+                {
+                    ADD_FAILURE() << nBytesPerSample * 8 << " bit source, output " << i << ": byte " << j << " differs";
+                }
+            }
+            EXPECT_EQ(nMismatches, 0u) << nBytesPerSample * 8 << " bit source, output " << i;
+        }
+        cudaFree(dpFrame);
+    }
+}
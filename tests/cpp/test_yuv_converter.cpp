@@ -0,0 +1,218 @@
+/*
+ * This copyright notice applies to this file only
+ *
+ * SPDX-FileCopyrightText: Copyright (c) 2025 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#include "YuvConverter.h"
+
+#include <gtest/gtest.h>
+
+#include <stdlib.h>
+#include <string>
+#include <vector>
+
+namespace
+{
+
+struct Shape
+{
+    int nWidth, nHeight, nPitch;
+};
+
+// 4:2:0 frame of nPitch samples per row; the chroma area is large enough for both layouts
+template <typename T>
+struct Frame
+{
+    Frame(const Shape& shape) : shape(shape)
+    {
+        nChromaWidth = (shape.nWidth + 1) / 2;
+        nChromaHeight = (shape.nHeight + 1) / 2;
+        nPlanarPitch = (shape.nPitch + 1) / 2;
+        vSample.resize((size_t)shape.nPitch * shape.nHeight + (size_t)2 * nPlanarPitch * nChromaHeight);
+        for (T& s : vSample)
+        {
+            s = (T)rand();
+        }
+    }
+    T* Chroma() { return vSample.data() + (size_t)shape.nPitch * shape.nHeight; }
+    T& U(int x, int y) { return Chroma()[(size_t)y * nPlanarPitch + x]; }
+    T& V(int x, int y) { return Chroma()[(size_t)(nChromaHeight + y) * nPlanarPitch + x]; }
+    T& InterleavedU(int x, int y) { return Chroma()[(size_t)y * shape.nPitch + 2 * x]; }
+    T& InterleavedV(int x, int y) { return Chroma()[(size_t)y * shape.nPitch + 2 * x + 1]; }
+
+    Shape shape;
+    int nChromaWidth, nChromaHeight, nPlanarPitch;
+    std::vector<T> vSample;
+};
+
+// Sample by sample layout change through a copy, as YuvConverter did before the in place row permutation
+template <typename T>
+void ReferencePlanarToUVInterleaved(Frame<T>& frame)
+{
+    Frame<T> src = frame;
+    for (int y = 0; y < frame.nChromaHeight; y++)
+    {
+        for (int x = 0; x < frame.nChromaWidth; x++)
+        {
+            frame.InterleavedU(x, y) = src.U(x, y);
+            frame.InterleavedV(x, y) = src.V(x, y);
+        }
+    }
+}
+
+template <typename T>
+void ReferenceUVInterleavedToPlanar(Frame<T>& frame)
+{
+    Frame<T> src = frame;
+    for (int y = 0; y < frame.nChromaHeight; y++)
+    {
+        for (int x = 0; x < frame.nChromaWidth; x++)
+        {
+            frame.U(x, y) = src.InterleavedU(x, y);
+            frame.V(x, y) = src.InterleavedV(x, y);
+        }
+    }
+}
+
+// Luma must be left alone; only the samples of the destination layout are defined in the chroma area
+template <typename T>
+void ExpectSameLumaAndInterleaved(Frame<T>& expected, Frame<T>& actual)
+{
+    size_t nLuma = (size_t)expected.shape.nPitch * expected.shape.nHeight;
+    ASSERT_TRUE(std::equal(expected.vSample.begin(), expected.vSample.begin() + nLuma, actual.vSample.begin()));
+    for (int y = 0; y < expected.nChromaHeight; y++)
+    {
+        for (int x = 0; x < expected.nChromaWidth; x++)
+        {
+            ASSERT_EQ(expected.InterleavedU(x, y), actual.InterleavedU(x, y)) << "x " << x << " y " << y;
+            ASSERT_EQ(expected.InterleavedV(x, y), actual.InterleavedV(x, y)) << "x " << x << " y " << y;
+        }
+    }
+}
+
+template <typename T>
+void ExpectSameLumaAndPlanar(Frame<T>& expected, Frame<T>& actual)
+{
+    size_t nLuma = (size_t)expected.shape.nPitch * expected.shape.nHeight;
+    ASSERT_TRUE(std::equal(expected.vSample.begin(), expected.vSample.begin() + nLuma, actual.vSample.begin()));
+    for (int y = 0; y < expected.nChromaHeight; y++)
+    {
+        for (int x = 0; x < expected.nChromaWidth; x++)
+        {
+            ASSERT_EQ(expected.U(x, y), actual.U(x, y)) << "x " << x << " y " << y;
+            ASSERT_EQ(expected.V(x, y), actual.V(x, y)) << "x " << x << " y " << y;
+        }
+    }
+}
+
+std::vector<Shape> Shapes()
+{
+    // widths around the 16 byte vector length, odd heights, and odd pitches which take the copy path
+    std::vector<Shape> vShape;
+    for (int nWidth : { 1, 2, 3, 7, 15, 16, 17, 31, 32, 33, 63, 64, 65, 130 })
+    {
+        for (int nHeight : { 1, 2, 3, 4, 7, 8 })
+        {
+            for (int nPad : { 0, 1, 2, 5, 32 })
+            {
+                vShape.push_back({ nWidth, nHeight, nWidth + nPad });
+            }
+        }
+    }
+    return vShape;
+}
+
+std::string ShapeName(const Shape& shape)
+{
+    return std::to_string(shape.nWidth) + "x" + std::to_string(shape.nHeight) + " pitch " + std::to_string(shape.nPitch);
+}
+
+template <typename T>
+class YuvConverterTest : public ::testing::Test
+{
+};
+
+typedef ::testing::Types<uint8_t, uint16_t> SampleTypes;
+TYPED_TEST_SUITE(YuvConverterTest, SampleTypes);
+
+TYPED_TEST(YuvConverterTest, PlanarToUVInterleavedMatchesReference)
+{
+    srand(1);
+    for (const Shape& shape : Shapes())
+    {
+        SCOPED_TRACE(ShapeName(shape));
+        Frame<TypeParam> expected(shape), simd = expected, scalar = expected;
+        ReferencePlanarToUVInterleaved(expected);
+        YuvConverter<TypeParam>(shape.nWidth, shape.nHeight).PlanarToUVInterleaved(simd.vSample.data(), shape.nPitch);
+        YuvConverter<TypeParam, false>(shape.nWidth, shape.nHeight).PlanarToUVInterleaved(scalar.vSample.data(), shape.nPitch);
+        ExpectSameLumaAndInterleaved(expected, simd);
+        ExpectSameLumaAndInterleaved(expected, scalar);
+    }
+}
+
+TYPED_TEST(YuvConverterTest, UVInterleavedToPlanarMatchesReference)
+{
+    srand(2);
+    for (const Shape& shape : Shapes())
+    {
+        SCOPED_TRACE(ShapeName(shape));
+        Frame<TypeParam> expected(shape), simd = expected, scalar = expected;
+        ReferenceUVInterleavedToPlanar(expected);
+        YuvConverter<TypeParam>(shape.nWidth, shape.nHeight).UVInterleavedToPlanar(simd.vSample.data(), shape.nPitch);
+        YuvConverter<TypeParam, false>(shape.nWidth, shape.nHeight).UVInterleavedToPlanar(scalar.vSample.data(), shape.nPitch);
+        ExpectSameLumaAndPlanar(expected, simd);
+        ExpectSameLumaAndPlanar(expected, scalar);
+    }
+}
+
+TYPED_TEST(YuvConverterTest, RoundTripRestoresPlanes)
+{
+    srand(3);
+    for (const Shape& shape : Shapes())
+    {
+        // an odd width at an odd pitch has interleaved rows one sample longer than the pitch, which overlap
+        if (2 * ((shape.nWidth + 1) / 2) > shape.nPitch)
+        {
+            continue;
+        }
+        SCOPED_TRACE(ShapeName(shape));
+        Frame<TypeParam> original(shape), frame = original;
+        // one converter per shape is reused in both directions, as the encoder does per frame
+        YuvConverter<TypeParam> converter(shape.nWidth, shape.nHeight);
+        converter.PlanarToUVInterleaved(frame.vSample.data(), shape.nPitch);
+        converter.UVInterleavedToPlanar(frame.vSample.data(), shape.nPitch);
+        ExpectSameLumaAndPlanar(original, frame);
+    }
+}
+
+TYPED_TEST(YuvConverterTest, DefaultPitchIsWidth)
+{
+    srand(4);
+    Shape shape = { 37, 9, 37 };
+    Frame<TypeParam> expected(shape), frame = expected;
+    ReferencePlanarToUVInterleaved(expected);
+    YuvConverter<TypeParam>(shape.nWidth, shape.nHeight).PlanarToUVInterleaved(frame.vSample.data());
+    ExpectSameLumaAndInterleaved(expected, frame);
+}
+
+} // namespace
@@ -0,0 +1,117 @@
+# This copyright notice applies to this file only
+#
+# SPDX-FileCopyrightText: Copyright (c) 2025 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+# SPDX-License-Identifier: MIT
+#
+# Permission is hereby granted, free of charge, to any person obtaining a
+# copy of this software and associated documentation files (the "Software"),
+# to deal in the Software without restriction, including without limitation
+# the rights to use, copy, modify, merge, publish, distribute, sublicense,
+# and/or sell copies of the Software, and to permit persons to whom the
+# Software is furnished to do so, subject to the following conditions:
+#
+# The above copyright notice and this permission notice shall be included in
+# all copies or substantial portions of the Software.
+#
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+# IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+# THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+# FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+# DEALINGS IN THE SOFTWARE.
+
+"""Fixtures of the PyNvVideoCodec tests. The tests need the built module and an NVIDIA GPU and are skipped otherwise."""
+
+import ctypes
+import ctypes.util
+
+import pytest
+
+
+def _gpu_count():
+    name = ctypes.util.find_library("nvcuda") or ctypes.util.find_library("cuda")
+    if not name:
+        return 0
+    try:
+        libcuda = ctypes.CDLL(name)
+        count = ctypes.c_int(0)
+        if libcuda.cuInit(0) != 0 or libcuda.cuDeviceGetCount(ctypes.byref(count)) != 0:
+            return 0
+        return count.value
+    except OSError:
+        return 0
+
+
+@pytest.fixture(scope="session")
+def np():
+    return pytest.importorskip("numpy")
+
+
+@pytest.fixture(scope="session")
+def nvc():
+    module = pytest.importorskip("PyNvVideoCodec")
+    if _gpu_count() == 0:
+        pytest.skip("no NVIDIA GPU available")
+    return module
+
+
+@pytest.fixture(scope="session")
+def frame_size():
+    """Width and height of the frames made by nv12_frames and of the encoders made by create_encoder."""
+    return 256, 128
+
+
+@pytest.fixture(scope="session")
+def nv12_frames(np, frame_size):
+    """Returns a function making n moving gradient NV12 frames of width x height as flat uint8 arrays."""
+    def make(n, width=frame_size[0], height=frame_size[1]):
+        x = np.arange(width, dtype=np.uint16)[None, :]
+        y = np.arange(height, dtype=np.uint16)[:, None]
+        frames = []
+        for i in range(n):
+            luma = ((x + y + 4 * i) & 0xFF).astype(np.uint8)
+            chroma = np.full((height // 2, width), 128, np.uint8)
+            chroma[:, 0::2] = (64 + 2 * i) & 0xFF
+            frames.append(np.concatenate([luma.ravel(), chroma.ravel()]))
+        return frames
+    return make
+
+
+@pytest.fixture(scope="session")
+def create_encoder(nvc, frame_size):
+    """Returns a function making an NV12 H.264 encoder with a GOP of 30 and no B frames for frames of frame_size.
+    Keyword arguments are passed to CreateEncoder and override these defaults."""
+    def create(usecpuinputbuffer=True, width=frame_size[0], height=frame_size[1], **config):
+        config = {"codec": "h264", "gop": 30, "bf": 0, **config}
+        return nvc.CreateEncoder(width, height, "NV12", usecpuinputbuffer, **config)
+    return create
+
+
+@pytest.fixture(scope="session")
+def encode_packets():
+    """Returns a function encoding frames one by one and draining the encoder with EndEncode.
+    It returns the output of every Encode call, along with the output of EndEncode."""
+    def encode(encoder, frames, picflags=None):
+        packets = [bytes(encoder.Encode(frame, picflags[i] if picflags else 0)) for i, frame in enumerate(frames)]
+        return packets, bytes(encoder.EndEncode())
+    return encode
+
+
+@pytest.fixture(scope="session")
+def encode_bitstream(encode_packets):
+    """Returns a function encoding frames one by one and draining the encoder with EndEncode into one bitstream."""
+    def encode(encoder, frames, picflags=None):
+        packets, tail = encode_packets(encoder, frames, picflags)
+        return b"".join(packets) + tail
+    return encode
+
+
+@pytest.fixture(scope="session")
+def h264_clip(create_encoder, encode_bitstream, nv12_frames, frame_size, tmp_path_factory):
+    """Encodes a synthetic H.264 elementary stream and returns (path, number of frames, width, height)."""
+    (width, height), count = frame_size, 60
+    path = tmp_path_factory.mktemp("clips") / "synthetic.264"
+    with open(path, "wb") as f:
+        f.write(encode_bitstream(create_encoder(), nv12_frames(count)))
+    return str(path), count, width, height
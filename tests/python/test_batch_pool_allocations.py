@@ -0,0 +1,52 @@
+# This copyright notice applies to this file only
+#
+# SPDX-FileCopyrightText: Copyright (c) 2025 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+# SPDX-License-Identifier: MIT
+#
+# Permission is hereby granted, free of charge, to any person obtaining a
+# copy of this software and associated documentation files (the "Software"),
+# to deal in the Software without restriction, including without limitation
+# the rights to use, copy, modify, merge, publish, distribute, sublicense,
+# and/or sell copies of the Software, and to permit persons to whom the
+# Software is furnished to do so, subject to the following conditions:
+#
+# The above copyright notice and this permission notice shall be included in
+# all copies or substantial portions of the Software.
+#
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+# IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+# THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+# FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+# DEALINGS IN THE SOFTWARE.
+
+"""Pooling of the batch tensors of SimpleDecoder.get_batch_tensor."""
+
+
+def test_batch_tensors_are_pooled_per_batch_size(nvc, h264_clip):
+    path, _, _, _ = h264_clip
+    decoder = nvc.SimpleDecoder(path, use_device_memory=True)
+    counts = []
+    # 5 batches of 4 and 5 batches of 6 frames stay within the 60 frames of the clip
+    for batch_size in [4] * 5 + [6] * 5:
+        batch = decoder.get_batch_tensor(batch_size)
+        assert len(batch) == batch_size
+        # the batch returns its buffer to the pool once released
+        del batch
+        counts.append(decoder.get_batch_allocation_count())
+
+    assert counts[:5] == [1] * 5
+    # a new batch size needs one new buffer, which is reused afterwards
+    assert counts[5:] == [2] * 5
+
+
+def test_held_batches_get_their_own_buffers(nvc, h264_clip):
+    path, _, _, _ = h264_clip
+    decoder = nvc.SimpleDecoder(path, use_device_memory=True)
+    held = [decoder.get_batch_tensor(4) for _ in range(3)]
+    assert decoder.get_batch_allocation_count() == 3
+    del held
+    for _ in range(3):
+        decoder.get_batch_tensor(4)
+    assert decoder.get_batch_allocation_count() == 3
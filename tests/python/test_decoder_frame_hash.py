@@ -0,0 +1,55 @@
+# This copyright notice applies to this file only
+#
+# SPDX-FileCopyrightText: Copyright (c) 2025 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+# SPDX-License-Identifier: MIT
+#
+# Permission is hereby granted, free of charge, to any person obtaining a
+# copy of this software and associated documentation files (the "Software"),
+# to deal in the Software without restriction, including without limitation
+# the rights to use, copy, modify, merge, publish, distribute, sublicense,
+# and/or sell copies of the Software, and to permit persons to whom the
+# Software is furnished to do so, subject to the following conditions:
+#
+# The above copyright notice and this permission notice shall be included in
+# all copies or substantial portions of the Software.
+#
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+# IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+# THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+# FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+# DEALINGS IN THE SOFTWARE.
+
+"""Frame hashes of the decoder (SetFrameHash), which are computed on the GPU while the frame is output."""
+
+import pytest
+
+
+def decode(nvc, path, **kwargs):
+    demuxer = nvc.CreateDemuxer(filename=path)
+    decoder = nvc.CreateDecoder(gpuid=0, codec=demuxer.GetNvCodecId(), usedevicememory=1, **kwargs)
+    decoder.SetFrameHash(True)
+    for packet in demuxer:
+        for frame in decoder.Decode(packet):
+            yield frame
+
+
+def test_device_frame_hash_matches_host_hash(nvc, np, h264_clip):
+    cp = pytest.importorskip("cupy")
+    path, count, _, _ = h264_clip
+    hashes = []
+    # native device frames are copied by the hash kernel itself
+    for frame in decode(nvc, path):
+        host = np.ascontiguousarray(cp.asnumpy(cp.from_dlpack(frame)))
+        assert frame.hash == nvc.FrameHash(host)
+        hashes.append(frame.hash)
+    assert len(hashes) == count
+    # the synthetic clip moves every frame
+    assert len(set(hashes)) == count
+
+
+def test_mapped_surface_hash_matches_copied_frame_hash(nvc, h264_clip):
+    path, _, _, _ = h264_clip
+    # mapped surfaces are hashed in place at the pitch of the surface
+    assert [frame.hash for frame in decode(nvc, path, outputmappedsurface=1)] == [frame.hash for frame in decode(nvc, path)]
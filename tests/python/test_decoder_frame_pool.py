@@ -0,0 +1,78 @@
+# This copyright notice applies to this file only
+#
+# SPDX-FileCopyrightText: Copyright (c) 2025 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+# SPDX-License-Identifier: MIT
+#
+# Permission is hereby granted, free of charge, to any person obtaining a
+# copy of this software and associated documentation files (the "Software"),
+# to deal in the Software without restriction, including without limitation
+# the rights to use, copy, modify, merge, publish, distribute, sublicense,
+# and/or sell copies of the Software, and to permit persons to whom the
+# Software is furnished to do so, subject to the following conditions:
+#
+# The above copyright notice and this permission notice shall be included in
+# all copies or substantial portions of the Software.
+#
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+# IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+# THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+# FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+# DEALINGS IN THE SOFTWARE.
+
+
+"""Preallocated output frames (preallocframes), which keep the display callback from allocating after warm-up."""
+
+import pytest
+
+
+@pytest.fixture(scope="module")
+def two_resolution_clip(create_encoder, encode_bitstream, nv12_frames, tmp_path_factory):
+    """An H.264 elementary stream of 30 frames at 256x128 followed by 30 frames at 128x64."""
+    path = tmp_path_factory.mktemp("clips") / "two_resolutions.264"
+    with open(path, "wb") as f:
+        for width, height in [(256, 128), (128, 64)]:
+            encoder = create_encoder(width=width, height=height)
+            f.write(encode_bitstream(encoder, nv12_frames(30, width, height)))
+    return str(path), 60
+
+
+def ladder(nvc):
+    params = nvc.PostProcessParams()
+    params.width = 64
+    params.height = 32
+    return [nvc.PostProcessOutput(nvc.PostProcessFormat.NV12, params)]
+
+
+def decode_with_stats(nvc, path, preallocframes, **kwargs):
+    demuxer = nvc.CreateDemuxer(filename=path)
+    decoder = nvc.CreateDecoder(gpuid=0, codec=demuxer.GetNvCodecId(), usedevicememory=1, maxwidth=256, maxheight=128,
+                                preallocframes=preallocframes, **kwargs)
+    decoder.SetFrameHash(True)
+    widths = []
+    allocations = []
+    for packet in demuxer:
+        frames = decoder.Decode(packet)
+        if frames:
+            widths.append(decoder.GetWidth())
+        allocations.append(decoder.GetFramePoolStats()["decode_time_allocations"])
+    return widths, allocations, decoder.GetFramePoolStats()
+
+
+@pytest.mark.parametrize("kwargs", [{}, {"usememorypool": 1}], ids=["default", "memory_pool"])
+def test_no_decode_time_allocations_across_reconfigure(nvc, two_resolution_clip, kwargs):
+    path, _ = two_resolution_clip
+    widths, allocations, stats = decode_with_stats(nvc, path, 16, outputladder=ladder(nvc), **kwargs)
+    # the second sequence reconfigures the session to a smaller resolution
+    assert widths[0] == 256 and widths[-1] == 128
+    assert stats["preallocated_frames"] == 16
+    # frames, ladder buffers and hash locations are all allocated with the session
+    assert max(allocations) == 0
+
+
+def test_lazy_frames_are_counted_as_decode_time_allocations(nvc, two_resolution_clip):
+    path, _ = two_resolution_clip
+    _, allocations, stats = decode_with_stats(nvc, path, 0, outputladder=ladder(nvc))
+    assert stats["preallocated_frames"] == 0
+    assert allocations[-1] > 0
@@ -0,0 +1,71 @@
+# This copyright notice applies to this file only
+#
+# SPDX-FileCopyrightText: Copyright (c) 2025 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+# SPDX-License-Identifier: MIT
+#
+# Permission is hereby granted, free of charge, to any person obtaining a
+# copy of this software and associated documentation files (the "Software"),
+# to deal in the Software without restriction, including without limitation
+# the rights to use, copy, modify, merge, publish, distribute, sublicense,
+# and/or sell copies of the Software, and to permit persons to whom the
+# Software is furnished to do so, subject to the following conditions:
+#
+# The above copyright notice and this permission notice shall be included in
+# all copies or substantial portions of the Software.
+#
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+# IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+# THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+# FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+# DEALINGS IN THE SOFTWARE.
+
+"""Decoder output of mapped decoder surfaces (outputmappedsurface=1)."""
+
+import pytest
+
+
+def decode_timestamps(nvc, path, seek_pts=None):
+    demuxer = nvc.CreateDemuxer(filename=path)
+    decoder = nvc.CreateDecoder(gpuid=0, codec=demuxer.GetNvCodecId(), usedevicememory=1, outputmappedsurface=1)
+    if seek_pts is not None:
+        decoder.SetSeekPTS(seek_pts)
+    timestamps = []
+    for packet in demuxer:
+        timestamps += [frame.timestamp for frame in decoder.Decode(packet)]
+    return timestamps
+
+
+def test_mapped_output_decodes_every_frame(nvc, h264_clip):
+    path, count, _, _ = h264_clip
+    assert len(decode_timestamps(nvc, path)) == count
+
+
+def test_mapped_output_drops_frames_before_seek_pts(nvc, h264_clip):
+    path, count, _, _ = h264_clip
+    timestamps = decode_timestamps(nvc, path)
+    if len(set(timestamps)) != count:
+        pytest.skip("the demuxer reports no distinct timestamps for the elementary stream")
+    seek_pts = timestamps[count // 2]
+    expected = [ts for ts in timestamps if ts >= seek_pts]
+    assert decode_timestamps(nvc, path, seek_pts) == expected
+
+
+def test_mapping_beyond_the_surface_limit_raises_and_decoding_recovers(nvc, h264_clip):
+    path, count, _, _ = h264_clip
+    demuxer = nvc.CreateDemuxer(filename=path)
+    decoder = nvc.CreateDecoder(gpuid=0, codec=demuxer.GetNvCodecId(), usedevicememory=1, outputmappedsurface=1)
+    packets = iter(demuxer)
+    locked = []
+    # every locked frame keeps its surface mapped until it is unlocked
+    with pytest.raises(Exception, match="output surfaces are mapped"):
+        for packet in packets:
+            for _ in range(decoder.GetNumDecodedFrame(packet)):
+                locked.append(decoder.GetLockedFrame())
+    assert 0 < len(locked) < count
+
+    for frame in locked:
+        decoder.UnlockFrame(frame)
+    decoded = sum(len(decoder.Decode(packet)) for packet in packets)
+    assert decoded > 0
@@ -0,0 +1,116 @@
+# This copyright notice applies to this file only
+#
+# SPDX-FileCopyrightText: Copyright (c) 2025 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+# SPDX-License-Identifier: MIT
+#
+# Permission is hereby granted, free of charge, to any person obtaining a
+# copy of this software and associated documentation files (the "Software"),
+# to deal in the Software without restriction, including without limitation
+# the rights to use, copy, modify, merge, publish, distribute, sublicense,
+# and/or sell copies of the Software, and to permit persons to whom the
+# Software is furnished to do so, subject to the following conditions:
+#
+# The above copyright notice and this permission notice shall be included in
+# all copies or substantial portions of the Software.
+#
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+# IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+# THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+# FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+# DEALINGS IN THE SOFTWARE.
+
+
+"""DLPack export of decoded frames: capsule versions, consumer arguments and dtypes."""
+
+import ctypes
+
+import pytest
+
+KDL_CPU = 1
+
+_capsule_name = ctypes.pythonapi.PyCapsule_GetName
+_capsule_name.restype = ctypes.c_char_p
+_capsule_name.argtypes = [ctypes.py_object]
+
+
+def capsule_name(capsule):
+    return _capsule_name(capsule).decode()
+
+
+def decode(nvc, path, count=None):
+    """Returns the decoder with its frames, which refer to its buffers."""
+    demuxer = nvc.CreateDemuxer(filename=path)
+    decoder = nvc.CreateDecoder(gpuid=0, codec=demuxer.GetNvCodecId(), usedevicememory=1)
+    frames = []
+    for packet in demuxer:
+        frames += decoder.Decode(packet)
+        if count and len(frames) >= count:
+            break
+    return decoder, frames
+
+
+@pytest.fixture(scope="module")
+def frame(nvc, h264_clip):
+    # the decoder is kept alive until the module is done with its frame
+    decoder, frames = decode(nvc, h264_clip[0], 1)
+    yield frames[0]
+
+
+@pytest.fixture(scope="module")
+def hevc_10bit_clip(nvc, np, nv12_frames, tmp_path_factory):
+    """Encodes a synthetic 10 bit HEVC stream, decoded as P016."""
+    width, height = 256, 128
+    try:
+        encoder = nvc.CreateEncoder(width, height, "P010", True, codec="hevc", gop=30, bf=0)
+    except Exception as e:
+        pytest.skip(f"no 10 bit HEVC encoder: {e}")
+    path = tmp_path_factory.mktemp("clips") / "synthetic_10bit.hevc"
+    with open(path, "wb") as f:
+        for nv12 in nv12_frames(5, width, height):
+            # P010 keeps the samples in the 10 high bits; CPU frames are passed as bytes
+            p010 = nv12.astype(np.uint16) << 8
+            f.write(bytes(encoder.Encode(p010.view(np.uint8))))
+        f.write(bytes(encoder.EndEncode()))
+    return str(path)
+
+
+def test_versioned_capsule_with_max_version(frame):
+    assert capsule_name(frame.__dlpack__(max_version=(1, 0))) == "dltensor_versioned"
+    assert capsule_name(frame.__dlpack__(max_version=(1, 1))) == "dltensor_versioned"
+
+
+def test_legacy_capsule_without_max_version(frame):
+    assert capsule_name(frame.__dlpack__()) == "dltensor"
+    assert capsule_name(frame.__dlpack__(max_version=(0, 8))) == "dltensor"
+
+
+def test_copy_raises_buffer_error(frame):
+    with pytest.raises(BufferError):
+        frame.__dlpack__(copy=True)
+    # no copy is what the frames do anyway
+    assert capsule_name(frame.__dlpack__(copy=False)) == "dltensor"
+
+
+def test_other_device_raises_buffer_error(frame):
+    device_type, device_id = frame.__dlpack_device__()
+    with pytest.raises(BufferError):
+        frame.__dlpack__(dl_device=(KDL_CPU, 0))
+    with pytest.raises(BufferError):
+        frame.__dlpack__(dl_device=(device_type, device_id + 1))
+    assert capsule_name(frame.__dlpack__(dl_device=(device_type, device_id))) == "dltensor"
+
+
+def test_nv12_frame_is_u1(frame):
+    assert frame.dtype == "|u1"
+    assert all(view.__cuda_array_interface__["typestr"] == "|u1" for view in frame.cuda())
+
+
+def test_p016_frame_is_u2(nvc, hevc_10bit_clip):
+    decoder, frames = decode(nvc, hevc_10bit_clip)
+    assert frames
+    for frame in frames:
+        assert frame.format == nvc.Pixel_Format.P016
+        assert frame.dtype == "<u2"
+        assert all(view.__cuda_array_interface__["typestr"] == "<u2" for view in frame.cuda())
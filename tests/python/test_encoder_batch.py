@@ -0,0 +1,100 @@
+# This copyright notice applies to this file only
+#
+# SPDX-FileCopyrightText: Copyright (c) 2025 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+# SPDX-License-Identifier: MIT
+#
+# Permission is hereby granted, free of charge, to any person obtaining a
+# copy of this software and associated documentation files (the "Software"),
+# to deal in the Software without restriction, including without limitation
+# the rights to use, copy, modify, merge, publish, distribute, sublicense,
+# and/or sell copies of the Software, and to permit persons to whom the
+# Software is furnished to do so, subject to the following conditions:
+#
+# The above copyright notice and this permission notice shall be included in
+# all copies or substantial portions of the Software.
+#
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+# IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+# THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+# FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+# DEALINGS IN THE SOFTWARE.
+
+"""Batch encoding (EncodeBatch) against encoding the same frames one by one."""
+
+import pytest
+
+FORCE_IDR = 0x2
+
+
+def split_packets(bitstream):
+    data = bytes(bitstream)
+    offsets = bitstream.offsets
+    return [data[offsets[i]:offsets[i + 1]] for i in range(len(offsets) - 1)]
+
+
+@pytest.mark.parametrize("bf", [0, 3])
+def test_batch_list_matches_per_frame_encode(create_encoder, encode_packets, nv12_frames, bf):
+    frames = nv12_frames(24)
+    packets, tail = encode_packets(create_encoder(bf=bf), frames)
+
+    bitstream = create_encoder(bf=bf).EncodeBatch(frames, flush=True)
+    assert bytes(bitstream) == b"".join(packets) + tail
+    assert bitstream.num_packets == len(frames)
+
+
+def test_batch_tensor_matches_per_frame_encode(create_encoder, encode_packets, np, nv12_frames):
+    frames = nv12_frames(16)
+    packets, tail = encode_packets(create_encoder(), frames)
+
+    # the first dimension of a stacked array indexes the frames
+    bitstream = create_encoder().EncodeBatch(np.stack(frames), flush=True)
+    assert bytes(bitstream) == b"".join(packets) + tail
+
+
+def test_offsets_split_the_batch_into_packets(create_encoder, encode_packets, nv12_frames):
+    frames = nv12_frames(12)
+    # without an output delay every Encode call returns exactly the packet of its frame
+    packets, tail = encode_packets(create_encoder(), frames)
+    assert tail == b""
+
+    bitstream = create_encoder().EncodeBatch(frames, flush=True)
+    assert bitstream.offsets[0] == 0
+    assert bitstream.offsets[-1] == len(bitstream)
+    assert len(bitstream.offsets) == bitstream.num_packets + 1
+    assert split_packets(bitstream) == packets
+
+
+def test_consecutive_batches_continue_the_stream(create_encoder, encode_packets, nv12_frames):
+    frames = nv12_frames(24)
+    packets, tail = encode_packets(create_encoder(bf=3), frames)
+
+    encoder = create_encoder(bf=3)
+    batches = [encoder.EncodeBatch(frames[:10]), encoder.EncodeBatch(frames[10:20]),
+               encoder.EncodeBatch(frames[20:], flush=True)]
+    assert b"".join(bytes(b) for b in batches) == b"".join(packets) + tail
+    assert sum(b.num_packets for b in batches) == len(frames)
+
+
+def test_picflags_apply_to_their_frame(create_encoder, encode_packets, nv12_frames):
+    frames = nv12_frames(12)
+    picflags = [FORCE_IDR if i == 5 else 0 for i in range(len(frames))]
+    packets, _ = encode_packets(create_encoder(), frames, picflags)
+    assert packets != encode_packets(create_encoder(), frames)[0]
+
+    bitstream = create_encoder().EncodeBatch(frames, picflags, flush=True)
+    assert split_packets(bitstream) == packets
+
+
+def test_picflags_of_the_wrong_length_raise(create_encoder, nv12_frames):
+    frames = nv12_frames(4)
+    with pytest.raises(Exception):
+        create_encoder().EncodeBatch(frames, [0] * 3)
+
+
+def test_empty_batch_outputs_nothing(create_encoder):
+    bitstream = create_encoder().EncodeBatch([], flush=True)
+    assert len(bitstream) == 0
+    assert bitstream.num_packets == 0
+    assert bitstream.offsets == [0]
@@ -0,0 +1,112 @@
+# This copyright notice applies to this file only
+#
+# SPDX-FileCopyrightText: Copyright (c) 2025 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+# SPDX-License-Identifier: MIT
+#
+# Permission is hereby granted, free of charge, to any person obtaining a
+# copy of this software and associated documentation files (the "Software"),
+# to deal in the Software without restriction, including without limitation
+# the rights to use, copy, modify, merge, publish, distribute, sublicense,
+# and/or sell copies of the Software, and to permit persons to whom the
+# Software is furnished to do so, subject to the following conditions:
+#
+# The above copyright notice and this permission notice shall be included in
+# all copies or substantial portions of the Software.
+#
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+# IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+# THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+# FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+# DEALINGS IN THE SOFTWARE.
+
+"""Bitstream outputs copied once from the encoder output (EncodeToBuffer, EncodeToFile) against Encode."""
+
+import os
+
+import pytest
+
+
+@pytest.mark.parametrize("bf", [0, 3])
+def test_encode_to_buffer_matches_encode(create_encoder, encode_bitstream, nv12_frames, bf):
+    frames = nv12_frames(24)
+    expected = encode_bitstream(create_encoder(bf=bf), frames)
+
+    encoder = create_encoder(bf=bf)
+    chunks = []
+    num_packets = 0
+    for frame in frames:
+        bitstream = encoder.EncodeToBuffer(frame)
+        # the memoryview aliases the buffer, it must hold the same bytes as the bytes() copy
+        assert memoryview(bitstream).tobytes() == bytes(bitstream)
+        assert len(bitstream) == len(bytes(bitstream))
+        chunks.append(bytes(bitstream))
+        num_packets += bitstream.num_packets
+    bitstream = encoder.EndEncodeToBuffer()
+    chunks.append(bytes(bitstream))
+    num_packets += bitstream.num_packets
+
+    assert b"".join(chunks) == expected
+    assert num_packets == len(frames)
+
+
+def test_encode_to_buffer_counts_one_packet_per_frame_without_delay(create_encoder, nv12_frames):
+    encoder = create_encoder()
+    for frame in nv12_frames(8):
+        bitstream = encoder.EncodeToBuffer(frame)
+        assert bitstream.num_packets == 1
+        assert len(bitstream) > 0
+    bitstream = encoder.EndEncodeToBuffer()
+    assert bitstream.num_packets == 0
+
+
+def test_live_bitstreams_are_not_reused(create_encoder, encode_bitstream, nv12_frames):
+    frames = nv12_frames(8)
+    expected = encode_bitstream(create_encoder(), frames)
+
+    encoder = create_encoder()
+    # keep every bitstream alive, so that no buffer is reused while still referenced
+    bitstreams = [encoder.EncodeToBuffer(frame) for frame in frames]
+    bitstreams.append(encoder.EndEncodeToBuffer())
+    assert b"".join(memoryview(b).tobytes() for b in bitstreams) == expected
+
+
+@pytest.mark.parametrize("bf", [0, 3])
+def test_encode_to_file_writes_the_encode_bitstream(create_encoder, encode_bitstream, nv12_frames, tmp_path, bf):
+    frames = nv12_frames(24)
+    expected = encode_bitstream(create_encoder(bf=bf), frames)
+
+    encoder = create_encoder(bf=bf)
+    path = tmp_path / "out.264"
+    written = 0
+    with open(path, "wb") as f:
+        for frame in frames:
+            written += encoder.EncodeToFile(frame, f.fileno())
+        written += encoder.EndEncodeToFile(f.fileno())
+
+    assert written == len(expected)
+    assert path.read_bytes() == expected
+
+
+def test_encode_to_file_appends_after_existing_content(create_encoder, encode_bitstream, nv12_frames, tmp_path):
+    frames = nv12_frames(4)
+    expected = encode_bitstream(create_encoder(), frames)
+
+    encoder = create_encoder()
+    path = tmp_path / "out.264"
+    with open(path, "wb") as f:
+        f.write(b"header")
+        f.flush()
+        for frame in frames:
+            encoder.EncodeToFile(frame, f.fileno())
+        encoder.EndEncodeToFile(f.fileno())
+    assert path.read_bytes() == b"header" + expected
+
+
+def test_encode_to_file_rejects_a_closed_descriptor(create_encoder, nv12_frames, tmp_path):
+    encoder = create_encoder()
+    fd = os.open(tmp_path / "out.264", os.O_WRONLY | os.O_CREAT)
+    os.close(fd)
+    with pytest.raises(Exception):
+        encoder.EncodeToFile(nv12_frames(1)[0], fd)
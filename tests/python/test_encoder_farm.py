@@ -0,0 +1,116 @@
+# This copyright notice applies to this file only
+#
+# SPDX-FileCopyrightText: Copyright (c) 2025 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+# SPDX-License-Identifier: MIT
+#
+# Permission is hereby granted, free of charge, to any person obtaining a
+# copy of this software and associated documentation files (the "Software"),
+# to deal in the Software without restriction, including without limitation
+# the rights to use, copy, modify, merge, publish, distribute, sublicense,
+# and/or sell copies of the Software, and to permit persons to whom the
+# Software is furnished to do so, subject to the following conditions:
+#
+# The above copyright notice and this permission notice shall be included in
+# all copies or substantial portions of the Software.
+#
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+# IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+# THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+# FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+# DEALINGS IN THE SOFTWARE.
+
+
+"""EncoderFarm jobs against encoding the same frames with CreateEncoder."""
+
+import pytest
+
+def farm_config(config):
+    # the farm takes the options as strings, as CreateEncoder passes them to the encoder
+    return {key: str(value) for key, value in config.items()}
+
+
+def retrieve_all(farm):
+    results = {}
+    while True:
+        result = farm.Retrieve(timeout=30.0)
+        if result is None:
+            break
+        assert result.job_id not in results
+        results[result.job_id] = result
+    return results
+
+
+def test_every_job_is_retrieved_once(nvc, nv12_frames, frame_size):
+    farm = nvc.EncoderFarm(gpu_ids=[0], sessions_per_gpu=2)
+    frames = nv12_frames(8)
+    config = farm_config({"codec": "h264", "gop": 30, "bf": 0})
+    job_ids = [farm.Submit(frames, *frame_size, "NV12", config) for _ in range(10)]
+    assert len(set(job_ids)) == len(job_ids)
+
+    results = retrieve_all(farm)
+    assert sorted(results) == sorted(job_ids)
+    assert farm.pending == 0
+    assert all(result.error == "" for result in results.values())
+
+
+@pytest.mark.parametrize("bf", [0, 2])
+def test_job_matches_single_encoder(nvc, create_encoder, encode_bitstream, nv12_frames, frame_size, bf):
+    frames = nv12_frames(20)
+    config = {"codec": "h264", "gop": 30, "bf": bf}
+    expected = encode_bitstream(create_encoder(**config), frames)
+
+    farm = nvc.EncoderFarm(gpu_ids=[0], sessions_per_gpu=1)
+    # the second job runs on the encoder of the first one, started as a new sequence
+    job_ids = [farm.Submit(frames, *frame_size, "NV12", farm_config(config)) for _ in range(2)]
+    results = retrieve_all(farm)
+    for job_id in job_ids:
+        bitstream = results[job_id].bitstream
+        assert bytes(bitstream) == expected
+        assert bitstream.num_packets == len(frames)
+        assert len(bitstream.offsets) == bitstream.num_packets + 1
+
+
+def test_mixed_configs_match_single_encoders(nvc, create_encoder, encode_bitstream, nv12_frames, frame_size):
+    width, height = frame_size
+    jobs = [
+        ({"codec": "h264", "gop": 30, "bf": 0}, width, height),
+        ({"codec": "hevc", "gop": 30, "bf": 0}, width, height),
+        ({"codec": "h264", "gop": 30, "bf": 0}, width, height),
+        ({"codec": "h264", "gop": 10, "bf": 2}, width, height),
+        ({"codec": "h264", "gop": 30, "bf": 0}, width // 2, height // 2),
+        ({"codec": "h264", "gop": 30, "bf": 0}, width, height),
+    ]
+    # a single session switches between creating an encoder and starting a new sequence on it
+    farm = nvc.EncoderFarm(gpu_ids=[0], sessions_per_gpu=1)
+    expected = {}
+    for config, width, height in jobs:
+        frames = nv12_frames(12, width, height)
+        job_id = farm.Submit(frames, width, height, "NV12", farm_config(config))
+        expected[job_id] = encode_bitstream(create_encoder(width=width, height=height, **config), frames)
+
+    results = retrieve_all(farm)
+    assert sorted(results) == sorted(expected)
+    for job_id, data in expected.items():
+        assert results[job_id].error == ""
+        assert bytes(results[job_id].bitstream) == data
+
+
+def test_failed_job_reports_error_and_farm_continues(nvc, create_encoder, encode_bitstream, nv12_frames, frame_size):
+    frames = nv12_frames(6)
+    config = {"codec": "h264", "gop": 30, "bf": 0}
+    expected = encode_bitstream(create_encoder(**config), frames)
+
+    farm = nvc.EncoderFarm(gpu_ids=[0], sessions_per_gpu=1)
+    good_before = farm.Submit(frames, *frame_size, "NV12", farm_config(config))
+    # a CPU buffer shorter than the frame fails in the worker
+    bad = farm.Submit([frames[0][:100]] + frames[1:], *frame_size, "NV12", farm_config(config))
+    good_after = farm.Submit(frames, *frame_size, "NV12", farm_config(config))
+
+    results = retrieve_all(farm)
+    assert results[bad].error != ""
+    assert results[bad].bitstream is None
+    for job_id in [good_before, good_after]:
+        assert results[job_id].error == ""
+        assert bytes(results[job_id].bitstream) == expected
@@ -0,0 +1,69 @@
+# This copyright notice applies to this file only
+#
+# SPDX-FileCopyrightText: Copyright (c) 2025 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+# SPDX-License-Identifier: MIT
+#
+# Permission is hereby granted, free of charge, to any person obtaining a
+# copy of this software and associated documentation files (the "Software"),
+# to deal in the Software without restriction, including without limitation
+# the rights to use, copy, modify, merge, publish, distribute, sublicense,
+# and/or sell copies of the Software, and to permit persons to whom the
+# Software is furnished to do so, subject to the following conditions:
+#
+# The above copyright notice and this permission notice shall be included in
+# all copies or substantial portions of the Software.
+#
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+# IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+# THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+# FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+# DEALINGS IN THE SOFTWARE.
+
+
+"""Per frame statistics of the encoder (frame_stats=1), attached to the packets of the sync and pipelined APIs."""
+
+import pytest
+
+
+@pytest.mark.parametrize("bf", [0, 2])
+def test_sync_encode_reports_one_record_per_packet(create_encoder, nv12_frames, bf):
+    encoder = create_encoder(bf=bf, frame_stats=1)
+    frames = nv12_frames(20)
+    bitstreams = [encoder.Encode(frame) for frame in frames] + [encoder.EndEncode()]
+
+    records = []
+    for bitstream in bitstreams:
+        assert len(bitstream.stats) == bitstream.num_packets
+        # the packets of a call are concatenated
+        assert sum(stats.size for stats in bitstream.stats) == len(bitstream)
+        if bitstream.num_packets == 1:
+            assert bitstream.stats[0].size == len(bitstream)
+        records += bitstream.stats
+    assert len(records) == len(frames)
+    assert sorted(stats.frame_idx for stats in records) == list(range(len(frames)))
+    # everything was attached, nothing is left queued
+    assert encoder.GetFrameStats() == []
+
+
+@pytest.mark.parametrize("bf", [0, 2])
+def test_pipelined_encode_reports_one_record_per_packet(create_encoder, nv12_frames, bf):
+    encoder = create_encoder(bf=bf, frame_stats=1)
+    frames = nv12_frames(20)
+    tickets = []
+    packets = []
+    for frame in frames:
+        tickets.append(encoder.Submit(frame))
+        # poll while submitting, so that the output thread races the lookup by timestamp
+        while (packet := encoder.Retrieve(0)) is not None:
+            packets.append(packet)
+    packets += encoder.Flush()
+
+    assert len(packets) == len(frames)
+    assert sorted(packet.timestamp for packet in packets) == sorted(tickets)
+    for packet in packets:
+        assert len(packet.stats) == 1
+        assert packet.stats[0].timestamp == packet.timestamp
+        assert packet.stats[0].size == len(packet)
+    assert encoder.GetFrameStats() == []
@@ -0,0 +1,119 @@
+# This copyright notice applies to this file only
+#
+# SPDX-FileCopyrightText: Copyright (c) 2025 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+# SPDX-License-Identifier: MIT
+#
+# Permission is hereby granted, free of charge, to any person obtaining a
+# copy of this software and associated documentation files (the "Software"),
+# to deal in the Software without restriction, including without limitation
+# the rights to use, copy, modify, merge, publish, distribute, sublicense,
+# and/or sell copies of the Software, and to permit persons to whom the
+# Software is furnished to do so, subject to the following conditions:
+#
+# The above copyright notice and this permission notice shall be included in
+# all copies or substantial portions of the Software.
+#
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+# IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+# THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+# FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+# DEALINGS IN THE SOFTWARE.
+
+"""CPU input frames uploaded through pinned staging buffers or from buffers registered with RegisterHostBuffer."""
+
+import pytest
+
+@pytest.fixture(scope="module")
+def frame_bytes(frame_size):
+    width, height = frame_size
+    return width * height * 3 // 2
+
+
+@pytest.mark.parametrize("bf", [0, 3])
+def test_reused_input_array_is_staged_before_encode_returns(create_encoder, encode_bitstream, np, nv12_frames, frame_bytes, bf):
+    # more frames than staging buffers, so that the staging ring wraps around while frames are in flight
+    frames = nv12_frames(24)
+    expected = encode_bitstream(create_encoder(bf=bf), frames)
+
+    encoder = create_encoder(bf=bf)
+    reused = np.empty(frame_bytes, np.uint8)
+    chunks = []
+    for frame in frames:
+        reused[:] = frame
+        chunks.append(bytes(encoder.Encode(reused)))
+    chunks.append(bytes(encoder.EndEncode()))
+    assert b"".join(chunks) == expected
+
+
+@pytest.mark.parametrize("bf", [0, 3])
+def test_frames_of_a_registered_buffer_encode_like_staged_frames(create_encoder, encode_bitstream, np, nv12_frames, bf):
+    frames = nv12_frames(24)
+    expected = encode_bitstream(create_encoder(bf=bf), frames)
+
+    encoder = create_encoder(bf=bf)
+    buffer = np.stack(frames)
+    encoder.RegisterHostBuffer(buffer)
+    # every row of the buffer lies within the registered range and is uploaded without staging
+    assert encode_bitstream(encoder, list(buffer)) == expected
+    encoder.UnregisterHostBuffer(buffer)
+
+
+@pytest.mark.parametrize("bf", [0, 3])
+def test_registered_ring_is_rewritten_while_frames_are_in_flight(create_encoder, encode_bitstream, np, nv12_frames, frame_bytes, bf):
+    frames = nv12_frames(24)
+    expected = encode_bitstream(create_encoder(bf=bf), frames)
+
+    encoder = create_encoder(bf=bf)
+    # a frame may be overwritten once three more frames have been encoded, so each slot of a ring of four frames is free when it is rewritten
+    ring = np.empty((4, frame_bytes), np.uint8)
+    encoder.RegisterHostBuffer(ring)
+    chunks = []
+    for i, frame in enumerate(frames):
+        ring[i % len(ring)] = frame
+        chunks.append(bytes(encoder.Encode(ring[i % len(ring)])))
+    chunks.append(bytes(encoder.EndEncode()))
+    encoder.UnregisterHostBuffer(ring)
+    assert b"".join(chunks) == expected
+
+
+def test_encoding_continues_after_unregister(create_encoder, encode_bitstream, np, nv12_frames):
+    frames = nv12_frames(12)
+    expected = encode_bitstream(create_encoder(), frames)
+
+    encoder = create_encoder()
+    buffer = np.stack(frames)
+    encoder.RegisterHostBuffer(buffer)
+    chunks = [bytes(encoder.Encode(frame)) for frame in buffer[:6]]
+    encoder.UnregisterHostBuffer(buffer)
+    chunks += [bytes(encoder.Encode(frame)) for frame in buffer[6:]]
+    chunks.append(bytes(encoder.EndEncode()))
+    assert b"".join(chunks) == expected
+
+
+def test_registering_twice_and_unregistering_unknown_buffers_are_no_ops(create_encoder, np, nv12_frames, frame_bytes):
+    encoder = create_encoder()
+    buffer = np.stack(nv12_frames(2))
+    encoder.RegisterHostBuffer(buffer)
+    encoder.RegisterHostBuffer(buffer)
+    encoder.RegisterHostBuffer(buffer[1])
+    encoder.UnregisterHostBuffer(np.empty(frame_bytes, np.uint8))
+    encoder.UnregisterHostBuffer(buffer)
+    encoder.UnregisterHostBuffer(buffer)
+
+
+def test_non_contiguous_buffer_cannot_be_registered(create_encoder, np, frame_bytes):
+    encoder = create_encoder()
+    with pytest.raises(Exception):
+        encoder.RegisterHostBuffer(np.empty((4, 2 * frame_bytes), np.uint8)[:, ::2])
+
+
+@pytest.mark.parametrize("register", [False, True])
+def test_frame_smaller_than_the_input_raises(create_encoder, np, frame_bytes, register):
+    encoder = create_encoder()
+    frame = np.zeros(frame_bytes - 1, np.uint8)
+    if register:
+        encoder.RegisterHostBuffer(frame)
+    with pytest.raises(Exception):
+        encoder.Encode(frame)
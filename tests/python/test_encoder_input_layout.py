@@ -0,0 +1,46 @@
+# This copyright notice applies to this file only
+#
+# SPDX-FileCopyrightText: Copyright (c) 2025 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+# SPDX-License-Identifier: MIT
+#
+# Permission is hereby granted, free of charge, to any person obtaining a
+# copy of this software and associated documentation files (the "Software"),
+# to deal in the Software without restriction, including without limitation
+# the rights to use, copy, modify, merge, publish, distribute, sublicense,
+# and/or sell copies of the Software, and to permit persons to whom the
+# Software is furnished to do so, subject to the following conditions:
+#
+# The above copyright notice and this permission notice shall be included in
+# all copies or substantial portions of the Software.
+#
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+# IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+# THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+# FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+# DEALINGS IN THE SOFTWARE.
+
+"""Device frames whose chroma plane does not directly follow the luma rows."""
+
+import pytest
+
+@pytest.mark.parametrize("gap", [0, 256, 4096 + 64])
+def test_nv12_planes_at_any_offset_encode_like_contiguous_frames(create_encoder, encode_bitstream, nv12_frames, frame_size, gap):
+    cp = pytest.importorskip("cupy")
+    width, height = frame_size
+    luma_size = width * height
+    contiguous = []
+    split = []
+    for frame in nv12_frames(8):
+        contiguous.append(cp.asarray(frame).reshape(height * 3 // 2, width, 1))
+        # one allocation with `gap` unused bytes between the luma and chroma planes
+        buffer = cp.zeros(luma_size + gap + luma_size // 2, cp.uint8)
+        buffer[:luma_size] = cp.asarray(frame[:luma_size])
+        buffer[luma_size + gap:] = cp.asarray(frame[luma_size:])
+        luma = buffer[:luma_size].reshape(height, width, 1)
+        chroma = buffer[luma_size + gap:].reshape(height // 2, width // 2, 2)
+        split.append([luma, chroma])
+
+    expected = encode_bitstream(create_encoder(usecpuinputbuffer=False), contiguous)
+    assert encode_bitstream(create_encoder(usecpuinputbuffer=False), split) == expected
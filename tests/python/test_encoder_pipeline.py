@@ -0,0 +1,79 @@
+# This copyright notice applies to this file only
+#
+# SPDX-FileCopyrightText: Copyright (c) 2025 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+# SPDX-License-Identifier: MIT
+#
+# Permission is hereby granted, free of charge, to any person obtaining a
+# copy of this software and associated documentation files (the "Software"),
+# to deal in the Software without restriction, including without limitation
+# the rights to use, copy, modify, merge, publish, distribute, sublicense,
+# and/or sell copies of the Software, and to permit persons to whom the
+# Software is furnished to do so, subject to the following conditions:
+#
+# The above copyright notice and this permission notice shall be included in
+# all copies or substantial portions of the Software.
+#
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+# IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+# THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+# FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+# DEALINGS IN THE SOFTWARE.
+
+"""Pipelined encoding (Submit/Retrieve/Flush) with an output delay, from B frames and lookahead."""
+
+import pytest
+
+DELAY_CONFIGS = [
+    pytest.param({"bf": 0}, id="no_delay"),
+    pytest.param({"bf": 3}, id="bframes"),
+    pytest.param({"lookahead": 8, "rc": "vbr"}, id="lookahead"),
+    pytest.param({"bf": 3, "lookahead": 8, "rc": "vbr"}, id="bframes_lookahead"),
+]
+
+
+@pytest.mark.parametrize("config", DELAY_CONFIGS)
+def test_every_submitted_frame_yields_one_packet(create_encoder, nv12_frames, config):
+    encoder = create_encoder(**config)
+    frames = nv12_frames(40)
+    tickets = []
+    packets = []
+    for frame in frames:
+        tickets.append(encoder.Submit(frame))
+        # polling must never hand out a frame held back by the output delay
+        while (packet := encoder.Retrieve(0)) is not None:
+            packets.append(packet)
+    packets += encoder.Flush()
+
+    assert len(packets) == len(frames)
+    assert sorted(p.timestamp for p in packets) == sorted(tickets)
+    assert all(len(p) > 0 for p in packets)
+    assert encoder.pending == 0
+
+
+@pytest.mark.parametrize("config", DELAY_CONFIGS)
+def test_retrieve_returns_when_all_frames_are_held_back(create_encoder, nv12_frames, config):
+    encoder = create_encoder(**config)
+    frames = nv12_frames(2)
+    for frame in frames:
+        encoder.Submit(frame)
+    # with an output delay the frames complete only after Flush, a blocking Retrieve must not hang
+    packets = []
+    while (packet := encoder.Retrieve(-1)) is not None:
+        packets.append(packet)
+    packets += encoder.Flush()
+    assert len(packets) == len(frames)
+
+
+@pytest.mark.parametrize("config", DELAY_CONFIGS[1:])
+def test_pipelined_bitstream_matches_synchronous_encode(create_encoder, encode_bitstream, nv12_frames, config):
+    frames = nv12_frames(24)
+
+    expected = encode_bitstream(create_encoder(**config), frames)
+
+    encoder = create_encoder(**config)
+    for frame in frames:
+        encoder.Submit(frame)
+    packets = encoder.Flush()
+    assert b"".join(bytes(p) for p in packets) == expected
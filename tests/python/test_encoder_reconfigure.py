@@ -0,0 +1,139 @@
+# This copyright notice applies to this file only
+#
+# SPDX-FileCopyrightText: Copyright (c) 2025 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+# SPDX-License-Identifier: MIT
+#
+# Permission is hereby granted, free of charge, to any person obtaining a
+# copy of this software and associated documentation files (the "Software"),
+# to deal in the Software without restriction, including without limitation
+# the rights to use, copy, modify, merge, publish, distribute, sublicense,
+# and/or sell copies of the Software, and to permit persons to whom the
+# Software is furnished to do so, subject to the following conditions:
+#
+# The above copyright notice and this permission notice shall be included in
+# all copies or substantial portions of the Software.
+#
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+# IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+# THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+# FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+# DEALINGS IN THE SOFTWARE.
+
+
+"""Live reconfiguration of the resolution, GOP and constant QP of an encoder (Reconfigure)."""
+
+import pytest
+
+@pytest.fixture(scope="module")
+def reconfigurable_encoder(create_encoder, frame_size):
+    """Returns a function making an encoder that reports frame statistics and can be reconfigured up to frame_size."""
+    width, height = frame_size
+    return lambda **config: create_encoder(max_res=f"{width}x{height}", frame_stats=1, **config)
+
+
+def picture_types(packets):
+    return [stats.picture_type for packet in packets for stats in packet.stats]
+
+
+def decoded_shapes(nvc, cp, path, max_width, max_height):
+    demuxer = nvc.CreateDemuxer(filename=path)
+    decoder = nvc.CreateDecoder(gpuid=0, codec=demuxer.GetNvCodecId(), usedevicememory=1, maxwidth=max_width, maxheight=max_height)
+    return [cp.from_dlpack(frame).shape for packet in demuxer for frame in decoder.Decode(packet)]
+
+
+def test_lower_resolution_within_max_res(nvc, reconfigurable_encoder, nv12_frames, frame_size, tmp_path):
+    cp = pytest.importorskip("cupy")
+    width, height = frame_size
+    encoder = reconfigurable_encoder()
+    path = tmp_path / "reconfigured.264"
+    with open(path, "wb") as f:
+        for frame in nv12_frames(10):
+            f.write(bytes(encoder.Encode(frame)))
+        f.write(bytes(encoder.EndEncode()))
+
+        params = encoder.GetEncodeReconfigureParams()
+        params.encodeWidth = width // 2
+        params.encodeHeight = height // 2
+        assert encoder.Reconfigure(params)
+        # the first frame at the new resolution starts a new sequence
+        packets = [encoder.Encode(frame) for frame in nv12_frames(10, width // 2, height // 2)]
+        assert picture_types(packets[:1]) == [nvc.NV_ENC_PIC_TYPE.IDR]
+        for packet in packets:
+            f.write(bytes(packet))
+        f.write(bytes(encoder.EndEncode()))
+
+    # NV12 frames are decoded as H * 3 / 2 rows of W bytes
+    shapes = decoded_shapes(nvc, cp, str(path), width, height)
+    assert shapes == [(height * 3 // 2, width)] * 10 + [(height * 3 // 4, width // 2)] * 10
+
+
+def test_resolution_beyond_max_res_raises(reconfigurable_encoder, nv12_frames, frame_size):
+    width, height = frame_size
+    encoder = reconfigurable_encoder()
+    params = encoder.GetEncodeReconfigureParams()
+    params.encodeWidth = width * 2
+    params.encodeHeight = height
+    with pytest.raises(Exception):
+        encoder.Reconfigure(params)
+    # the encoder keeps its configuration
+    encoder.Encode(nv12_frames(1)[0])
+
+
+def test_reset_with_pending_frames_raises(reconfigurable_encoder, nv12_frames, frame_size):
+    width, height = frame_size
+    # B frames hold the first frames back in the encoder
+    encoder = reconfigurable_encoder(bf=2)
+    for frame in nv12_frames(2):
+        encoder.Encode(frame)
+    params = encoder.GetEncodeReconfigureParams()
+    params.resetEncoder = True
+    with pytest.raises(Exception):
+        encoder.Reconfigure(params)
+    params.resetEncoder = False
+    params.encodeWidth = width // 2
+    params.encodeHeight = height // 2
+    with pytest.raises(Exception):
+        encoder.Reconfigure(params)
+
+    # once flushed the reset goes through
+    encoder.EndEncode()
+    assert encoder.Reconfigure(params)
+
+
+def test_gop_and_idr_period(nvc, reconfigurable_encoder, nv12_frames):
+    encoder = reconfigurable_encoder()
+    params = encoder.GetEncodeReconfigureParams()
+    params.gopLength = 5
+    params.idrPeriod = 5
+    params.resetEncoder = True
+    params.forceIDR = True
+    assert encoder.Reconfigure(params)
+
+    packets = [encoder.Encode(frame) for frame in nv12_frames(20)]
+    packets.append(encoder.EndEncode())
+    types = picture_types(packets)
+    assert len(types) == 20
+    assert [i for i, t in enumerate(types) if t == nvc.NV_ENC_PIC_TYPE.IDR] == [0, 5, 10, 15]
+
+
+def test_const_qp(nvc, reconfigurable_encoder, nv12_frames):
+    frames = nv12_frames(10)
+    encoder = reconfigurable_encoder(rc="constqp", constqp=20)
+    results = {}
+    for qp in [20, 40]:
+        params = encoder.GetEncodeReconfigureParams()
+        params.rateControlMode = nvc.NV_ENC_PARAMS_RC_MODE.CONSTQP
+        params.constQPIntra = params.constQPInterP = params.constQPInterB = qp
+        params.resetEncoder = True
+        params.forceIDR = True
+        assert encoder.Reconfigure(params)
+        packets = [encoder.Encode(frame) for frame in frames]
+        packets.append(encoder.EndEncode())
+        stats = [s for packet in packets for s in packet.stats]
+        results[qp] = (sum(s.avg_qp for s in stats) / len(stats), sum(len(bytes(p)) for p in packets))
+
+    # a higher QP quantizes more coarsely
+    assert results[40][0] > results[20][0]
+    assert results[40][1] < results[20][1]
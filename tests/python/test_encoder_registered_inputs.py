@@ -0,0 +1,79 @@
+# This copyright notice applies to this file only
+#
+# SPDX-FileCopyrightText: Copyright (c) 2025 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+# SPDX-License-Identifier: MIT
+#
+# Permission is hereby granted, free of charge, to any person obtaining a
+# copy of this software and associated documentation files (the "Software"),
+# to deal in the Software without restriction, including without limitation
+# the rights to use, copy, modify, merge, publish, distribute, sublicense,
+# and/or sell copies of the Software, and to permit persons to whom the
+# Software is furnished to do so, subject to the following conditions:
+#
+# The above copyright notice and this permission notice shall be included in
+# all copies or substantial portions of the Software.
+#
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+# IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+# THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+# FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+# DEALINGS IN THE SOFTWARE.
+
+"""Device frames registered with the encoder (registered_inputs=N) and encoded in place, against copied frames."""
+
+import pytest
+
+def device_frames(cp, frames, width, height):
+    return [cp.asarray(frame).reshape(height * 3 // 2, width, 1) for frame in frames]
+
+
+@pytest.mark.parametrize("registered_inputs", [1, 4, 16])
+@pytest.mark.parametrize("bf", [0, 3])
+def test_distinct_frames_encode_like_copied_frames(create_encoder, encode_bitstream, nv12_frames, frame_size,
+                                                   registered_inputs, bf):
+    cp = pytest.importorskip("cupy")
+    frames = device_frames(cp, nv12_frames(12), *frame_size)
+    # a cache smaller than the frames evicts, with B frames while the evicted frame may still be in flight
+    expected = encode_bitstream(create_encoder(usecpuinputbuffer=False, bf=bf), frames)
+    assert encode_bitstream(create_encoder(usecpuinputbuffer=False, bf=bf, registered_inputs=registered_inputs), frames) == expected
+
+
+@pytest.mark.parametrize("ring_size", [1, 3])
+def test_ring_of_reused_buffers_encodes_the_current_content(create_encoder, encode_bitstream, nv12_frames, frame_size,
+                                                            ring_size):
+    cp = pytest.importorskip("cupy")
+    width, height = frame_size
+    frames = nv12_frames(12)
+    expected = encode_bitstream(create_encoder(usecpuinputbuffer=False), device_frames(cp, frames, width, height))
+
+    ring = [cp.empty((height * 3 // 2, width, 1), cp.uint8) for _ in range(ring_size)]
+    encoder = create_encoder(usecpuinputbuffer=False, registered_inputs=ring_size)
+    chunks = []
+    for i, frame in enumerate(frames):
+        # without an output delay the frame is read once Encode returns, so the buffer can be refilled
+        buffer = ring[i % ring_size]
+        buffer[...] = cp.asarray(frame).reshape(buffer.shape)
+        cp.cuda.runtime.deviceSynchronize()
+        chunks.append(bytes(encoder.Encode(buffer)))
+    chunks.append(bytes(encoder.EndEncode()))
+    assert b"".join(chunks) == expected
+
+
+def test_split_planes_are_copied_instead(create_encoder, encode_bitstream, nv12_frames, frame_size):
+    cp = pytest.importorskip("cupy")
+    width, height = frame_size
+    luma_size = width * height
+    frames = nv12_frames(6)
+    split = []
+    for frame in frames:
+        # a registered resource has no chroma offset, so the gap must make the frame fall back to a copy
+        buffer = cp.zeros(luma_size + 4096 + luma_size // 2, cp.uint8)
+        buffer[:luma_size] = cp.asarray(frame[:luma_size])
+        buffer[luma_size + 4096:] = cp.asarray(frame[luma_size:])
+        split.append([buffer[:luma_size].reshape(height, width, 1),
+                      buffer[luma_size + 4096:].reshape(height // 2, width // 2, 2)])
+
+    expected = encode_bitstream(create_encoder(usecpuinputbuffer=False), device_frames(cp, frames, width, height))
+    assert encode_bitstream(create_encoder(usecpuinputbuffer=False, registered_inputs=4), split) == expected
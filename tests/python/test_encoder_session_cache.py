@@ -0,0 +1,104 @@
+# This copyright notice applies to this file only
+#
+# SPDX-FileCopyrightText: Copyright (c) 2025 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+# SPDX-License-Identifier: MIT
+#
+# Permission is hereby granted, free of charge, to any person obtaining a
+# copy of this software and associated documentation files (the "Software"),
+# to deal in the Software without restriction, including without limitation
+# the rights to use, copy, modify, merge, publish, distribute, sublicense,
+# and/or sell copies of the Software, and to permit persons to whom the
+# Software is furnished to do so, subject to the following conditions:
+#
+# The above copyright notice and this permission notice shall be included in
+# all copies or substantial portions of the Software.
+#
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+# IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+# THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+# FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+# DEALINGS IN THE SOFTWARE.
+
+
+"""Reuse of idle encoder sessions (SetEncoderSessionCacheSize) against freshly created sessions."""
+
+import gc
+
+import pytest
+
+@pytest.fixture
+def session_cache(nvc):
+    nvc.ClearEncoderSessionCache()
+    nvc.SetEncoderSessionCacheSize(2)
+    yield
+    nvc.SetEncoderSessionCacheSize(0)
+    nvc.ClearEncoderSessionCache()
+
+
+def test_recreated_encoder_reuses_the_session(nvc, create_encoder, encode_bitstream, nv12_frames, session_cache):
+    frames = nv12_frames(20)
+    created = nvc.GetEncoderSessionCacheStats()["sessions_created"]
+    encoder = create_encoder()
+    expected = encode_bitstream(encoder, frames)
+    # the session goes to the cache when the encoder is destroyed
+    del encoder
+    gc.collect()
+    stats = nvc.GetEncoderSessionCacheStats()
+    assert stats["sessions_created"] == created + 1
+
+    encoder = create_encoder()
+    after = nvc.GetEncoderSessionCacheStats()
+    assert after["sessions_reused"] == stats["sessions_reused"] + 1
+    assert after["sessions_created"] == stats["sessions_created"]
+    # the reset session starts a new stream with an IDR, as a new session does
+    assert encode_bitstream(encoder, frames) == expected
+
+
+def test_session_left_mid_stream_is_reset(nvc, create_encoder, encode_bitstream, nv12_frames, session_cache):
+    frames = nv12_frames(20)
+    encoder = create_encoder(bf=2)
+    expected = encode_bitstream(encoder, frames)
+    del encoder
+    gc.collect()
+
+    # frames still queued in the session are dropped when it goes to the cache
+    encoder = create_encoder(bf=2)
+    for frame in frames[:5]:
+        encoder.Encode(frame)
+    del encoder
+    gc.collect()
+
+    reused = nvc.GetEncoderSessionCacheStats()["sessions_reused"]
+    encoder = create_encoder(bf=2)
+    assert nvc.GetEncoderSessionCacheStats()["sessions_reused"] == reused + 1
+    assert encode_bitstream(encoder, frames) == expected
+
+
+def test_incompatible_config_creates_a_new_session(nvc, create_encoder, encode_bitstream, nv12_frames, session_cache):
+    frames = nv12_frames(20)
+    encoder = create_encoder()
+    del encoder
+    gc.collect()
+    stats = nvc.GetEncoderSessionCacheStats()
+
+    # the number of B frames sizes the buffers of the session, so the cached one cannot be reset to it
+    encoder = create_encoder(bf=2)
+    after = nvc.GetEncoderSessionCacheStats()
+    assert after["sessions_reused"] == stats["sessions_reused"]
+    assert after["sessions_created"] == stats["sessions_created"] + 1
+
+    # the cache is empty now, so this is a fresh session as well
+    fresh = create_encoder(bf=2)
+    assert encode_bitstream(encoder, frames) == encode_bitstream(fresh, frames)
+
+
+def test_disabled_cache_never_reuses(nvc, create_encoder):
+    nvc.SetEncoderSessionCacheSize(0)
+    reused = nvc.GetEncoderSessionCacheStats()["sessions_reused"]
+    encoder = create_encoder()
+    del encoder
+    gc.collect()
+    create_encoder()
+    assert nvc.GetEncoderSessionCacheStats()["sessions_reused"] == reused
@@ -0,0 +1,71 @@
+# This copyright notice applies to this file only
+#
+# SPDX-FileCopyrightText: Copyright (c) 2025 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+# SPDX-License-Identifier: MIT
+#
+# Permission is hereby granted, free of charge, to any person obtaining a
+# copy of this software and associated documentation files (the "Software"),
+# to deal in the Software without restriction, including without limitation
+# the rights to use, copy, modify, merge, publish, distribute, sublicense,
+# and/or sell copies of the Software, and to permit persons to whom the
+# Software is furnished to do so, subject to the following conditions:
+#
+# The above copyright notice and this permission notice shall be included in
+# all copies or substantial portions of the Software.
+#
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+# IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+# THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+# FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+# DEALINGS IN THE SOFTWARE.
+
+
+"""Buffer descriptors of decoded frames, which are recycled once the frames are released."""
+
+import pytest
+
+
+def ladder(nvc):
+    params = nvc.PostProcessParams()
+    params.width = 128
+    params.height = 64
+    return [nvc.PostProcessOutput(nvc.PostProcessFormat.NV12, params)]
+
+
+def allocation_counts(nvc, path, fetch, **kwargs):
+    """Decodes the clip and returns the descriptor allocation count after each packet. Frames are dropped right away."""
+    demuxer = nvc.CreateDemuxer(filename=path)
+    decoder = nvc.CreateDecoder(gpuid=0, codec=demuxer.GetNvCodecId(), usedevicememory=1, **kwargs)
+    counts = []
+    frames = 0
+    for packet in demuxer:
+        frames += fetch(decoder, packet)
+        counts.append(decoder.GetExternalBufferAllocationCount())
+    return frames, counts
+
+
+def decode(decoder, packet):
+    return len(decoder.Decode(packet))
+
+
+def get_frame(decoder, packet):
+    n = decoder.GetNumDecodedFrame(packet)
+    for _ in range(n):
+        decoder.GetFrame()
+    return n
+
+
+@pytest.mark.parametrize("fetch", [decode, get_frame], ids=["Decode", "GetFrame"])
+@pytest.mark.parametrize("with_ladder", [False, True], ids=["frame", "ladder"])
+def test_allocation_count_stays_flat(nvc, h264_clip, fetch, with_ladder):
+    path, count, _, _ = h264_clip
+    kwargs = {"outputladder": ladder(nvc)} if with_ladder else {}
+    frames, counts = allocation_counts(nvc, path, fetch, **kwargs)
+
+    assert frames == count
+    assert counts[-1] > 0
+    # once the first frames are out, every descriptor comes back to the pool before it is needed again
+    warm = len(counts) // 4
+    assert counts[warm] == counts[-1]
@@ -0,0 +1,59 @@
+# This copyright notice applies to this file only
+#
+# SPDX-FileCopyrightText: Copyright (c) 2025 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+# SPDX-License-Identifier: MIT
+#
+# Permission is hereby granted, free of charge, to any person obtaining a
+# copy of this software and associated documentation files (the "Software"),
+# to deal in the Software without restriction, including without limitation
+# the rights to use, copy, modify, merge, publish, distribute, sublicense,
+# and/or sell copies of the Software, and to permit persons to whom the
+# Software is furnished to do so, subject to the following conditions:
+#
+# The above copyright notice and this permission notice shall be included in
+# all copies or substantial portions of the Software.
+#
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+# IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+# THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+# FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+# DEALINGS IN THE SOFTWARE.
+
+
+"""Frames decoded to pinned host memory match the frames decoded to device memory byte for byte."""
+
+import pytest
+
+
+def decode_to_numpy(nvc, np, cp, path, use_device_memory, output_color_type):
+    """Decodes the whole clip and copies each frame to a numpy array before the decoder reuses its buffer."""
+    demuxer = nvc.CreateDemuxer(filename=path)
+    decoder = nvc.CreateDecoder(gpuid=0, codec=demuxer.GetNvCodecId(), usedevicememory=int(use_device_memory),
+                                outputColorType=output_color_type)
+    frames = []
+    for packet in demuxer:
+        for frame in decoder.Decode(packet):
+            if use_device_memory:
+                frames.append(cp.asnumpy(cp.from_dlpack(frame)))
+            else:
+                # host frames wait for their copy from the device when they are exported through DLPack
+                frames.append(np.array(np.from_dlpack(frame)))
+    return frames
+
+
+@pytest.mark.parametrize("output_color_type", ["NATIVE", "RGB"])
+def test_host_frames_match_device_frames(nvc, np, h264_clip, output_color_type):
+    cp = pytest.importorskip("cupy")
+    path, count, width, height = h264_clip
+    color_type = getattr(nvc.OutputColorType, output_color_type)
+    device_frames = decode_to_numpy(nvc, np, cp, path, True, color_type)
+    host_frames = decode_to_numpy(nvc, np, cp, path, False, color_type)
+
+    assert len(device_frames) == len(host_frames) == count
+    expected_shape = (height * 3 // 2, width) if output_color_type == "NATIVE" else (height, width, 3)
+    for i, (device_frame, host_frame) in enumerate(zip(device_frames, host_frames)):
+        assert device_frame.shape == expected_shape
+        assert host_frame.shape == device_frame.shape, f"frame {i}"
+        assert host_frame.tobytes() == device_frame.tobytes(), f"frame {i}"
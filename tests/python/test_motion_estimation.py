@@ -0,0 +1,86 @@
+# This copyright notice applies to this file only
+#
+# SPDX-FileCopyrightText: Copyright (c) 2025 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+# SPDX-License-Identifier: MIT
+#
+# Permission is hereby granted, free of charge, to any person obtaining a
+# copy of this software and associated documentation files (the "Software"),
+# to deal in the Software without restriction, including without limitation
+# the rights to use, copy, modify, merge, publish, distribute, sublicense,
+# and/or sell copies of the Software, and to permit persons to whom the
+# Software is furnished to do so, subject to the following conditions:
+#
+# The above copyright notice and this permission notice shall be included in
+# all copies or substantial portions of the Software.
+#
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+# IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+# THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+# FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+# DEALINGS IN THE SOFTWARE.
+
+
+"""Motion estimation only sessions (me_only=1) and RunMotionEstimation."""
+
+import collections
+
+import pytest
+
+WIDTH, HEIGHT = 256, 128
+
+
+@pytest.fixture(scope="module")
+def me_encoder_supported(nvc):
+    if not nvc.GetEncoderCaps(codec="h264").get("support_meonly_mode"):
+        pytest.skip("GPU has no motion estimation only mode")
+
+
+def textured_frame(np, seed=0):
+    """NV12 frame with a random luma texture, so that every block matches only at its true displacement."""
+    rng = np.random.default_rng(seed)
+    luma = rng.integers(0, 256, (HEIGHT, WIDTH), dtype=np.uint8)
+    chroma = np.full((HEIGHT // 2, WIDTH), 128, np.uint8)
+    return luma, chroma
+
+
+def to_nv12(np, luma, chroma):
+    return np.concatenate([luma.ravel(), chroma.ravel()])
+
+
+@pytest.mark.parametrize("shift_x, shift_y", [(3, 0), (0, 2), (-4, 1)])
+def test_shift_gives_quarter_pel_vector(nvc, np, me_encoder_supported, shift_x, shift_y):
+    encoder = nvc.CreateEncoder(WIDTH, HEIGHT, "NV12", True, codec="h264", me_only=1)
+    luma, chroma = textured_frame(np)
+    # frame[y, x] = reference[y + shift_y, x + shift_x], so each block is found shift pixels away in the reference
+    shifted = np.roll(luma, (-shift_y, -shift_x), axis=(0, 1))
+    field = encoder.RunMotionEstimation(to_nv12(np, shifted, chroma), to_nv12(np, luma, chroma))
+
+    assert field.mv.shape == (HEIGHT // 16, WIDTH // 16, 4, 2)
+    # the blocks along the edges see the wrapped around texture, only the inner ones are counted
+    inner = field.mv[1:-1, 1:-1, 0, :].reshape(-1, 2)
+    vectors = collections.Counter(map(tuple, inner.tolist()))
+    dominant, count = vectors.most_common(1)[0]
+    assert dominant == (4 * shift_x, 4 * shift_y)
+    assert count > len(inner) // 2
+
+
+def test_identical_frames_give_zero_vectors(nvc, np, me_encoder_supported):
+    encoder = nvc.CreateEncoder(WIDTH, HEIGHT, "NV12", True, codec="h264", me_only=1)
+    frame = to_nv12(np, *textured_frame(np))
+    field = encoder.RunMotionEstimation(frame, frame)
+    assert not field.mv.any()
+
+
+def test_me_only_requires_h264(nvc):
+    # checked before the capabilities, so it raises on every GPU
+    with pytest.raises(Exception):
+        nvc.CreateEncoder(WIDTH, HEIGHT, "NV12", True, codec="hevc", me_only=1)
+
+
+def test_run_motion_estimation_requires_me_only(nvc, nv12_frames):
+    encoder = nvc.CreateEncoder(WIDTH, HEIGHT, "NV12", True, codec="h264")
+    frame = nv12_frames(1, WIDTH, HEIGHT)[0]
+    with pytest.raises(Exception):
+        encoder.RunMotionEstimation(frame, frame)
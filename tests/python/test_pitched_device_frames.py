@@ -0,0 +1,67 @@
+# This copyright notice applies to this file only
+#
+# SPDX-FileCopyrightText: Copyright (c) 2025 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+# SPDX-License-Identifier: MIT
+#
+# Permission is hereby granted, free of charge, to any person obtaining a
+# copy of this software and associated documentation files (the "Software"),
+# to deal in the Software without restriction, including without limitation
+# the rights to use, copy, modify, merge, publish, distribute, sublicense,
+# and/or sell copies of the Software, and to permit persons to whom the
+# Software is furnished to do so, subject to the following conditions:
+#
+# The above copyright notice and this permission notice shall be included in
+# all copies or substantial portions of the Software.
+#
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+# IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+# THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+# FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+# DEALINGS IN THE SOFTWARE.
+
+
+"""Default device output of SimpleDecoder and ThreadedDecoder, which decode into pitched device frames."""
+
+import pytest
+
+
+def first_simple_decoder_frame(nvc, path):
+    # elementary streams carry no frame count, the decoder needs to scan the stream for it
+    decoder = nvc.SimpleDecoder(path, need_scanned_stream_metadata=1)
+    return decoder, decoder[0]
+
+
+def first_threaded_decoder_frame(nvc, path):
+    decoder = nvc.ThreadedDecoder(path, 1)
+    frames = decoder.get_batch_frames(1)
+    return decoder, frames[0]
+
+
+@pytest.mark.parametrize("first_frame", [first_simple_decoder_frame, first_threaded_decoder_frame], ids=["simple", "threaded"])
+def test_first_frame_is_pitched(nvc, h264_clip, first_frame):
+    path, _, width, height = h264_clip
+    # the decoder owns the frame buffer and is kept alive while the frame is checked
+    decoder, frame = first_frame(nvc, path)
+
+    luma, chroma = frame.GetPtrToPlane(0), frame.GetPtrToPlane(1)
+    assert luma != 0
+    pitch = frame.strides[0]
+    assert pitch >= width
+    # the chroma rows follow the luma rows at the pitch of the allocation
+    assert chroma - luma == pitch * height
+    assert frame.shape == (height * 3 // 2, width)
+
+
+@pytest.mark.parametrize("first_frame", [first_simple_decoder_frame, first_threaded_decoder_frame], ids=["simple", "threaded"])
+def test_first_frame_matches_host_frame(nvc, np, h264_clip, first_frame):
+    cp = pytest.importorskip("cupy")
+    path, _, width, height = h264_clip
+    decoder, frame = first_frame(nvc, path)
+    device_frame = cp.asnumpy(cp.from_dlpack(frame))
+
+    host_decoder = nvc.SimpleDecoder(path, use_device_memory=False, need_scanned_stream_metadata=1)
+    host_frame = np.array(np.from_dlpack(host_decoder[0]))
+    assert device_frame.shape == host_frame.shape == (height * 3 // 2, width)
+    assert device_frame.tobytes() == host_frame.tobytes()
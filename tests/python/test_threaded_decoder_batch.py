@@ -0,0 +1,88 @@
+# This copyright notice applies to this file only
+#
+# SPDX-FileCopyrightText: Copyright (c) 2025 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+# SPDX-License-Identifier: MIT
+#
+# Permission is hereby granted, free of charge, to any person obtaining a
+# copy of this software and associated documentation files (the "Software"),
+# to deal in the Software without restriction, including without limitation
+# the rights to use, copy, modify, merge, publish, distribute, sublicense,
+# and/or sell copies of the Software, and to permit persons to whom the
+# Software is furnished to do so, subject to the following conditions:
+#
+# The above copyright notice and this permission notice shall be included in
+# all copies or substantial portions of the Software.
+#
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+# IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+# THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+# FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+# DEALINGS IN THE SOFTWARE.
+
+"""Batch tensors of the threaded decoder, which the decoder writes in place once a batch size is requested."""
+
+import pytest
+
+
+def frame_batches(nvc, cp, path, batch_size):
+    decoder = nvc.ThreadedDecoder(path, batch_size, use_device_memory=True)
+    batches = []
+    while True:
+        frames = decoder.get_batch_frames(batch_size)
+        if not frames:
+            break
+        # the frames are only valid until the next call
+        batches.append(([frame.timestamp for frame in frames], cp.stack([cp.from_dlpack(frame).copy() for frame in frames])))
+    decoder.end()
+    return batches
+
+
+def tensor_batches(nvc, path, batch_size):
+    decoder = nvc.ThreadedDecoder(path, batch_size, use_device_memory=True)
+    batches = []
+    while True:
+        batch = decoder.get_batch_tensor(batch_size)
+        if len(batch) == 0:
+            break
+        batches.append(batch)
+    decoder.end()
+    return batches
+
+
+@pytest.mark.parametrize("batch_size", [1, 4, 7])
+def test_batch_tensor_matches_frames(nvc, h264_clip, batch_size):
+    cp = pytest.importorskip("cupy")
+    path, count, _, _ = h264_clip
+    expected = frame_batches(nvc, cp, path, batch_size)
+    # every batch is kept alive until the end, so a reused target would show up as a mismatch
+    batches = tensor_batches(nvc, path, batch_size)
+
+    assert sum(len(batch) for batch in batches) == count
+    assert len(batches) == len(expected)
+    for batch, (timestamps, frames) in zip(batches, expected):
+        assert list(batch.timestamps) == timestamps
+        assert cp.array_equal(cp.from_dlpack(batch), frames)
+
+
+@pytest.mark.parametrize("batch_size", [1, 4])
+def test_batches_are_written_in_place(nvc, h264_clip, batch_size):
+    path, count, _, _ = h264_clip
+    # device frames are pitched by default, batch targets must keep the pitch for the in place path to run
+    decoder = nvc.ThreadedDecoder(path, batch_size, use_device_memory=True)
+    batches = []
+    copied = []
+    while True:
+        batch = decoder.get_batch_tensor(batch_size)
+        if len(batch) == 0:
+            break
+        batches.append(batch)
+        copied.append(decoder.get_batch_copied_frame_count())
+    decoder.end()
+
+    assert sum(len(batch) for batch in batches) == count
+    # only frames decoded before the first request and the batches realigning with the targets are copied,
+    # the second half of the clip is handed out in place
+    assert copied[len(copied) // 2] == copied[-1]
+    assert copied[-1] < count // 2